@@ -3,6 +3,8 @@
 #extension GL_GOOGLE_include_directive : enable
 
 #include "constants.h"
+#include "directional_light_cascades.h"
+#include "light_clustering.h"
 #include "gbuffer.h"
 
 struct DirectionalLight
@@ -23,18 +25,21 @@ struct PointLight
 
 layout(set = 0, binding = 0) readonly buffer _mesh_per_frame
 {
-    highp mat4       proj_view_matrix;
-    highp vec3       camera_position;
-    lowp float       _padding_camera_position;
-    highp vec3       ambient_light;
-    lowp float       _padding_ambient_light;
-    highp uint       point_light_num;
-    uint             _padding_point_light_num_1;
-    uint             _padding_point_light_num_2;
-    uint             _padding_point_light_num_3;
-    PointLight       scene_point_lights[m_max_point_light_count];
-    DirectionalLight scene_directional_light;
-    highp mat4       directional_light_proj_view;
+    highp mat4               proj_view_matrix;
+    highp vec3               camera_position;
+    lowp float               _padding_camera_position;
+    highp vec3               ambient_light;
+    lowp float               _padding_ambient_light;
+    highp uint               point_light_num;
+    uint                     _padding_point_light_num_1;
+    uint                     _padding_point_light_num_2;
+    uint                     _padding_point_light_num_3;
+    PointLight               scene_point_lights[m_max_point_light_count];
+    DirectionalLight         scene_directional_light;
+    DirectionalLightCascades directional_light_cascades;
+    highp vec2               render_scale;
+    lowp float               _padding_render_scale_1;
+    lowp float               _padding_render_scale_2;
 };
 
 layout(set = 0, binding = 3) uniform sampler2D brdfLUT_sampler;
@@ -51,10 +56,24 @@ layout(input_attachment_index = 3, set = 1, binding = 3) uniform highp subpassIn
 
 layout(set = 2, binding = 1) uniform samplerCube skybox_sampler;
 
+layout(set = 3, binding = 0) readonly buffer _unused_name_light_clustering_per_frame
+{
+    LightClusteringGrid light_clustering_grid;
+    PointLight          clustered_point_lights[];
+};
+
+layout(set = 3, binding = 1) readonly buffer _unused_name_light_clusters
+{
+    highp uint light_cluster_light_counts[m_light_cluster_count];
+    highp uint light_cluster_light_indices[];
+};
+
 layout(location = 0) in highp vec2 in_texcoord;
 layout(location = 0) out highp vec4 out_color;
 
 #include "mesh_lighting.h"
+#include "directional_light_cascades.inl"
+#include "light_clustering.inl"
 
 void main()
 {
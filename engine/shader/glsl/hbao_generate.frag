@@ -52,7 +52,9 @@ highp float ComputeAO(highp vec3 vpos,
 
 
 highp vec3 GetViewPos(highp vec2 uv) {
-    highp float depth = texture(in_depth, uv).r;
+    // only the window size at the top left of the depth is rendered, the edge is clamped as by the sampler
+    highp vec2 render_scale = vec2(windowWidth, windowHeight) / vec2(textureSize(in_depth, 0));
+    highp float depth = texture(in_depth, clamp(uv, 0.0, 1.0) * render_scale).r;
     highp vec4 clipSpace = vec4(uv * 2.0 - 1.0, depth, 1.0);
     highp vec4 viewSpace = proj_inv_matrix * clipSpace;
     highp vec3 viewPos = viewSpace.xyz / viewSpace.w;
@@ -3,6 +3,8 @@
 #extension GL_GOOGLE_include_directive : enable
 
 #include "constants.h"
+#include "directional_light_cascades.h"
+#include "light_clustering.h"
 
 struct DirectionalLight
 {
@@ -22,18 +24,21 @@ struct PointLight
 
 layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
 {
-    highp mat4       proj_view_matrix;
-    highp vec3       camera_position;
-    lowp float       _padding_camera_position;
-    highp vec3       ambient_light;
-    lowp float       _padding_ambient_light;
-    highp uint       point_light_num;
-    uint             _padding_point_light_num_1;
-    uint             _padding_point_light_num_2;
-    uint             _padding_point_light_num_3;
-    PointLight       scene_point_lights[m_max_point_light_count];
-    DirectionalLight scene_directional_light;
-    highp mat4       directional_light_proj_view;
+    highp mat4               proj_view_matrix;
+    highp vec3               camera_position;
+    lowp float               _padding_camera_position;
+    highp vec3               ambient_light;
+    lowp float               _padding_ambient_light;
+    highp uint               point_light_num;
+    uint                     _padding_point_light_num_1;
+    uint                     _padding_point_light_num_2;
+    uint                     _padding_point_light_num_3;
+    PointLight               scene_point_lights[m_max_point_light_count];
+    DirectionalLight         scene_directional_light;
+    DirectionalLightCascades directional_light_cascades;
+    highp vec2               render_scale;
+    lowp float               _padding_render_scale_1;
+    lowp float               _padding_render_scale_2;
 };
 
 layout(set = 0, binding = 3) uniform sampler2D brdfLUT_sampler;
@@ -60,6 +65,18 @@ layout(set = 2, binding = 3) uniform sampler2D normal_texture_sampler;
 layout(set = 2, binding = 4) uniform sampler2D occlusion_texture_sampler;
 layout(set = 2, binding = 5) uniform sampler2D emissive_color_texture_sampler;
 
+layout(set = 3, binding = 0) readonly buffer _unused_name_light_clustering_per_frame
+{
+    LightClusteringGrid light_clustering_grid;
+    PointLight          clustered_point_lights[];
+};
+
+layout(set = 3, binding = 1) readonly buffer _unused_name_light_clusters
+{
+    highp uint light_cluster_light_counts[m_light_cluster_count];
+    highp uint light_cluster_light_indices[];
+};
+
 // read in fragnormal (from vertex shader)
 layout(location = 0) in highp vec3 in_world_position;
 layout(location = 1) in highp vec3 in_normal;
@@ -76,7 +93,10 @@ highp vec3 getBasecolor()
 
 highp vec3 calculateNormal()
 {
-    highp vec3 tangent_normal = texture(normal_texture_sampler, in_texcoord).xyz * 2.0 - 1.0;
+    // normal maps may be block compressed to two channels, z is rebuilt
+    highp vec2 tangent_normal_xy = texture(normal_texture_sampler, in_texcoord).xy * 2.0 - 1.0;
+    highp vec3 tangent_normal =
+        vec3(tangent_normal_xy, sqrt(max(1.0 - dot(tangent_normal_xy, tangent_normal_xy), 0.0)));
 
     highp vec3 N = normalize(in_normal);
     highp vec3 T = normalize(in_tangent.xyz);
@@ -87,6 +107,8 @@ highp vec3 calculateNormal()
 }
 
 #include "mesh_lighting.h"
+#include "directional_light_cascades.inl"
+#include "light_clustering.inl"
 
 void main()
 {
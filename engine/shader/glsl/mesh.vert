@@ -3,6 +3,7 @@
 #extension GL_GOOGLE_include_directive : enable
 
 #include "constants.h"
+#include "directional_light_cascades.h"
 #include "structures.h"
 
 struct DirectionalLight
@@ -23,18 +24,18 @@ struct PointLight
 
 layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
 {
-    mat4             proj_view_matrix;
-    vec3             camera_position;
-    float            _padding_camera_position;
-    vec3             ambient_light;
-    float            _padding_ambient_light;
-    uint             point_light_num;
-    uint             _padding_point_light_num_1;
-    uint             _padding_point_light_num_2;
-    uint             _padding_point_light_num_3;
-    PointLight       scene_point_lights[m_max_point_light_count];
-    DirectionalLight scene_directional_light;
-    highp mat4       directional_light_proj_view;
+    mat4                     proj_view_matrix;
+    vec3                     camera_position;
+    float                    _padding_camera_position;
+    vec3                     ambient_light;
+    float                    _padding_ambient_light;
+    uint                     point_light_num;
+    uint                     _padding_point_light_num_1;
+    uint                     _padding_point_light_num_2;
+    uint                     _padding_point_light_num_3;
+    PointLight               scene_point_lights[m_max_point_light_count];
+    DirectionalLight         scene_directional_light;
+    DirectionalLightCascades directional_light_cascades;
 };
 
 layout(set = 0, binding = 1) readonly buffer _unused_name_per_drawcall
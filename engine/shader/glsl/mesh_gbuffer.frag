@@ -43,7 +43,10 @@ highp vec3 getBasecolor()
 
 highp vec3 calculateNormal()
 {
-    highp vec3 tangent_normal = texture(normal_texture_sampler, in_texcoord).xyz * 2.0 - 1.0;
+    // normal maps may be block compressed to two channels, z is rebuilt
+    highp vec2 tangent_normal_xy = texture(normal_texture_sampler, in_texcoord).xy * 2.0 - 1.0;
+    highp vec3 tangent_normal =
+        vec3(tangent_normal_xy, sqrt(max(1.0 - dot(tangent_normal_xy, tangent_normal_xy), 0.0)));
 
     highp vec3 N = normalize(in_normal);
     highp vec3 T = normalize(in_tangent.xyz);
@@ -2,18 +2,16 @@
 
 #extension GL_GOOGLE_include_directive : enable
 
-// TODO: geometry shader is inefficient for Mali GPU
-#extension GL_EXT_geometry_shader : enable
-
 #include "constants.h"
 
-layout(set = 0, binding = 0) readonly buffer _unused_name_global_set_per_frame_binding_buffer
+layout(set = 0, binding = 0) readonly buffer _unused_name_global_set_per_face_binding_buffer
 {
-    uint point_light_count;
-    uint _padding_point_light_count_0;
-    uint _padding_point_light_count_1;
-    uint _padding_point_light_count_2;
-    highp vec4 point_lights_position_and_radius[m_max_point_light_count];
+    highp vec3 point_light_position;
+    highp float point_light_radius;
+    highp float hemisphere_sign;
+    highp float _padding_hemisphere_sign_0;
+    highp float _padding_hemisphere_sign_1;
+    highp float _padding_hemisphere_sign_2;
 };
 
 layout(location = 0) in highp float in_inv_length;
@@ -27,8 +25,6 @@ void main()
     // perspective correct interpolation_
     highp vec3 position_view_space = in_inv_length_position_view_space / in_inv_length;
 
-    highp float point_light_radius = point_lights_position_and_radius[gl_Layer / 2].w;
-
     highp float ratio = length(position_view_space) / point_light_radius;
 
     // Trick: we don't write to depth, and thus we can use early depth test
@@ -2,9 +2,23 @@
 
 #extension GL_GOOGLE_include_directive : enable
 
+// Imagination Technologies Limited. "Dual Paraboloid Environment Mapping." Power SDK Whitepaper 2017.
+// https://github.com/powervr-graphics/Native_SDK/blob/R17.1-v4.3/Documentation/Whitepapers/Dual%20Paraboloid%20Environment%20Mapping.Whitepaper.pdf
+
 #include "constants.h"
 #include "structures.h"
 
+// one paraboloid of one point light, each of them is rendered into its own layer
+layout(set = 0, binding = 0) readonly buffer _unused_name_global_set_per_face_binding_buffer
+{
+    highp vec3 point_light_position;
+    highp float point_light_radius;
+    highp float hemisphere_sign;
+    highp float _padding_hemisphere_sign_0;
+    highp float _padding_hemisphere_sign_1;
+    highp float _padding_hemisphere_sign_2;
+};
+
 layout(set = 0, binding = 1) readonly buffer _unused_name_per_drawcall
 {
     VulkanMeshInstance mesh_instances[m_mesh_per_drawcall_max_instance_count];
@@ -22,7 +36,8 @@ layout(set = 1, binding = 0) readonly buffer _unused_name_per_mesh_joint_binding
 
 layout(location = 0) in highp vec3 in_position;
 
-layout(location = 0) out highp vec3 out_position_world_space;
+layout(location = 0) out highp float out_inv_length;
+layout(location = 1) out highp vec3 out_inv_length_position_view_space;
 
 void main()
 {
@@ -68,5 +83,29 @@ void main()
         model_position = in_position;
     }
 
-    out_position_world_space = (model_matrix * vec4(model_position, 1.0)).xyz;
+    highp vec3 position_world_space = (model_matrix * vec4(model_position, 1.0)).xyz;
+
+    // world space to light view space
+    // identity rotation
+    // Z - Up
+    // Y - Forward
+    // X - Right
+    highp vec3 position_view_space = position_world_space - point_light_position;
+
+    highp vec3 position_spherical_function_domain = normalize(position_view_space);
+
+    // z > 0
+    // (x_2d, y_2d, 0) + (0, 0, 1) = λ ((x_sph, y_sph, z_sph) + (0, 0, 1))
+    // (x_2d, y_2d) = (x_sph, y_sph) / (z_sph + 1)
+    // z < 0
+    // (x_2d, y_2d, 0) + (0, 0, -1) = λ ((x_sph, y_sph, z_sph) + (0, 0, -1))
+    // (x_2d, y_2d) = (x_sph, y_sph) / (-z_sph + 1)
+    highp vec4 position_clip;
+    position_clip.xy = position_spherical_function_domain.xy;
+    position_clip.w  = hemisphere_sign * position_spherical_function_domain.z + 1.0;
+    position_clip.z  = 0.5 * position_clip.w;
+    gl_Position      = position_clip;
+
+    out_inv_length                     = 1.0f / length(position_view_space);
+    out_inv_length_position_view_space = out_inv_length * position_view_space;
 }
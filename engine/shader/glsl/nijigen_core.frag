@@ -29,6 +29,9 @@ layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
     lowp float  _padding_camera_position;
     
     DirectionalLight scene_directional_light;
+    highp vec2       render_scale;
+    lowp float       _padding_render_scale_1;
+    lowp float       _padding_render_scale_2;
 };
 
 layout(set = 0, binding = 3) uniform samplerCube irradiance_sampler;
@@ -245,7 +248,7 @@ void main()
     highp vec2 uvOffset = vec2(sign(normalVS.x),0.) * _rim_light_width / (1.0 + linearEyeDepth) / 100.0; // 根据法线向左还是向右生成微小的偏移，除以1 + linearEyeDepth实现近大远小的效果
     highp vec2 sampleUV = positionCS.xy + uvOffset;  // 计算偏移后的屏幕空间坐标
     sampleUV = clamp(sampleUV, vec2(0.0), vec2(0.99));
-    highp float offsetSceneDepth = texture(depth_sampler, sampleUV).r;                        // 查询偏移点处的z值
+    highp float offsetSceneDepth = texture(depth_sampler, sampleUV * render_scale).r;         // 查询偏移点处的z值
     highp float offsetLinearEyeDepth = LinearEyeDepth(offsetSceneDepth);                    // 计算偏移点处观察空间深度
     highp float rimLight = saturate(offsetLinearEyeDepth - (linearEyeDepth + _rim_light_threshold)) / _rim_light_fadeout; // 根据观察空间深度差计算边缘光的亮度
     highp vec3 rimLightColor = rimLight * scene_directional_light.color;
@@ -4,7 +4,7 @@
 
 #include "constants.h"
 
-layout(set = 0, binding = 0) uniform _unused_name_perframe
+layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
 {
     mat4 proj_view_matrix;
     vec3 right_diection;
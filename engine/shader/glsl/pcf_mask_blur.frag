@@ -1,5 +1,10 @@
 #version 310 es
 
+layout(push_constant) uniform _unused_name_constant {
+    highp int mask_extent_x;
+    highp int mask_extent_y;
+} pcf_mask_blur;
+
 layout(set = 0, binding = 0) uniform highp sampler2D in_pcf_mask;
 
 layout(location = 0) in highp vec2 in_ndc_texcoord;
@@ -17,7 +22,9 @@ highp float kernel[25] = float[25](
 void main() {
 
 	ivec2 uv = ivec2(round(gl_FragCoord.x),round(gl_FragCoord.y));
-    ivec2 right_top_point = textureSize(in_pcf_mask, 0) - 1;
+    // only the scene region of the target holds the mask of this frame
+    ivec2 mask_extent     = ivec2(pcf_mask_blur.mask_extent_x, pcf_mask_blur.mask_extent_y);
+    ivec2 right_top_point = min(textureSize(in_pcf_mask, 0), mask_extent) - 1;
     highp float pcf_mask_result = 0.0;
     for (int x = -2; x <= 2; ++x) {
         for (int y = -2; y <= 2; ++y) {
@@ -3,6 +3,7 @@
 #extension GL_GOOGLE_include_directive : enable
 
 #include "constants.h"
+#include "directional_light_cascades.h"
 
 struct DirectionalLight
 {
@@ -22,18 +23,18 @@ struct PointLight
 
 layout(set = 0, binding = 0) readonly buffer _skybox_per_frame
 {
-    highp mat4       proj_view_matrix;
-    highp vec3       camera_position;
-    lowp float       _padding_camera_position;
-    highp vec3       ambient_light;
-    lowp float       _padding_ambient_light;
-    highp uint       point_light_num;
-    uint             _padding_point_light_num_1;
-    uint             _padding_point_light_num_2;
-    uint             _padding_point_light_num_3;
-    PointLight       scene_point_lights[m_max_point_light_count];
-    DirectionalLight scene_directional_light;
-    highp mat4       directional_light_proj_view;
+    highp mat4               proj_view_matrix;
+    highp vec3               camera_position;
+    lowp float               _padding_camera_position;
+    highp vec3               ambient_light;
+    lowp float               _padding_ambient_light;
+    highp uint               point_light_num;
+    uint                     _padding_point_light_num_1;
+    uint                     _padding_point_light_num_2;
+    uint                     _padding_point_light_num_3;
+    PointLight               scene_point_lights[m_max_point_light_count];
+    DirectionalLight         scene_directional_light;
+    DirectionalLightCascades directional_light_cascades;
 };
 
 layout(location = 0) out vec3 out_UVW;
@@ -2,6 +2,8 @@
 
 layout(push_constant) uniform _unused_name_constant {
     highp float brightness_threshold;  
+    highp int   scene_extent_x;
+    highp int   scene_extent_y;
 } bloom_effect;
 
 layout(input_attachment_index = 0, set = 0, binding = 0) uniform highp subpassInput in_color;
@@ -24,7 +26,9 @@ highp float kernel[25] = float[25](
 void main() {
 
 	ivec2 uv = ivec2(round(gl_FragCoord.x),round(gl_FragCoord.y));
-    ivec2 right_top_point = textureSize(in_ssao, 0) - 1;
+    // only the scene region of the target holds the ssao of this frame
+    ivec2 scene_extent    = ivec2(bloom_effect.scene_extent_x, bloom_effect.scene_extent_y);
+    ivec2 right_top_point = min(textureSize(in_ssao, 0), scene_extent) - 1;
     highp float ssao_result = 0.0;
     for (int x = -2; x <= 2; ++x) {
         for (int y = -2; y <= 2; ++y) {
@@ -4,8 +4,13 @@
 
 #include "constants.h"
 
-layout(input_attachment_index = 0, set = 0, binding = 0) uniform highp subpassInput in_color;
-layout(input_attachment_index = 1, set = 0, binding = 1) uniform highp subpassInput in_bloom_blur_color;
+// sampled instead of loaded, the scene is upscaled from the top left of the swapchain sized images
+layout(set = 0, binding = 0) uniform highp sampler2D in_color;
+layout(set = 0, binding = 1) uniform highp sampler2D in_bloom_blur_color;
+
+layout(push_constant) uniform _unused_name_constant {
+    highp vec2 render_scale;
+} scene;
 
 layout(location = 0) out highp vec4 out_color;
 
@@ -13,7 +18,10 @@ highp vec3 Uncharted2Tonemap(highp vec3 x);
 
 void main()
 {
-    highp vec3 color = subpassLoad(in_color).rgb + subpassLoad(in_bloom_blur_color).rgb;
+    // the output is as large as the images, the uv stays half a texel inside of the rendered scene
+    highp vec2 image_size = vec2(textureSize(in_color, 0));
+    highp vec2 uv = min(gl_FragCoord.xy / image_size * scene.render_scale, scene.render_scale - 0.5 / image_size);
+    highp vec3 color = texture(in_color, uv).rgb + texture(in_bloom_blur_color, uv).rgb;
 
     // tone mapping
     color = Uncharted2Tonemap(color * 4.5f);
@@ -0,0 +1,107 @@
+#version 310 es
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "constants.h"
+
+// one pipeline per set of enabled effects, the disabled ones are compiled out
+layout(constant_id = 0) const bool enable_color_grading = true;
+layout(constant_id = 1) const bool enable_vignette      = true;
+
+// sampled instead of loaded, the scene is upscaled from the top left of the swapchain sized images
+layout(set = 0, binding = 0) uniform highp sampler2D in_color;
+layout(set = 0, binding = 1) uniform highp sampler2D in_bloom_blur_color;
+
+layout(set = 0, binding = 2) uniform sampler2D color_grading_lut_texture_sampler;
+
+layout(push_constant) uniform _unused_name_constant {
+    highp float useColorGrading;
+    highp float brightness;
+    highp float contrast;
+    highp float saturation;
+    highp float temperature;
+    highp float vignetteCutoff;
+    highp float vignetteExponent;
+    highp vec2  renderScale;
+} uber_effect;
+
+layout(location = 0) in highp vec2 in_texcoord;
+layout(location = 0) out highp vec4 out_color;
+
+highp vec3 Uncharted2Tonemap(highp vec3 x);
+highp mat3 temperatureMatrix(highp float temp);
+
+void main()
+{
+    // tone mapping, same as tone_mapping.frag
+    highp vec2 image_size = vec2(textureSize(in_color, 0));
+    highp vec2 scene_uv   = min(in_texcoord * uber_effect.renderScale, uber_effect.renderScale - 0.5 / image_size);
+    highp vec3 tone_mapped_color = texture(in_color, scene_uv).rgb + texture(in_bloom_blur_color, scene_uv).rgb;
+    tone_mapped_color = Uncharted2Tonemap(tone_mapped_color * 4.5f);
+    tone_mapped_color = tone_mapped_color * (1.0f / Uncharted2Tonemap(vec3(11.2f)));
+    tone_mapped_color = vec3(pow(tone_mapped_color.x, 1.0 / 2.2),
+                             pow(tone_mapped_color.y, 1.0 / 2.2),
+                             pow(tone_mapped_color.z, 1.0 / 2.2));
+
+    highp vec4 color = vec4(tone_mapped_color, 1.0f);
+
+    // color grading, same as color_grading.frag
+    if (enable_color_grading)
+    {
+        highp ivec2 lut_tex_size = textureSize(color_grading_lut_texture_sampler, 0);
+        highp float _COLORS      = float(lut_tex_size.y);
+
+        highp vec4 graded_color = color;
+
+        graded_color.rgb += uber_effect.brightness;
+        graded_color.rgb = clamp(graded_color.rgb, 0.0, 1.0);
+
+        graded_color.rgb = (graded_color.rgb - 0.5) * uber_effect.contrast + 0.5;
+
+        highp vec3 luminance = vec3(dot(graded_color.rgb, vec3(0.2126, 0.7152, 0.0722)));
+        graded_color.rgb     = luminance + (graded_color.rgb - luminance) * uber_effect.saturation;
+        graded_color.rgb     = clamp(graded_color.rgb, 0.0, 1.0);
+
+        graded_color.rgb = temperatureMatrix(uber_effect.temperature) * graded_color.rgb;
+
+        highp float b       = graded_color.b * _COLORS;
+        highp float b_floor = floor(b);
+        highp float b_ceil  = ceil(b);
+        highp vec4 color_floor =
+            texture(color_grading_lut_texture_sampler, vec2((b_floor + graded_color.r) / _COLORS, graded_color.g));
+        highp vec4 color_ceil =
+            texture(color_grading_lut_texture_sampler, vec2((b_ceil + graded_color.r) / _COLORS, graded_color.g));
+
+        color = mix(graded_color, mix(color_floor, color_ceil, b - b_ceil), uber_effect.useColorGrading);
+    }
+
+    // vignette, same as vignette.frag
+    if (enable_vignette)
+    {
+        highp float len   = length(in_texcoord - 0.5f);
+        highp float ratio = pow(uber_effect.vignetteCutoff / len, uber_effect.vignetteExponent);
+
+        color = min(1.0, ratio) * color;
+    }
+
+    // the remap pass is a plain copy, nothing to fuse
+    out_color = color;
+}
+
+highp vec3 Uncharted2Tonemap(highp vec3 x)
+{
+    highp float A = 0.15;
+    highp float B = 0.50;
+    highp float C = 0.10;
+    highp float D = 0.20;
+    highp float E = 0.02;
+    highp float F = 0.30;
+    return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+}
+
+highp mat3 temperatureMatrix(highp float temp)
+{
+    temp           = clamp(temp, -1.0, 1.0);
+    highp float t1 = temp * 0.2;
+    return mat3(vec3(1.0 + t1, -t1, -t1), vec3(-t1, 1.0 + t1, -t1), vec3(-t1, -t1, 1.0 + t1));
+}
@@ -1,5 +1,11 @@
 #define m_max_point_light_count 15
-#define m_max_point_light_geom_vertices 90 // 90 = 2 * 3 * m_max_point_light_count
+#define m_max_directional_light_cascade_count 4
+#define m_max_clustered_point_light_count 1024
+#define m_light_cluster_count_x 16
+#define m_light_cluster_count_y 9
+#define m_light_cluster_count_z 24
+#define m_light_cluster_max_point_light_count 128
+#define m_light_cluster_count (m_light_cluster_count_x * m_light_cluster_count_y * m_light_cluster_count_z)
 #define m_mesh_per_drawcall_max_instance_count 64
 #define m_mesh_vertex_blending_max_joint_count 1024
 #define CHAOS_LAYOUT_MAJOR row_major
@@ -0,0 +1,10 @@
+struct DirectionalLightCascades
+{
+    highp mat4 proj_views[m_max_directional_light_cascade_count];
+    // from the uv of the cascade to the uv of the atlas, scale in xy and offset in zw
+    highp vec4 atlas_scale_offsets[m_max_directional_light_cascade_count];
+    highp uint cascade_count;
+    uint       _padding_cascade_count_1;
+    uint       _padding_cascade_count_2;
+    uint       _padding_cascade_count_3;
+};
@@ -0,0 +1,21 @@
+// include after the declaration of DirectionalLightCascades directional_light_cascades
+// returns the atlas uv in xy and the depth in z of the position in the first cascade covering it, and the index of
+// the cascade in w or -1 outside of all the cascades. a cascade only covers the positions whose filter of
+// margin_texels stays inside of its tile
+highp vec4 directionalLightShadowCoords(highp vec3 position_world_space, highp float margin_texels)
+{
+    for (highp int i = 0; i < int(directional_light_cascades.cascade_count); ++i)
+    {
+        highp vec4 position_clip = directional_light_cascades.proj_views[i] * vec4(position_world_space, 1.0);
+        highp vec3 position_ndc  = position_clip.xyz / position_clip.w;
+
+        highp vec4  atlas_scale_offset = directional_light_cascades.atlas_scale_offsets[i];
+        highp float margin             = margin_texels * 2.0 / (SHADOW_MAP_SIZE * atlas_scale_offset.x);
+        if (all(lessThanEqual(abs(position_ndc.xy), vec2(1.0 - margin))) && position_ndc.z <= 1.0)
+        {
+            highp vec2 uv = (position_ndc.xy * 0.5 + 0.5) * atlas_scale_offset.xy + atlas_scale_offset.zw;
+            return vec4(uv, position_ndc.z, float(i));
+        }
+    }
+    return vec4(0.0, 0.0, 0.0, -1.0);
+}
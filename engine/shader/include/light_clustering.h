@@ -0,0 +1,15 @@
+struct LightClusteringGrid
+{
+    highp mat4  view_matrix;
+    // x, y, width and height in pixels of the viewport of the main camera
+    highp vec4  viewport;
+    // view space xy at the view depth one of the ndc xy
+    highp vec2  inverse_proj_scale;
+    highp float z_near;
+    highp float z_far;
+    // the slice of a view depth is log(depth) * slice_scale + slice_bias
+    highp float slice_scale;
+    highp float slice_bias;
+    highp uint  point_light_num;
+    uint        _padding_point_light_num;
+};
@@ -0,0 +1,20 @@
+// include after the declaration of LightClusteringGrid light_clustering_grid
+// returns the index of the cluster of the main camera view containing the fragment, the clusters are laid out x
+// first, then y, then the slices
+highp uint lightClusterIndex(highp vec3 position_world_space, highp vec2 frag_coord)
+{
+    highp vec2 uv = (frag_coord - light_clustering_grid.viewport.xy) / light_clustering_grid.viewport.zw;
+    highp vec2 tile =
+        clamp(floor(uv * vec2(m_light_cluster_count_x, m_light_cluster_count_y)),
+              vec2(0.0, 0.0),
+              vec2(m_light_cluster_count_x - 1, m_light_cluster_count_y - 1));
+
+    highp float depth = -(light_clustering_grid.view_matrix * vec4(position_world_space, 1.0)).z;
+    highp float slice = clamp(floor(log(max(depth, light_clustering_grid.z_near)) * light_clustering_grid.slice_scale +
+                                    light_clustering_grid.slice_bias),
+                              0.0,
+                              float(m_light_cluster_count_z - 1));
+
+    return (uint(slice) * uint(m_light_cluster_count_y) + uint(tile.y)) * uint(m_light_cluster_count_x) +
+           uint(tile.x);
+}
@@ -6,13 +6,17 @@ highp vec3 origin_samplecube_R = vec3(R.x, R.z, R.y);
 
 highp vec3 F0 = mix(vec3(dielectric_specular, dielectric_specular, dielectric_specular), basecolor, metallic);
 
-// direct light specular and diffuse BRDF contribution
+// direct light specular and diffuse BRDF contribution, only of the point lights in the cluster of the fragment
 highp vec3 Lo = vec3(0.0, 0.0, 0.0);
-for (highp int light_index = 0; light_index < int(point_light_num) && light_index < m_max_point_light_count;
-     ++light_index)
+
+highp uint light_cluster_index      = lightClusterIndex(in_world_position, gl_FragCoord.xy);
+highp uint light_cluster_first_slot = light_cluster_index * uint(m_light_cluster_max_point_light_count);
+highp uint light_cluster_light_num  = light_cluster_light_counts[light_cluster_index];
+for (highp uint light_slot = 0u; light_slot < light_cluster_light_num; ++light_slot)
 {
-    highp vec3  point_light_position = scene_point_lights[light_index].position;
-    highp float point_light_radius   = scene_point_lights[light_index].radius;
+    highp int   light_index          = int(light_cluster_light_indices[light_cluster_first_slot + light_slot]);
+    highp vec3  point_light_position = clustered_point_lights[light_index].position;
+    highp float point_light_radius   = clustered_point_lights[light_index].radius;
 
     highp vec3  L   = normalize(point_light_position - in_world_position);
     highp float NoL = min(dot(N, L), 1.0);
@@ -25,7 +29,9 @@ for (highp int light_index = 0; light_index < int(point_light_num) && light_inde
     highp float light_attenuation = radius_attenuation * distance_attenuation * NoL;
     if (light_attenuation > 0.0)
     {
-        highp float shadow;
+        // only the first lights have shadow maps
+        highp float shadow = 1.0f;
+        if (light_index < m_max_point_light_count)
         {
             // world space to light view space
             // identity rotation
@@ -63,7 +69,7 @@ for (highp int light_index = 0; light_index < int(point_light_num) && light_inde
 
         if (shadow > 0.0f)
         {
-            highp vec3 En = scene_point_lights[light_index].intensity * light_attenuation;
+            highp vec3 En = clustered_point_lights[light_index].intensity * light_attenuation;
             Lo += BRDF(L, V, N, F0, basecolor, metallic, roughness) * En;
         }
     }
@@ -95,12 +101,10 @@ highp vec3 Libl = (kD * diffuse + specular);
 
     if (NoL > 0.0)
     {
-        highp float shadow = texture(pcf_mask, in_texcoord).r;
+        highp float shadow = texture(pcf_mask, in_texcoord * render_scale).r;
         
-        highp vec4 position_clip = directional_light_proj_view * vec4(in_world_position, 1.0);
-        highp vec3 position_ndc  = position_clip.xyz / position_clip.w;
-
-        position_ndc.xy = ndcxy_to_uv(position_ndc.xy);
+        // the filter of the pcf stays inside of the tile of the cascade
+        highp vec4 shadow_coords = directionalLightShadowCoords(in_world_position, FILTER_STRIDE);
 
         // highp float closest_depth = texture(directional_light_shadow, uv).r + 0.000075;
         // highp float current_depth = position_ndc.z;
@@ -111,10 +115,10 @@ highp vec3 Libl = (kD * diffuse + specular);
         {
             highp vec3 En = scene_directional_light.color * NoL;
             highp vec3 directColor = BRDF(L, V, N, F0, basecolor, metallic, roughness) * En;
-            if (shadow < 0.98f) {
+            if (shadow < 0.98f && shadow_coords.w >= 0.0) {
                 poissonDiskSamples(in_texcoord);
                 highp float filterRadiusUV = FILTER_STRIDE / SHADOW_MAP_SIZE;
-                highp float pcf = PCF(position_ndc, filterRadiusUV);
+                highp float pcf = PCF(shadow_coords.xyz, filterRadiusUV);
                 directColor *= pcf;
             }
             Lo += directColor;
@@ -12,3 +12,14 @@ struct VulkanMeshVertexJointBinding
     highp ivec4 indices;
     highp vec4  weights;
 };
+
+struct VulkanGPUDrivenMeshInstance
+{
+    highp mat4 model_matrix;
+    highp vec4 bounding_box_min; // world space, w unused
+    highp vec4 bounding_box_max;
+    highp uint batch_index;
+    highp uint batch_first_instance;
+    highp uint _padding_batch_1;
+    highp uint _padding_batch_2;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    class PiccoloEngine;
+
+    struct BenchmarkSettings
+    {
+        uint32_t    frame_count {300};
+        // ticked before the measured frames, the warm up goes on until the assets of the world are loaded
+        uint32_t    warmup_frame_count {30};
+        float       delta_time {1.0f / 60.0f};
+        std::string timings_file_path {"benchmark_timings.csv"};
+        // skipped when empty
+        std::string image_file_path;
+        std::string trace_file_path;
+    };
+
+    /// Ticks a headless engine with a fixed delta time and records the wall time of every frame
+    class PiccoloBenchmark
+    {
+    public:
+        void initialize(PiccoloEngine* engine_runtime, const BenchmarkSettings& settings);
+        // false if one of the outputs could not be written
+        bool run();
+
+    private:
+        void warmup();
+        bool writeTimings() const;
+        void printSummary() const;
+
+        PiccoloEngine*     m_engine_runtime {nullptr};
+        BenchmarkSettings  m_settings;
+        std::vector<float> m_frame_times_ms;
+    };
+} // namespace Piccolo
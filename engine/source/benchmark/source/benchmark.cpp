@@ -0,0 +1,149 @@
+#include "benchmark/include/benchmark.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler_system.h"
+
+#include "runtime/engine.h"
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+
+namespace Piccolo
+{
+    // bounds the warm up when an asset never finishes loading
+    static const uint32_t s_max_asset_loading_frame_count = 10000;
+
+    void PiccoloBenchmark::initialize(PiccoloEngine* engine_runtime, const BenchmarkSettings& settings)
+    {
+        assert(engine_runtime);
+
+        m_engine_runtime = engine_runtime;
+        m_settings       = settings;
+    }
+
+    bool PiccoloBenchmark::run()
+    {
+        assert(m_engine_runtime);
+
+        warmup();
+
+        m_frame_times_ms.clear();
+        m_frame_times_ms.reserve(m_settings.frame_count);
+        for (uint32_t frame_index = 0; frame_index < m_settings.frame_count; ++frame_index)
+        {
+            using namespace std::chrono;
+
+            // the tick waits for the fence of an earlier frame, so the wall time follows the gpu once it is the
+            // bottleneck
+            const steady_clock::time_point begin_time_point = steady_clock::now();
+            m_engine_runtime->tickOneFrame(m_settings.delta_time);
+            const steady_clock::time_point end_time_point = steady_clock::now();
+
+            m_frame_times_ms.push_back(duration<float, std::milli>(end_time_point - begin_time_point).count());
+        }
+
+        printSummary();
+
+        bool is_success = writeTimings();
+
+        if (!m_settings.image_file_path.empty())
+        {
+            if (g_runtime_global_context.m_render_system->saveLastFrameImage(m_settings.image_file_path))
+            {
+                LOG_INFO("last frame written to {}", m_settings.image_file_path);
+            }
+            else
+            {
+                LOG_ERROR("failed to write the last frame to {}", m_settings.image_file_path);
+                is_success = false;
+            }
+        }
+
+        if (!m_settings.trace_file_path.empty())
+        {
+            if (g_runtime_global_context.m_profiler_system->dumpChromeTrace(m_settings.trace_file_path))
+            {
+                LOG_INFO("profiler trace written to {}", m_settings.trace_file_path);
+            }
+            else
+            {
+                LOG_ERROR("failed to write the profiler trace to {}", m_settings.trace_file_path);
+                is_success = false;
+            }
+        }
+
+        return is_success;
+    }
+
+    void PiccoloBenchmark::warmup()
+    {
+        for (uint32_t frame_index = 0; frame_index < m_settings.warmup_frame_count; ++frame_index)
+        {
+            m_engine_runtime->tickOneFrame(m_settings.delta_time);
+        }
+
+        uint32_t asset_loading_frame_count = 0;
+        while (g_runtime_global_context.m_render_system->getPendingAssetLoadCount() > 0 &&
+               asset_loading_frame_count < s_max_asset_loading_frame_count)
+        {
+            m_engine_runtime->tickOneFrame(m_settings.delta_time);
+            ++asset_loading_frame_count;
+        }
+
+        if (g_runtime_global_context.m_render_system->getPendingAssetLoadCount() > 0)
+        {
+            LOG_WARN("the assets of the world are still loading, the measured frames may draw an incomplete scene");
+        }
+    }
+
+    bool PiccoloBenchmark::writeTimings() const
+    {
+        std::ofstream file(m_settings.timings_file_path, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_ERROR("failed to write the frame timings to {}", m_settings.timings_file_path);
+            return false;
+        }
+
+        file << "frame,frame_time_ms\n";
+        for (size_t frame_index = 0; frame_index < m_frame_times_ms.size(); ++frame_index)
+        {
+            file << frame_index << "," << m_frame_times_ms[frame_index] << "\n";
+        }
+
+        LOG_INFO("frame timings written to {}", m_settings.timings_file_path);
+        return file.good();
+    }
+
+    void PiccoloBenchmark::printSummary() const
+    {
+        if (m_frame_times_ms.empty())
+        {
+            return;
+        }
+
+        std::vector<float> sorted_frame_times_ms = m_frame_times_ms;
+        std::sort(sorted_frame_times_ms.begin(), sorted_frame_times_ms.end());
+
+        auto percentile = [&sorted_frame_times_ms](float fraction) {
+            const size_t index = static_cast<size_t>(fraction * (sorted_frame_times_ms.size() - 1) + 0.5f);
+            return sorted_frame_times_ms[index];
+        };
+
+        const float total_ms = std::accumulate(sorted_frame_times_ms.begin(), sorted_frame_times_ms.end(), 0.0f);
+        const float mean_ms  = total_ms / sorted_frame_times_ms.size();
+
+        std::printf("frames: %zu\n", sorted_frame_times_ms.size());
+        std::printf("mean:   %.3f ms (%.1f fps)\n", mean_ms, 1000.0f / mean_ms);
+        std::printf("min:    %.3f ms\n", sorted_frame_times_ms.front());
+        std::printf("median: %.3f ms\n", percentile(0.5f));
+        std::printf("p95:    %.3f ms\n", percentile(0.95f));
+        std::printf("p99:    %.3f ms\n", percentile(0.99f));
+        std::printf("max:    %.3f ms\n", sorted_frame_times_ms.back());
+    }
+} // namespace Piccolo
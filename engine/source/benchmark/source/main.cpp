@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "runtime/engine.h"
+
+#include "benchmark/include/benchmark.h"
+
+static void printUsage(const char* executable_name)
+{
+    std::cout << "usage: " << executable_name << " [options]\n"
+              << "renders the default world of the config without a window and records the frame times\n"
+              << "  --config <path>      engine config, PiccoloEditor.ini next to the executable by default\n"
+              << "  --frames <count>     measured frames, 300 by default\n"
+              << "  --warmup <count>     frames ticked before the measurement, 30 by default\n"
+              << "  --width <pixels>     1280 by default\n"
+              << "  --height <pixels>    720 by default\n"
+              << "  --delta-time <s>     fixed delta time of every tick, 1/60 by default\n"
+              << "  --timings <path>     per frame times as csv, benchmark_timings.csv by default\n"
+              << "  --image <path>       writes the last frame as a png\n"
+              << "  --trace <path>       writes the profiler chrome trace of the last frames\n";
+}
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path executable_path(argv[0]);
+
+    Piccolo::EngineInitParams init_params;
+    init_params.config_file_path = executable_path.parent_path() / "PiccoloEditor.ini";
+    init_params.is_headless      = true;
+
+    Piccolo::BenchmarkSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* option = argv[i];
+        if (std::strcmp(option, "--help") == 0)
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "missing value of " << option << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        if (std::strcmp(option, "--config") == 0)
+        {
+            init_params.config_file_path = value;
+        }
+        else if (std::strcmp(option, "--frames") == 0)
+        {
+            settings.frame_count = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        }
+        else if (std::strcmp(option, "--warmup") == 0)
+        {
+            settings.warmup_frame_count = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        }
+        else if (std::strcmp(option, "--width") == 0)
+        {
+            init_params.window_width = std::atoi(value);
+        }
+        else if (std::strcmp(option, "--height") == 0)
+        {
+            init_params.window_height = std::atoi(value);
+        }
+        else if (std::strcmp(option, "--delta-time") == 0)
+        {
+            settings.delta_time = static_cast<float>(std::atof(value));
+        }
+        else if (std::strcmp(option, "--timings") == 0)
+        {
+            settings.timings_file_path = value;
+        }
+        else if (std::strcmp(option, "--image") == 0)
+        {
+            settings.image_file_path = value;
+        }
+        else if (std::strcmp(option, "--trace") == 0)
+        {
+            settings.trace_file_path = value;
+        }
+        else
+        {
+            std::cerr << "unknown option " << option << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (init_params.window_width <= 0 || init_params.window_height <= 0 || settings.delta_time <= 0.0f)
+    {
+        std::cerr << "the resolution and the delta time must be positive\n";
+        return 1;
+    }
+
+    Piccolo::PiccoloEngine* engine = new Piccolo::PiccoloEngine();
+
+    engine->startEngine(init_params);
+    engine->initialize();
+
+    Piccolo::PiccoloBenchmark* benchmark = new Piccolo::PiccoloBenchmark();
+    benchmark->initialize(engine, settings);
+
+    const bool is_success = benchmark->run();
+
+    delete benchmark;
+
+    engine->clear();
+    engine->shutdownEngine();
+
+    return is_success ? 0 : 1;
+}
@@ -571,8 +571,9 @@ namespace Piccolo
             {m_translation_axis.m_mesh_data, m_rotation_axis.m_mesh_data, m_scale_aixs.m_mesh_data});
     }
 
-    size_t EditorSceneManager::getGuidOfPickedMesh(const Vector2& picked_uv) const
+    void EditorSceneManager::requestGuidOfPickedMesh(const Vector2&                picked_uv,
+                                                     std::function<void(uint32_t)> callback) const
     {
-        return g_editor_global_context.m_render_system->getGuidOfPickedMesh(picked_uv);
+        g_editor_global_context.m_render_system->requestGuidOfPickedMesh(picked_uv, std::move(callback));
     }
 } // namespace Piccolo
@@ -338,6 +338,19 @@ namespace Piccolo
                 {
                     g_runtime_global_context.m_world_manager->saveCurrentLevel();
                 }
+                if (ImGui::MenuItem("Dump Profiler Trace"))
+                {
+                    // open with chrome://tracing or ui.perfetto.dev
+                    const std::string trace_path = "profiler_trace.json";
+                    if (g_runtime_global_context.m_profiler_system->dumpChromeTrace(trace_path))
+                    {
+                        LOG_INFO("profiler trace dumped to {}", trace_path);
+                    }
+                    else
+                    {
+                        LOG_ERROR("failed to dump profiler trace to {}", trace_path);
+                    }
+                }
                 if (ImGui::MenuItem("Exit"))
                 {
                     g_editor_global_context.m_engine_runtime->shutdownEngine();
@@ -10,10 +10,10 @@ inline void hash_combine(std::size_t& seed, const T& v)
 }
 
 template<typename T, typename... Ts>
-inline void hash_combine(std::size_t& seed, const T& v, Ts... rest)
+inline void hash_combine(std::size_t& seed, const T& v, const Ts&... rest)
 {
     hash_combine(seed, v);
-    if constexpr (sizeof...(Ts) > 1)
+    if constexpr (sizeof...(Ts) > 0)
     {
         hash_combine(seed, rest...);
     }
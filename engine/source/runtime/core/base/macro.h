@@ -1,6 +1,7 @@
 #pragma once
 
 #include "runtime/core/log/log_system.h"
+#include "runtime/core/profiler/profiler_system.h"
 
 #include "runtime/function/global/global_context.h"
 
@@ -20,6 +21,14 @@
 
 #define LOG_FATAL(...) LOG_HELPER(LogSystem::LogLevel::fatal, __VA_ARGS__);
 
+#define PROFILE_SCOPE_CONCAT_HELPER(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_HELPER(a, b)
+
+// times the rest of the enclosing scope, the name must be a string literal
+#define PROFILE_SCOPE(name) \
+    ProfilerScope PROFILE_SCOPE_CONCAT(profiler_scope_, __LINE__)( \
+        g_runtime_global_context.m_profiler_system.get(), name);
+
 #define PolitSleep(_ms) std::this_thread::sleep_for(std::chrono::milliseconds(_ms));
 
 #define PolitNameOf(name) #name
@@ -0,0 +1,164 @@
+#include "runtime/core/base/thread_pool.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace Piccolo
+{
+    ThreadPool::~ThreadPool() { clear(); }
+
+    void ThreadPool::initialize(uint32_t thread_count)
+    {
+        clear();
+
+        if (thread_count == 0)
+        {
+            uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+            thread_count                   = hardware_thread_count > 1 ? hardware_thread_count - 1 : 1;
+        }
+
+        m_stopping = false;
+        m_workers.reserve(thread_count);
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            m_workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    void ThreadPool::clear()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_tasks_mutex);
+            m_stopping = true;
+        }
+        m_tasks_condition.notify_all();
+
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+    }
+
+    void ThreadPool::enqueue(std::function<void()> task)
+    {
+        if (m_workers.empty())
+        {
+            // not initialized, run in place
+            task();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_tasks_mutex);
+            m_tasks.push(std::move(task));
+        }
+        m_tasks_condition.notify_one();
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_tasks_mutex);
+                m_tasks_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    // only reached when stopping, pending tasks are drained first
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+
+            // an exception must not reach the worker thread. submit already stores it in the future and
+            // parallelFor rethrows it on the caller, so only the other tasks get here
+            try
+            {
+                task();
+            }
+            catch (const std::exception& exception)
+            {
+                LOG_ERROR("thread pool task failed: {}", exception.what());
+            }
+            catch (...)
+            {
+                LOG_ERROR("thread pool task failed with an unknown exception");
+            }
+        }
+    }
+
+    void ThreadPool::parallelFor(size_t                                                                   count,
+                                 size_t                                                                   chunk_size,
+                                 const std::function<void(size_t chunk_index, size_t begin, size_t end)>& func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        chunk_size         = std::max<size_t>(chunk_size, 1);
+        size_t chunk_count = getChunkCount(count, chunk_size);
+
+        // the first exception of a chunk stops the chunks not started yet and is rethrown on the caller
+        std::atomic<size_t> next_chunk {0};
+        std::exception_ptr  chunk_exception;
+        std::mutex          chunk_exception_mutex;
+        auto                run_chunks = [&]() {
+            try
+            {
+                for (size_t chunk_index = next_chunk++; chunk_index < chunk_count; chunk_index = next_chunk++)
+                {
+                    size_t begin = chunk_index * chunk_size;
+                    func(chunk_index, begin, std::min(begin + chunk_size, count));
+                }
+            }
+            catch (...)
+            {
+                next_chunk = chunk_count;
+
+                std::lock_guard<std::mutex> lock(chunk_exception_mutex);
+                if (!chunk_exception)
+                {
+                    chunk_exception = std::current_exception();
+                }
+            }
+        };
+
+        // the helpers reference this stack frame, so wait for all of them and not only for the chunks
+        size_t                  helper_count = std::min<size_t>(m_workers.size(), chunk_count - 1);
+        size_t                  finished_helper_count {0};
+        std::mutex              finished_mutex;
+        std::condition_variable finished_condition;
+
+        for (size_t i = 0; i < helper_count; ++i)
+        {
+            enqueue([&]() {
+                run_chunks();
+
+                std::lock_guard<std::mutex> lock(finished_mutex);
+                if (++finished_helper_count == helper_count)
+                {
+                    finished_condition.notify_one();
+                }
+            });
+        }
+
+        run_chunks();
+
+        {
+            std::unique_lock<std::mutex> lock(finished_mutex);
+            finished_condition.wait(lock, [&]() { return finished_helper_count == helper_count; });
+        }
+
+        if (chunk_exception)
+        {
+            std::rethrow_exception(chunk_exception);
+        }
+    }
+} // namespace Piccolo
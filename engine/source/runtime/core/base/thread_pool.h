@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Piccolo
+{
+    class ThreadPool
+    {
+    public:
+        ThreadPool() = default;
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // thread_count 0 means one worker less than the hardware threads, the caller is the last one
+        void initialize(uint32_t thread_count = 0);
+        void clear();
+
+        uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        // run a task on a worker thread, an exception thrown by it is rethrown by the future
+        template<typename TFunc>
+        auto submit(TFunc&& func) -> std::future<decltype(func())>
+        {
+            using TResult = decltype(func());
+
+            auto task = std::make_shared<std::packaged_task<TResult()>>(std::forward<TFunc>(func));
+            std::future<TResult> result = task->get_future();
+            enqueue([task]() { (*task)(); });
+            return result;
+        }
+
+        // split [0, count) into chunks of chunk_size and run them on the workers and the calling thread,
+        // return after all chunks are finished. chunk_index is in [0, getChunkCount(count, chunk_size))
+        // must not be called from a task of the same pool. the first exception thrown by a chunk is rethrown
+        void parallelFor(size_t                                                            count,
+                         size_t                                                            chunk_size,
+                         const std::function<void(size_t chunk_index, size_t begin, size_t end)>& func);
+
+        static size_t getChunkCount(size_t count, size_t chunk_size) { return (count + chunk_size - 1) / chunk_size; }
+
+    private:
+        void enqueue(std::function<void()> task);
+        void workerLoop();
+
+        std::vector<std::thread>          m_workers;
+        std::queue<std::function<void()>> m_tasks;
+        std::mutex                        m_tasks_mutex;
+        std::condition_variable           m_tasks_condition;
+        bool                              m_stopping {false};
+    };
+} // namespace Piccolo
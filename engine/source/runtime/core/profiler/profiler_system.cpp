@@ -0,0 +1,173 @@
+#include "runtime/core/profiler/profiler_system.h"
+
+#include "runtime/core/meta/json.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace Piccolo
+{
+    ProfilerSystem::ProfilerSystem(uint32_t frame_history_count) :
+        m_start_time_point(std::chrono::steady_clock::now()),
+        m_frame_history_count(std::max(frame_history_count, 1u))
+    {
+        m_frames.reserve(m_frame_history_count);
+    }
+
+    void ProfilerSystem::beginFrame()
+    {
+        const uint64_t now_us = getTimeUs();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_frame_serial > 0)
+        {
+            m_current_frame.duration_us = now_us - m_current_frame.begin_us;
+
+            // the frame with serial s is kept at (s - 1) % m_frame_history_count
+            if (m_frames.size() < m_frame_history_count)
+            {
+                m_frames.push_back(std::move(m_current_frame));
+            }
+            else
+            {
+                m_frames[(m_current_frame.frame_serial - 1) % m_frame_history_count] = std::move(m_current_frame);
+            }
+        }
+
+        ++m_frame_serial;
+        m_current_frame              = {};
+        m_current_frame.frame_serial = m_frame_serial;
+        m_current_frame.begin_us     = now_us;
+    }
+
+    uint64_t ProfilerSystem::getFrameSerial() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_frame_serial;
+    }
+
+    uint64_t ProfilerSystem::getTimeUs() const
+    {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(steady_clock::now() - m_start_time_point).count();
+    }
+
+    void ProfilerSystem::addCPUEvent(const char* name, uint64_t begin_us, uint64_t end_us)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ProfilerEvent event;
+        event.name         = name;
+        event.begin_us     = begin_us;
+        event.duration_us  = end_us - begin_us;
+        event.thread_index = getThreadIndex();
+        m_current_frame.cpu_events.push_back(event);
+    }
+
+    void ProfilerSystem::addGPUEvents(uint64_t frame_serial, std::vector<ProfilerEvent>&& events)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ProfilerFrame* frame = nullptr;
+        if (frame_serial == m_current_frame.frame_serial)
+        {
+            frame = &m_current_frame;
+        }
+        else if (frame_serial > 0 && frame_serial < m_frame_serial)
+        {
+            ProfilerFrame& history_frame = m_frames[(frame_serial - 1) % m_frame_history_count];
+            if (history_frame.frame_serial == frame_serial)
+            {
+                frame = &history_frame;
+            }
+        }
+        if (!frame || events.empty())
+        {
+            return;
+        }
+
+        // shift the gpu clock onto the cpu one
+        const uint64_t gpu_begin_us =
+            std::min_element(events.begin(), events.end(), [](const ProfilerEvent& lhs, const ProfilerEvent& rhs) {
+                return lhs.begin_us < rhs.begin_us;
+            })->begin_us;
+        for (ProfilerEvent& event : events)
+        {
+            event.begin_us = event.begin_us - gpu_begin_us + frame->begin_us;
+        }
+        frame->gpu_events = std::move(events);
+    }
+
+    bool ProfilerSystem::dumpChromeTrace(const std::string& file_path) const
+    {
+        static constexpr int s_cpu_process_id = 0;
+        static constexpr int s_gpu_process_id = 1;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        PJson::array trace_events;
+        trace_events.push_back(PJson::object {{"name", "process_name"},
+                                              {"ph", "M"},
+                                              {"pid", s_cpu_process_id},
+                                              {"args", PJson::object {{"name", "CPU"}}}});
+        trace_events.push_back(PJson::object {{"name", "process_name"},
+                                              {"ph", "M"},
+                                              {"pid", s_gpu_process_id},
+                                              {"args", PJson::object {{"name", "GPU"}}}});
+
+        auto add_event = [&trace_events](const char* name, uint64_t begin_us, uint64_t duration_us, int pid, int tid) {
+            trace_events.push_back(PJson::object {{"name", name},
+                                                  {"ph", "X"},
+                                                  {"ts", static_cast<double>(begin_us)},
+                                                  {"dur", static_cast<double>(duration_us)},
+                                                  {"pid", pid},
+                                                  {"tid", tid}});
+        };
+
+        // oldest frame first
+        const size_t first_frame_index =
+            m_frames.size() < m_frame_history_count ? 0 : (m_frame_serial - 1) % m_frame_history_count;
+        for (size_t i = 0; i < m_frames.size(); ++i)
+        {
+            const ProfilerFrame& frame = m_frames[(first_frame_index + i) % m_frames.size()];
+
+            const std::string frame_name = "Frame " + std::to_string(frame.frame_serial);
+            trace_events.push_back(PJson::object {{"name", frame_name},
+                                                  {"ph", "X"},
+                                                  {"ts", static_cast<double>(frame.begin_us)},
+                                                  {"dur", static_cast<double>(frame.duration_us)},
+                                                  {"pid", s_cpu_process_id},
+                                                  {"tid", 0}});
+
+            for (const ProfilerEvent& event : frame.cpu_events)
+            {
+                add_event(event.name, event.begin_us, event.duration_us, s_cpu_process_id, event.thread_index);
+            }
+            for (const ProfilerEvent& event : frame.gpu_events)
+            {
+                add_event(event.name, event.begin_us, event.duration_us, s_gpu_process_id, 0);
+            }
+        }
+
+        std::ofstream file(file_path, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        file << PJson(PJson::object {{"traceEvents", trace_events}, {"displayTimeUnit", "ms"}}).dump();
+        return file.good();
+    }
+
+    uint32_t ProfilerSystem::getThreadIndex()
+    {
+        const auto iter = m_thread_indices.find(std::this_thread::get_id());
+        if (iter != m_thread_indices.end())
+        {
+            return iter->second;
+        }
+        const uint32_t thread_index = static_cast<uint32_t>(m_thread_indices.size());
+        m_thread_indices.emplace(std::this_thread::get_id(), thread_index);
+        return thread_index;
+    }
+} // namespace Piccolo
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    // a named span of time, in microseconds since the start of the profiler
+    struct ProfilerEvent
+    {
+        const char* name {nullptr};
+        uint64_t    begin_us {0};
+        uint64_t    duration_us {0};
+        uint32_t    thread_index {0};
+    };
+
+    struct ProfilerFrame
+    {
+        uint64_t                   frame_serial {0};
+        uint64_t                   begin_us {0};
+        uint64_t                   duration_us {0};
+        std::vector<ProfilerEvent> cpu_events;
+        // the gpu clock can not be correlated with the cpu one, so the events of a frame are shifted to start
+        // where the recording of the frame started
+        std::vector<ProfilerEvent> gpu_events;
+    };
+
+    // keeps the cpu scopes and the gpu passes of the last frames, which can be dumped to a chrome trace
+    // (chrome://tracing or ui.perfetto.dev) at any time.
+    // the event names must outlive the profiler, string literals are expected
+    class ProfilerSystem final
+    {
+    public:
+        static constexpr uint32_t s_default_frame_history_count {300};
+
+        explicit ProfilerSystem(uint32_t frame_history_count = s_default_frame_history_count);
+
+        // closes the current frame into the history and opens the next one
+        void beginFrame();
+
+        uint64_t getFrameSerial() const;
+        uint64_t getTimeUs() const;
+
+        // thread safe
+        void addCPUEvent(const char* name, uint64_t begin_us, uint64_t end_us);
+
+        // the gpu results of a frame arrive frames in flight later, they are dropped once the frame has left the
+        // history
+        void addGPUEvents(uint64_t frame_serial, std::vector<ProfilerEvent>&& events);
+
+        bool dumpChromeTrace(const std::string& file_path) const;
+
+    private:
+        uint32_t getThreadIndex();
+
+        const std::chrono::steady_clock::time_point m_start_time_point;
+
+        mutable std::mutex         m_mutex;
+        std::vector<ProfilerFrame> m_frames;
+        uint32_t                   m_frame_history_count;
+        uint64_t                   m_frame_serial {0};
+        ProfilerFrame              m_current_frame;
+
+        std::unordered_map<std::thread::id, uint32_t> m_thread_indices;
+    };
+
+    // records the lifetime of the scope as a cpu event
+    class ProfilerScope final
+    {
+    public:
+        ProfilerScope(ProfilerSystem* profiler, const char* name) : m_profiler(profiler), m_name(name)
+        {
+            if (m_profiler)
+            {
+                m_begin_us = m_profiler->getTimeUs();
+            }
+        }
+
+        ~ProfilerScope()
+        {
+            if (m_profiler)
+            {
+                m_profiler->addCPUEvent(m_name, m_begin_us, m_profiler->getTimeUs());
+            }
+        }
+
+        ProfilerScope(const ProfilerScope&) = delete;
+        ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+    private:
+        ProfilerSystem* m_profiler;
+        const char*     m_name;
+        uint64_t        m_begin_us {0};
+    };
+} // namespace Piccolo
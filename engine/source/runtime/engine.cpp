@@ -17,10 +17,17 @@ namespace Piccolo
     std::unordered_set<std::string> g_editor_tick_component_types {};
 
     void PiccoloEngine::startEngine(const std::string& config_file_path)
+    {
+        EngineInitParams init_params;
+        init_params.config_file_path = config_file_path;
+        startEngine(init_params);
+    }
+
+    void PiccoloEngine::startEngine(const EngineInitParams& init_params)
     {
         Reflection::TypeMetaRegister::Register();
 
-        g_runtime_global_context.startSystems(config_file_path);
+        g_runtime_global_context.startSystems(init_params);
 
         LOG_INFO("engine start");
     }
@@ -66,6 +73,9 @@ namespace Piccolo
 
     bool PiccoloEngine::tickOneFrame(float delta_time)
     {
+        g_runtime_global_context.m_profiler_system->beginFrame();
+        PROFILE_SCOPE("Engine::tickOneFrame");
+
         logicalTick(delta_time);
         calculateFPS(delta_time);
 
@@ -91,12 +101,16 @@ namespace Piccolo
 
     void PiccoloEngine::logicalTick(float delta_time)
     {
+        PROFILE_SCOPE("Engine::logicalTick");
+
         g_runtime_global_context.m_world_manager->tick(delta_time);
         g_runtime_global_context.m_input_system->tick();
     }
 
     bool PiccoloEngine::rendererTick()
     {
+        PROFILE_SCOPE("Engine::rendererTick");
+
         g_runtime_global_context.m_render_system->tick();
         return true;
     }
@@ -11,6 +11,15 @@ namespace Piccolo
     extern bool                            g_is_editor_mode;
     extern std::unordered_set<std::string> g_editor_tick_component_types;
 
+    struct EngineInitParams
+    {
+        std::filesystem::path config_file_path;
+        // renders into offscreen images, without a window or a surface
+        bool is_headless {false};
+        int  window_width {1280};
+        int  window_height {720};
+    };
+
     class PiccoloEngine
     {
         friend class PiccoloEditor;
@@ -19,6 +28,7 @@ namespace Piccolo
 
     public:
         void startEngine(const std::string& config_file_path);
+        void startEngine(const EngineInitParams& init_params);
         void shutdownEngine();
 
         void initialize();
@@ -122,38 +122,70 @@ namespace Piccolo
 
         if (transform_component->isDirty())
         {
-            std::vector<GameObjectPartDesc> dirty_mesh_parts;
-            SkeletonAnimationResult         animation_result;
-            animation_result.m_transforms.push_back({Matrix4x4::IDENTITY});
-            if (animation_component != nullptr)
+            RenderSwapContext& render_swap_context = g_runtime_global_context.m_render_system->getSwapContext();
+            RenderSwapData&    logic_swap_data     = render_swap_context.getLogicSwapData();
+
+            GObjectID go_id = m_parent_object.lock()->getID();
+
+            if (m_is_render_desc_sent)
             {
-                for (auto& node : animation_component->getResult().node)
+                // the parts are already in the render scene, only send the transform and the pose
+                std::vector<Matrix4x4> joint_matrices;
+                if (animation_component != nullptr)
+                {
+                    joint_matrices.reserve(animation_component->getResult().node.size() + 1);
+                    joint_matrices.push_back(Matrix4x4::IDENTITY);
+                    for (auto& node : animation_component->getResult().node)
+                    {
+                        joint_matrices.push_back(Matrix4x4(node.transform));
+                    }
+                }
+
+                for (size_t part_index = 0; part_index < m_raw_meshes.size(); ++part_index)
                 {
-                    animation_result.m_transforms.push_back({Matrix4x4(node.transform)});
+                    GameObjectPartTransformDesc transform_desc;
+                    transform_desc.m_part_id = {go_id, part_index};
+                    transform_desc.m_transform_matrix =
+                        transform_component->getMatrix() * m_raw_meshes[part_index].m_transform_desc.m_transform_matrix;
+                    transform_desc.m_joint_matrices = joint_matrices;
+
+                    logic_swap_data.updateGameObjectTransform(std::move(transform_desc));
                 }
             }
-            for (GameObjectPartDesc& mesh_part : m_raw_meshes)
+            else
             {
-                if (animation_component)
+                std::vector<GameObjectPartDesc> dirty_mesh_parts;
+                SkeletonAnimationResult         animation_result;
+                animation_result.m_transforms.push_back({Matrix4x4::IDENTITY});
+                if (animation_component != nullptr)
+                {
+                    for (auto& node : animation_component->getResult().node)
+                    {
+                        animation_result.m_transforms.push_back({Matrix4x4(node.transform)});
+                    }
+                }
+                for (GameObjectPartDesc& mesh_part : m_raw_meshes)
                 {
-                    mesh_part.m_with_animation                                = true;
-                    mesh_part.m_skeleton_animation_result                     = animation_result;
-                    mesh_part.m_skeleton_binding_desc.m_skeleton_binding_file = mesh_part.m_mesh_desc.m_mesh_file;
+                    if (animation_component)
+                    {
+                        mesh_part.m_with_animation                                = true;
+                        mesh_part.m_skeleton_animation_result                     = animation_result;
+                        mesh_part.m_skeleton_binding_desc.m_skeleton_binding_file = mesh_part.m_mesh_desc.m_mesh_file;
+                    }
+                    Matrix4x4 object_transform_matrix = mesh_part.m_transform_desc.m_transform_matrix;
+
+                    mesh_part.m_transform_desc.m_transform_matrix =
+                        transform_component->getMatrix() * object_transform_matrix;
+                    dirty_mesh_parts.push_back(mesh_part);
+
+                    mesh_part.m_transform_desc.m_transform_matrix = object_transform_matrix;
                 }
-                Matrix4x4 object_transform_matrix = mesh_part.m_transform_desc.m_transform_matrix;
 
-                mesh_part.m_transform_desc.m_transform_matrix =
-                    transform_component->getMatrix() * object_transform_matrix;
-                dirty_mesh_parts.push_back(mesh_part);
+                logic_swap_data.addDirtyGameObject(GameObjectDesc {go_id, dirty_mesh_parts});
 
-                mesh_part.m_transform_desc.m_transform_matrix = object_transform_matrix;
+                m_is_render_desc_sent = true;
             }
 
-            RenderSwapContext& render_swap_context = g_runtime_global_context.m_render_system->getSwapContext();
-            RenderSwapData&    logic_swap_data     = render_swap_context.getLogicSwapData();
-
-            logic_swap_data.addDirtyGameObject(GameObjectDesc {m_parent_object.lock()->getID(), dirty_mesh_parts});
-
             transform_component->setDirtyFlag(false);
         }
     }
@@ -30,5 +30,8 @@ namespace Piccolo
         MeshComponentRes m_mesh_res;
 
         std::vector<GameObjectPartDesc> m_raw_meshes;
+
+        // the full part descs are only sent once, later changes go through the transform channel
+        bool m_is_render_desc_sent {false};
     };
 } // namespace Piccolo
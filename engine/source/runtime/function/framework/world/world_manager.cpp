@@ -39,6 +39,8 @@ namespace Piccolo
 
     void WorldManager::tick(float delta_time)
     {
+        PROFILE_SCOPE("WorldManager::tick");
+
         if (!m_is_world_loaded)
         {
             loadWorld(m_current_world_url);
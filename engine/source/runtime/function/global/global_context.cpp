@@ -1,6 +1,7 @@
 #include "runtime/function/global/global_context.h"
 
 #include "core/log/log_system.h"
+#include "core/profiler/profiler_system.h"
 
 #include "runtime/engine.h"
 
@@ -22,15 +23,17 @@ namespace Piccolo
 {
     RuntimeGlobalContext g_runtime_global_context;
 
-    void RuntimeGlobalContext::startSystems(const std::string& config_file_path)
+    void RuntimeGlobalContext::startSystems(const EngineInitParams& init_params)
     {
         m_config_manager = std::make_shared<ConfigManager>();
-        m_config_manager->initialize(config_file_path);
+        m_config_manager->initialize(init_params.config_file_path);
 
         m_file_system = std::make_shared<FileSystem>();
 
         m_logger_system = std::make_shared<LogSystem>();
 
+        m_profiler_system = std::make_shared<ProfilerSystem>();
+
         m_asset_manager = std::make_shared<AssetManager>();
 
         m_legacy_physics_system = std::make_shared<PhysicsSystem>();
@@ -43,6 +46,9 @@ namespace Piccolo
 
         m_window_system = std::make_shared<WindowSystem>();
         WindowCreateInfo window_create_info;
+        window_create_info.width       = init_params.window_width;
+        window_create_info.height      = init_params.window_height;
+        window_create_info.is_headless = init_params.is_headless;
         m_window_system->initialize(window_create_info);
 
         m_input_system = std::make_shared<InputSystem>();
@@ -77,6 +83,8 @@ namespace Piccolo
         m_asset_manager.reset();
 
 
+        m_profiler_system.reset();
+
         m_logger_system.reset();
 
         m_file_system.reset();
@@ -6,6 +6,7 @@
 namespace Piccolo
 {
     class LogSystem;
+    class ProfilerSystem;
     class InputSystem;
     class PhysicsSystem;
     class PhysicsManager;
@@ -24,12 +25,13 @@ namespace Piccolo
     {
     public:
         // create all global systems and initialize these systems
-        void startSystems(const std::string& config_file_path);
+        void startSystems(const EngineInitParams& init_params);
         // destroy all global systems
         void shutdownSystems();
 
     public:
         std::shared_ptr<LogSystem>       m_logger_system;
+        std::shared_ptr<ProfilerSystem>  m_profiler_system;
         std::shared_ptr<InputSystem>     m_input_system;
         std::shared_ptr<FileSystem>      m_file_system;
         std::shared_ptr<AssetManager>    m_asset_manager;
@@ -177,6 +177,8 @@ namespace Piccolo
 
     void PhysicsScene::tick(float delta_time)
     {
+        PROFILE_SCOPE("PhysicsScene::tick");
+
         const float time_step = 1.f / m_config.m_update_frequency;
 
         m_physics.m_jolt_physics_system->Update(time_step,
@@ -132,7 +132,7 @@ namespace Piccolo
         computePipelineCreateInfo.stage = shaderStage;
         if (VK_SUCCESS !=
             vkCreateComputePipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &computePipelineCreateInfo, nullptr,  &m_render_pipelines[0].pipeline))
+                m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &computePipelineCreateInfo, nullptr,  &m_render_pipelines[0].pipeline))
         {
             throw std::runtime_error("create particle kickoff pipe");
         }
@@ -190,6 +190,12 @@ namespace Piccolo
                               VK_IMAGE_LAYOUT_GENERAL);
 
 
+        // the bright color only covers the scene region, the blur must neither read nor write past it
+        m_blur_pass_push_constant_object.scene_extent_x = static_cast<int>(m_vulkan_rhi->m_scene_extent.width);
+        m_blur_pass_push_constant_object.scene_extent_y = static_cast<int>(m_vulkan_rhi->m_scene_extent.height);
+        uint32_t group_count_x = (m_vulkan_rhi->m_scene_extent.width + 15) / 16;
+        uint32_t group_count_y = (m_vulkan_rhi->m_scene_extent.height + 15) / 16;
+
         for (size_t i = 0; i < m_blur_times; ++i) {
 
             if (m_vulkan_rhi->isDebugLabelEnabled())
@@ -214,10 +220,7 @@ namespace Piccolo
                                     &m_descriptor_infos[0].descriptor_set,
                                     0,
                                     0);
-            vkCmdDispatch(m_compute_command_buffer,
-                          m_vulkan_rhi->m_swapchain_extent.width / 16,
-                          m_vulkan_rhi->m_swapchain_extent.height / 16,
-                          1);
+            vkCmdDispatch(m_compute_command_buffer, group_count_x, group_count_y, 1);
 
             transitionImageLayout(m_input_attachment_image, 
                                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 
@@ -253,10 +256,7 @@ namespace Piccolo
                                     &m_descriptor_infos[1].descriptor_set,
                                     0,
                                     0);
-            vkCmdDispatch(m_compute_command_buffer,
-                          m_vulkan_rhi->m_swapchain_extent.width / 16,
-                          m_vulkan_rhi->m_swapchain_extent.height / 16, 
-                          1);
+            vkCmdDispatch(m_compute_command_buffer, group_count_x, group_count_y, 1);
 
             transitionImageLayout(m_input_attachment_image, 
                                   VK_IMAGE_LAYOUT_GENERAL, 
@@ -14,6 +14,8 @@ namespace Piccolo
     {
         std::pair<int, int> direction;
         int                 blur_kernal_size;
+        int                 scene_extent_x;
+        int                 scene_extent_y;
     };
 
     class BlurPass : public RenderPass
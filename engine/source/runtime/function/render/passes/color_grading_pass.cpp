@@ -205,7 +205,7 @@ namespace Piccolo
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
         if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
+                m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
             VK_SUCCESS)
         {
             throw std::runtime_error("create post process graphics pipeline");
@@ -9,6 +9,7 @@ namespace Piccolo
         VkRenderPass render_pass;
         VkImageView  scene_input_attachment;
         VkImageView  ui_input_attachment;
+        uint32_t     subpass {_post_process_subpass_combine_ui};
     };
 
     class CombineUIPass : public RenderPass
@@ -23,5 +24,8 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
+
+    private:
+        uint32_t m_subpass {_post_process_subpass_combine_ui};
     };
 } // namespace Piccolo
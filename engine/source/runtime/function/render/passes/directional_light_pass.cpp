@@ -31,11 +31,17 @@ namespace Piccolo
         const RenderResource* vulkan_resource = static_cast<const RenderResource*>(render_resource.get());
         if (vulkan_resource)
         {
-            m_mesh_directional_light_shadow_perframe_storage_buffer_object =
-                vulkan_resource->m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+            m_directional_light_cascades =
+                vulkan_resource->m_mesh_perframe_storage_buffer_object.directional_light_cascades;
         }
     }
-    void DirectionalLightShadowPass::draw() { drawModel(); }
+    void DirectionalLightShadowPass::draw()
+    {
+        beginRenderPass(m_vulkan_rhi->m_current_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+        recordRenderPass(m_vulkan_rhi->m_current_command_buffer);
+        endRenderPass(m_vulkan_rhi->m_current_command_buffer);
+    }
+
     void DirectionalLightShadowPass::setupAttachments()
     {
         // color and depth
@@ -94,11 +100,11 @@ namespace Piccolo
         VkAttachmentDescription& directional_light_shadow_color_attachment_description = attachments[0];
         directional_light_shadow_color_attachment_description.format         = m_framebuffer.attachments[0].format;
         directional_light_shadow_color_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
-        directional_light_shadow_color_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        directional_light_shadow_color_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_LOAD;
         directional_light_shadow_color_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
         directional_light_shadow_color_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         directional_light_shadow_color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        directional_light_shadow_color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+        directional_light_shadow_color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         directional_light_shadow_color_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         VkAttachmentDescription& directional_light_shadow_depth_attachment_description = attachments[1];
@@ -130,9 +136,20 @@ namespace Piccolo
         shadow_pass.pColorAttachments       = &shadow_pass_color_attachment_reference;
         shadow_pass.pDepthStencilAttachment = &shadow_pass_depth_attachment_reference;
 
-        VkSubpassDependency dependencies[1] = {};
+        VkSubpassDependency dependencies[2] = {};
+
+        // the cached cascades are loaded, after the lighting of the previous frame read them
+        VkSubpassDependency& previous_lighting_pass_dependency = dependencies[0];
+        previous_lighting_pass_dependency.srcSubpass           = VK_SUBPASS_EXTERNAL;
+        previous_lighting_pass_dependency.dstSubpass           = 0;
+        previous_lighting_pass_dependency.srcStageMask         = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        previous_lighting_pass_dependency.dstStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        previous_lighting_pass_dependency.srcAccessMask        = 0;
+        previous_lighting_pass_dependency.dstAccessMask =
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        previous_lighting_pass_dependency.dependencyFlags = 0;
 
-        VkSubpassDependency& lighting_pass_dependency = dependencies[0];
+        VkSubpassDependency& lighting_pass_dependency = dependencies[1];
         lighting_pass_dependency.srcSubpass           = 0;
         lighting_pass_dependency.dstSubpass           = VK_SUBPASS_EXTERNAL;
         lighting_pass_dependency.srcStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -340,10 +357,12 @@ namespace Piccolo
         depth_stencil_create_info.depthBoundsTestEnable = VK_FALSE;
         depth_stencil_create_info.stencilTestEnable     = VK_FALSE;
 
+        // every cascade is drawn into its own tile of the atlas
+        VkDynamicState                   dynamic_states[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
         VkPipelineDynamicStateCreateInfo dynamic_state_create_info {};
         dynamic_state_create_info.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamic_state_create_info.dynamicStateCount = 0;
-        dynamic_state_create_info.pDynamicStates    = NULL;
+        dynamic_state_create_info.dynamicStateCount = (sizeof(dynamic_states) / sizeof(dynamic_states[0]));
+        dynamic_state_create_info.pDynamicStates    = dynamic_states;
 
         VkGraphicsPipelineCreateInfo pipelineInfo {};
         pipelineInfo.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -363,7 +382,7 @@ namespace Piccolo
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
         if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
+                m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
             VK_SUCCESS)
         {
             throw std::runtime_error("create mesh directional light shadow graphics pipeline");
@@ -468,63 +487,66 @@ namespace Piccolo
                                0,
                                NULL);
     }
-    void DirectionalLightShadowPass::drawModel()
+    void DirectionalLightShadowPass::beginRenderPass(VkCommandBuffer command_buffer, VkSubpassContents contents)
     {
-        struct MeshNode
+        if (!m_atlas_layout_initialized)
         {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
-
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>>
-            directional_light_mesh_drawcall_batch;
+            VkImageMemoryBarrier undefined_to_shader_read_barrier {};
+            undefined_to_shader_read_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            undefined_to_shader_read_barrier.pNext               = nullptr;
+            undefined_to_shader_read_barrier.srcAccessMask       = 0;
+            undefined_to_shader_read_barrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
+            undefined_to_shader_read_barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+            undefined_to_shader_read_barrier.newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            undefined_to_shader_read_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            undefined_to_shader_read_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            undefined_to_shader_read_barrier.image               = m_framebuffer.attachments[0].image;
+            undefined_to_shader_read_barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            vkCmdPipelineBarrier(command_buffer,
+                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                 0,
+                                 0,
+                                 nullptr,
+                                 0,
+                                 nullptr,
+                                 1,
+                                 &undefined_to_shader_read_barrier);
+            m_atlas_layout_initialized = true;
+        }
 
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_directional_light_visible_mesh_nodes))
-        {
-            auto& mesh_instanced = directional_light_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
+        VkRenderPassBeginInfo renderpass_begin_info {};
+        renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
+        renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
+        renderpass_begin_info.renderArea.offset = {0, 0};
+        renderpass_begin_info.renderArea.extent = {s_directional_light_shadow_map_dimension,
+                                                   s_directional_light_shadow_map_dimension};
 
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
+        // the color is loaded, only the tiles of the cascades rendered this frame are cleared
+        VkClearValue clear_values[2];
+        clear_values[0].color                 = {1.0f};
+        clear_values[1].depthStencil          = {1.0f, 0};
+        renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
+        renderpass_begin_info.pClearValues    = clear_values;
 
-            mesh_nodes.push_back(temp);
-        }
+        m_vulkan_rhi->m_vk_cmd_begin_render_pass(command_buffer, &renderpass_begin_info, contents);
 
-        // Directional Light Shadow begin pass
+        if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            VkRenderPassBeginInfo renderpass_begin_info {};
-            renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
-            renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
-            renderpass_begin_info.renderArea.offset = {0, 0};
-            renderpass_begin_info.renderArea.extent = {s_directional_light_shadow_map_dimension,
-                                                       s_directional_light_shadow_map_dimension};
-
-            VkClearValue clear_values[2];
-            clear_values[0].color                 = {1.0f};
-            clear_values[1].depthStencil          = {1.0f, 0};
-            renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
-            renderpass_begin_info.pClearValues    = clear_values;
-
-            m_vulkan_rhi->m_vk_cmd_begin_render_pass(
-                m_vulkan_rhi->m_current_command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
-
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
-                                                   NULL,
-                                                   "Directional Light Shadow",
-                                                   {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
-            }
+            VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+                                               NULL,
+                                               "Directional Light Shadow",
+                                               {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
         }
+    }
+
+    void DirectionalLightShadowPass::recordRenderPass(VkCommandBuffer command_buffer)
+    {
+        uint32_t render_mask    = *m_visiable_nodes.p_directional_light_cascade_render_mask;
+        uint32_t grid_size      = getDirectionalLightCascadeGridSize(m_directional_light_cascades.cascade_count);
+        uint32_t tile_dimension = s_directional_light_shadow_map_dimension / grid_size;
 
         // Mesh
         if (m_vulkan_rhi->isPointLightShadowEnabled())
@@ -533,201 +555,189 @@ namespace Piccolo
             {
                 VkDebugUtilsLabelEXT label_info = {
                     VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
             }
 
-            m_vulkan_rhi->m_vk_cmd_bind_pipeline(m_vulkan_rhi->m_current_command_buffer,
+            m_vulkan_rhi->m_vk_cmd_bind_pipeline(command_buffer,
                                                  VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                  m_render_pipelines[0].pipeline);
 
-            // perframe storage buffer
-            uint32_t perframe_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-            MeshDirectionalLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
-                (*reinterpret_cast<MeshDirectionalLightShadowPerframeStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perframe_dynamic_offset));
-            perframe_storage_buffer_object = m_mesh_directional_light_shadow_perframe_storage_buffer_object;
-
-            for (auto& [material, mesh_instanced] : directional_light_mesh_drawcall_batch)
+            for (uint32_t cascade_index = 0; cascade_index < m_directional_light_cascades.cascade_count;
+                 ++cascade_index)
+            {
+                if (!(render_mask & (1U << cascade_index)))
+                {
+                    continue;
+                }
+
+                VkRect2D tile = {{static_cast<int32_t>((cascade_index % grid_size) * tile_dimension),
+                                  static_cast<int32_t>((cascade_index / grid_size) * tile_dimension)},
+                                 {tile_dimension, tile_dimension}};
+                VkViewport viewport = {static_cast<float>(tile.offset.x),
+                                       static_cast<float>(tile.offset.y),
+                                       static_cast<float>(tile_dimension),
+                                       static_cast<float>(tile_dimension),
+                                       0.0f,
+                                       1.0f};
+                m_vulkan_rhi->m_vk_cmd_set_viewport(command_buffer, 0, 1, &viewport);
+                m_vulkan_rhi->m_vk_cmd_set_scissor(command_buffer, 0, 1, &tile);
+
+                VkClearAttachment clear_attachment {};
+                clear_attachment.aspectMask       = VK_IMAGE_ASPECT_COLOR_BIT;
+                clear_attachment.colorAttachment  = 0;
+                clear_attachment.clearValue.color = {1.0f};
+                VkClearRect clear_rect            = {tile, 0, 1};
+                m_vulkan_rhi->m_vk_cmd_clear_attachments(command_buffer, 1, &clear_attachment, 1, &clear_rect);
+
+                // perframe storage buffer
+                auto perframe_allocation = allocateUpload<MeshDirectionalLightShadowPerframeStorageBufferObject>();
+                perframe_allocation.data->light_proj_view = m_directional_light_cascades.proj_views[cascade_index];
+
+                drawCascade(command_buffer,
+                            m_visiable_nodes.p_directional_light_cascade_draw_lists[cascade_index],
+                            perframe_allocation.dynamic_offset);
+            }
+            *m_visiable_nodes.p_directional_light_cached_cascade_valid_mask |= render_mask;
+
+            if (m_vulkan_rhi->isDebugLabelEnabled())
             {
-                // TODO: render from near to far
+                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
+            }
+        }
+    }
+
+    void DirectionalLightShadowPass::drawCascade(VkCommandBuffer       command_buffer,
+                                                 const RenderDrawList& draw_list,
+                                                 uint32_t              perframe_dynamic_offset)
+    {
+        for (const RenderDrawBatch& batch : draw_list.getBatches())
+        {
+            VulkanMesh*           mesh       = batch.m_mesh;
+            const RenderMeshNode* mesh_nodes = draw_list.getBatchNodes(batch);
 
-                for (auto& [mesh, mesh_nodes] : mesh_instanced)
+            uint32_t total_instance_count = batch.m_node_count;
+            if (total_instance_count > 0)
+            {
+                // bind per mesh
+                m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                                                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                            m_render_pipelines[0].layout,
+                                                            1,
+                                                            1,
+                                                            &mesh->mesh_vertex_blending_descriptor_set,
+                                                            0,
+                                                            NULL);
+
+                VkBuffer     vertex_buffers[] = {mesh->mesh_vertex_position_buffer};
+                VkDeviceSize offsets[]        = {0};
+                m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(command_buffer, 0, 1, vertex_buffers, offsets);
+                m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                    command_buffer, mesh->mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
                 {
-                    uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                    if (total_instance_count > 0)
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // perdrawcall storage buffer
+                    auto perdrawcall_allocation =
+                        allocateUpload<MeshDirectionalLightShadowPerdrawcallStorageBufferObject>();
+                    uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                    MeshDirectionalLightShadowPerdrawcallStorageBufferObject&
+                        perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
                     {
-                        // bind per mesh
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
-                                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                                    m_render_pipelines[0].layout,
-                                                                    1,
-                                                                    1,
-                                                                    &mesh->mesh_vertex_blending_descriptor_set,
-                                                                    0,
-                                                                    NULL);
-
-                        VkBuffer     vertex_buffers[] = {mesh->mesh_vertex_position_buffer};
-                        VkDeviceSize offsets[]        = {0};
-                        m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
-                            m_vulkan_rhi->m_current_command_buffer, 0, 1, vertex_buffers, offsets);
-                        m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                            m_vulkan_rhi->m_current_command_buffer, mesh->mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
-
-                        uint32_t drawcall_max_instance_count =
-                            (sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
-                             sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
-                        uint32_t drawcall_count =
-                            roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                        for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
-                        {
-                            uint32_t current_instance_count =
-                                ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                                 drawcall_max_instance_count) ?
-                                    (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                    drawcall_max_instance_count;
-
-                            // perdrawcall storage buffer
-                            uint32_t perdrawcall_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                perdrawcall_dynamic_offset +
-                                sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                            MeshDirectionalLightShadowPerdrawcallStorageBufferObject&
-                                perdrawcall_storage_buffer_object =
-                                    (*reinterpret_cast<MeshDirectionalLightShadowPerdrawcallStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        perdrawcall_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                    *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                                perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                                  -1.0;
-                            }
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]) ?
+                                1.0 :
+                                -1.0;
+                    }
 
-                            // per drawcall vertex blending storage buffer
-                            uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                            bool     least_one_enable_vertex_blending = true;
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    least_one_enable_vertex_blending = false;
-                                    break;
-                                }
-                            }
-                            if (least_one_enable_vertex_blending)
+                    // per drawcall vertex blending storage buffer
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset;
+                    bool     least_one_enable_vertex_blending = true;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        if (!isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
+                        {
+                            least_one_enable_vertex_blending = false;
+                            break;
+                        }
+                    }
+                    if (least_one_enable_vertex_blending)
+                    {
+                        auto per_drawcall_vertex_blending_allocation = allocateUpload<
+                            MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject>();
+                        per_drawcall_vertex_blending_dynamic_offset =
+                            per_drawcall_vertex_blending_allocation.dynamic_offset;
+
+                        MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject&
+                            per_drawcall_vertex_blending_storage_buffer_object =
+                                *per_drawcall_vertex_blending_allocation.data;
+                        for (uint32_t i = 0; i < current_instance_count; ++i)
+                        {
+                            if (isShaderVertexBlending(
+                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                             {
-                                per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                    per_drawcall_vertex_blending_dynamic_offset +
-                                    sizeof(MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                                assert(m_global_render_resource->_storage_buffer
-                                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                       (m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                        m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                                MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject&
-                                    per_drawcall_vertex_blending_storage_buffer_object =
-                                        (*reinterpret_cast<
-                                            MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject*>(
-                                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                            ._global_upload_ringbuffer_memory_pointer) +
-                                            per_drawcall_vertex_blending_dynamic_offset));
-                                for (uint32_t i = 0; i < current_instance_count; ++i)
+                                for (uint32_t j = 0;
+                                     j <
+                                     mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
+                                     ++j)
                                 {
-                                    if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                    {
-                                        for (uint32_t j = 0;
-                                             j <
-                                             mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                             ++j)
-                                        {
-                                            per_drawcall_vertex_blending_storage_buffer_object
-                                                .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                    .joint_matrices[j];
-                                        }
-                                    }
+                                    per_drawcall_vertex_blending_storage_buffer_object
+                                        .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
+                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
+                                            .joint_matrices[j];
                                 }
                             }
-                            else
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = 0;
-                            }
-
-                            // bind perdrawcall
-                            uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                           perdrawcall_dynamic_offset,
-                                                           per_drawcall_vertex_blending_dynamic_offset};
-                            m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                                m_vulkan_rhi->m_current_command_buffer,
-                                VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                m_render_pipelines[0].layout,
-                                0,
-                                1,
-                                &m_descriptor_infos[0].descriptor_set,
-                                (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
-                                dynamic_offsets);
-                            m_vulkan_rhi->m_vk_cmd_draw_indexed(m_vulkan_rhi->m_current_command_buffer,
-                                                                mesh->mesh_index_count,
-                                                                current_instance_count,
-                                                                0,
-                                                                0,
-                                                                0);
                         }
                     }
-                }
-            }
+                    else
+                    {
+                        per_drawcall_vertex_blending_dynamic_offset = 0;
+                    }
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset};
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        m_render_pipelines[0].layout,
+                        0,
+                        1,
+                        &m_descriptor_infos[0].descriptor_set,
+                        (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                        dynamic_offsets);
+                    drawMeshInstances(command_buffer,
+                                      *mesh,
+                                      mesh_nodes + drawcall_max_instance_count * drawcall_index,
+                                      current_instance_count,
+                                      1);
+                }
             }
         }
+    }
 
-        // Directional Light Shadow end pass
+    void DirectionalLightShadowPass::endRenderPass(VkCommandBuffer command_buffer)
+    {
+        if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
-            }
-
-            m_vulkan_rhi->m_vk_cmd_end_render_pass(m_vulkan_rhi->m_current_command_buffer);
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
         }
+
+        m_vulkan_rhi->m_vk_cmd_end_render_pass(command_buffer);
     }
 } // namespace Piccolo
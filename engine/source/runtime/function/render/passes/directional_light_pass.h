@@ -14,6 +14,10 @@ namespace Piccolo
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
         void draw() override final;
 
+        void beginRenderPass(VkCommandBuffer command_buffer, VkSubpassContents contents) override final;
+        void recordRenderPass(VkCommandBuffer command_buffer) override final;
+        void endRenderPass(VkCommandBuffer command_buffer) override final;
+
         void setPerMeshLayout(const VkDescriptorSetLayout& layout) { m_per_mesh_layout = layout; }
 
     private:
@@ -23,11 +27,17 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
-        void drawModel();
+
+        void drawCascade(VkCommandBuffer       command_buffer,
+                         const RenderDrawList& draw_list,
+                         uint32_t              perframe_dynamic_offset);
 
     private:
-        VkDescriptorSetLayout m_per_mesh_layout;
-        MeshDirectionalLightShadowPerframeStorageBufferObject
-            m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+        VkDescriptorSetLayout          m_per_mesh_layout;
+        VulkanDirectionalLightCascades m_directional_light_cascades;
+
+        // the cascades not rendered in a frame keep their tiles of the atlas from the previous frames, so the atlas
+        // is loaded instead of cleared and has to be in the shader read layout from the first frame
+        bool m_atlas_layout_initialized {false};
     };
 } // namespace Piccolo
@@ -10,6 +10,7 @@ namespace Piccolo
     {
         VkRenderPass render_pass;
         VkImageView  input_attachment;
+        uint32_t     subpass {_post_process_subpass_fxaa};
     };
 
     class FXAAPass : public RenderPass
@@ -24,5 +25,8 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
+
+    private:
+        uint32_t m_subpass {_post_process_subpass_fxaa};
     };
 } // namespace Piccolo
@@ -0,0 +1,251 @@
+#include "runtime/function/render/passes/light_clustering_pass.h"
+#include "runtime/function/render/render_resource.h"
+
+#include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_util.h"
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include <light_clustering_comp.h>
+
+namespace Piccolo
+{
+    static const uint32_t s_light_clustering_group_size = 64;
+
+    void LightClusteringPass::initialize(const RenderPassInitInfo* init_info)
+    {
+        RenderPass::initialize(nullptr);
+
+        m_light_clustering_perframe_storage_buffer_object.grid.point_light_num = 0;
+
+        setupDescriptorSetLayout();
+        setupPipelines();
+        setupDescriptorSet();
+    }
+
+    void LightClusteringPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
+    {
+        const RenderResource* vulkan_resource = static_cast<const RenderResource*>(render_resource.get());
+        if (vulkan_resource)
+        {
+            m_light_clustering_perframe_storage_buffer_object =
+                vulkan_resource->m_light_clustering_perframe_storage_buffer_object;
+        }
+    }
+
+    void LightClusteringPass::setupDescriptorSetLayout()
+    {
+        m_descriptor_infos.resize(1);
+
+        VkDescriptorSetLayoutBinding light_clusters_layout_bindings[2] = {};
+
+        VkDescriptorSetLayoutBinding& lights_binding = light_clusters_layout_bindings[0];
+        lights_binding.binding                       = 0;
+        lights_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        lights_binding.descriptorCount               = 1;
+        lights_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        VkDescriptorSetLayoutBinding& clusters_binding = light_clusters_layout_bindings[1];
+        clusters_binding.binding                       = 1;
+        clusters_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        clusters_binding.descriptorCount               = 1;
+        clusters_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        VkDescriptorSetLayoutCreateInfo light_clusters_layout_create_info {};
+        light_clusters_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        light_clusters_layout_create_info.bindingCount =
+            sizeof(light_clusters_layout_bindings) / sizeof(light_clusters_layout_bindings[0]);
+        light_clusters_layout_create_info.pBindings = light_clusters_layout_bindings;
+
+        if (VK_SUCCESS != vkCreateDescriptorSetLayout(m_vulkan_rhi->m_device,
+                                                      &light_clusters_layout_create_info,
+                                                      NULL,
+                                                      &m_descriptor_infos[0].layout))
+        {
+            throw std::runtime_error("create light clustering layout");
+        }
+    }
+
+    void LightClusteringPass::setupPipelines()
+    {
+        m_render_pipelines.resize(1);
+
+        VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
+        pipeline_layout_create_info.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount = 1;
+        pipeline_layout_create_info.pSetLayouts    = &m_descriptor_infos[0].layout;
+
+        if (vkCreatePipelineLayout(
+                m_vulkan_rhi->m_device, &pipeline_layout_create_info, nullptr, &m_render_pipelines[0].layout) !=
+            VK_SUCCESS)
+        {
+            throw std::runtime_error("create light clustering pipeline layout");
+        }
+
+        VkPipelineShaderStageCreateInfo shader_stage_create_info {};
+        shader_stage_create_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shader_stage_create_info.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+        shader_stage_create_info.module = VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, LIGHT_CLUSTERING_COMP);
+        shader_stage_create_info.pName  = "main";
+
+        VkComputePipelineCreateInfo compute_pipeline_create_info {};
+        compute_pipeline_create_info.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        compute_pipeline_create_info.stage  = shader_stage_create_info;
+        compute_pipeline_create_info.layout = m_render_pipelines[0].layout;
+
+        if (vkCreateComputePipelines(m_vulkan_rhi->m_device,
+                                     m_vulkan_rhi->m_pipeline_cache,
+                                     1,
+                                     &compute_pipeline_create_info,
+                                     nullptr,
+                                     &m_render_pipelines[0].pipeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("create light clustering pipeline");
+        }
+
+        vkDestroyShaderModule(m_vulkan_rhi->m_device, shader_stage_create_info.module, nullptr);
+    }
+
+    void LightClusteringPass::setupDescriptorSet()
+    {
+        m_frame_resources.resize(m_vulkan_rhi->s_max_frames_in_flight);
+        for (FrameResource& frame_resource : m_frame_resources)
+        {
+            VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                     m_vulkan_rhi->m_device,
+                                     sizeof(LightClusteringPerframeStorageBufferObject),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                     frame_resource.light_buffer,
+                                     frame_resource.light_buffer_memory);
+            vkMapMemory(m_vulkan_rhi->m_device,
+                        frame_resource.light_buffer_memory,
+                        0,
+                        VK_WHOLE_SIZE,
+                        0,
+                        &frame_resource.light_buffer_memory_pointer);
+
+            // the light counts of the clusters, then the fixed slots of the light indices of every cluster. only
+            // written and read by the gpu
+            VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                     m_vulkan_rhi->m_device,
+                                     sizeof(uint32_t) * s_light_cluster_count *
+                                         (1 + s_light_cluster_max_point_light_count),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                     frame_resource.cluster_buffer,
+                                     frame_resource.cluster_buffer_memory);
+
+            VkDescriptorSetAllocateInfo descriptor_set_alloc_info {};
+            descriptor_set_alloc_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            descriptor_set_alloc_info.descriptorPool     = m_vulkan_rhi->m_descriptor_pool;
+            descriptor_set_alloc_info.descriptorSetCount = 1;
+            descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[0].layout;
+
+            if (VK_SUCCESS != vkAllocateDescriptorSets(
+                                  m_vulkan_rhi->m_device, &descriptor_set_alloc_info, &frame_resource.descriptor_set))
+            {
+                throw std::runtime_error("allocate light clustering descriptor set");
+            }
+
+            VkDescriptorBufferInfo lights_buffer_info {};
+            lights_buffer_info.buffer = frame_resource.light_buffer;
+            lights_buffer_info.offset = 0;
+            lights_buffer_info.range  = VK_WHOLE_SIZE;
+
+            VkDescriptorBufferInfo clusters_buffer_info {};
+            clusters_buffer_info.buffer = frame_resource.cluster_buffer;
+            clusters_buffer_info.offset = 0;
+            clusters_buffer_info.range  = VK_WHOLE_SIZE;
+
+            VkWriteDescriptorSet descriptor_writes[2] = {};
+
+            descriptor_writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[0].dstSet          = frame_resource.descriptor_set;
+            descriptor_writes[0].dstBinding      = 0;
+            descriptor_writes[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptor_writes[0].descriptorCount = 1;
+            descriptor_writes[0].pBufferInfo     = &lights_buffer_info;
+
+            descriptor_writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[1].dstSet          = frame_resource.descriptor_set;
+            descriptor_writes[1].dstBinding      = 1;
+            descriptor_writes[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptor_writes[1].descriptorCount = 1;
+            descriptor_writes[1].pBufferInfo     = &clusters_buffer_info;
+
+            vkUpdateDescriptorSets(m_vulkan_rhi->m_device,
+                                   sizeof(descriptor_writes) / sizeof(descriptor_writes[0]),
+                                   descriptor_writes,
+                                   0,
+                                   NULL);
+        }
+    }
+
+    void LightClusteringPass::draw()
+    {
+        FrameResource& frame_resource = m_frame_resources[m_vulkan_rhi->m_current_frame_index];
+
+        // only the grid and the lights of the scene are uploaded
+        uint32_t point_light_num = m_light_clustering_perframe_storage_buffer_object.grid.point_light_num;
+        memcpy(frame_resource.light_buffer_memory_pointer,
+               &m_light_clustering_perframe_storage_buffer_object,
+               offsetof(LightClusteringPerframeStorageBufferObject, point_lights) +
+                   sizeof(VulkanScenePointLight) * point_light_num);
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Light Clustering", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+        }
+
+        vkCmdBindPipeline(
+            m_vulkan_rhi->m_current_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_render_pipelines[0].pipeline);
+        vkCmdBindDescriptorSets(m_vulkan_rhi->m_current_command_buffer,
+                                VK_PIPELINE_BIND_POINT_COMPUTE,
+                                m_render_pipelines[0].layout,
+                                0,
+                                1,
+                                &frame_resource.descriptor_set,
+                                0,
+                                NULL);
+        vkCmdDispatch(m_vulkan_rhi->m_current_command_buffer,
+                      roundUp(s_light_cluster_count, s_light_clustering_group_size) / s_light_clustering_group_size,
+                      1,
+                      1);
+
+        // the clusters are read by the lighting of the main camera pass
+        VkMemoryBarrier memory_barrier {};
+        memory_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memory_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             0,
+                             1,
+                             &memory_barrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+        }
+    }
+
+    VkDescriptorSetLayout LightClusteringPass::getLightClustersDescriptorSetLayout() const
+    {
+        return m_descriptor_infos[0].layout;
+    }
+
+    VkDescriptorSet LightClusteringPass::getLightClustersDescriptorSet() const
+    {
+        return m_frame_resources[m_vulkan_rhi->m_current_frame_index].descriptor_set;
+    }
+} // namespace Piccolo
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "runtime/function/render/render_pass.h"
+
+namespace Piccolo
+{
+    // culls the point lights into the clusters of the main camera view in a compute shader, which writes the indices
+    // of the lights touching every cluster. the lighting shaders only loop over the lights of the cluster of their
+    // fragment
+    class LightClusteringPass : public RenderPass
+    {
+    public:
+        void initialize(const RenderPassInitInfo* init_info) override final;
+        void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
+
+        // records the clustering into the current command buffer, outside of any render pass
+        void draw() override final;
+
+        // set 3 of the mesh lighting and the deferred lighting pipelines
+        VkDescriptorSetLayout getLightClustersDescriptorSetLayout() const;
+        VkDescriptorSet       getLightClustersDescriptorSet() const;
+
+    private:
+        // the lights are rewritten by the cpu, so every frame in flight has its own buffers
+        struct FrameResource
+        {
+            VkBuffer        light_buffer {VK_NULL_HANDLE};
+            VkDeviceMemory  light_buffer_memory {VK_NULL_HANDLE};
+            void*           light_buffer_memory_pointer {nullptr};
+            VkBuffer        cluster_buffer {VK_NULL_HANDLE};
+            VkDeviceMemory  cluster_buffer_memory {VK_NULL_HANDLE};
+            VkDescriptorSet descriptor_set {VK_NULL_HANDLE};
+        };
+
+        void setupDescriptorSetLayout();
+        void setupPipelines();
+        void setupDescriptorSet();
+
+        LightClusteringPerframeStorageBufferObject m_light_clustering_perframe_storage_buffer_object;
+        std::vector<FrameResource>                 m_frame_resources;
+    };
+} // namespace Piccolo
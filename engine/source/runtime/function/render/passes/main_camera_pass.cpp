@@ -13,6 +13,7 @@
 #include <deferred_lighting_vert.h>
 #include <mesh_frag.h>
 #include <mesh_gbuffer_frag.h>
+#include <mesh_gpu_driven_vert.h>
 #include <mesh_vert.h>
 #include <skybox_frag.h>
 #include <skybox_vert.h>
@@ -891,7 +892,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                VK_NULL_HANDLE,
+                m_vulkan_rhi->m_pipeline_cache,
                 1,
                 &pipelineInfo,
                 nullptr,
@@ -901,6 +902,57 @@ namespace Piccolo
                 throw std::runtime_error("create mesh gbuffer graphics pipeline");
             }
 
+            // the static objects culled on the gpu, only the vertex shader and the layout differ
+            if (m_mesh_culling_pass && m_mesh_culling_pass->isEnabled())
+            {
+                VkDescriptorSetLayout gpu_driven_descriptorset_layouts[4] = {
+                    m_descriptor_infos[_mesh_global].layout,
+                    m_descriptor_infos[_per_mesh].layout,
+                    m_descriptor_infos[_mesh_per_material].layout,
+                    m_mesh_culling_pass->getInstanceDescriptorSetLayout()};
+
+                // first visible instance of the batch
+                VkPushConstantRange push_constant_range {};
+                push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+                push_constant_range.offset     = 0;
+                push_constant_range.size       = sizeof(uint32_t);
+
+                VkPipelineLayoutCreateInfo gpu_driven_pipeline_layout_create_info {};
+                gpu_driven_pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+                gpu_driven_pipeline_layout_create_info.setLayoutCount =
+                    sizeof(gpu_driven_descriptorset_layouts) / sizeof(gpu_driven_descriptorset_layouts[0]);
+                gpu_driven_pipeline_layout_create_info.pSetLayouts            = gpu_driven_descriptorset_layouts;
+                gpu_driven_pipeline_layout_create_info.pushConstantRangeCount = 1;
+                gpu_driven_pipeline_layout_create_info.pPushConstantRanges    = &push_constant_range;
+
+                if (vkCreatePipelineLayout(m_vulkan_rhi->m_device,
+                                           &gpu_driven_pipeline_layout_create_info,
+                                           nullptr,
+                                           &m_render_pipelines[_render_pipeline_type_mesh_gbuffer_gpu_driven].layout) !=
+                    VK_SUCCESS)
+                {
+                    throw std::runtime_error("create mesh gbuffer gpu driven pipeline layout");
+                }
+
+                VkShaderModule gpu_driven_vert_shader_module =
+                    VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_GPU_DRIVEN_VERT);
+                shader_stages[0].module = gpu_driven_vert_shader_module;
+                pipelineInfo.layout     = m_render_pipelines[_render_pipeline_type_mesh_gbuffer_gpu_driven].layout;
+
+                if (vkCreateGraphicsPipelines(
+                        m_vulkan_rhi->m_device,
+                        m_vulkan_rhi->m_pipeline_cache,
+                        1,
+                        &pipelineInfo,
+                        nullptr,
+                        &m_render_pipelines[_render_pipeline_type_mesh_gbuffer_gpu_driven].pipeline) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("create mesh gbuffer gpu driven graphics pipeline");
+                }
+
+                vkDestroyShaderModule(m_vulkan_rhi->m_device, gpu_driven_vert_shader_module, nullptr);
+            }
+
             vkDestroyShaderModule(m_vulkan_rhi->m_device, vert_shader_module, nullptr);
             vkDestroyShaderModule(m_vulkan_rhi->m_device, frag_shader_module, nullptr);
         }
@@ -908,9 +960,11 @@ namespace Piccolo
 
         // deferred lighting
         {
-            VkDescriptorSetLayout      descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
-                                                              m_descriptor_infos[_deferred_lighting].layout,
-                                                              m_descriptor_infos[_skybox].layout};
+            VkDescriptorSetLayout      descriptorset_layouts[4] = {
+                m_descriptor_infos[_mesh_global].layout,
+                m_descriptor_infos[_deferred_lighting].layout,
+                m_descriptor_infos[_skybox].layout,
+                m_light_clustering_pass->getLightClustersDescriptorSetLayout()};
             VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
             pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
             pipeline_layout_create_info.setLayoutCount =
@@ -1041,7 +1095,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1057,12 +1111,14 @@ namespace Piccolo
 
         // mesh lighting
         {
-            VkDescriptorSetLayout      descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
-                                                              m_descriptor_infos[_per_mesh].layout,
-                                                              m_descriptor_infos[_mesh_per_material].layout};
+            VkDescriptorSetLayout      descriptorset_layouts[4] = {
+                m_descriptor_infos[_mesh_global].layout,
+                m_descriptor_infos[_per_mesh].layout,
+                m_descriptor_infos[_mesh_per_material].layout,
+                m_light_clustering_pass->getLightClustersDescriptorSetLayout()};
             VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
             pipeline_layout_create_info.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-            pipeline_layout_create_info.setLayoutCount = 3;
+            pipeline_layout_create_info.setLayoutCount = 4;
             pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
 
             if (vkCreatePipelineLayout(m_vulkan_rhi->m_device,
@@ -1185,7 +1241,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1328,7 +1384,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1858,33 +1914,7 @@ namespace Piccolo
 
     void MainCameraPass::drawMeshGbuffer()
     {
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
-
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
-
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
-        {
-            if (node.is_NBR_material)
-                continue;
-            auto& mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
-
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
-
-            mesh_nodes.push_back(temp);
-        }
+        const RenderDrawList& draw_list = *m_visiable_nodes.p_main_camera_draw_list;
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
@@ -1900,213 +1930,284 @@ namespace Piccolo
         VkViewport viewport {};
         viewport.x        = 0.0f;
         viewport.y        = 0.0f;
-        viewport.width    = m_vulkan_rhi->m_swapchain_extent.width;
-        viewport.height   = m_vulkan_rhi->m_swapchain_extent.height;
+        viewport.width    = m_vulkan_rhi->m_scene_extent.width;
+        viewport.height   = m_vulkan_rhi->m_scene_extent.height;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         VkRect2D scissor {};
         scissor.offset = {0, 0};
-        scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height};
+        scissor.extent = {m_vulkan_rhi->m_scene_extent.width, m_vulkan_rhi->m_scene_extent.height};
         m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &viewport);
         m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
 
         // perframe storage buffer
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-            perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-        assert(m_global_render_resource->_storage_buffer
-                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-               (m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-        (*reinterpret_cast<MeshPerframeStorageBufferObject*>(
-            reinterpret_cast<uintptr_t>(
-                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-            perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
-
-        for (auto& pair1 : main_camera_mesh_drawcall_batch)
+        auto     perframe_allocation     = allocateUpload<MeshPerframeStorageBufferObject>();
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+        *perframe_allocation.data = m_mesh_perframe_storage_buffer_object;
+
+        bool gpu_driven = m_mesh_culling_pass && m_mesh_culling_pass->isEnabled();
+
+        VulkanPBRMaterial* bound_material = nullptr;
+        for (const RenderDrawBatch& batch : draw_list.getBatches())
         {
-            VulkanPBRMaterial& material       = (*pair1.first);
-            auto&              mesh_instanced = pair1.second;
-
-            // bind per material
-            m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
-                                                        VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                        m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
-                                                        2,
-                                                        1,
-                                                        &material.material_descriptor_set,
-                                                        0,
-                                                        NULL);
-
-            // TODO: render from near to far
-
-            for (auto& pair2 : mesh_instanced)
+            // nbr materials are drawn by the nbr pass
+            if (batch.m_is_NBR_material)
+            {
+                continue;
+            }
+
+            // static objects are culled and drawn by the gpu
+            if (gpu_driven && !batch.m_enable_vertex_blending)
             {
-                VulkanMesh& mesh       = (*pair2.first);
-                auto&       mesh_nodes = pair2.second;
+                continue;
+            }
+
+            // bind per material, the batches of a material are adjacent
+            if (batch.m_material != bound_material)
+            {
+                bound_material = batch.m_material;
+                m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
+                                                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                            m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
+                                                            2,
+                                                            1,
+                                                            &bound_material->material_descriptor_set,
+                                                            0,
+                                                            NULL);
+            }
 
-                uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                if (total_instance_count > 0)
+            VulkanMesh&           mesh       = *batch.m_mesh;
+            const RenderMeshNode* mesh_nodes = draw_list.getBatchNodes(batch);
+
+            uint32_t total_instance_count = batch.m_node_count;
+            if (total_instance_count > 0)
+            {
+                // bind per mesh
+                m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
+                    m_vulkan_rhi->m_current_command_buffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
+                    1,
+                    1,
+                    &mesh.mesh_vertex_blending_descriptor_set,
+                    0,
+                    NULL);
+
+                VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                             mesh.mesh_vertex_varying_enable_blending_buffer,
+                                             mesh.mesh_vertex_varying_buffer};
+                VkDeviceSize offsets[]        = {0, 0, 0};
+                m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(m_vulkan_rhi->m_current_command_buffer,
+                                                           0,
+                                                           (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                                           vertex_buffers,
+                                                           offsets);
+                m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                    m_vulkan_rhi->m_current_command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
                 {
-                    // bind per mesh
-                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                        m_vulkan_rhi->m_current_command_buffer,
-                        VK_PIPELINE_BIND_POINT_GRAPHICS,
-                        m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
-                        1,
-                        1,
-                        &mesh.mesh_vertex_blending_descriptor_set,
-                        0,
-                        NULL);
-
-                    VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
-                                                 mesh.mesh_vertex_varying_enable_blending_buffer,
-                                                 mesh.mesh_vertex_varying_buffer};
-                    VkDeviceSize offsets[]        = {0, 0, 0};
-                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(m_vulkan_rhi->m_current_command_buffer,
-                                                               0,
-                                                               (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
-                                                               vertex_buffers,
-                                                               offsets);
-                    m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                        m_vulkan_rhi->m_current_command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
-
-                    uint32_t drawcall_max_instance_count =
-                        (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
-                         sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
-                    uint32_t drawcall_count =
-                        roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                    for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // per drawcall storage buffer
+                    auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                    uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                    MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                        *perdrawcall_allocation.data;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
                     {
-                        uint32_t current_instance_count =
-                            ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                             drawcall_max_instance_count) ?
-                                (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                drawcall_max_instance_count;
-
-                        // per drawcall storage buffer
-                        uint32_t perdrawcall_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                            perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                               (m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                        MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                perdrawcall_dynamic_offset));
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                              -1.0;
-                        }
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]) ?
+                                1.0 :
+                                -1.0;
+                    }
 
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
+                    // per drawcall vertex blending storage buffer
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset;
+                    bool     least_one_enable_vertex_blending = true;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        if (!isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                         {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
+                            least_one_enable_vertex_blending = false;
+                            break;
                         }
-                        if (least_one_enable_vertex_blending)
+                    }
+                    if (least_one_enable_vertex_blending)
+                    {
+                        auto per_drawcall_vertex_blending_allocation =
+                            allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
+                        per_drawcall_vertex_blending_dynamic_offset =
+                            per_drawcall_vertex_blending_allocation.dynamic_offset;
+
+                        MeshPerdrawcallVertexBlendingStorageBufferObject&
+                            per_drawcall_vertex_blending_storage_buffer_object =
+                                *per_drawcall_vertex_blending_allocation.data;
+                        for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
+                            if (isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                             {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
+                                for (uint32_t j = 0;
+                                     j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
+                                     ++j)
                                 {
-                                    for (uint32_t j = 0;
-                                         j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                         ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
+                                    per_drawcall_vertex_blending_storage_buffer_object
+                                        .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
+                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
+                                            .joint_matrices[j];
                                 }
                             }
                         }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
-
-                        // bind perdrawcall
-                        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                       perdrawcall_dynamic_offset,
-                                                       per_drawcall_vertex_blending_dynamic_offset};
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                            m_vulkan_rhi->m_current_command_buffer,
-                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
-                            0,
-                            1,
-                            &m_descriptor_infos[_mesh_global].descriptor_set,
-                            3,
-                            dynamic_offsets);
-
-                        m_vulkan_rhi->m_vk_cmd_draw_indexed(m_vulkan_rhi->m_current_command_buffer,
-                                                            mesh.mesh_index_count,
-                                                            current_instance_count,
-                                                            0,
-                                                            0,
-                                                            0);
                     }
+                    else
+                    {
+                        per_drawcall_vertex_blending_dynamic_offset = 0;
+                    }
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset};
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
+                        m_vulkan_rhi->m_current_command_buffer,
+                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
+                        0,
+                        1,
+                        &m_descriptor_infos[_mesh_global].descriptor_set,
+                        3,
+                        dynamic_offsets);
+
+                    drawMeshInstances(m_vulkan_rhi->m_current_command_buffer,
+                                      mesh,
+                                      mesh_nodes + drawcall_max_instance_count * drawcall_index,
+                                      current_instance_count,
+                                      2);
                 }
             }
         }
 
+        if (gpu_driven)
+        {
+            drawMeshGbufferGPUDriven(perframe_dynamic_offset);
+        }
+
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
             m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
         }
     }
 
+    void MainCameraPass::drawMeshGbufferGPUDriven(uint32_t perframe_dynamic_offset)
+    {
+        const RenderDrawList& draw_list = *m_visiable_nodes.p_gpu_driven_draw_list;
+        if (draw_list.getNodes().empty())
+        {
+            return;
+        }
+
+        const RenderPipelineBase& gpu_driven_pipeline =
+            m_render_pipelines[_render_pipeline_type_mesh_gbuffer_gpu_driven];
+
+        m_vulkan_rhi->m_vk_cmd_bind_pipeline(
+            m_vulkan_rhi->m_current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, gpu_driven_pipeline.pipeline);
+
+        // the per drawcall bindings are not read, the instances come from set 3
+        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset, 0, 0};
+        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
+                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                    gpu_driven_pipeline.layout,
+                                                    0,
+                                                    1,
+                                                    &m_descriptor_infos[_mesh_global].descriptor_set,
+                                                    3,
+                                                    dynamic_offsets);
+
+        VkDescriptorSet instance_descriptor_set = m_mesh_culling_pass->getInstanceDescriptorSet();
+        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
+                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                    gpu_driven_pipeline.layout,
+                                                    3,
+                                                    1,
+                                                    &instance_descriptor_set,
+                                                    0,
+                                                    NULL);
+
+        // one indirect draw per batch, the culling wrote the instance counts
+        VkBuffer           draw_command_buffer = m_mesh_culling_pass->getDrawCommandBuffer();
+        VulkanPBRMaterial* bound_material      = nullptr;
+        const std::vector<RenderDrawBatch>& batches = draw_list.getBatches();
+        for (uint32_t batch_index = 0; batch_index < batches.size(); ++batch_index)
+        {
+            const RenderDrawBatch& batch = batches[batch_index];
+
+            if (batch.m_material != bound_material)
+            {
+                bound_material = batch.m_material;
+                m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
+                    m_vulkan_rhi->m_current_command_buffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    gpu_driven_pipeline.layout,
+                    2,
+                    1,
+                    &bound_material->material_descriptor_set,
+                    0,
+                    NULL);
+            }
+
+            VulkanMesh& mesh = *batch.m_mesh;
+
+            m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
+                m_vulkan_rhi->m_current_command_buffer,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                gpu_driven_pipeline.layout,
+                1,
+                1,
+                &mesh.mesh_vertex_blending_descriptor_set,
+                0,
+                NULL);
+
+            VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                         mesh.mesh_vertex_varying_enable_blending_buffer,
+                                         mesh.mesh_vertex_varying_buffer};
+            VkDeviceSize offsets[]        = {0, 0, 0};
+            m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(m_vulkan_rhi->m_current_command_buffer,
+                                                       0,
+                                                       (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                                       vertex_buffers,
+                                                       offsets);
+            m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                m_vulkan_rhi->m_current_command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
+
+            vkCmdPushConstants(m_vulkan_rhi->m_current_command_buffer,
+                               gpu_driven_pipeline.layout,
+                               VK_SHADER_STAGE_VERTEX_BIT,
+                               0,
+                               sizeof(uint32_t),
+                               &batch.m_first_node);
+
+            vkCmdDrawIndexedIndirect(m_vulkan_rhi->m_current_command_buffer,
+                                     draw_command_buffer,
+                                     sizeof(VkDrawIndexedIndirectCommand) * batch_index,
+                                     1,
+                                     sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+
 
     void MainCameraPass::drawDeferredLighting()
     {
@@ -2116,44 +2217,31 @@ namespace Piccolo
         VkViewport viewport {};
         viewport.x        = 0.0f;
         viewport.y        = 0.0f;
-        viewport.width    = m_vulkan_rhi->m_swapchain_extent.width;
-        viewport.height   = m_vulkan_rhi->m_swapchain_extent.height;
+        viewport.width    = m_vulkan_rhi->m_scene_extent.width;
+        viewport.height   = m_vulkan_rhi->m_scene_extent.height;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         VkRect2D scissor {};
         scissor.offset = {0, 0};
-        scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height};
+        scissor.extent = {m_vulkan_rhi->m_scene_extent.width, m_vulkan_rhi->m_scene_extent.height};
         m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &viewport);
         m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
 
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-            perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-        assert(m_global_render_resource->_storage_buffer
-                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-               (m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-        (*reinterpret_cast<MeshPerframeStorageBufferObject*>(
-            reinterpret_cast<uintptr_t>(
-                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-            perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
-
-        VkDescriptorSet descriptor_sets[3] = {m_descriptor_infos[_mesh_global].descriptor_set,
+        auto     perframe_allocation     = allocateUpload<MeshPerframeStorageBufferObject>();
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+        *perframe_allocation.data = m_mesh_perframe_storage_buffer_object;
+
+        VkDescriptorSet descriptor_sets[4] = {m_descriptor_infos[_mesh_global].descriptor_set,
                                               m_descriptor_infos[_deferred_lighting].descriptor_set,
-                                              m_descriptor_infos[_skybox].descriptor_set};
+                                              m_descriptor_infos[_skybox].descriptor_set,
+                                              m_light_clustering_pass->getLightClustersDescriptorSet()};
         uint32_t        dynamic_offsets[4] = {perframe_dynamic_offset, perframe_dynamic_offset, 0, 0};
         m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
                                                     VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                     m_render_pipelines[_render_pipeline_type_deferred_lighting].layout,
                                                     0,
-                                                    3,
+                                                    4,
                                                     descriptor_sets,
                                                     4,
                                                     dynamic_offsets);
@@ -2163,31 +2251,7 @@ namespace Piccolo
 
     void MainCameraPass::drawMeshLighting()
     {
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
-
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
-
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
-        {
-            auto& mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
-
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
-
-            mesh_nodes.push_back(temp);
-        }
+        const RenderDrawList& draw_list = *m_visiable_nodes.p_main_camera_draw_list;
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
@@ -2202,203 +2266,176 @@ namespace Piccolo
         VkViewport viewport {};
         viewport.x        = 0.0f;
         viewport.y        = 0.0f;
-        viewport.width    = m_vulkan_rhi->m_swapchain_extent.width;
-        viewport.height   = m_vulkan_rhi->m_swapchain_extent.height;
+        viewport.width    = m_vulkan_rhi->m_scene_extent.width;
+        viewport.height   = m_vulkan_rhi->m_scene_extent.height;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         VkRect2D scissor {};
         scissor.offset = {0, 0};
-        scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height};
+        scissor.extent = {m_vulkan_rhi->m_scene_extent.width, m_vulkan_rhi->m_scene_extent.height};
         m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &viewport);
         m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
 
         // perframe storage buffer
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-            perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-        assert(m_global_render_resource->_storage_buffer
-                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-               (m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-        (*reinterpret_cast<MeshPerframeStorageBufferObject*>(
-            reinterpret_cast<uintptr_t>(
-                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-            perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
-
-        for (auto& pair1 : main_camera_mesh_drawcall_batch)
+        auto     perframe_allocation     = allocateUpload<MeshPerframeStorageBufferObject>();
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+        *perframe_allocation.data = m_mesh_perframe_storage_buffer_object;
+
+        // the point lights of the clusters, for all the batches
+        VkDescriptorSet light_clusters_descriptor_set = m_light_clustering_pass->getLightClustersDescriptorSet();
+        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
+                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                    m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
+                                                    3,
+                                                    1,
+                                                    &light_clusters_descriptor_set,
+                                                    0,
+                                                    NULL);
+
+        VulkanPBRMaterial* bound_material = nullptr;
+        for (const RenderDrawBatch& batch : draw_list.getBatches())
         {
-            VulkanPBRMaterial& material       = (*pair1.first);
-            auto&              mesh_instanced = pair1.second;
-
-            // bind per material
-            m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
-                                                        VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                        m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
-                                                        2,
-                                                        1,
-                                                        &material.material_descriptor_set,
-                                                        0,
-                                                        NULL);
-
-            // TODO: render from near to far
-
-            for (auto& pair2 : mesh_instanced)
+            // nbr materials are drawn by the nbr pass
+            if (batch.m_is_NBR_material)
+            {
+                continue;
+            }
+
+            // bind per material, the batches of a material are adjacent
+            if (batch.m_material != bound_material)
             {
-                VulkanMesh& mesh       = (*pair2.first);
-                auto&       mesh_nodes = pair2.second;
+                bound_material = batch.m_material;
+                m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
+                                                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                            m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
+                                                            2,
+                                                            1,
+                                                            &bound_material->material_descriptor_set,
+                                                            0,
+                                                            NULL);
+            }
+
+            VulkanMesh&           mesh       = *batch.m_mesh;
+            const RenderMeshNode* mesh_nodes = draw_list.getBatchNodes(batch);
 
-                uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                if (total_instance_count > 0)
+            uint32_t total_instance_count = batch.m_node_count;
+            if (total_instance_count > 0)
+            {
+                // bind per mesh
+                m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
+                    m_vulkan_rhi->m_current_command_buffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
+                    1,
+                    1,
+                    &mesh.mesh_vertex_blending_descriptor_set,
+                    0,
+                    NULL);
+
+                VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                             mesh.mesh_vertex_varying_enable_blending_buffer,
+                                             mesh.mesh_vertex_varying_buffer};
+                VkDeviceSize offsets[]        = {0, 0, 0};
+                m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(m_vulkan_rhi->m_current_command_buffer,
+                                                           0,
+                                                           (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                                           vertex_buffers,
+                                                           offsets);
+                m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                    m_vulkan_rhi->m_current_command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
                 {
-                    // bind per mesh
-                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                        m_vulkan_rhi->m_current_command_buffer,
-                        VK_PIPELINE_BIND_POINT_GRAPHICS,
-                        m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
-                        1,
-                        1,
-                        &mesh.mesh_vertex_blending_descriptor_set,
-                        0,
-                        NULL);
-
-                    VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
-                                                 mesh.mesh_vertex_varying_enable_blending_buffer,
-                                                 mesh.mesh_vertex_varying_buffer};
-                    VkDeviceSize offsets[]        = {0, 0, 0};
-                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(m_vulkan_rhi->m_current_command_buffer,
-                                                               0,
-                                                               (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
-                                                               vertex_buffers,
-                                                               offsets);
-                    m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                        m_vulkan_rhi->m_current_command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
-
-                    uint32_t drawcall_max_instance_count =
-                        (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
-                         sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
-                    uint32_t drawcall_count =
-                        roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                    for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // per drawcall storage buffer
+                    auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                    uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                    MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                        *perdrawcall_allocation.data;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
                     {
-                        uint32_t current_instance_count =
-                            ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                             drawcall_max_instance_count) ?
-                                (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                drawcall_max_instance_count;
-
-                        // per drawcall storage buffer
-                        uint32_t perdrawcall_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                            perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                               (m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                        MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                perdrawcall_dynamic_offset));
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                              -1.0;
-                        }
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]) ?
+                                1.0 :
+                                -1.0;
+                    }
 
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
+                    // per drawcall vertex blending storage buffer
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset;
+                    bool     least_one_enable_vertex_blending = true;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        if (!isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                         {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
+                            least_one_enable_vertex_blending = false;
+                            break;
                         }
-                        if (least_one_enable_vertex_blending)
+                    }
+                    if (least_one_enable_vertex_blending)
+                    {
+                        auto per_drawcall_vertex_blending_allocation =
+                            allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
+                        per_drawcall_vertex_blending_dynamic_offset =
+                            per_drawcall_vertex_blending_allocation.dynamic_offset;
+
+                        MeshPerdrawcallVertexBlendingStorageBufferObject&
+                            per_drawcall_vertex_blending_storage_buffer_object =
+                                *per_drawcall_vertex_blending_allocation.data;
+                        for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
+                            if (isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                             {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
+                                for (uint32_t j = 0;
+                                     j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
+                                     ++j)
                                 {
-                                    for (uint32_t j = 0;
-                                         j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                         ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
+                                    per_drawcall_vertex_blending_storage_buffer_object
+                                        .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
+                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
+                                            .joint_matrices[j];
                                 }
                             }
                         }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
-
-                        // bind perdrawcall
-                        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                       perdrawcall_dynamic_offset,
-                                                       per_drawcall_vertex_blending_dynamic_offset};
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                            m_vulkan_rhi->m_current_command_buffer,
-                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
-                            0,
-                            1,
-                            &m_descriptor_infos[_mesh_global].descriptor_set,
-                            3,
-                            dynamic_offsets);
-
-                        m_vulkan_rhi->m_vk_cmd_draw_indexed(m_vulkan_rhi->m_current_command_buffer,
-                                                            mesh.mesh_index_count,
-                                                            current_instance_count,
-                                                            0,
-                                                            0,
-                                                            0);
                     }
+                    else
+                    {
+                        per_drawcall_vertex_blending_dynamic_offset = 0;
+                    }
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset};
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
+                        m_vulkan_rhi->m_current_command_buffer,
+                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
+                        0,
+                        1,
+                        &m_descriptor_infos[_mesh_global].descriptor_set,
+                        3,
+                        dynamic_offsets);
+
+                    drawMeshInstances(m_vulkan_rhi->m_current_command_buffer,
+                                      mesh,
+                                      mesh_nodes + drawcall_max_instance_count * drawcall_index,
+                                      current_instance_count,
+                                      2);
                 }
             }
         }
@@ -2412,24 +2449,10 @@ namespace Piccolo
 
     void MainCameraPass::drawSkybox()
     {
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-            perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-        assert(m_global_render_resource->_storage_buffer
-                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-               (m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-        (*reinterpret_cast<MeshPerframeStorageBufferObject*>(
-            reinterpret_cast<uintptr_t>(
-                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-            perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
+        auto     perframe_allocation     = allocateUpload<MeshPerframeStorageBufferObject>();
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+        *perframe_allocation.data = m_mesh_perframe_storage_buffer_object;
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
@@ -2471,4 +2494,11 @@ namespace Piccolo
 
     void MainCameraPass::setParticlePass(std::shared_ptr<ParticlePass> pass) { m_particle_pass = pass; }
 
+    void MainCameraPass::setMeshCullingPass(std::shared_ptr<MeshCullingPass> pass) { m_mesh_culling_pass = pass; }
+
+    void MainCameraPass::setLightClusteringPass(std::shared_ptr<LightClusteringPass> pass)
+    {
+        m_light_clustering_pass = pass;
+    }
+
 } // namespace Piccolo
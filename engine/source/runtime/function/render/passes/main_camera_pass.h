@@ -2,6 +2,8 @@
 
 #include "runtime/function/render/render_pass.h"
 
+#include "runtime/function/render/passes/light_clustering_pass.h"
+#include "runtime/function/render/passes/mesh_culling_pass.h"
 #include "runtime/function/render/passes/ssao_generate_pass.h"
 #include "runtime/function/render/passes/ssao_blur_pass.h"
 #include "runtime/function/render/passes/nbr_pass.h"
@@ -37,6 +39,7 @@ namespace Piccolo
         // 2. sky box
         // 3. axis
         // 4. billboard type particle
+        // 5. model culled on the gpu
         enum RenderPipeLineType : uint8_t
         {
             _render_pipeline_type_mesh_gbuffer = 0,
@@ -44,6 +47,7 @@ namespace Piccolo
             _render_pipeline_type_mesh_lighting,
             _render_pipeline_type_skybox,
             _render_pipeline_type_particle,
+            _render_pipeline_type_mesh_gbuffer_gpu_driven,
             _render_pipeline_type_count
         };
 
@@ -80,6 +84,12 @@ namespace Piccolo
 
         void setParticlePass(std::shared_ptr<ParticlePass> pass);
 
+        // must be set before initialize to draw the static objects with the gpu culling
+        void setMeshCullingPass(std::shared_ptr<MeshCullingPass> pass);
+
+        // must be set before initialize, the lighting reads the point lights of the clusters it writes
+        void setLightClusteringPass(std::shared_ptr<LightClusteringPass> pass);
+
     private:
         void setupParticlePass();
         void setupAttachments();
@@ -95,6 +105,7 @@ namespace Piccolo
         void setupGbufferLightingDescriptorSet();
 
         void drawMeshGbuffer();
+        void drawMeshGbufferGPUDriven(uint32_t perframe_dynamic_offset);
         void drawNBRMeshLighting();
         void drawDeferredLighting();
         void drawMeshLighting();
@@ -104,5 +115,7 @@ namespace Piccolo
     private:
         std::vector<VkFramebuffer> m_swapchain_framebuffers;
         std::shared_ptr<ParticlePass> m_particle_pass;
+        std::shared_ptr<MeshCullingPass> m_mesh_culling_pass;
+        std::shared_ptr<LightClusteringPass> m_light_clustering_pass;
     };
 } // namespace Piccolo
@@ -0,0 +1,467 @@
+#include "runtime/function/render/passes/mesh_culling_pass.h"
+#include "runtime/function/render/render_helper.h"
+#include "runtime/function/render/render_resource.h"
+
+#include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_util.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <mesh_gpu_culling_comp.h>
+
+namespace Piccolo
+{
+    static const uint32_t s_mesh_culling_group_size                = 64;
+    static const uint32_t s_mesh_culling_initial_instance_capacity = 1024;
+    static const uint32_t s_mesh_culling_initial_batch_capacity    = 256;
+
+    void MeshCullingPass::initialize(const RenderPassInitInfo* init_info)
+    {
+        RenderPass::initialize(nullptr);
+
+        const MeshCullingPassInitInfo* _init_info = static_cast<const MeshCullingPassInitInfo*>(init_info);
+        m_enable_gpu_driven_culling               = _init_info->enable_gpu_driven_culling;
+        if (!m_enable_gpu_driven_culling)
+        {
+            return;
+        }
+
+        setupDescriptorSetLayout();
+        setupPipelines();
+        setupDescriptorSet();
+
+        // the descriptor sets always point at valid buffers
+        for (FrameResource& frame_resource : m_frame_resources)
+        {
+            reserveFrameResource(
+                frame_resource, s_mesh_culling_initial_instance_capacity, s_mesh_culling_initial_batch_capacity);
+        }
+    }
+
+    void MeshCullingPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
+    {
+        const RenderResource* vulkan_resource = static_cast<const RenderResource*>(render_resource.get());
+        if (vulkan_resource)
+        {
+            // the same frustum as the cpu culling of the main camera
+            const Matrix4x4& proj_view_matrix = vulkan_resource->m_mesh_perframe_storage_buffer_object.proj_view_matrix;
+            ClusterFrustum   f = CreateClusterFrustumFromMatrix(proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+
+            m_push_constant_object.frustum_planes[0] = f.m_plane_right;
+            m_push_constant_object.frustum_planes[1] = f.m_plane_left;
+            m_push_constant_object.frustum_planes[2] = f.m_plane_top;
+            m_push_constant_object.frustum_planes[3] = f.m_plane_bottom;
+            m_push_constant_object.frustum_planes[4] = f.m_plane_near;
+            m_push_constant_object.frustum_planes[5] = f.m_plane_far;
+        }
+    }
+
+    void MeshCullingPass::setupDescriptorSetLayout()
+    {
+        m_descriptor_infos.resize(_layout_type_count);
+
+        {
+            VkDescriptorSetLayoutBinding culling_layout_bindings[3] = {};
+
+            VkDescriptorSetLayoutBinding& instances_binding = culling_layout_bindings[0];
+            instances_binding.binding                       = 0;
+            instances_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            instances_binding.descriptorCount               = 1;
+            instances_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutBinding& draw_commands_binding = culling_layout_bindings[1];
+            draw_commands_binding.binding                       = 1;
+            draw_commands_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            draw_commands_binding.descriptorCount               = 1;
+            draw_commands_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutBinding& visible_instances_binding = culling_layout_bindings[2];
+            visible_instances_binding.binding                       = 2;
+            visible_instances_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            visible_instances_binding.descriptorCount               = 1;
+            visible_instances_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutCreateInfo culling_layout_create_info {};
+            culling_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            culling_layout_create_info.bindingCount =
+                sizeof(culling_layout_bindings) / sizeof(culling_layout_bindings[0]);
+            culling_layout_create_info.pBindings = culling_layout_bindings;
+
+            if (VK_SUCCESS != vkCreateDescriptorSetLayout(m_vulkan_rhi->m_device,
+                                                          &culling_layout_create_info,
+                                                          NULL,
+                                                          &m_descriptor_infos[_culling].layout))
+            {
+                throw std::runtime_error("create mesh culling layout");
+            }
+        }
+
+        {
+            VkDescriptorSetLayoutBinding instance_layout_bindings[2] = {};
+
+            VkDescriptorSetLayoutBinding& instances_binding = instance_layout_bindings[0];
+            instances_binding.binding                       = 0;
+            instances_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            instances_binding.descriptorCount               = 1;
+            instances_binding.stageFlags                    = VK_SHADER_STAGE_VERTEX_BIT;
+
+            VkDescriptorSetLayoutBinding& visible_instances_binding = instance_layout_bindings[1];
+            visible_instances_binding.binding                       = 1;
+            visible_instances_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            visible_instances_binding.descriptorCount               = 1;
+            visible_instances_binding.stageFlags                    = VK_SHADER_STAGE_VERTEX_BIT;
+
+            VkDescriptorSetLayoutCreateInfo instance_layout_create_info {};
+            instance_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            instance_layout_create_info.bindingCount =
+                sizeof(instance_layout_bindings) / sizeof(instance_layout_bindings[0]);
+            instance_layout_create_info.pBindings = instance_layout_bindings;
+
+            if (VK_SUCCESS != vkCreateDescriptorSetLayout(m_vulkan_rhi->m_device,
+                                                          &instance_layout_create_info,
+                                                          NULL,
+                                                          &m_descriptor_infos[_instance].layout))
+            {
+                throw std::runtime_error("create mesh culling instance layout");
+            }
+        }
+    }
+
+    void MeshCullingPass::setupPipelines()
+    {
+        m_render_pipelines.resize(1);
+
+        VkPushConstantRange push_constant_range {};
+        push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        push_constant_range.offset     = 0;
+        push_constant_range.size       = sizeof(MeshCullingPushConstantObject);
+
+        VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
+        pipeline_layout_create_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount         = 1;
+        pipeline_layout_create_info.pSetLayouts            = &m_descriptor_infos[_culling].layout;
+        pipeline_layout_create_info.pushConstantRangeCount = 1;
+        pipeline_layout_create_info.pPushConstantRanges    = &push_constant_range;
+
+        if (vkCreatePipelineLayout(
+                m_vulkan_rhi->m_device, &pipeline_layout_create_info, nullptr, &m_render_pipelines[0].layout) !=
+            VK_SUCCESS)
+        {
+            throw std::runtime_error("create mesh culling pipeline layout");
+        }
+
+        VkPipelineShaderStageCreateInfo shader_stage_create_info {};
+        shader_stage_create_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shader_stage_create_info.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+        shader_stage_create_info.module = VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_GPU_CULLING_COMP);
+        shader_stage_create_info.pName  = "main";
+
+        VkComputePipelineCreateInfo compute_pipeline_create_info {};
+        compute_pipeline_create_info.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        compute_pipeline_create_info.stage  = shader_stage_create_info;
+        compute_pipeline_create_info.layout = m_render_pipelines[0].layout;
+
+        if (vkCreateComputePipelines(m_vulkan_rhi->m_device,
+                                     m_vulkan_rhi->m_pipeline_cache,
+                                     1,
+                                     &compute_pipeline_create_info,
+                                     nullptr,
+                                     &m_render_pipelines[0].pipeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("create mesh culling pipeline");
+        }
+
+        vkDestroyShaderModule(m_vulkan_rhi->m_device, shader_stage_create_info.module, nullptr);
+    }
+
+    void MeshCullingPass::setupDescriptorSet()
+    {
+        m_frame_resources.resize(m_vulkan_rhi->s_max_frames_in_flight);
+        for (FrameResource& frame_resource : m_frame_resources)
+        {
+            VkDescriptorSetLayout descriptor_set_layouts[2] = {m_descriptor_infos[_culling].layout,
+                                                               m_descriptor_infos[_instance].layout};
+
+            VkDescriptorSetAllocateInfo descriptor_set_alloc_info {};
+            descriptor_set_alloc_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            descriptor_set_alloc_info.descriptorPool     = m_vulkan_rhi->m_descriptor_pool;
+            descriptor_set_alloc_info.descriptorSetCount = 2;
+            descriptor_set_alloc_info.pSetLayouts        = descriptor_set_layouts;
+
+            VkDescriptorSet descriptor_sets[2];
+            if (VK_SUCCESS !=
+                vkAllocateDescriptorSets(m_vulkan_rhi->m_device, &descriptor_set_alloc_info, descriptor_sets))
+            {
+                throw std::runtime_error("allocate mesh culling descriptor set");
+            }
+            frame_resource.culling_descriptor_set  = descriptor_sets[0];
+            frame_resource.instance_descriptor_set = descriptor_sets[1];
+        }
+    }
+
+    void MeshCullingPass::reserveFrameResource(FrameResource& frame_resource,
+                                               uint32_t       instance_count,
+                                               uint32_t       batch_count)
+    {
+        if (instance_count <= frame_resource.instance_capacity && batch_count <= frame_resource.batch_capacity)
+        {
+            return;
+        }
+
+        // grow geometrically, the frame is not in flight so its buffers can be replaced
+        destroyFrameResourceBuffers(frame_resource);
+        frame_resource.instance_capacity = std::max(instance_count, frame_resource.instance_capacity * 2);
+        frame_resource.batch_capacity    = std::max(batch_count, frame_resource.batch_capacity * 2);
+
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 sizeof(VulkanGPUDrivenMeshInstance) * frame_resource.instance_capacity,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 frame_resource.instance_buffer,
+                                 frame_resource.instance_buffer_memory);
+        vkMapMemory(m_vulkan_rhi->m_device,
+                    frame_resource.instance_buffer_memory,
+                    0,
+                    VK_WHOLE_SIZE,
+                    0,
+                    &frame_resource.instance_buffer_memory_pointer);
+
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 sizeof(VkDrawIndexedIndirectCommand) * frame_resource.batch_capacity,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 frame_resource.draw_command_buffer,
+                                 frame_resource.draw_command_buffer_memory);
+        vkMapMemory(m_vulkan_rhi->m_device,
+                    frame_resource.draw_command_buffer_memory,
+                    0,
+                    VK_WHOLE_SIZE,
+                    0,
+                    &frame_resource.draw_command_buffer_memory_pointer);
+
+        // only written and read by the gpu
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 sizeof(uint32_t) * frame_resource.instance_capacity,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                 frame_resource.visible_instance_buffer,
+                                 frame_resource.visible_instance_buffer_memory);
+
+        frame_resource.uploaded_version = ~0ull;
+        updateFrameResourceDescriptorSet(frame_resource);
+    }
+
+    void MeshCullingPass::destroyFrameResourceBuffers(FrameResource& frame_resource)
+    {
+        if (frame_resource.instance_buffer != VK_NULL_HANDLE)
+        {
+            vkDestroyBuffer(m_vulkan_rhi->m_device, frame_resource.instance_buffer, nullptr);
+            vkFreeMemory(m_vulkan_rhi->m_device, frame_resource.instance_buffer_memory, nullptr);
+            vkDestroyBuffer(m_vulkan_rhi->m_device, frame_resource.draw_command_buffer, nullptr);
+            vkFreeMemory(m_vulkan_rhi->m_device, frame_resource.draw_command_buffer_memory, nullptr);
+            vkDestroyBuffer(m_vulkan_rhi->m_device, frame_resource.visible_instance_buffer, nullptr);
+            vkFreeMemory(m_vulkan_rhi->m_device, frame_resource.visible_instance_buffer_memory, nullptr);
+        }
+    }
+
+    void MeshCullingPass::updateFrameResourceDescriptorSet(FrameResource& frame_resource)
+    {
+        VkDescriptorBufferInfo instances_buffer_info {};
+        instances_buffer_info.buffer = frame_resource.instance_buffer;
+        instances_buffer_info.offset = 0;
+        instances_buffer_info.range  = VK_WHOLE_SIZE;
+
+        VkDescriptorBufferInfo draw_commands_buffer_info {};
+        draw_commands_buffer_info.buffer = frame_resource.draw_command_buffer;
+        draw_commands_buffer_info.offset = 0;
+        draw_commands_buffer_info.range  = VK_WHOLE_SIZE;
+
+        VkDescriptorBufferInfo visible_instances_buffer_info {};
+        visible_instances_buffer_info.buffer = frame_resource.visible_instance_buffer;
+        visible_instances_buffer_info.offset = 0;
+        visible_instances_buffer_info.range  = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet descriptor_writes[5] = {};
+
+        descriptor_writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[0].dstSet          = frame_resource.culling_descriptor_set;
+        descriptor_writes[0].dstBinding      = 0;
+        descriptor_writes[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[0].descriptorCount = 1;
+        descriptor_writes[0].pBufferInfo     = &instances_buffer_info;
+
+        descriptor_writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[1].dstSet          = frame_resource.culling_descriptor_set;
+        descriptor_writes[1].dstBinding      = 1;
+        descriptor_writes[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[1].descriptorCount = 1;
+        descriptor_writes[1].pBufferInfo     = &draw_commands_buffer_info;
+
+        descriptor_writes[2].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[2].dstSet          = frame_resource.culling_descriptor_set;
+        descriptor_writes[2].dstBinding      = 2;
+        descriptor_writes[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[2].descriptorCount = 1;
+        descriptor_writes[2].pBufferInfo     = &visible_instances_buffer_info;
+
+        descriptor_writes[3].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[3].dstSet          = frame_resource.instance_descriptor_set;
+        descriptor_writes[3].dstBinding      = 0;
+        descriptor_writes[3].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[3].descriptorCount = 1;
+        descriptor_writes[3].pBufferInfo     = &instances_buffer_info;
+
+        descriptor_writes[4].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[4].dstSet          = frame_resource.instance_descriptor_set;
+        descriptor_writes[4].dstBinding      = 1;
+        descriptor_writes[4].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[4].descriptorCount = 1;
+        descriptor_writes[4].pBufferInfo     = &visible_instances_buffer_info;
+
+        vkUpdateDescriptorSets(m_vulkan_rhi->m_device,
+                               sizeof(descriptor_writes) / sizeof(descriptor_writes[0]),
+                               descriptor_writes,
+                               0,
+                               NULL);
+    }
+
+    void MeshCullingPass::uploadInstances(FrameResource& frame_resource, const RenderDrawList& draw_list)
+    {
+        VulkanGPUDrivenMeshInstance* instances =
+            reinterpret_cast<VulkanGPUDrivenMeshInstance*>(frame_resource.instance_buffer_memory_pointer);
+
+        const std::vector<RenderDrawBatch>& batches = draw_list.getBatches();
+        for (uint32_t batch_index = 0; batch_index < batches.size(); ++batch_index)
+        {
+            const RenderDrawBatch& batch      = batches[batch_index];
+            const RenderMeshNode*  mesh_nodes = draw_list.getBatchNodes(batch);
+            for (uint32_t i = 0; i < batch.m_node_count; ++i)
+            {
+                VulkanGPUDrivenMeshInstance& instance = instances[batch.m_first_node + i];
+                instance.model_matrix                 = *mesh_nodes[i].model_matrix;
+                instance.bounding_box_min             = Vector4(mesh_nodes[i].world_bounding_box->min_bound, 1.0f);
+                instance.bounding_box_max             = Vector4(mesh_nodes[i].world_bounding_box->max_bound, 1.0f);
+                instance.batch_index                  = batch_index;
+                instance.batch_first_instance         = batch.m_first_node;
+            }
+        }
+
+        frame_resource.uploaded_version = draw_list.getVersion();
+    }
+
+    void MeshCullingPass::draw()
+    {
+        if (!m_enable_gpu_driven_culling || !m_visiable_nodes.p_gpu_driven_draw_list)
+        {
+            return;
+        }
+
+        const RenderDrawList& draw_list      = *m_visiable_nodes.p_gpu_driven_draw_list;
+        uint32_t              instance_count = static_cast<uint32_t>(draw_list.getNodes().size());
+        uint32_t              batch_count    = static_cast<uint32_t>(draw_list.getBatches().size());
+        if (instance_count == 0)
+        {
+            return;
+        }
+
+        FrameResource& frame_resource = m_frame_resources[m_vulkan_rhi->m_current_frame_index];
+
+        // the static objects are only uploaded again when they change
+        if (frame_resource.uploaded_version != draw_list.getVersion())
+        {
+            reserveFrameResource(frame_resource, instance_count, batch_count);
+            uploadInstances(frame_resource, draw_list);
+        }
+
+        if (m_draw_commands_version != draw_list.getVersion())
+        {
+            m_draw_commands.resize(batch_count);
+            for (uint32_t batch_index = 0; batch_index < batch_count; ++batch_index)
+            {
+                VkDrawIndexedIndirectCommand& draw_command = m_draw_commands[batch_index];
+                draw_command.indexCount    = draw_list.getBatches()[batch_index].m_mesh->mesh_index_count;
+                draw_command.instanceCount = 0;
+                draw_command.firstIndex    = 0;
+                draw_command.vertexOffset  = 0;
+                draw_command.firstInstance = 0;
+            }
+            m_draw_commands_version = draw_list.getVersion();
+        }
+
+        // the culling counts the visible instances up from zero
+        memcpy(frame_resource.draw_command_buffer_memory_pointer,
+               m_draw_commands.data(),
+               sizeof(VkDrawIndexedIndirectCommand) * batch_count);
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh Culling", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+        }
+
+        m_push_constant_object.instance_count = instance_count;
+
+        vkCmdBindPipeline(
+            m_vulkan_rhi->m_current_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_render_pipelines[0].pipeline);
+        vkCmdBindDescriptorSets(m_vulkan_rhi->m_current_command_buffer,
+                                VK_PIPELINE_BIND_POINT_COMPUTE,
+                                m_render_pipelines[0].layout,
+                                0,
+                                1,
+                                &frame_resource.culling_descriptor_set,
+                                0,
+                                NULL);
+        vkCmdPushConstants(m_vulkan_rhi->m_current_command_buffer,
+                           m_render_pipelines[0].layout,
+                           VK_SHADER_STAGE_COMPUTE_BIT,
+                           0,
+                           sizeof(MeshCullingPushConstantObject),
+                           &m_push_constant_object);
+        vkCmdDispatch(m_vulkan_rhi->m_current_command_buffer,
+                      roundUp(instance_count, s_mesh_culling_group_size) / s_mesh_culling_group_size,
+                      1,
+                      1);
+
+        // the draw commands and the visible instances are consumed by the gbuffer pass
+        VkMemoryBarrier memory_barrier {};
+        memory_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memory_barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                             0,
+                             1,
+                             &memory_barrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+        }
+    }
+
+    VkDescriptorSetLayout MeshCullingPass::getInstanceDescriptorSetLayout() const
+    {
+        return m_descriptor_infos[_instance].layout;
+    }
+
+    VkDescriptorSet MeshCullingPass::getInstanceDescriptorSet() const
+    {
+        return m_frame_resources[m_vulkan_rhi->m_current_frame_index].instance_descriptor_set;
+    }
+
+    VkBuffer MeshCullingPass::getDrawCommandBuffer() const
+    {
+        return m_frame_resources[m_vulkan_rhi->m_current_frame_index].draw_command_buffer;
+    }
+} // namespace Piccolo
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "runtime/function/render/render_pass.h"
+
+namespace Piccolo
+{
+    struct MeshCullingPassInitInfo : RenderPassInitInfo
+    {
+        bool enable_gpu_driven_culling {false};
+    };
+
+    struct MeshCullingPushConstantObject
+    {
+        Vector4  frustum_planes[6];
+        uint32_t instance_count;
+        uint32_t _padding_instance_count_1;
+        uint32_t _padding_instance_count_2;
+        uint32_t _padding_instance_count_3;
+    };
+
+    // frustum culls the static objects of the gpu driven draw list in a compute shader, which writes the indirect
+    // draw of every batch and the compacted indices of its visible instances for the gbuffer pass.
+    // the instances are only uploaded when the draw list changes
+    class MeshCullingPass : public RenderPass
+    {
+    public:
+        void initialize(const RenderPassInitInfo* init_info) override final;
+        void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
+
+        // records the culling into the current command buffer, outside of any render pass
+        void draw() override final;
+
+        bool isEnabled() const { return m_enable_gpu_driven_culling; }
+
+        // set 3 of the gpu driven gbuffer pipeline
+        VkDescriptorSetLayout getInstanceDescriptorSetLayout() const;
+        VkDescriptorSet       getInstanceDescriptorSet() const;
+
+        // one VkDrawIndexedIndirectCommand per batch of the gpu driven draw list
+        VkBuffer getDrawCommandBuffer() const;
+
+    private:
+        enum LayoutType : uint8_t
+        {
+            _culling = 0,
+            _instance,
+            _layout_type_count
+        };
+
+        // the buffers are rewritten by the cpu, so every frame in flight has its own
+        struct FrameResource
+        {
+            uint64_t        uploaded_version {~0ull};
+            uint32_t        instance_capacity {0};
+            uint32_t        batch_capacity {0};
+            VkBuffer        instance_buffer {VK_NULL_HANDLE};
+            VkDeviceMemory  instance_buffer_memory {VK_NULL_HANDLE};
+            void*           instance_buffer_memory_pointer {nullptr};
+            VkBuffer        draw_command_buffer {VK_NULL_HANDLE};
+            VkDeviceMemory  draw_command_buffer_memory {VK_NULL_HANDLE};
+            void*           draw_command_buffer_memory_pointer {nullptr};
+            VkBuffer        visible_instance_buffer {VK_NULL_HANDLE};
+            VkDeviceMemory  visible_instance_buffer_memory {VK_NULL_HANDLE};
+            VkDescriptorSet culling_descriptor_set {VK_NULL_HANDLE};
+            VkDescriptorSet instance_descriptor_set {VK_NULL_HANDLE};
+        };
+
+        void setupDescriptorSetLayout();
+        void setupPipelines();
+        void setupDescriptorSet();
+
+        void reserveFrameResource(FrameResource& frame_resource, uint32_t instance_count, uint32_t batch_count);
+        void destroyFrameResourceBuffers(FrameResource& frame_resource);
+        void updateFrameResourceDescriptorSet(FrameResource& frame_resource);
+        void uploadInstances(FrameResource& frame_resource, const RenderDrawList& draw_list);
+
+        bool                                      m_enable_gpu_driven_culling {false};
+        MeshCullingPushConstantObject             m_push_constant_object;
+        std::vector<FrameResource>                m_frame_resources;
+        std::vector<VkDrawIndexedIndirectCommand> m_draw_commands;
+        uint64_t                                  m_draw_commands_version {~0ull};
+    };
+} // namespace Piccolo
@@ -0,0 +1,432 @@
+#include "runtime/function/render/passes/mesh_skinning_pass.h"
+#include "runtime/function/render/render_helper.h"
+#include "runtime/function/render/render_mesh.h"
+#include "runtime/function/render/render_resource.h"
+
+#include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_util.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <mesh_skinning_comp.h>
+
+namespace Piccolo
+{
+    static const uint32_t s_mesh_skinning_group_size              = 64;
+    static const uint32_t s_mesh_skinning_initial_vertex_capacity = 65536;
+
+    void MeshSkinningPass::initialize(const RenderPassInitInfo* init_info)
+    {
+        RenderPass::initialize(nullptr);
+
+        const MeshSkinningPassInitInfo* _init_info = static_cast<const MeshSkinningPassInitInfo*>(init_info);
+        m_enable_compute_skinning                  = _init_info->enable_compute_skinning;
+        if (!m_enable_compute_skinning)
+        {
+            return;
+        }
+
+        setupDescriptorSetLayout();
+        setupPipelines();
+        setupDescriptorSet();
+
+        // the descriptor sets always point at valid buffers
+        for (FrameResource& frame_resource : m_frame_resources)
+        {
+            reserveFrameResource(frame_resource, s_mesh_skinning_initial_vertex_capacity);
+        }
+    }
+
+    void MeshSkinningPass::setupDescriptorSetLayout()
+    {
+        m_descriptor_infos.resize(_layout_type_count);
+
+        {
+            VkDescriptorSetLayoutBinding per_frame_layout_bindings[3] = {};
+
+            VkDescriptorSetLayoutBinding& joint_matrices_binding = per_frame_layout_bindings[0];
+            joint_matrices_binding.binding                       = 0;
+            joint_matrices_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            joint_matrices_binding.descriptorCount               = 1;
+            joint_matrices_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutBinding& skinned_positions_binding = per_frame_layout_bindings[1];
+            skinned_positions_binding.binding                       = 1;
+            skinned_positions_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            skinned_positions_binding.descriptorCount               = 1;
+            skinned_positions_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutBinding& skinned_varyings_binding = per_frame_layout_bindings[2];
+            skinned_varyings_binding.binding                       = 2;
+            skinned_varyings_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            skinned_varyings_binding.descriptorCount               = 1;
+            skinned_varyings_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutCreateInfo per_frame_layout_create_info {};
+            per_frame_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            per_frame_layout_create_info.bindingCount =
+                sizeof(per_frame_layout_bindings) / sizeof(per_frame_layout_bindings[0]);
+            per_frame_layout_create_info.pBindings = per_frame_layout_bindings;
+
+            if (VK_SUCCESS != vkCreateDescriptorSetLayout(m_vulkan_rhi->m_device,
+                                                          &per_frame_layout_create_info,
+                                                          NULL,
+                                                          &m_descriptor_infos[_skinning_per_frame].layout))
+            {
+                throw std::runtime_error("create mesh skinning per frame layout");
+            }
+        }
+
+        {
+            VkDescriptorSetLayoutBinding per_mesh_layout_bindings[3] = {};
+
+            VkDescriptorSetLayoutBinding& positions_binding = per_mesh_layout_bindings[0];
+            positions_binding.binding                       = 0;
+            positions_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            positions_binding.descriptorCount               = 1;
+            positions_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutBinding& varyings_binding = per_mesh_layout_bindings[1];
+            varyings_binding.binding                       = 1;
+            varyings_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            varyings_binding.descriptorCount               = 1;
+            varyings_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutBinding& joint_binding_binding = per_mesh_layout_bindings[2];
+            joint_binding_binding.binding                       = 2;
+            joint_binding_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            joint_binding_binding.descriptorCount               = 1;
+            joint_binding_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+
+            VkDescriptorSetLayoutCreateInfo per_mesh_layout_create_info {};
+            per_mesh_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            per_mesh_layout_create_info.bindingCount =
+                sizeof(per_mesh_layout_bindings) / sizeof(per_mesh_layout_bindings[0]);
+            per_mesh_layout_create_info.pBindings = per_mesh_layout_bindings;
+
+            if (VK_SUCCESS != vkCreateDescriptorSetLayout(m_vulkan_rhi->m_device,
+                                                          &per_mesh_layout_create_info,
+                                                          NULL,
+                                                          &m_descriptor_infos[_skinning_per_mesh].layout))
+            {
+                throw std::runtime_error("create mesh skinning per mesh layout");
+            }
+        }
+    }
+
+    void MeshSkinningPass::setupPipelines()
+    {
+        m_render_pipelines.resize(1);
+
+        VkDescriptorSetLayout descriptor_set_layouts[_layout_type_count] = {
+            m_descriptor_infos[_skinning_per_frame].layout, m_descriptor_infos[_skinning_per_mesh].layout};
+
+        VkPushConstantRange push_constant_range {};
+        push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        push_constant_range.offset     = 0;
+        push_constant_range.size       = sizeof(MeshSkinningPushConstantObject);
+
+        VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
+        pipeline_layout_create_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount         = _layout_type_count;
+        pipeline_layout_create_info.pSetLayouts            = descriptor_set_layouts;
+        pipeline_layout_create_info.pushConstantRangeCount = 1;
+        pipeline_layout_create_info.pPushConstantRanges    = &push_constant_range;
+
+        if (vkCreatePipelineLayout(
+                m_vulkan_rhi->m_device, &pipeline_layout_create_info, nullptr, &m_render_pipelines[0].layout) !=
+            VK_SUCCESS)
+        {
+            throw std::runtime_error("create mesh skinning pipeline layout");
+        }
+
+        VkPipelineShaderStageCreateInfo shader_stage_create_info {};
+        shader_stage_create_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shader_stage_create_info.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+        shader_stage_create_info.module = VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_SKINNING_COMP);
+        shader_stage_create_info.pName  = "main";
+
+        VkComputePipelineCreateInfo compute_pipeline_create_info {};
+        compute_pipeline_create_info.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        compute_pipeline_create_info.stage  = shader_stage_create_info;
+        compute_pipeline_create_info.layout = m_render_pipelines[0].layout;
+
+        if (vkCreateComputePipelines(m_vulkan_rhi->m_device,
+                                     m_vulkan_rhi->m_pipeline_cache,
+                                     1,
+                                     &compute_pipeline_create_info,
+                                     nullptr,
+                                     &m_render_pipelines[0].pipeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("create mesh skinning pipeline");
+        }
+
+        vkDestroyShaderModule(m_vulkan_rhi->m_device, shader_stage_create_info.module, nullptr);
+    }
+
+    void MeshSkinningPass::setupDescriptorSet()
+    {
+        m_frame_resources.resize(m_vulkan_rhi->s_max_frames_in_flight);
+        for (FrameResource& frame_resource : m_frame_resources)
+        {
+            VkDescriptorSetAllocateInfo descriptor_set_alloc_info {};
+            descriptor_set_alloc_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            descriptor_set_alloc_info.descriptorPool     = m_vulkan_rhi->m_descriptor_pool;
+            descriptor_set_alloc_info.descriptorSetCount = 1;
+            descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[_skinning_per_frame].layout;
+
+            if (VK_SUCCESS != vkAllocateDescriptorSets(
+                                  m_vulkan_rhi->m_device, &descriptor_set_alloc_info, &frame_resource.descriptor_set))
+            {
+                throw std::runtime_error("allocate mesh skinning per frame descriptor set");
+            }
+        }
+    }
+
+    void MeshSkinningPass::reserveFrameResource(FrameResource& frame_resource, uint32_t vertex_count)
+    {
+        if (vertex_count <= frame_resource.vertex_capacity)
+        {
+            return;
+        }
+
+        // grow geometrically, the frame is not in flight so its buffers can be replaced
+        destroyFrameResourceBuffers(frame_resource);
+        frame_resource.vertex_capacity = std::max(vertex_count, frame_resource.vertex_capacity * 2);
+
+        // only written and read by the gpu
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 sizeof(MeshVertex::VulkanMeshVertexPostition) * frame_resource.vertex_capacity,
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                 frame_resource.position_buffer,
+                                 frame_resource.position_buffer_memory);
+
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) *
+                                     frame_resource.vertex_capacity,
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                 frame_resource.varying_enable_blending_buffer,
+                                 frame_resource.varying_enable_blending_buffer_memory);
+
+        updateFrameResourceDescriptorSet(frame_resource);
+    }
+
+    void MeshSkinningPass::destroyFrameResourceBuffers(FrameResource& frame_resource)
+    {
+        if (frame_resource.position_buffer != VK_NULL_HANDLE)
+        {
+            vkDestroyBuffer(m_vulkan_rhi->m_device, frame_resource.position_buffer, nullptr);
+            vkFreeMemory(m_vulkan_rhi->m_device, frame_resource.position_buffer_memory, nullptr);
+            vkDestroyBuffer(m_vulkan_rhi->m_device, frame_resource.varying_enable_blending_buffer, nullptr);
+            vkFreeMemory(m_vulkan_rhi->m_device, frame_resource.varying_enable_blending_buffer_memory, nullptr);
+        }
+    }
+
+    void MeshSkinningPass::updateFrameResourceDescriptorSet(FrameResource& frame_resource)
+    {
+        VkDescriptorBufferInfo joint_matrices_buffer_info {};
+        joint_matrices_buffer_info.buffer = m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+        joint_matrices_buffer_info.offset = 0;
+        joint_matrices_buffer_info.range  = sizeof(MeshSkinningJointStorageBufferObject);
+        assert(joint_matrices_buffer_info.range < m_global_render_resource->_storage_buffer._max_storage_buffer_range);
+
+        VkDescriptorBufferInfo skinned_positions_buffer_info {};
+        skinned_positions_buffer_info.buffer = frame_resource.position_buffer;
+        skinned_positions_buffer_info.offset = 0;
+        skinned_positions_buffer_info.range  = VK_WHOLE_SIZE;
+
+        VkDescriptorBufferInfo skinned_varyings_buffer_info {};
+        skinned_varyings_buffer_info.buffer = frame_resource.varying_enable_blending_buffer;
+        skinned_varyings_buffer_info.offset = 0;
+        skinned_varyings_buffer_info.range  = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet descriptor_writes[3] = {};
+
+        descriptor_writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[0].dstSet          = frame_resource.descriptor_set;
+        descriptor_writes[0].dstBinding      = 0;
+        descriptor_writes[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        descriptor_writes[0].descriptorCount = 1;
+        descriptor_writes[0].pBufferInfo     = &joint_matrices_buffer_info;
+
+        descriptor_writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[1].dstSet          = frame_resource.descriptor_set;
+        descriptor_writes[1].dstBinding      = 1;
+        descriptor_writes[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[1].descriptorCount = 1;
+        descriptor_writes[1].pBufferInfo     = &skinned_positions_buffer_info;
+
+        descriptor_writes[2].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[2].dstSet          = frame_resource.descriptor_set;
+        descriptor_writes[2].dstBinding      = 2;
+        descriptor_writes[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[2].descriptorCount = 1;
+        descriptor_writes[2].pBufferInfo     = &skinned_varyings_buffer_info;
+
+        vkUpdateDescriptorSets(m_vulkan_rhi->m_device,
+                               sizeof(descriptor_writes) / sizeof(descriptor_writes[0]),
+                               descriptor_writes,
+                               0,
+                               NULL);
+    }
+
+    void MeshSkinningPass::updateMeshDescriptorSet(VulkanMesh& mesh)
+    {
+        if (mesh.mesh_skinning_descriptor_set != VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        VkDescriptorSetAllocateInfo descriptor_set_alloc_info {};
+        descriptor_set_alloc_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        descriptor_set_alloc_info.descriptorPool     = m_vulkan_rhi->m_descriptor_pool;
+        descriptor_set_alloc_info.descriptorSetCount = 1;
+        descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[_skinning_per_mesh].layout;
+
+        if (VK_SUCCESS != vkAllocateDescriptorSets(
+                              m_vulkan_rhi->m_device, &descriptor_set_alloc_info, &mesh.mesh_skinning_descriptor_set))
+        {
+            throw std::runtime_error("allocate mesh skinning per mesh descriptor set");
+        }
+
+        VkDescriptorBufferInfo positions_buffer_info {};
+        positions_buffer_info.buffer = mesh.mesh_vertex_position_buffer;
+        positions_buffer_info.offset = 0;
+        positions_buffer_info.range  = VK_WHOLE_SIZE;
+
+        VkDescriptorBufferInfo varyings_buffer_info {};
+        varyings_buffer_info.buffer = mesh.mesh_vertex_varying_enable_blending_buffer;
+        varyings_buffer_info.offset = 0;
+        varyings_buffer_info.range  = VK_WHOLE_SIZE;
+
+        VkDescriptorBufferInfo joint_binding_buffer_info {};
+        joint_binding_buffer_info.buffer = mesh.mesh_vertex_joint_binding_buffer;
+        joint_binding_buffer_info.offset = 0;
+        joint_binding_buffer_info.range  = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet descriptor_writes[3] = {};
+
+        descriptor_writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[0].dstSet          = mesh.mesh_skinning_descriptor_set;
+        descriptor_writes[0].dstBinding      = 0;
+        descriptor_writes[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[0].descriptorCount = 1;
+        descriptor_writes[0].pBufferInfo     = &positions_buffer_info;
+
+        descriptor_writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[1].dstSet          = mesh.mesh_skinning_descriptor_set;
+        descriptor_writes[1].dstBinding      = 1;
+        descriptor_writes[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[1].descriptorCount = 1;
+        descriptor_writes[1].pBufferInfo     = &varyings_buffer_info;
+
+        descriptor_writes[2].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[2].dstSet          = mesh.mesh_skinning_descriptor_set;
+        descriptor_writes[2].dstBinding      = 2;
+        descriptor_writes[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[2].descriptorCount = 1;
+        descriptor_writes[2].pBufferInfo     = &joint_binding_buffer_info;
+
+        vkUpdateDescriptorSets(m_vulkan_rhi->m_device,
+                               sizeof(descriptor_writes) / sizeof(descriptor_writes[0]),
+                               descriptor_writes,
+                               0,
+                               NULL);
+    }
+
+    void MeshSkinningPass::draw()
+    {
+        m_skinned_vertex_buffers = SkinnedVertexBuffers();
+        if (!m_enable_compute_skinning || !m_visiable_nodes.p_skinned_mesh_nodes ||
+            m_visiable_nodes.p_skinned_mesh_nodes->empty())
+        {
+            return;
+        }
+
+        const std::vector<RenderMeshNode>& skinned_mesh_nodes = *m_visiable_nodes.p_skinned_mesh_nodes;
+
+        // the render scene hands out the offsets one instance after the other
+        const RenderMeshNode& last_node    = skinned_mesh_nodes.back();
+        uint32_t              vertex_count = last_node.skinned_vertex_offset + last_node.ref_mesh->mesh_vertex_count;
+
+        FrameResource& frame_resource = m_frame_resources[m_vulkan_rhi->m_current_frame_index];
+        reserveFrameResource(frame_resource, vertex_count);
+
+        m_skinned_vertex_buffers.position_buffer                = frame_resource.position_buffer;
+        m_skinned_vertex_buffers.varying_enable_blending_buffer = frame_resource.varying_enable_blending_buffer;
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh Skinning", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+        }
+
+        vkCmdBindPipeline(
+            m_vulkan_rhi->m_current_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_render_pipelines[0].pipeline);
+
+        for (const RenderMeshNode& node : skinned_mesh_nodes)
+        {
+            VulkanMesh& mesh = *node.ref_mesh;
+            updateMeshDescriptorSet(mesh);
+
+            RenderUploadAllocation<MeshSkinningJointStorageBufferObject> joint_matrices =
+                allocateUpload<MeshSkinningJointStorageBufferObject>();
+            memcpy(joint_matrices.data->joint_matrices,
+                   node.joint_matrices,
+                   sizeof(Matrix4x4) * std::min(node.joint_count, s_mesh_vertex_blending_max_joint_count));
+
+            VkDescriptorSet descriptor_sets[_layout_type_count] = {frame_resource.descriptor_set,
+                                                                   mesh.mesh_skinning_descriptor_set};
+            vkCmdBindDescriptorSets(m_vulkan_rhi->m_current_command_buffer,
+                                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                                    m_render_pipelines[0].layout,
+                                    0,
+                                    _layout_type_count,
+                                    descriptor_sets,
+                                    1,
+                                    &joint_matrices.dynamic_offset);
+
+            MeshSkinningPushConstantObject push_constant_object;
+            push_constant_object.vertex_count          = mesh.mesh_vertex_count;
+            push_constant_object.skinned_vertex_offset = node.skinned_vertex_offset;
+            vkCmdPushConstants(m_vulkan_rhi->m_current_command_buffer,
+                               m_render_pipelines[0].layout,
+                               VK_SHADER_STAGE_COMPUTE_BIT,
+                               0,
+                               sizeof(MeshSkinningPushConstantObject),
+                               &push_constant_object);
+            vkCmdDispatch(m_vulkan_rhi->m_current_command_buffer,
+                          roundUp(mesh.mesh_vertex_count, s_mesh_skinning_group_size) / s_mesh_skinning_group_size,
+                          1,
+                          1);
+        }
+
+        // the skinned vertices are fetched by all the mesh passes of the frame
+        VkMemoryBarrier memory_barrier {};
+        memory_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memory_barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                             0,
+                             1,
+                             &memory_barrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "runtime/function/render/render_pass.h"
+
+namespace Piccolo
+{
+    struct MeshSkinningPassInitInfo : RenderPassInitInfo
+    {
+        bool enable_compute_skinning {false};
+    };
+
+    struct MeshSkinningPushConstantObject
+    {
+        uint32_t vertex_count;
+        uint32_t skinned_vertex_offset;
+    };
+
+    // skins every visible skinned instance once per frame in a compute shader, into vertex buffers laid out like the
+    // position and the normal and tangent buffers of the meshes. the shadow, depth, base and nbr passes bind them and
+    // draw the instances as static meshes instead of blending the joints again in each of their vertex shaders
+    class MeshSkinningPass : public RenderPass
+    {
+    public:
+        void initialize(const RenderPassInitInfo* init_info) override final;
+
+        // records the skinning into the current command buffer, before the passes drawing the skinned instances
+        void draw() override final;
+
+        bool isEnabled() const { return m_enable_compute_skinning; }
+
+    private:
+        enum LayoutType : uint8_t
+        {
+            _skinning_per_frame = 0,
+            _skinning_per_mesh,
+            _layout_type_count
+        };
+
+        // the skinned vertices are read by the passes of the frame, so every frame in flight has its own
+        struct FrameResource
+        {
+            uint32_t        vertex_capacity {0};
+            VkBuffer        position_buffer {VK_NULL_HANDLE};
+            VkDeviceMemory  position_buffer_memory {VK_NULL_HANDLE};
+            VkBuffer        varying_enable_blending_buffer {VK_NULL_HANDLE};
+            VkDeviceMemory  varying_enable_blending_buffer_memory {VK_NULL_HANDLE};
+            VkDescriptorSet descriptor_set {VK_NULL_HANDLE};
+        };
+
+        void setupDescriptorSetLayout();
+        void setupPipelines();
+        void setupDescriptorSet();
+
+        void reserveFrameResource(FrameResource& frame_resource, uint32_t vertex_count);
+        void destroyFrameResourceBuffers(FrameResource& frame_resource);
+        void updateFrameResourceDescriptorSet(FrameResource& frame_resource);
+        void updateMeshDescriptorSet(VulkanMesh& mesh);
+
+        bool                       m_enable_compute_skinning {false};
+        std::vector<FrameResource> m_frame_resources;
+    };
+} // namespace Piccolo
@@ -388,7 +388,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(
-                    m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_eyes_and_eyebrows].pipeline) !=
+                    m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_eyes_and_eyebrows].pipeline) !=
                 VK_SUCCESS)
             {
                 throw std::runtime_error("create nbr graphics pipeline");
@@ -505,7 +505,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(
-                    m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_face_and_mouth].pipeline) !=
+                    m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_face_and_mouth].pipeline) !=
                 VK_SUCCESS)
             {
                 throw std::runtime_error("create nbr graphics pipeline");
@@ -622,7 +622,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(
-                    m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_body].pipeline) !=
+                    m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_body].pipeline) !=
                 VK_SUCCESS)
             {
                 throw std::runtime_error("create nbr graphics pipeline");
@@ -739,7 +739,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(
-                    m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_hair].pipeline) !=
+                    m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_hair].pipeline) !=
                 VK_SUCCESS)
             {
                 throw std::runtime_error("create nbr graphics pipeline");
@@ -856,7 +856,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(
-                    m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_hair_alpha].pipeline) !=
+                    m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_hair_alpha].pipeline) !=
                 VK_SUCCESS)
             {
                 throw std::runtime_error("create nbr graphics pipeline");
@@ -959,7 +959,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(
-                    m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_eye_black].pipeline) !=
+                    m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[_nbr_pipeline_type_eye_black].pipeline) !=
                 VK_SUCCESS)
             {
                 throw std::runtime_error("create nbr graphics pipeline");
@@ -1111,7 +1111,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                            VK_NULL_HANDLE,
+                                            m_vulkan_rhi->m_pipeline_cache,
                                             1,
                                             &pipelineInfo,
                                             nullptr,
@@ -1320,25 +1320,29 @@ namespace Piccolo
             const Matrix4x4* model_matrix {nullptr};
             const Matrix4x4* joint_matrices {nullptr};
             uint32_t         joint_count {0};
+            uint32_t         skinned_vertex_offset {s_invalid_skinned_vertex_offset};
         };
 
         std::vector<MeshNode> nbr_mesh_nodes(_nbr_mesh_count);
         // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
+        const RenderDrawList& draw_list = *m_visiable_nodes.p_main_camera_draw_list;
+        for (const RenderDrawBatch& batch : draw_list.getBatches())
         {
-            if (!node.is_NBR_material)
+            if (!batch.m_is_NBR_material)
                 continue;
-            assert(node.nbr_mesh_id != uint32_t(10000));
+            assert(batch.m_nbr_mesh_id != uint32_t(10000));
 
-            MeshNode& temp    = nbr_mesh_nodes[node.nbr_mesh_id];
-            temp.material     = node.ref_material_nbr;
-            temp.mesh         = node.ref_mesh;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
+            // one instance is drawn per nbr mesh part
+            const RenderMeshNode& node = draw_list.getBatchNodes(batch)[batch.m_node_count - 1];
+
+            MeshNode& temp      = nbr_mesh_nodes[batch.m_nbr_mesh_id];
+            temp.material       = batch.m_material_nbr;
+            temp.mesh           = batch.m_mesh;
+            temp.model_matrix   = node.model_matrix;
+            temp.joint_matrices = isShaderVertexBlending(node) ? node.joint_matrices : nullptr;
+            temp.joint_count    = node.joint_count;
+
+            temp.skinned_vertex_offset = node.skinned_vertex_offset;
         }
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
@@ -1351,33 +1355,19 @@ namespace Piccolo
         VkViewport viewport {};
         viewport.x        = 0.0f;
         viewport.y        = 0.0f;
-        viewport.width    = m_vulkan_rhi->m_swapchain_extent.width;
-        viewport.height   = m_vulkan_rhi->m_swapchain_extent.height;
+        viewport.width    = m_vulkan_rhi->m_scene_extent.width;
+        viewport.height   = m_vulkan_rhi->m_scene_extent.height;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         VkRect2D scissor {};
         scissor.offset = {0, 0};
-        scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height};
+        scissor.extent = {m_vulkan_rhi->m_scene_extent.width, m_vulkan_rhi->m_scene_extent.height};
 
         // perframe storage buffer
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-            perframe_dynamic_offset + sizeof(NBRMeshPerframeStorageBufferObject);
-        assert(m_global_render_resource->_storage_buffer
-                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-               (m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-        (*reinterpret_cast<NBRMeshPerframeStorageBufferObject*>(
-            reinterpret_cast<uintptr_t>(
-                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-            perframe_dynamic_offset)) = m_nbr_mesh_perframe_storage_buffer_object;
+        auto     perframe_allocation     = allocateUpload<NBRMeshPerframeStorageBufferObject>();
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+        *perframe_allocation.data = m_nbr_mesh_perframe_storage_buffer_object;
 
         if (nbr_mesh_nodes[_nbr_mesh_eyes].material || nbr_mesh_nodes[_nbr_mesh_eyebrows].material)
         {
@@ -1428,28 +1418,20 @@ namespace Piccolo
                 m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                     m_vulkan_rhi->m_current_command_buffer, eyes_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+                // drawn as a static mesh when the mesh skinning pass has skinned it
+                if (eyes_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+                {
+                    bindSkinnedVertexBuffers(
+                        m_vulkan_rhi->m_current_command_buffer, eyes_mesh_node.skinned_vertex_offset, 2);
+                }
+
                 uint32_t current_instance_count = 1;
 
                 // per drawcall storage buffer
-                uint32_t perdrawcall_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        perdrawcall_dynamic_offset));
+                auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
                 perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *eyes_mesh_node.model_matrix;
                 perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -1460,27 +1442,14 @@ namespace Piccolo
 
                 if (eyes_mesh_node.joint_matrices)
                 {
+                    auto per_drawcall_vertex_blending_allocation =
+                        allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
                     per_drawcall_vertex_blending_dynamic_offset =
-                        roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                        per_drawcall_vertex_blending_dynamic_offset +
-                        sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                    assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                           (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                        per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                     MeshPerdrawcallVertexBlendingStorageBufferObject&
                         per_drawcall_vertex_blending_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                per_drawcall_vertex_blending_dynamic_offset));
+                            *per_drawcall_vertex_blending_allocation.data;
 
                     for (uint32_t j = 0; j < eyes_mesh_node.joint_count; ++j)
                     {
@@ -1555,28 +1524,20 @@ namespace Piccolo
                 m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                     m_vulkan_rhi->m_current_command_buffer, eyebrows_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+                // drawn as a static mesh when the mesh skinning pass has skinned it
+                if (eyebrows_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+                {
+                    bindSkinnedVertexBuffers(
+                        m_vulkan_rhi->m_current_command_buffer, eyebrows_mesh_node.skinned_vertex_offset, 2);
+                }
+
                 uint32_t current_instance_count = 1;
 
                 // per drawcall storage buffer
-                uint32_t perdrawcall_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        perdrawcall_dynamic_offset));
+                auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
                 perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *eyebrows_mesh_node.model_matrix;
                 perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -1587,27 +1548,14 @@ namespace Piccolo
 
                 if (eyebrows_mesh_node.joint_matrices)
                 {
+                    auto per_drawcall_vertex_blending_allocation =
+                        allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
                     per_drawcall_vertex_blending_dynamic_offset =
-                        roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                        per_drawcall_vertex_blending_dynamic_offset +
-                        sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                    assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                           (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                        per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                     MeshPerdrawcallVertexBlendingStorageBufferObject&
                         per_drawcall_vertex_blending_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                per_drawcall_vertex_blending_dynamic_offset));
+                            *per_drawcall_vertex_blending_allocation.data;
 
                     for (uint32_t j = 0; j < eyebrows_mesh_node.joint_count; ++j)
                     {
@@ -1691,28 +1639,20 @@ namespace Piccolo
                 m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                     m_vulkan_rhi->m_current_command_buffer, face_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+                // drawn as a static mesh when the mesh skinning pass has skinned it
+                if (face_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+                {
+                    bindSkinnedVertexBuffers(
+                        m_vulkan_rhi->m_current_command_buffer, face_mesh_node.skinned_vertex_offset, 2);
+                }
+
                 uint32_t current_instance_count = 1;
 
                 // per drawcall storage buffer
-                uint32_t perdrawcall_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        perdrawcall_dynamic_offset));
+                auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
                 perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *face_mesh_node.model_matrix;
                 perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -1723,27 +1663,14 @@ namespace Piccolo
 
                 if (face_mesh_node.joint_matrices)
                 {
+                    auto per_drawcall_vertex_blending_allocation =
+                        allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
                     per_drawcall_vertex_blending_dynamic_offset =
-                        roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                        per_drawcall_vertex_blending_dynamic_offset +
-                        sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                    assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                           (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                        per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                     MeshPerdrawcallVertexBlendingStorageBufferObject&
                         per_drawcall_vertex_blending_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                per_drawcall_vertex_blending_dynamic_offset));
+                            *per_drawcall_vertex_blending_allocation.data;
 
                     for (uint32_t j = 0; j < face_mesh_node.joint_count; ++j)
                     {
@@ -1817,28 +1744,20 @@ namespace Piccolo
                 m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                     m_vulkan_rhi->m_current_command_buffer, mouth_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+                // drawn as a static mesh when the mesh skinning pass has skinned it
+                if (mouth_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+                {
+                    bindSkinnedVertexBuffers(
+                        m_vulkan_rhi->m_current_command_buffer, mouth_mesh_node.skinned_vertex_offset, 2);
+                }
+
                 uint32_t current_instance_count = 1;
 
                 // per drawcall storage buffer
-                uint32_t perdrawcall_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        perdrawcall_dynamic_offset));
+                auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
                 perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *mouth_mesh_node.model_matrix;
                 perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -1849,27 +1768,14 @@ namespace Piccolo
 
                 if (mouth_mesh_node.joint_matrices)
                 {
+                    auto per_drawcall_vertex_blending_allocation =
+                        allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
                     per_drawcall_vertex_blending_dynamic_offset =
-                        roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                        per_drawcall_vertex_blending_dynamic_offset +
-                        sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                    assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                           (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                        per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                     MeshPerdrawcallVertexBlendingStorageBufferObject&
                         per_drawcall_vertex_blending_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                per_drawcall_vertex_blending_dynamic_offset));
+                            *per_drawcall_vertex_blending_allocation.data;
 
                     for (uint32_t j = 0; j < mouth_mesh_node.joint_count; ++j)
                     {
@@ -1951,28 +1857,20 @@ namespace Piccolo
             m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                 m_vulkan_rhi->m_current_command_buffer, body_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+            // drawn as a static mesh when the mesh skinning pass has skinned it
+            if (body_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+            {
+                bindSkinnedVertexBuffers(
+                    m_vulkan_rhi->m_current_command_buffer, body_mesh_node.skinned_vertex_offset, 2);
+            }
+
             uint32_t current_instance_count = 1;
 
             // per drawcall storage buffer
-            uint32_t perdrawcall_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perdrawcall_dynamic_offset));
+            auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+            uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
             perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *body_mesh_node.model_matrix;
             perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -1983,26 +1881,12 @@ namespace Piccolo
 
             if (body_mesh_node.joint_matrices)
             {
-                per_drawcall_vertex_blending_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    per_drawcall_vertex_blending_dynamic_offset +
-                    sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                auto per_drawcall_vertex_blending_allocation =
+                    allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
+                per_drawcall_vertex_blending_dynamic_offset = per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                 MeshPerdrawcallVertexBlendingStorageBufferObject& per_drawcall_vertex_blending_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        per_drawcall_vertex_blending_dynamic_offset));
+                    *per_drawcall_vertex_blending_allocation.data;
 
                 for (uint32_t j = 0; j < body_mesh_node.joint_count; ++j)
                 {
@@ -2078,28 +1962,20 @@ namespace Piccolo
             m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                 m_vulkan_rhi->m_current_command_buffer, hair_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+            // drawn as a static mesh when the mesh skinning pass has skinned it
+            if (hair_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+            {
+                bindSkinnedVertexBuffers(
+                    m_vulkan_rhi->m_current_command_buffer, hair_mesh_node.skinned_vertex_offset, 2);
+            }
+
             uint32_t current_instance_count = 1;
 
             // per drawcall storage buffer
-            uint32_t perdrawcall_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perdrawcall_dynamic_offset));
+            auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+            uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
             perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *hair_mesh_node.model_matrix;
             perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -2110,26 +1986,12 @@ namespace Piccolo
 
             if (hair_mesh_node.joint_matrices)
             {
-                per_drawcall_vertex_blending_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    per_drawcall_vertex_blending_dynamic_offset +
-                    sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                auto per_drawcall_vertex_blending_allocation =
+                    allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
+                per_drawcall_vertex_blending_dynamic_offset = per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                 MeshPerdrawcallVertexBlendingStorageBufferObject& per_drawcall_vertex_blending_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        per_drawcall_vertex_blending_dynamic_offset));
+                    *per_drawcall_vertex_blending_allocation.data;
 
                 for (uint32_t j = 0; j < hair_mesh_node.joint_count; ++j)
                 {
@@ -2205,28 +2067,20 @@ namespace Piccolo
             m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                 m_vulkan_rhi->m_current_command_buffer, hair_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+            // drawn as a static mesh when the mesh skinning pass has skinned it
+            if (hair_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+            {
+                bindSkinnedVertexBuffers(
+                    m_vulkan_rhi->m_current_command_buffer, hair_mesh_node.skinned_vertex_offset, 2);
+            }
+
             uint32_t current_instance_count = 1;
 
             // per drawcall storage buffer
-            uint32_t perdrawcall_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perdrawcall_dynamic_offset));
+            auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+            uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
             perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *hair_mesh_node.model_matrix;
             perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -2237,26 +2091,12 @@ namespace Piccolo
 
             if (hair_mesh_node.joint_matrices)
             {
-                per_drawcall_vertex_blending_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    per_drawcall_vertex_blending_dynamic_offset +
-                    sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                auto per_drawcall_vertex_blending_allocation =
+                    allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
+                per_drawcall_vertex_blending_dynamic_offset = per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                 MeshPerdrawcallVertexBlendingStorageBufferObject& per_drawcall_vertex_blending_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        per_drawcall_vertex_blending_dynamic_offset));
+                    *per_drawcall_vertex_blending_allocation.data;
 
                 for (uint32_t j = 0; j < hair_mesh_node.joint_count; ++j)
                 {
@@ -2332,28 +2172,20 @@ namespace Piccolo
             m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                 m_vulkan_rhi->m_current_command_buffer, eye_black_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+            // drawn as a static mesh when the mesh skinning pass has skinned it
+            if (eye_black_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+            {
+                bindSkinnedVertexBuffers(
+                    m_vulkan_rhi->m_current_command_buffer, eye_black_mesh_node.skinned_vertex_offset, 2);
+            }
+
             uint32_t current_instance_count = 1;
 
             // per drawcall storage buffer
-            uint32_t perdrawcall_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perdrawcall_dynamic_offset));
+            auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+            uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
             perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *eye_black_mesh_node.model_matrix;
             perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -2364,26 +2196,12 @@ namespace Piccolo
 
             if (eye_black_mesh_node.joint_matrices)
             {
-                per_drawcall_vertex_blending_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    per_drawcall_vertex_blending_dynamic_offset +
-                    sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                auto per_drawcall_vertex_blending_allocation =
+                    allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
+                per_drawcall_vertex_blending_dynamic_offset = per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                 MeshPerdrawcallVertexBlendingStorageBufferObject& per_drawcall_vertex_blending_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        per_drawcall_vertex_blending_dynamic_offset));
+                    *per_drawcall_vertex_blending_allocation.data;
 
                 for (uint32_t j = 0; j < eye_black_mesh_node.joint_count; ++j)
                 {
@@ -2427,25 +2245,10 @@ namespace Piccolo
             m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
 
             // perframe storage buffer
-            perframe_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perframe_dynamic_offset + sizeof(NBROutlineMeshPerframeStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-            (*reinterpret_cast<NBROutlineMeshPerframeStorageBufferObject*>(
-                reinterpret_cast<uintptr_t>(
-                    m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                perframe_dynamic_offset)) = m_nbr_outline_mesh_perframe_storage_buffer_object;
+            auto perframe_allocation = allocateUpload<NBROutlineMeshPerframeStorageBufferObject>();
+            perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+            *perframe_allocation.data = m_nbr_outline_mesh_perframe_storage_buffer_object;
 
             if (nbr_mesh_nodes[_nbr_mesh_face].material)
             {
@@ -2500,28 +2303,20 @@ namespace Piccolo
                 m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                     m_vulkan_rhi->m_current_command_buffer, face_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+                // drawn as a static mesh when the mesh skinning pass has skinned it
+                if (face_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+                {
+                    bindSkinnedVertexBuffers(
+                        m_vulkan_rhi->m_current_command_buffer, face_mesh_node.skinned_vertex_offset, 2);
+                }
+
                 uint32_t current_instance_count = 1;
 
                 // per drawcall storage buffer
-                uint32_t perdrawcall_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        perdrawcall_dynamic_offset));
+                auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
                 perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *face_mesh_node.model_matrix;
                 perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -2532,27 +2327,14 @@ namespace Piccolo
 
                 if (face_mesh_node.joint_matrices)
                 {
+                    auto per_drawcall_vertex_blending_allocation =
+                        allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
                     per_drawcall_vertex_blending_dynamic_offset =
-                        roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                        per_drawcall_vertex_blending_dynamic_offset +
-                        sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                    assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                           (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                        per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                     MeshPerdrawcallVertexBlendingStorageBufferObject&
                         per_drawcall_vertex_blending_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                per_drawcall_vertex_blending_dynamic_offset));
+                            *per_drawcall_vertex_blending_allocation.data;
 
                     for (uint32_t j = 0; j < face_mesh_node.joint_count; ++j)
                     {
@@ -2638,28 +2420,20 @@ namespace Piccolo
                 m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                     m_vulkan_rhi->m_current_command_buffer, body_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+                // drawn as a static mesh when the mesh skinning pass has skinned it
+                if (body_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+                {
+                    bindSkinnedVertexBuffers(
+                        m_vulkan_rhi->m_current_command_buffer, body_mesh_node.skinned_vertex_offset, 2);
+                }
+
                 uint32_t current_instance_count = 1;
 
                 // per drawcall storage buffer
-                uint32_t perdrawcall_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        perdrawcall_dynamic_offset));
+                auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
                 perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *body_mesh_node.model_matrix;
                 perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -2670,27 +2444,14 @@ namespace Piccolo
 
                 if (body_mesh_node.joint_matrices)
                 {
+                    auto per_drawcall_vertex_blending_allocation =
+                        allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
                     per_drawcall_vertex_blending_dynamic_offset =
-                        roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                        per_drawcall_vertex_blending_dynamic_offset +
-                        sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                    assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                           (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                        per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                     MeshPerdrawcallVertexBlendingStorageBufferObject&
                         per_drawcall_vertex_blending_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                per_drawcall_vertex_blending_dynamic_offset));
+                            *per_drawcall_vertex_blending_allocation.data;
 
                     for (uint32_t j = 0; j < body_mesh_node.joint_count; ++j)
                     {
@@ -2777,28 +2538,20 @@ namespace Piccolo
                 m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
                     m_vulkan_rhi->m_current_command_buffer, hair_mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
+                // drawn as a static mesh when the mesh skinning pass has skinned it
+                if (hair_mesh_node.skinned_vertex_offset != s_invalid_skinned_vertex_offset)
+                {
+                    bindSkinnedVertexBuffers(
+                        m_vulkan_rhi->m_current_command_buffer, hair_mesh_node.skinned_vertex_offset, 2);
+                }
+
                 uint32_t current_instance_count = 1;
 
                 // per drawcall storage buffer
-                uint32_t perdrawcall_dynamic_offset =
-                    roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                    perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                       (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                    (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                        reinterpret_cast<uintptr_t>(
-                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                        perdrawcall_dynamic_offset));
+                auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
 
                 perdrawcall_storage_buffer_object.mesh_instances[0].model_matrix = *hair_mesh_node.model_matrix;
                 perdrawcall_storage_buffer_object.mesh_instances[0].enable_vertex_blending =
@@ -2809,27 +2562,14 @@ namespace Piccolo
 
                 if (hair_mesh_node.joint_matrices)
                 {
+                    auto per_drawcall_vertex_blending_allocation =
+                        allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
                     per_drawcall_vertex_blending_dynamic_offset =
-                        roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                        per_drawcall_vertex_blending_dynamic_offset +
-                        sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                    assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                           (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                        per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                     MeshPerdrawcallVertexBlendingStorageBufferObject&
                         per_drawcall_vertex_blending_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                per_drawcall_vertex_blending_dynamic_offset));
+                            *per_drawcall_vertex_blending_allocation.data;
 
                     for (uint32_t j = 0; j < hair_mesh_node.joint_count; ++j)
                     {
@@ -19,7 +19,6 @@ namespace Piccolo
 {
     void ParticleEmitterBufferBatch::freeUpBatch(VkDevice device)
     {
-        vkFreeMemory(device, m_counter_host_memory, nullptr);
         vkFreeMemory(device, m_position_host_memory, nullptr);
         vkFreeMemory(device, m_position_device_memory, nullptr);
         vkFreeMemory(device, m_counter_device_memory, nullptr);
@@ -29,46 +28,30 @@ namespace Piccolo
         vkFreeMemory(device, m_dead_list_memory, nullptr);
         vkFreeMemory(device, m_particle_component_res_memory, nullptr);
         vkFreeMemory(device, m_position_render_memory, nullptr);
+        vkFreeMemory(device, m_draw_indirect_argument_memory, nullptr);
 
         vkDestroyBuffer(device, m_particle_storage_buffer, nullptr);
         vkDestroyBuffer(device, m_position_render_buffer, nullptr);
         vkDestroyBuffer(device, m_position_device_buffer, nullptr);
         vkDestroyBuffer(device, m_position_host_buffer, nullptr);
         vkDestroyBuffer(device, m_counter_device_buffer, nullptr);
-        vkDestroyBuffer(device, m_counter_host_buffer, nullptr);
         vkDestroyBuffer(device, m_indirect_dispatch_argument_buffer, nullptr);
         vkDestroyBuffer(device, m_alive_list_buffer, nullptr);
         vkDestroyBuffer(device, m_alive_list_next_buffer, nullptr);
         vkDestroyBuffer(device, m_dead_list_buffer, nullptr);
         vkDestroyBuffer(device, m_particle_component_res_buffer, nullptr);
+        vkDestroyBuffer(device, m_draw_indirect_argument_buffer, nullptr);
     }
 
     void ParticlePass::copyNormalAndDepthImage()
     {
-        uint8_t index = (m_vulkan_rhi->m_current_frame_index + m_vulkan_rhi->s_max_frames_in_flight - 1) %
-                        m_vulkan_rhi->s_max_frames_in_flight;
-
-        if (VK_SUCCESS !=
-            vkWaitForFences(
-                m_vulkan_rhi->m_device, 1, &m_vulkan_rhi->m_is_frame_in_flight_fences[index], VK_TRUE, UINT64_MAX))
-            throw std::runtime_error("wait for fence");
-
-        VkCommandBufferBeginInfo command_buffer_begin_info {};
-        command_buffer_begin_info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        command_buffer_begin_info.flags            = 0;
-        command_buffer_begin_info.pInheritanceInfo = nullptr;
-
-        VkResult res_begin_command_buffer =
-            m_vulkan_rhi->m_vk_begin_command_buffer(m_copy_command_buffer, &command_buffer_begin_info);
-        assert(VK_SUCCESS == res_begin_command_buffer);
-
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
             VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
                                                NULL,
                                                "Copy Depth Image for Particle",
                                                {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_copy_command_buffer, &label_info);
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
         }
 
         // depth image
@@ -85,7 +68,7 @@ namespace Piccolo
             imagememorybarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.image         = m_dst_depth_image;
 
-            vkCmdPipelineBarrier(m_copy_command_buffer,
+            vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -96,13 +79,13 @@ namespace Piccolo
                                  1,
                                  &imagememorybarrier);
 
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
             imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             imagememorybarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
             imagememorybarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
             imagememorybarrier.image         = m_src_depth_image;
 
-            vkCmdPipelineBarrier(m_copy_command_buffer,
+            vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -121,7 +104,7 @@ namespace Piccolo
             imagecopyRegion.extent         = {
                 m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height, 1};
 
-            vkCmdCopyImage(m_copy_command_buffer,
+            vkCmdCopyImage(m_vulkan_rhi->m_current_command_buffer,
                            m_src_depth_image,
                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                            m_dst_depth_image,
@@ -134,7 +117,7 @@ namespace Piccolo
             imagememorybarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
 
-            vkCmdPipelineBarrier(m_copy_command_buffer,
+            vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -151,7 +134,7 @@ namespace Piccolo
             imagememorybarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-            vkCmdPipelineBarrier(m_copy_command_buffer,
+            vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -165,7 +148,7 @@ namespace Piccolo
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_copy_command_buffer);
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
         }
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
@@ -174,7 +157,7 @@ namespace Piccolo
                                                NULL,
                                                "Copy Normal Image for Particle",
                                                {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_copy_command_buffer, &label_info);
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
         }
 
         // color image
@@ -187,7 +170,7 @@ namespace Piccolo
             imagememorybarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.image         = m_dst_normal_image;
 
-            vkCmdPipelineBarrier(m_copy_command_buffer,
+            vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -198,13 +181,13 @@ namespace Piccolo
                                  1,
                                  &imagememorybarrier);
 
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             imagememorybarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
             imagememorybarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
             imagememorybarrier.image         = m_src_normal_image;
 
-            vkCmdPipelineBarrier(m_copy_command_buffer,
+            vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -223,7 +206,7 @@ namespace Piccolo
             imagecopyRegion.extent         = {
                 m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height, 1};
 
-            vkCmdCopyImage(m_copy_command_buffer,
+            vkCmdCopyImage(m_vulkan_rhi->m_current_command_buffer,
                            m_src_normal_image,
                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                            m_dst_normal_image,
@@ -236,7 +219,7 @@ namespace Piccolo
             imagememorybarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
 
-            vkCmdPipelineBarrier(m_copy_command_buffer,
+            vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -253,7 +236,7 @@ namespace Piccolo
             imagememorybarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-            vkCmdPipelineBarrier(m_copy_command_buffer,
+            vkCmdPipelineBarrier(m_vulkan_rhi->m_current_command_buffer,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -267,31 +250,8 @@ namespace Piccolo
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_copy_command_buffer);
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
         }
-
-        VkResult res_end_command_buffer = m_vulkan_rhi->m_vk_end_command_buffer(m_copy_command_buffer);
-        assert(VK_SUCCESS == res_end_command_buffer);
-
-        VkResult res_reset_fences = m_vulkan_rhi->m_vk_reset_fences(
-            m_vulkan_rhi->m_device, 1, &m_vulkan_rhi->m_is_frame_in_flight_fences[index]);
-        assert(VK_SUCCESS == res_reset_fences);
-
-        VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        VkSubmitInfo         submit_info   = {};
-        submit_info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount     = 1;
-        submit_info.pWaitSemaphores        = &m_vulkan_rhi->m_image_available_for_texturescopy_semaphores[index];
-        submit_info.pWaitDstStageMask      = wait_stages;
-        submit_info.commandBufferCount     = 1;
-        submit_info.pCommandBuffers        = &m_copy_command_buffer;
-        submit_info.signalSemaphoreCount   = 0;
-        submit_info.pSignalSemaphores      = nullptr;
-        VkResult res_queue_submit          = vkQueueSubmit(
-            m_vulkan_rhi->m_graphics_queue, 1, &submit_info, m_vulkan_rhi->m_is_frame_in_flight_fences[index]);
-        assert(VK_SUCCESS == res_queue_submit);
-
-        vkQueueWaitIdle(m_vulkan_rhi->m_graphics_queue);
     }
 
     void ParticlePass::updateAfterFramebufferRecreate()
@@ -350,6 +310,11 @@ namespace Piccolo
 
     void ParticlePass::draw()
     {
+        auto     perframe_allocation     = allocateUpload<ParticleBillboardPerframeStorageBufferObject>();
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+        *perframe_allocation.data = m_particlebillboard_perframe_storage_buffer_object;
+
         for (int i = 0; i < m_emitter_count; ++i)
         {
             if (m_vulkan_rhi->isDebugLabelEnabled())
@@ -364,13 +329,13 @@ namespace Piccolo
             VkViewport viewport {};
             viewport.x        = 0.0f;
             viewport.y        = 0.0f;
-            viewport.width    = m_vulkan_rhi->m_swapchain_extent.width;
-            viewport.height   = m_vulkan_rhi->m_swapchain_extent.height;
+            viewport.width    = m_vulkan_rhi->m_scene_extent.width;
+            viewport.height   = m_vulkan_rhi->m_scene_extent.height;
             viewport.minDepth = 0.0f;
             viewport.maxDepth = 1.0f;
             VkRect2D scissor {};
             scissor.offset = {0, 0};
-            scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height};
+            scissor.extent = {m_vulkan_rhi->m_scene_extent.width, m_vulkan_rhi->m_scene_extent.height};
             m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &viewport);
             m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
 
@@ -380,10 +345,15 @@ namespace Piccolo
                                                         0,
                                                         1,
                                                         &m_descriptor_infos[i * 3 + 2].descriptor_set,
-                                                        0,
-                                                        nullptr);
+                                                        1,
+                                                        &perframe_dynamic_offset);
 
-            vkCmdDraw(m_render_command_buffer, 4, m_emitter_buffer_batches[i].m_num_particle, 0, 0);
+            // the instance count is the alive particle count written by the simulation of the previous frame
+            vkCmdDrawIndirect(m_render_command_buffer,
+                              m_emitter_buffer_batches[i].m_draw_indirect_argument_buffer,
+                              0,
+                              1,
+                              sizeof(VkDrawIndirectCommand));
 
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
@@ -486,8 +456,9 @@ namespace Piccolo
 
             VkDescriptorBufferInfo particlebillboard_perframe_storage_buffer_info = {};
             particlebillboard_perframe_storage_buffer_info.offset                 = 0;
-            particlebillboard_perframe_storage_buffer_info.range                  = VK_WHOLE_SIZE;
-            particlebillboard_perframe_storage_buffer_info.buffer                 = m_particle_billboard_uniform_buffer;
+            particlebillboard_perframe_storage_buffer_info.range = sizeof(ParticleBillboardPerframeStorageBufferObject);
+            particlebillboard_perframe_storage_buffer_info.buffer =
+                m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
 
             VkDescriptorBufferInfo particlebillboard_perdrawcall_storage_buffer_info = {};
             particlebillboard_perdrawcall_storage_buffer_info.offset                 = 0;
@@ -502,7 +473,7 @@ namespace Piccolo
             particlebillboard_descriptor_writes_info[0].dstSet     = m_descriptor_infos[eid * 3 + 2].descriptor_set;
             particlebillboard_descriptor_writes_info[0].dstBinding = 0;
             particlebillboard_descriptor_writes_info[0].dstArrayElement = 0;
-            particlebillboard_descriptor_writes_info[0].descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            particlebillboard_descriptor_writes_info[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
             particlebillboard_descriptor_writes_info[0].descriptorCount = 1;
             particlebillboard_descriptor_writes_info[0].pBufferInfo = &particlebillboard_perframe_storage_buffer_info;
 
@@ -557,6 +528,9 @@ namespace Piccolo
 
     void ParticlePass::setEmitterCount(int count)
     {
+        // the emitters are only set up on level loading, the frames in flight may still use the old buffers
+        vkDeviceWaitIdle(m_vulkan_rhi->m_device);
+
         for (int i = 0; i < m_emitter_buffer_batches.size(); ++i)
         {
             m_emitter_buffer_batches[i].freeUpBatch(m_vulkan_rhi->m_device);
@@ -600,6 +574,20 @@ namespace Piccolo
                                                   &indirectargument,
                                                   indirectArgumentSize);
 
+            VkDrawIndirectCommand drawargument = {};
+            drawargument.vertexCount           = 4;
+            drawargument.instanceCount         = m_emitter_buffer_batches[id].m_num_particle;
+            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
+                                                  m_vulkan_rhi->m_physical_device,
+                                                  VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                  &m_emitter_buffer_batches[id].m_draw_indirect_argument_buffer,
+                                                  &m_emitter_buffer_batches[id].m_draw_indirect_argument_memory,
+                                                  sizeof(VkDrawIndirectCommand),
+                                                  &drawargument,
+                                                  sizeof(VkDrawIndirectCommand));
+
             const VkDeviceSize aliveListSize = 4 * sizeof(uint32_t) * s_max_particles;
             std::vector<int>   aliveindices(s_max_particles * 4, 0);
             for (int i = 0; i < s_max_particles; ++i)
@@ -640,13 +628,15 @@ namespace Piccolo
         VkFence         fence;
         ParticleCounter counterNext {};
         {
-
+            // the counter is only uploaded once, the staging buffer is freed after the copy
+            VkBuffer       counterStagingBuffer;
+            VkDeviceMemory counterStagingMemory;
             VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
                                                   m_vulkan_rhi->m_physical_device,
                                                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                                  &m_emitter_buffer_batches[id].m_counter_host_buffer,
-                                                  &m_emitter_buffer_batches[id].m_counter_host_memory,
+                                                  &counterStagingBuffer,
+                                                  &counterStagingMemory,
                                                   counterBufferSize,
                                                   &counter,
                                                   sizeof(counter));
@@ -655,18 +645,18 @@ namespace Piccolo
             void* mapped;
 
             vkMapMemory(m_vulkan_rhi->m_device,
-                        m_emitter_buffer_batches[id].m_counter_host_memory,
+                        counterStagingMemory,
                         0,
                         VK_WHOLE_SIZE,
                         0,
                         &mapped);
             VkMappedMemoryRange mappedRange {};
             mappedRange.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-            mappedRange.memory = m_emitter_buffer_batches[id].m_counter_host_memory;
+            mappedRange.memory = counterStagingMemory;
             mappedRange.offset = 0;
             mappedRange.size   = VK_WHOLE_SIZE;
             vkFlushMappedMemoryRanges(m_vulkan_rhi->m_device, 1, &mappedRange);
-            vkUnmapMemory(m_vulkan_rhi->m_device, m_emitter_buffer_batches[id].m_counter_host_memory);
+            vkUnmapMemory(m_vulkan_rhi->m_device, counterStagingMemory);
 
             VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
                                                   m_vulkan_rhi->m_physical_device,
@@ -700,7 +690,7 @@ namespace Piccolo
             VkBufferCopy copyRegion = {};
             copyRegion.size         = counterBufferSize;
             vkCmdCopyBuffer(copyCmd,
-                            m_emitter_buffer_batches[id].m_counter_host_buffer,
+                            counterStagingBuffer,
                             m_emitter_buffer_batches[id].m_counter_device_buffer,
                             1,
                             &copyRegion);
@@ -733,6 +723,8 @@ namespace Piccolo
 
             vkDestroyFence(m_vulkan_rhi->m_device, fence, nullptr);
             vkFreeCommandBuffers(m_vulkan_rhi->m_device, m_vulkan_rhi->m_command_pool, 1, &copyCmd);
+            vkDestroyBuffer(m_vulkan_rhi->m_device, counterStagingBuffer, nullptr);
+            vkFreeMemory(m_vulkan_rhi->m_device, counterStagingMemory, nullptr);
         }
 
         const VkDeviceSize staggingBuferSize        = s_max_particles * sizeof(Particle);
@@ -742,7 +734,7 @@ namespace Piccolo
         {
             VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
                                                   m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                                                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                                                   &m_emitter_buffer_batches[id].m_particle_component_res_buffer,
@@ -751,16 +743,6 @@ namespace Piccolo
                                                   &m_emitter_buffer_batches[id].m_emitter_desc,
                                                   sizeof(ParticleEmitterDesc));
 
-            if (VK_SUCCESS != vkMapMemory(m_vulkan_rhi->m_device,
-                                          m_emitter_buffer_batches[id].m_particle_component_res_memory,
-                                          0,
-                                          VK_WHOLE_SIZE,
-                                          0,
-                                          &m_emitter_buffer_batches[id].m_emitter_desc_mapped))
-            {
-                throw std::runtime_error("map emitter component res buffer");
-            }
-
             VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
                                                   m_vulkan_rhi->m_physical_device,
                                                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
@@ -876,22 +858,42 @@ namespace Piccolo
         setupPipelines();
         setupAttachments();
 
+        const uint32_t frames_in_flight = m_vulkan_rhi->s_max_frames_in_flight;
+
+        m_compute_command_buffers.resize(frames_in_flight);
         VkCommandBufferAllocateInfo cmdBufAllocateInfo {};
         cmdBufAllocateInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         cmdBufAllocateInfo.commandPool        = m_vulkan_rhi->m_command_pool;
         cmdBufAllocateInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        cmdBufAllocateInfo.commandBufferCount = 1;
+        cmdBufAllocateInfo.commandBufferCount = frames_in_flight;
         if (VK_SUCCESS !=
-            vkAllocateCommandBuffers(m_vulkan_rhi->m_device, &cmdBufAllocateInfo, &m_compute_command_buffer))
+            vkAllocateCommandBuffers(m_vulkan_rhi->m_device, &cmdBufAllocateInfo, m_compute_command_buffers.data()))
             throw std::runtime_error("alloc compute command buffer");
-        if (VK_SUCCESS != vkAllocateCommandBuffers(m_vulkan_rhi->m_device, &cmdBufAllocateInfo, &m_copy_command_buffer))
-            throw std::runtime_error("alloc copyt command buffer");
 
         VkFenceCreateInfo fenceCreateInfo {};
         fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = 0;
-        if (VK_SUCCESS != vkCreateFence(m_vulkan_rhi->m_device, &fenceCreateInfo, nullptr, &m_fence))
-            throw std::runtime_error("create fence");
+        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo {};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        m_compute_fences.resize(frames_in_flight);
+        m_depth_and_normal_copied_semaphores.resize(frames_in_flight);
+        m_simulation_finished_semaphores.resize(frames_in_flight);
+        for (uint32_t i = 0; i < frames_in_flight; ++i)
+        {
+            if (VK_SUCCESS != vkCreateFence(m_vulkan_rhi->m_device, &fenceCreateInfo, nullptr, &m_compute_fences[i]))
+                throw std::runtime_error("create fence");
+            if (VK_SUCCESS != vkCreateSemaphore(m_vulkan_rhi->m_device,
+                                                &semaphoreCreateInfo,
+                                                nullptr,
+                                                &m_depth_and_normal_copied_semaphores[i]) ||
+                VK_SUCCESS != vkCreateSemaphore(m_vulkan_rhi->m_device,
+                                                &semaphoreCreateInfo,
+                                                nullptr,
+                                                &m_simulation_finished_semaphores[i]))
+                throw std::runtime_error("create semaphore");
+        }
     }
 
     void ParticlePass::initialize(const RenderPassInitInfo* init_info)
@@ -1055,7 +1057,7 @@ namespace Piccolo
                 particlebillboard_global_layout_bindings[0];
             particlebillboard_global_layout_perframe_storage_buffer_binding.binding = 0;
             particlebillboard_global_layout_perframe_storage_buffer_binding.descriptorType =
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
             particlebillboard_global_layout_perframe_storage_buffer_binding.descriptorCount = 1;
             particlebillboard_global_layout_perframe_storage_buffer_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
             particlebillboard_global_layout_perframe_storage_buffer_binding.pImmutableSamplers = NULL;
@@ -1115,15 +1117,6 @@ namespace Piccolo
             LOG_INFO("compute pipe layout done");
         }
 
-        VkPipelineCache           pipelineCache;
-        VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
-        pipelineCacheCreateInfo.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-        if (VK_SUCCESS !=
-            vkCreatePipelineCache(m_vulkan_rhi->m_device, &pipelineCacheCreateInfo, nullptr, &pipelineCache))
-        {
-            throw std::runtime_error("create particle cache");
-        }
-
         struct SpecializationData
         {
             uint32_t BUFFER_ELEMENT_COUNT = 32;
@@ -1159,7 +1152,7 @@ namespace Piccolo
             computePipelineCreateInfo.stage = shaderStage;
             if (VK_SUCCESS !=
                 vkCreateComputePipelines(
-                    m_vulkan_rhi->m_device, pipelineCache, 1, &computePipelineCreateInfo, nullptr, &m_kickoff_pipeline))
+                    m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &computePipelineCreateInfo, nullptr, &m_kickoff_pipeline))
             {
                 throw std::runtime_error("create particle kickoff pipe");
             }
@@ -1173,7 +1166,7 @@ namespace Piccolo
             computePipelineCreateInfo.stage = shaderStage;
             if (VK_SUCCESS !=
                 vkCreateComputePipelines(
-                    m_vulkan_rhi->m_device, pipelineCache, 1, &computePipelineCreateInfo, nullptr, &m_emit_pipeline))
+                    m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &computePipelineCreateInfo, nullptr, &m_emit_pipeline))
             {
                 throw std::runtime_error("create particle emit pipe");
             }
@@ -1186,7 +1179,7 @@ namespace Piccolo
 
             computePipelineCreateInfo.stage = shaderStage;
             if (VK_SUCCESS != vkCreateComputePipelines(m_vulkan_rhi->m_device,
-                                                       pipelineCache,
+                                                       m_vulkan_rhi->m_pipeline_cache,
                                                        1,
                                                        &computePipelineCreateInfo,
                                                        nullptr,
@@ -1324,7 +1317,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1613,41 +1606,49 @@ namespace Piccolo
 
     void ParticlePass::simulate()
     {
-        for (auto i : m_emitter_tick_indices)
+        const uint8_t   index          = m_vulkan_rhi->m_current_frame_index;
+        VkCommandBuffer command_buffer = m_compute_command_buffers[index];
+
+        // the command buffer was submitted frames in flight ago, the billboards of the frame after it have already
+        // waited for it, so this does not stall
+        if (VK_SUCCESS != vkWaitForFences(m_vulkan_rhi->m_device, 1, &m_compute_fences[index], VK_TRUE, UINT64_MAX))
         {
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {
-                    VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particlecompute", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
-            }
+            throw std::runtime_error("wait for fence");
+        }
+        vkResetFences(m_vulkan_rhi->m_device, 1, &m_compute_fences[index]);
 
-            VkCommandBufferBeginInfo cmdBufInfo {};
-            cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        VkCommandBufferBeginInfo cmdBufInfo {};
+        cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        // particle compute pass
+        if (VK_SUCCESS != vkBeginCommandBuffer(command_buffer, &cmdBufInfo))
+        {
+            throw std::runtime_error("begin command buffer");
+        }
 
-            VkSubmitInfo computeSubmitInfo {};
-            computeSubmitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask  = 0;
-            computeSubmitInfo.commandBufferCount = 1;
-            computeSubmitInfo.pCommandBuffers    = &m_compute_command_buffer;
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particlecompute", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
+        }
 
-            // particle compute pass
-            if (VK_SUCCESS != vkBeginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
-            {
-                throw std::runtime_error("begin command buffer");
-            }
+        recordUniformBufferUpdate(command_buffer);
 
+        for (auto i : m_emitter_tick_indices)
+        {
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
                 VkDebugUtilsLabelEXT label_info = {
                     VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Kickoff", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
+                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
             }
 
-            vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
             VkDescriptorSet descriptorsets[2] = {m_descriptor_infos[i * 3].descriptor_set,
                                                  m_descriptor_infos[i * 3 + 1].descriptor_set};
-            vkCmdBindDescriptorSets(m_compute_command_buffer,
+            vkCmdBindDescriptorSets(command_buffer,
                                     VK_PIPELINE_BIND_POINT_COMPUTE,
                                     m_render_pipelines[0].layout,
                                     0,
@@ -1655,11 +1656,11 @@ namespace Piccolo
                                     descriptorsets,
                                     0,
                                     0);
-            vkCmdDispatch(m_compute_command_buffer, 1, 1, 1);
+            vkCmdDispatch(command_buffer, 1, 1, 1);
 
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
+                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
             }
 
             VkBufferMemoryBarrier bufferBarrier {};
@@ -1671,7 +1672,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -1689,7 +1690,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -1704,17 +1705,17 @@ namespace Piccolo
             {
                 VkDebugUtilsLabelEXT label_info = {
                     VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Emit", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
+                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
             }
 
-            vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_emit_pipeline);
-            vkCmdDispatchIndirect(m_compute_command_buffer,
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_emit_pipeline);
+            vkCmdDispatchIndirect(command_buffer,
                                   m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
                                   s_argument_offset_emit);
 
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
+                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
             }
 
             bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_position_device_buffer;
@@ -1724,7 +1725,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -1742,7 +1743,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -1760,7 +1761,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -1778,7 +1779,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -1796,7 +1797,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -1814,7 +1815,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                  0,
@@ -1829,53 +1830,20 @@ namespace Piccolo
             {
                 VkDebugUtilsLabelEXT label_info = {
                     VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Simulate", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
+                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
             }
 
-            vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_simulate_pipeline);
-            vkCmdDispatchIndirect(m_compute_command_buffer,
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_simulate_pipeline);
+            vkCmdDispatchIndirect(command_buffer,
                                   m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
                                   s_argument_offset_simulate);
 
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
-            }
-
-            if (VK_SUCCESS != vkEndCommandBuffer(m_compute_command_buffer))
-            {
-                throw std::runtime_error("end command buffer");
-            }
-            vkResetFences(m_vulkan_rhi->m_device, 1, &m_fence);
-            computeSubmitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask  = 0;
-            computeSubmitInfo.commandBufferCount = 1;
-            computeSubmitInfo.pCommandBuffers    = &m_compute_command_buffer;
-            if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &computeSubmitInfo, m_fence))
-            {
-                throw std::runtime_error("compute queue submit");
-            }
-
-            if (VK_SUCCESS != vkWaitForFences(m_vulkan_rhi->m_device, 1, &m_fence, VK_TRUE, UINT64_MAX))
-            {
-                throw std::runtime_error("wait for fence");
-            }
-
-            if (VK_SUCCESS != vkBeginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
-            {
-                throw std::runtime_error("begin command buffer");
-            }
-
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
-                                                   NULL,
-                                                   "Copy Particle Counter Buffer",
-                                                   {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
+                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
             }
 
-            // Barrier to ensure that shader writes are finished before buffer is read back from GPU
+            // the billboards of the next frame draw as many instances as there are particles alive after the simulation
             bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
             bufferBarrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
             bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_device_buffer;
@@ -1883,7 +1851,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
+            vkCmdPipelineBarrier(command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  VK_PIPELINE_STAGE_TRANSFER_BIT,
                                  0,
@@ -1893,128 +1861,120 @@ namespace Piccolo
                                  &bufferBarrier,
                                  0,
                                  nullptr);
-            // Read back to host visible buffer
+
             VkBufferCopy copyRegion = {};
-            copyRegion.size         = sizeof(ParticleCounter);
-            vkCmdCopyBuffer(m_compute_command_buffer,
+            copyRegion.srcOffset    = offsetof(ParticleCounter, alive_count_after_sim);
+            copyRegion.dstOffset    = offsetof(VkDrawIndirectCommand, instanceCount);
+            copyRegion.size         = sizeof(uint32_t);
+            vkCmdCopyBuffer(command_buffer,
                             m_emitter_buffer_batches[i].m_counter_device_buffer,
-                            m_emitter_buffer_batches[i].m_counter_host_buffer,
+                            m_emitter_buffer_batches[i].m_draw_indirect_argument_buffer,
                             1,
                             &copyRegion);
+        }
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
-            }
-
-            // Barrier to ensure that buffer copy is finished before host reading from it
-            bufferBarrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_HOST_READ_BIT;
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_host_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_HOST_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
-            if (VK_SUCCESS != vkEndCommandBuffer(m_compute_command_buffer))
-            {
-                throw std::runtime_error("end command buffer");
-            }
-
-            // Submit compute work
-            vkResetFences(m_vulkan_rhi->m_device, 1, &m_fence);
-            computeSubmitInfo                        = {};
-            const VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            computeSubmitInfo.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask      = &waitStageMask;
-            computeSubmitInfo.commandBufferCount     = 1;
-            computeSubmitInfo.pCommandBuffers        = &m_compute_command_buffer;
-            if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &computeSubmitInfo, m_fence))
-            {
-                throw std::runtime_error("compute queue submit");
-            }
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
+        }
 
-            if (VK_SUCCESS != vkWaitForFences(m_vulkan_rhi->m_device, 1, &m_fence, VK_TRUE, UINT64_MAX))
-            {
-                throw std::runtime_error("wait for fence");
-            }
+        if (VK_SUCCESS != vkEndCommandBuffer(command_buffer))
+        {
+            throw std::runtime_error("end command buffer");
+        }
 
-            vkQueueWaitIdle(m_vulkan_rhi->m_compute_queue);
+        // submitted every frame, even without ticked emitters, to keep the semaphores of the frames chained. the
+        // simulation reads the depth and normal images copied by the graphics submit of this frame, and the one of
+        // the next frame waits for it before copying them again and drawing the billboards
+        const VkPipelineStageFlags waitStageMask =
+            VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        VkSubmitInfo computeSubmitInfo {};
+        computeSubmitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        computeSubmitInfo.waitSemaphoreCount   = 1;
+        computeSubmitInfo.pWaitSemaphores      = &m_depth_and_normal_copied_semaphores[index];
+        computeSubmitInfo.pWaitDstStageMask    = &waitStageMask;
+        computeSubmitInfo.commandBufferCount   = 1;
+        computeSubmitInfo.pCommandBuffers      = &command_buffer;
+        computeSubmitInfo.signalSemaphoreCount = 1;
+        computeSubmitInfo.pSignalSemaphores    = &m_simulation_finished_semaphores[index];
+        if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &computeSubmitInfo, m_compute_fences[index]))
+        {
+            throw std::runtime_error("compute queue submit");
+        }
+        m_pending_simulation_finished_semaphore = m_simulation_finished_semaphores[index];
 
-            // Make device writes visible to the host
-            void* mapped;
-            vkMapMemory(m_vulkan_rhi->m_device,
-                        m_emitter_buffer_batches[i].m_counter_host_memory,
-                        0,
-                        VK_WHOLE_SIZE,
-                        0,
-                        &mapped);
-            VkMappedMemoryRange mappedRange {};
-            mappedRange.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-            mappedRange.memory = m_emitter_buffer_batches[i].m_counter_host_memory;
-            mappedRange.offset = 0;
-            mappedRange.size   = VK_WHOLE_SIZE;
-            vkInvalidateMappedMemoryRanges(m_vulkan_rhi->m_device, 1, &mappedRange);
+        m_emitter_tick_indices.clear();
+    }
 
-            // Copy to output
-            ParticleCounter counterNext {};
-            memcpy(&counterNext, mapped, sizeof(ParticleCounter));
-            vkUnmapMemory(m_vulkan_rhi->m_device, m_emitter_buffer_batches[i].m_counter_host_memory);
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
-            }
-            if constexpr (s_verbose_particle_alive_info)
-                LOG_INFO("{} {} {} {}",
-                         counterNext.dead_count,
-                         counterNext.alive_count,
-                         counterNext.alive_count_after_sim,
-                         counterNext.emit_count);
-            m_emitter_buffer_batches[i].m_num_particle = counterNext.alive_count_after_sim;
+    void ParticlePass::recordUniformBufferUpdate(VkCommandBuffer command_buffer)
+    {
+        // the previous simulation is done with the buffers before they are updated
+        VkMemoryBarrier memoryBarrier {};
+        memoryBarrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask =
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0,
+                             1,
+                             &memoryBarrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        vkCmdUpdateBuffer(command_buffer, m_compute_uniform_buffer, 0, sizeof(m_ubo), &m_ubo);
+        vkCmdUpdateBuffer(command_buffer,
+                          m_scene_uniform_buffer,
+                          0,
+                          sizeof(ParticleCollisionPerframeStorageBufferObject),
+                          &m_particle_collision_perframe_storage_buffer_object);
+        for (ParticleEmitterTransformDesc& transform_desc : m_emitter_transform_indices)
+        {
+            ParticleEmitterBufferBatch& batch = m_emitter_buffer_batches[transform_desc.m_id];
+            vkCmdUpdateBuffer(command_buffer,
+                              batch.m_particle_component_res_buffer,
+                              0,
+                              sizeof(ParticleEmitterDesc),
+                              &batch.m_emitter_desc);
         }
-        m_emitter_tick_indices.clear();
         m_emitter_transform_indices.clear();
+
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0,
+                             1,
+                             &memoryBarrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
     }
 
     void ParticlePass::prepareUniformBuffer()
     {
+        // updated by the simulation command buffers
         VkDeviceMemory d_mem;
         VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
                                  m_vulkan_rhi->m_device,
                                  sizeof(m_particle_collision_perframe_storage_buffer_object),
-                                 VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                                  m_scene_uniform_buffer,
                                  d_mem);
-        if (VK_SUCCESS !=
-            vkMapMemory(m_vulkan_rhi->m_device, d_mem, 0, VK_WHOLE_SIZE, 0, &m_scene_uniform_buffer_mapped))
-        {
-            throw std::runtime_error("map billboard uniform buffer");
-        }
         VkDeviceMemory d_uniformdmemory;
         VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
                                               m_vulkan_rhi->m_physical_device,
-                                              VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                                  VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                              VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                                               &m_compute_uniform_buffer,
                                               &d_uniformdmemory,
                                               sizeof(m_ubo));
-        if (VK_SUCCESS !=
-            vkMapMemory(
-                m_vulkan_rhi->m_device, d_uniformdmemory, 0, VK_WHOLE_SIZE, 0, &m_particle_compute_buffer_mapped))
-        {
-            throw std::runtime_error("map buffer");
-        }
 
         const GlobalParticleRes& global_res = m_particle_manager->getGlobalParticleRes();
 
@@ -2038,25 +1998,6 @@ namespace Piccolo
         m_ubo.viewport.w  = m_viewport_params.height;
         m_ubo.extent.x    = m_vulkan_rhi->m_scissor.extent.width;
         m_ubo.extent.y    = m_vulkan_rhi->m_scissor.extent.height;
-
-        memcpy(m_particle_compute_buffer_mapped, &m_ubo, sizeof(m_ubo));
-
-        {
-            VkDeviceMemory d_mem;
-            VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
-                                     m_vulkan_rhi->m_device,
-                                     sizeof(m_particlebillboard_perframe_storage_buffer_object),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                     m_particle_billboard_uniform_buffer,
-                                     d_mem);
-            if (VK_SUCCESS !=
-                vkMapMemory(
-                    m_vulkan_rhi->m_device, d_mem, 0, VK_WHOLE_SIZE, 0, &m_particle_billboard_uniform_buffer_mapped))
-            {
-                throw std::runtime_error("map billboard uniform buffer");
-            }
-        }
     }
 
     void ParticlePass::updateEmitterTransform()
@@ -2066,10 +2007,6 @@ namespace Piccolo
             int index                                                 = transform_desc.m_id;
             m_emitter_buffer_batches[index].m_emitter_desc.m_position = transform_desc.m_position;
             m_emitter_buffer_batches[index].m_emitter_desc.m_rotation = transform_desc.m_rotation;
-
-            memcpy(m_emitter_buffer_batches[index].m_emitter_desc_mapped,
-                   &m_emitter_buffer_batches[index].m_emitter_desc,
-                   sizeof(ParticleEmitterDesc));
         }
     }
 
@@ -2083,16 +2020,21 @@ namespace Piccolo
         float rnd2 = m_random_engine.uniformDistribution<float>(0, 1000) * 0.001f;
         m_ubo.pack = Vector4 {rnd0, rnd1, rnd2, static_cast<float>(m_vulkan_rhi->m_current_frame_index)};
 
-        m_ubo.viewport.x = m_vulkan_rhi->m_viewport.x;
-        m_ubo.viewport.y = m_vulkan_rhi->m_viewport.y;
-        m_ubo.viewport.z = m_vulkan_rhi->m_viewport.width;
-        m_ubo.viewport.w = m_vulkan_rhi->m_viewport.height;
+        // the depth is rendered into the top left scene extent of its swapchain sized image
+        const float render_scale_x =
+            static_cast<float>(m_vulkan_rhi->m_scene_extent.width) / m_vulkan_rhi->m_swapchain_extent.width;
+        const float render_scale_y =
+            static_cast<float>(m_vulkan_rhi->m_scene_extent.height) / m_vulkan_rhi->m_swapchain_extent.height;
+
+        m_ubo.viewport.x = m_vulkan_rhi->m_viewport.x * render_scale_x;
+        m_ubo.viewport.y = m_vulkan_rhi->m_viewport.y * render_scale_y;
+        m_ubo.viewport.z = m_vulkan_rhi->m_viewport.width * render_scale_x;
+        m_ubo.viewport.w = m_vulkan_rhi->m_viewport.height * render_scale_y;
         m_ubo.extent.x   = m_vulkan_rhi->m_scissor.extent.width;
         m_ubo.extent.y   = m_vulkan_rhi->m_scissor.extent.height;
 
         m_ubo.extent.z = g_runtime_global_context.m_render_system->getRenderCamera()->m_znear;
         m_ubo.extent.w = g_runtime_global_context.m_render_system->getRenderCamera()->m_zfar;
-        memcpy(m_particle_compute_buffer_mapped, &m_ubo, sizeof(m_ubo));
     }
 
     void ParticlePass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
@@ -2102,15 +2044,9 @@ namespace Piccolo
         {
             m_particle_collision_perframe_storage_buffer_object =
                 vulkan_resource->m_particle_collision_perframe_storage_buffer_object;
-            memcpy(m_scene_uniform_buffer_mapped,
-                   &m_particle_collision_perframe_storage_buffer_object,
-                   sizeof(ParticleCollisionPerframeStorageBufferObject));
 
             m_particlebillboard_perframe_storage_buffer_object =
                 vulkan_resource->m_particlebillboard_perframe_storage_buffer_object;
-            memcpy(m_particle_billboard_uniform_buffer_mapped,
-                   &m_particlebillboard_perframe_storage_buffer_object,
-                   sizeof(m_particlebillboard_perframe_storage_buffer_object));
 
             m_viewport_params = m_vulkan_rhi->m_viewport;
             updateUniformBuffer();
@@ -2131,6 +2067,13 @@ namespace Piccolo
 
     void ParticlePass::setRenderPassHandle(VkRenderPass render_pass) { m_render_pass = render_pass; }
 
+    VkSemaphore ParticlePass::getDepthAndNormalCopiedSemaphore() const
+    {
+        return m_depth_and_normal_copied_semaphores[m_vulkan_rhi->m_current_frame_index];
+    }
+
+    VkSemaphore ParticlePass::getSimulationFinishedSemaphore() const { return m_pending_simulation_finished_semaphore; }
+
     void ParticlePass::setTickIndices(const std::vector<ParticleEmitterID>& tick_indices)
     {
         m_emitter_tick_indices = tick_indices;
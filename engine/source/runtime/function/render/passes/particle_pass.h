@@ -20,14 +20,13 @@ namespace Piccolo
         VkBuffer m_position_device_buffer;
         VkBuffer m_position_host_buffer;
         VkBuffer m_counter_device_buffer;
-        VkBuffer m_counter_host_buffer;
         VkBuffer m_indirect_dispatch_argument_buffer;
         VkBuffer m_alive_list_buffer;
         VkBuffer m_alive_list_next_buffer;
         VkBuffer m_dead_list_buffer;
         VkBuffer m_particle_component_res_buffer;
+        VkBuffer m_draw_indirect_argument_buffer;
 
-        VkDeviceMemory m_counter_host_memory;
         VkDeviceMemory m_position_host_memory;
         VkDeviceMemory m_position_device_memory;
         VkDeviceMemory m_counter_device_memory;
@@ -37,8 +36,7 @@ namespace Piccolo
         VkDeviceMemory m_dead_list_memory;
         VkDeviceMemory m_particle_component_res_memory;
         VkDeviceMemory m_position_render_memory;
-
-        void* m_emitter_desc_mapped {nullptr};
+        VkDeviceMemory m_draw_indirect_argument_memory;
 
         ParticleEmitterDesc m_emitter_desc;
 
@@ -55,10 +53,21 @@ namespace Piccolo
 
         void draw() override final;
 
+        // submits the simulation of the ticked emitters to the compute queue after the graphics submit of the frame,
+        // the billboards of the next frame draw its result
         void simulate();
 
+        // records the copy of the depth and normal images the simulation collides against into the current command
+        // buffer, after the main camera pass
         void copyNormalAndDepthImage();
 
+        // the graphics submit of the frame signals this one for the simulation to wait on
+        VkSemaphore getDepthAndNormalCopiedSemaphore() const;
+
+        // the graphics submit of the frame waits on this one before the copy and the billboards, VK_NULL_HANDLE
+        // before the first simulation
+        VkSemaphore getSimulationFinishedSemaphore() const;
+
         void setDepthAndNormalImage(VkImage depth_image, VkImage normal_image);
 
         void setupParticlePass();
@@ -82,6 +91,10 @@ namespace Piccolo
     private:
         void updateUniformBuffer();
 
+        // the simulation of the previous frame may still read the uniform buffers, so they are updated in order on
+        // the compute queue
+        void recordUniformBufferUpdate(VkCommandBuffer command_buffer);
+
         void updateEmitterTransform();
 
         void setupAttachments();
@@ -102,18 +115,20 @@ namespace Piccolo
         VkPipeline m_emit_pipeline;
         VkPipeline m_simulate_pipeline;
 
-        VkCommandBuffer m_compute_command_buffer;
         VkCommandBuffer m_render_command_buffer;
-        VkCommandBuffer m_copy_command_buffer;
+
+        // the simulation runs one frame ahead of the billboards, so every frame in flight has its own command buffer
+        std::vector<VkCommandBuffer> m_compute_command_buffers;
+        std::vector<VkFence>         m_compute_fences;
+        std::vector<VkSemaphore>     m_depth_and_normal_copied_semaphores;
+        std::vector<VkSemaphore>     m_simulation_finished_semaphores;
+        VkSemaphore                  m_pending_simulation_finished_semaphore {VK_NULL_HANDLE};
 
         VkBuffer m_scene_uniform_buffer;
         VkBuffer m_compute_uniform_buffer;
-        VkBuffer m_particle_billboard_uniform_buffer;
 
         VkViewport m_viewport_params;
 
-        VkFence m_fence;
-
         VkImage        m_src_depth_image;
         VkImage        m_dst_normal_image;
         VkImage        m_src_normal_image;
@@ -139,10 +154,6 @@ namespace Piccolo
         ParticleBillboardPerframeStorageBufferObject m_particlebillboard_perframe_storage_buffer_object;
         ParticleCollisionPerframeStorageBufferObject m_particle_collision_perframe_storage_buffer_object;
 
-        void* m_particle_compute_buffer_mapped {nullptr};
-        void* m_particle_billboard_uniform_buffer_mapped {nullptr};
-        void* m_scene_uniform_buffer_mapped {nullptr};
-
         struct uvec4
         {
             uint32_t x;
@@ -54,16 +54,27 @@ namespace Piccolo
         VkViewport viewport {};
         viewport.x        = 0.0f;
         viewport.y        = 0.0f;
-        viewport.width    = m_vulkan_rhi->m_swapchain_extent.width/4;
-        viewport.height   = m_vulkan_rhi->m_swapchain_extent.height/4;
+        viewport.width    = m_vulkan_rhi->m_scene_extent.width/4;
+        viewport.height   = m_vulkan_rhi->m_scene_extent.height/4;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         VkRect2D scissor {};
         scissor.offset = {0, 0};
-        scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width / 4, m_vulkan_rhi->m_swapchain_extent.height/4};
+        scissor.extent = {m_vulkan_rhi->m_scene_extent.width / 4, m_vulkan_rhi->m_scene_extent.height/4};
         m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &viewport);
         m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
-        
+
+        // the mask only covers the scene region, the blur must not read past it
+        PCFMaskBlurPushConstantsObject push_constants;
+        push_constants.mask_extent_x = static_cast<int32_t>(scissor.extent.width);
+        push_constants.mask_extent_y = static_cast<int32_t>(scissor.extent.height);
+        vkCmdPushConstants(m_vulkan_rhi->m_current_command_buffer,
+                           m_render_pipelines[0].layout,
+                           VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0,
+                           sizeof(PCFMaskBlurPushConstantsObject),
+                           &push_constants);
+
         m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
                                                     VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                     m_render_pipelines[0].layout,
@@ -228,12 +239,19 @@ namespace Piccolo
     {
         m_render_pipelines.resize(1);
 
+        VkPushConstantRange pushConstantRange {};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushConstantRange.offset     = 0;
+        pushConstantRange.size       = sizeof(PCFMaskBlurPushConstantsObject);
+
         VkDescriptorSetLayout      descriptorset_layouts[] = {m_descriptor_infos[0].layout};
         VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
         pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         pipeline_layout_create_info.setLayoutCount =
             (sizeof(descriptorset_layouts) / sizeof(descriptorset_layouts[0]));
         pipeline_layout_create_info.pSetLayouts            = descriptorset_layouts;
+        pipeline_layout_create_info.pushConstantRangeCount = 1;
+        pipeline_layout_create_info.pPushConstantRanges    = &pushConstantRange;
 
         if (vkCreatePipelineLayout(
                 m_vulkan_rhi->m_device, &pipeline_layout_create_info, nullptr, &m_render_pipelines[0].layout) !=
@@ -357,7 +375,7 @@ namespace Piccolo
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
         if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                        VK_NULL_HANDLE,
+                                        m_vulkan_rhi->m_pipeline_cache,
                                         1,
                                         &pipelineInfo,
                                         nullptr,
@@ -6,6 +6,12 @@ namespace Piccolo
 {
     class RenderResourceBase;
 
+    struct PCFMaskBlurPushConstantsObject
+    {
+        int32_t mask_extent_x;
+        int32_t mask_extent_y;
+    };
+
     class PCFMaskBlurPass : public RenderPass
     {
     public:
@@ -31,8 +31,12 @@ namespace Piccolo
         {
             m_pcf_mask_gen_push_constants_object.inverse_proj_view_matrix =
                 vulkan_resource->m_mesh_perframe_storage_buffer_object.proj_view_matrix.inverse();
-            m_pcf_mask_gen_push_constants_object.light_proj_view_matrix = 
-                vulkan_resource->m_mesh_perframe_storage_buffer_object.directional_light_proj_view;
+            m_pcf_mask_gen_push_constants_object.render_scale_x =
+                vulkan_resource->m_mesh_perframe_storage_buffer_object.render_scale_x;
+            m_pcf_mask_gen_push_constants_object.render_scale_y =
+                vulkan_resource->m_mesh_perframe_storage_buffer_object.render_scale_y;
+            m_directional_light_cascades =
+                vulkan_resource->m_mesh_perframe_storage_buffer_object.directional_light_cascades;
         }
     }
 
@@ -75,16 +79,19 @@ namespace Piccolo
         VkViewport viewport {};
         viewport.x        = 0.0f;
         viewport.y        = 0.0f;
-        viewport.width    = m_vulkan_rhi->m_swapchain_extent.width/4;
-        viewport.height   = m_vulkan_rhi->m_swapchain_extent.height/4;
+        viewport.width    = m_vulkan_rhi->m_scene_extent.width/4;
+        viewport.height   = m_vulkan_rhi->m_scene_extent.height/4;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         VkRect2D scissor {};
         scissor.offset = {0, 0};
-        scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width / 4, m_vulkan_rhi->m_swapchain_extent.height/4};
+        scissor.extent = {m_vulkan_rhi->m_scene_extent.width / 4, m_vulkan_rhi->m_scene_extent.height/4};
         m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &viewport);
         m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
 
+        auto cascades_allocation   = allocateUpload<VulkanDirectionalLightCascades>();
+        *cascades_allocation.data  = m_directional_light_cascades;
+        uint32_t dynamic_offsets[] = {cascades_allocation.dynamic_offset};
 
         m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
                         VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -92,8 +99,8 @@ namespace Piccolo
                         0,
                         1,
                         &m_descriptor_infos[0].descriptor_set,
-                        0,
-                        NULL);
+                        (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                        dynamic_offsets);
 
         vkCmdDraw(m_vulkan_rhi->m_current_command_buffer, 3, 1, 0, 0);
 
@@ -225,7 +232,7 @@ namespace Piccolo
 
         // pcf_mask_gen
         {
-            VkDescriptorSetLayoutBinding pcf_mask_layout_bindings[2];
+            VkDescriptorSetLayoutBinding pcf_mask_layout_bindings[3];
 
             VkDescriptorSetLayoutBinding& pcf_mask_layout_depth_texture_binding = pcf_mask_layout_bindings[0];
             pcf_mask_layout_depth_texture_binding.binding                       = 0;
@@ -243,9 +250,16 @@ namespace Piccolo
             pcf_mask_layout_direction_light_shadowMap_texture_binding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
             pcf_mask_layout_direction_light_shadowMap_texture_binding.pImmutableSamplers = NULL;
 
+            VkDescriptorSetLayoutBinding& pcf_mask_layout_cascades_binding = pcf_mask_layout_bindings[2];
+            pcf_mask_layout_cascades_binding.binding            = 2;
+            pcf_mask_layout_cascades_binding.descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            pcf_mask_layout_cascades_binding.descriptorCount    = 1;
+            pcf_mask_layout_cascades_binding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+            pcf_mask_layout_cascades_binding.pImmutableSamplers = NULL;
+
             VkDescriptorSetLayoutCreateInfo pcf_mask_layout_create_info {};
             pcf_mask_layout_create_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-            pcf_mask_layout_create_info.bindingCount = 2;
+            pcf_mask_layout_create_info.bindingCount = 3;
             pcf_mask_layout_create_info.pBindings    = pcf_mask_layout_bindings;
 
             if (VK_SUCCESS !=
@@ -399,7 +413,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -445,7 +459,13 @@ namespace Piccolo
             directional_light_shadow_texture_image_info.imageView   = m_directional_light_shadow_color_image_view;
             directional_light_shadow_texture_image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-            VkWriteDescriptorSet pcf_mask_descriptor_writes_info[2];
+            VkDescriptorBufferInfo directional_light_cascades_buffer_info {};
+            directional_light_cascades_buffer_info.offset = 0;
+            directional_light_cascades_buffer_info.range  = sizeof(VulkanDirectionalLightCascades);
+            directional_light_cascades_buffer_info.buffer =
+                m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+
+            VkWriteDescriptorSet pcf_mask_descriptor_writes_info[3];
 
             pcf_mask_descriptor_writes_info[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
             pcf_mask_descriptor_writes_info[0].pNext           = NULL;
@@ -465,7 +485,16 @@ namespace Piccolo
             pcf_mask_descriptor_writes_info[1].descriptorCount = 1;
             pcf_mask_descriptor_writes_info[1].pImageInfo      = &directional_light_shadow_texture_image_info;
 
-            vkUpdateDescriptorSets(m_vulkan_rhi->m_device, 2, pcf_mask_descriptor_writes_info, 0, NULL);
+            pcf_mask_descriptor_writes_info[2].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            pcf_mask_descriptor_writes_info[2].pNext           = NULL;
+            pcf_mask_descriptor_writes_info[2].dstSet          = m_descriptor_infos[0].descriptor_set;
+            pcf_mask_descriptor_writes_info[2].dstBinding      = 2;
+            pcf_mask_descriptor_writes_info[2].dstArrayElement = 0;
+            pcf_mask_descriptor_writes_info[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            pcf_mask_descriptor_writes_info[2].descriptorCount = 1;
+            pcf_mask_descriptor_writes_info[2].pBufferInfo     = &directional_light_cascades_buffer_info;
+
+            vkUpdateDescriptorSets(m_vulkan_rhi->m_device, 3, pcf_mask_descriptor_writes_info, 0, NULL);
         }
 
     }
@@ -9,7 +9,8 @@ namespace Piccolo
     struct PCFMaskGenPushConstantsObject
     {
         Matrix4x4 inverse_proj_view_matrix;
-        Matrix4x4 light_proj_view_matrix;
+        float     render_scale_x;
+        float     render_scale_y;
     };
 
     class PCFMaskGenPass : public RenderPass
@@ -31,6 +32,7 @@ namespace Piccolo
         void setupDescriptorSet();
 
     private:
-        PCFMaskGenPushConstantsObject m_pcf_mask_gen_push_constants_object;
+        PCFMaskGenPushConstantsObject  m_pcf_mask_gen_push_constants_object;
+        VulkanDirectionalLightCascades m_directional_light_cascades;
     };
 } // namespace Piccolo
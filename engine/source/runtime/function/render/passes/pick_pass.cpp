@@ -9,9 +9,6 @@
 #include <mesh_inefficient_pick_frag.h>
 #include <mesh_inefficient_pick_vert.h>
 
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include <stb_image_write.h>
-
 #include <map>
 #include <stdexcept>
 
@@ -30,6 +27,7 @@ namespace Piccolo
         setupDescriptorSetLayout();
         setupPipelines();
         setupDescriptorSet();
+        setupReadbackBuffer();
     }
     void PickPass::postInitialize() {}
     void PickPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
@@ -43,7 +41,265 @@ namespace Piccolo
             _mesh_inefficient_pick_perframe_storage_buffer_object.rt_height = m_vulkan_rhi->m_swapchain_extent.height;
         }
     }
-    void PickPass::draw() {}
+    void PickPass::draw()
+    {
+        const uint32_t frame_index = m_vulkan_rhi->m_current_frame_index;
+        if (!_requested_pick.callback || _pending_pick_callbacks[frame_index])
+        {
+            // nothing to pick, or the pick last recorded with this frame index is not resolved yet
+            return;
+        }
+
+        std::function<void(uint32_t)> callback = std::move(_requested_pick.callback);
+        _requested_pick.callback               = nullptr;
+
+        const int32_t pixel_x =
+            static_cast<int32_t>(_requested_pick.uv.x * m_vulkan_rhi->m_viewport.width + m_vulkan_rhi->m_viewport.x);
+        const int32_t pixel_y =
+            static_cast<int32_t>(_requested_pick.uv.y * m_vulkan_rhi->m_viewport.height + m_vulkan_rhi->m_viewport.y);
+        if (pixel_x < 0 || pixel_y < 0 || static_cast<uint32_t>(pixel_x) >= m_vulkan_rhi->m_swapchain_extent.width ||
+            static_cast<uint32_t>(pixel_y) >= m_vulkan_rhi->m_swapchain_extent.height)
+        {
+            callback(0);
+            return;
+        }
+
+        // only the texel under the cursor is rasterized and read back
+        VkRect2D pick_rect {};
+        pick_rect.offset = {pixel_x, pixel_y};
+        pick_rect.extent = {1, 1};
+
+        VkCommandBuffer       command_buffer = m_vulkan_rhi->m_current_command_buffer;
+        const RenderDrawList& draw_list      = *m_visiable_nodes.p_main_camera_draw_list;
+
+        {
+            VkImageMemoryBarrier transfer_to_render_barrier {};
+            transfer_to_render_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            transfer_to_render_barrier.pNext               = nullptr;
+            transfer_to_render_barrier.srcAccessMask       = 0;
+            transfer_to_render_barrier.dstAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            transfer_to_render_barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+            transfer_to_render_barrier.newLayout           = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            transfer_to_render_barrier.srcQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
+            transfer_to_render_barrier.dstQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
+            transfer_to_render_barrier.image               = m_framebuffer.attachments[0].image;
+            transfer_to_render_barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            vkCmdPipelineBarrier(command_buffer,
+                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 0,
+                                 0,
+                                 nullptr,
+                                 0,
+                                 nullptr,
+                                 1,
+                                 &transfer_to_render_barrier);
+        }
+
+        VkRenderPassBeginInfo renderpass_begin_info {};
+        renderpass_begin_info.sType       = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderpass_begin_info.renderPass  = m_framebuffer.render_pass;
+        renderpass_begin_info.framebuffer = m_framebuffer.framebuffer;
+        renderpass_begin_info.renderArea  = pick_rect;
+
+        VkClearColorValue color_value         = {0, 0, 0, 0};
+        VkClearValue      clearValues[2]      = {color_value, {1.0f, 0}};
+        renderpass_begin_info.clearValueCount = 2;
+        renderpass_begin_info.pClearValues    = clearValues;
+
+        m_vulkan_rhi->m_vk_cmd_begin_render_pass(
+            command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE); // no second buffer
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh Inefficient Pick", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
+        }
+
+        m_vulkan_rhi->m_vk_cmd_bind_pipeline(
+            command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
+        m_vulkan_rhi->m_vk_cmd_set_viewport(command_buffer, 0, 1, &m_vulkan_rhi->m_viewport);
+        m_vulkan_rhi->m_vk_cmd_set_scissor(command_buffer, 0, 1, &pick_rect);
+
+        // perframe storage buffer
+        auto     perframe_allocation     = allocateUpload<MeshInefficientPickPerframeStorageBufferObject>();
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+        *perframe_allocation.data = _mesh_inefficient_pick_perframe_storage_buffer_object;
+
+        for (const RenderDrawBatch& batch : draw_list.getBatches())
+        {
+            VulkanMesh&           mesh       = *batch.m_mesh;
+            const RenderMeshNode* mesh_nodes = draw_list.getBatchNodes(batch);
+
+            uint32_t total_instance_count = batch.m_node_count;
+            if (total_instance_count > 0)
+            {
+                // bind per mesh
+                m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                                                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                            m_render_pipelines[0].layout,
+                                                            1,
+                                                            1,
+                                                            &mesh.mesh_vertex_blending_descriptor_set,
+                                                            0,
+                                                            NULL);
+
+                VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer};
+                VkDeviceSize offsets[]        = {0};
+                m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(command_buffer, 0, 1, vertex_buffers, offsets);
+                m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                    command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices) /
+                     sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                {
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // perdrawcall storage buffer
+                    auto perdrawcall_allocation = allocateUpload<MeshInefficientPickPerdrawcallStorageBufferObject>();
+                    uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                    MeshInefficientPickPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                        *perdrawcall_allocation.data;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        perdrawcall_storage_buffer_object.model_matrices[i] =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.node_ids[i] =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].node_id;
+                    }
+
+                    // per drawcall vertex blending storage buffer
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset;
+                    if (mesh.enable_vertex_blending)
+                    {
+                        auto per_drawcall_vertex_blending_allocation =
+                            allocateUpload<MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject>();
+                        per_drawcall_vertex_blending_dynamic_offset =
+                            per_drawcall_vertex_blending_allocation.dynamic_offset;
+
+                        MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject&
+                            per_drawcall_vertex_blending_storage_buffer_object =
+                                *per_drawcall_vertex_blending_allocation.data;
+                        for (uint32_t i = 0; i < current_instance_count; ++i)
+                        {
+                            for (uint32_t j = 0;
+                                 j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
+                                 ++j)
+                            {
+                                per_drawcall_vertex_blending_storage_buffer_object
+                                    .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
+                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices[j];
+                            }
+                        }
+                    }
+                    else
+                    {
+                        per_drawcall_vertex_blending_dynamic_offset = 0;
+                    }
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset};
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                                                                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                                m_render_pipelines[0].layout,
+                                                                0,
+                                                                1,
+                                                                &m_descriptor_infos[0].descriptor_set,
+                                                                sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0]),
+                                                                dynamic_offsets);
+
+                    m_vulkan_rhi->m_vk_cmd_draw_indexed(
+                        command_buffer, mesh.mesh_index_count, current_instance_count, 0, 0, 0);
+                }
+            }
+        }
+
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
+        }
+
+        m_vulkan_rhi->m_vk_cmd_end_render_pass(command_buffer);
+
+        // the render pass leaves the ids in transfer src
+        VkImageMemoryBarrier copy_to_buffer_barrier {};
+        copy_to_buffer_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        copy_to_buffer_barrier.pNext               = nullptr;
+        copy_to_buffer_barrier.srcAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        copy_to_buffer_barrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
+        copy_to_buffer_barrier.oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        copy_to_buffer_barrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        copy_to_buffer_barrier.srcQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
+        copy_to_buffer_barrier.dstQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
+        copy_to_buffer_barrier.image               = m_framebuffer.attachments[0].image;
+        copy_to_buffer_barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr,
+                             1,
+                             &copy_to_buffer_barrier);
+
+        VkBufferImageCopy region {};
+        region.bufferOffset                    = sizeof(uint32_t) * frame_index;
+        region.bufferRowLength                 = 0;
+        region.bufferImageHeight               = 0;
+        region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel       = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount     = 1;
+        region.imageOffset                     = {pick_rect.offset.x, pick_rect.offset.y, 0};
+        region.imageExtent                     = {pick_rect.extent.width, pick_rect.extent.height, 1};
+
+        vkCmdCopyImageToBuffer(command_buffer,
+                               m_framebuffer.attachments[0].image,
+                               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               _readback_buffer,
+                               1,
+                               &region);
+
+        // made visible to the host by the fence of the frame
+        VkBufferMemoryBarrier readback_barrier {};
+        readback_barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        readback_barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        readback_barrier.dstAccessMask       = VK_ACCESS_HOST_READ_BIT;
+        readback_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        readback_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        readback_barrier.buffer              = _readback_buffer;
+        readback_barrier.offset              = region.bufferOffset;
+        readback_barrier.size                = sizeof(uint32_t);
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_HOST_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             1,
+                             &readback_barrier,
+                             0,
+                             nullptr);
+
+        _pending_pick_callbacks[frame_index] = std::move(callback);
+    }
     void PickPass::setupAttachments()
     {
         m_framebuffer.attachments.resize(1);
@@ -325,7 +581,7 @@ namespace Piccolo
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
         if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
+                m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
             VK_SUCCESS)
         {
             throw std::runtime_error("create mesh inefficient pick graphics pipeline");
@@ -427,434 +683,45 @@ namespace Piccolo
         setupAttachments();
         setupFramebuffer();
     }
-    uint32_t PickPass::pick(const Vector2& picked_uv)
+    void PickPass::requestPick(const Vector2& picked_uv, std::function<void(uint32_t)> callback)
     {
-        uint32_t pixel_x =
-            static_cast<uint32_t>(picked_uv.x * m_vulkan_rhi->m_viewport.width + m_vulkan_rhi->m_viewport.x);
-        uint32_t pixel_y =
-            static_cast<uint32_t>(picked_uv.y * m_vulkan_rhi->m_viewport.height + m_vulkan_rhi->m_viewport.y);
-        uint32_t picked_pixel_index = m_vulkan_rhi->m_swapchain_extent.width * pixel_y + pixel_x;
-        if (pixel_x >= m_vulkan_rhi->m_swapchain_extent.width || pixel_y >= m_vulkan_rhi->m_swapchain_extent.height)
-            return 0;
-
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-            uint32_t         node_id;
-        };
-
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
-
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
-        {
-            auto& mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
-            auto& model_nodes    = mesh_instanced[node.ref_mesh];
-
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            temp.node_id      = node.node_id;
-            if (node.ref_mesh->enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
-
-            model_nodes.push_back(temp);
-        }
-
-        // reset storage buffer offset
-        m_global_render_resource->_storage_buffer
-            ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] =
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_begin[*m_vulkan_rhi->m_p_current_frame_index];
-
-        VkResult res_wait_for_fences =
-            vkWaitForFences(m_vulkan_rhi->m_device,
-                            1,
-                            &m_vulkan_rhi->m_is_frame_in_flight_fences[*m_vulkan_rhi->m_p_current_frame_index],
-                            VK_TRUE,
-                            UINT64_MAX);
-        assert(VK_SUCCESS == res_wait_for_fences);
-
-        VkResult res_reset_command_pool = m_vulkan_rhi->m_vk_reset_command_pool(
-            m_vulkan_rhi->m_device, m_vulkan_rhi->m_p_command_pools[*m_vulkan_rhi->m_p_current_frame_index], 0);
-        assert(VK_SUCCESS == res_reset_command_pool);
-
-        VkCommandBufferBeginInfo command_buffer_begin_info {};
-        command_buffer_begin_info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        command_buffer_begin_info.flags            = 0;
-        command_buffer_begin_info.pInheritanceInfo = nullptr;
-
-        VkResult res_begin_command_buffer = m_vulkan_rhi->m_vk_begin_command_buffer(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], &command_buffer_begin_info);
-        assert(VK_SUCCESS == res_begin_command_buffer);
-
-        {
-            VkImageMemoryBarrier transfer_to_render_barrier {};
-            transfer_to_render_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            transfer_to_render_barrier.pNext               = nullptr;
-            transfer_to_render_barrier.srcAccessMask       = 0;
-            transfer_to_render_barrier.dstAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            transfer_to_render_barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
-            transfer_to_render_barrier.newLayout           = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            transfer_to_render_barrier.srcQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
-            transfer_to_render_barrier.dstQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
-            transfer_to_render_barrier.image               = m_framebuffer.attachments[0].image;
-            transfer_to_render_barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-            vkCmdPipelineBarrier(m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &transfer_to_render_barrier);
-        }
-
-        m_vulkan_rhi->m_vk_cmd_set_viewport(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], 0, 1, &m_vulkan_rhi->m_viewport);
-        m_vulkan_rhi->m_vk_cmd_set_scissor(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], 0, 1, &m_vulkan_rhi->m_scissor);
-
-        VkRenderPassBeginInfo renderpass_begin_info {};
-        renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
-        renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
-        renderpass_begin_info.renderArea.offset = {0, 0};
-        renderpass_begin_info.renderArea.extent = m_vulkan_rhi->m_swapchain_extent;
-
-        VkClearColorValue color_value         = {0, 0, 0, 0};
-        VkClearValue      clearValues[2]      = {color_value, {1.0f, 0}};
-        renderpass_begin_info.clearValueCount = 2;
-        renderpass_begin_info.pClearValues    = clearValues;
-
-        m_vulkan_rhi->m_vk_cmd_begin_render_pass(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-            &renderpass_begin_info,
-            VK_SUBPASS_CONTENTS_INLINE); // no second buffer
-
-        if (m_vulkan_rhi->isDebugLabelEnabled())
-        {
-            VkDebugUtilsLabelEXT label_info = {
-                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh Inefficient Pick", {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(
-                m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], &label_info);
-        }
-
-        m_vulkan_rhi->m_vk_cmd_bind_pipeline(m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                                             VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                             m_render_pipelines[0].pipeline);
-        m_vulkan_rhi->m_vk_cmd_set_viewport(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], 0, 1, &m_vulkan_rhi->m_viewport);
-        m_vulkan_rhi->m_vk_cmd_set_scissor(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], 0, 1, &m_vulkan_rhi->m_scissor);
-
-        // perframe storage buffer
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-        m_global_render_resource->_storage_buffer
-            ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] =
-            perframe_dynamic_offset + sizeof(MeshInefficientPickPerframeStorageBufferObject);
-        assert(m_global_render_resource->_storage_buffer
-                   ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] <=
-               (m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_begin[*m_vulkan_rhi->m_p_current_frame_index] +
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_size[*m_vulkan_rhi->m_p_current_frame_index]));
-
-        (*reinterpret_cast<MeshInefficientPickPerframeStorageBufferObject*>(
-            reinterpret_cast<uintptr_t>(
-                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-            perframe_dynamic_offset)) = _mesh_inefficient_pick_perframe_storage_buffer_object;
-
-        for (auto& pair1 : main_camera_mesh_drawcall_batch)
+        // a newer request replaces the one that is not recorded yet
+        _requested_pick.uv       = picked_uv;
+        _requested_pick.callback = std::move(callback);
+    }
+    void PickPass::resolvePendingPicks()
+    {
+        for (uint32_t frame_index = 0; frame_index < _pending_pick_callbacks.size(); ++frame_index)
         {
-            VulkanPBRMaterial& material       = (*pair1.first);
-            auto&              mesh_instanced = pair1.second;
-
-            // TODO: render from near to far
-
-            for (auto& pair2 : mesh_instanced)
+            if (!_pending_pick_callbacks[frame_index] ||
+                vkGetFenceStatus(m_vulkan_rhi->m_device, m_vulkan_rhi->m_is_frame_in_flight_fences[frame_index]) !=
+                    VK_SUCCESS)
             {
-                VulkanMesh& mesh       = (*pair2.first);
-                auto&       mesh_nodes = pair2.second;
-
-                uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                if (total_instance_count > 0)
-                {
-                    // bind per mesh
-                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                        m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                        VK_PIPELINE_BIND_POINT_GRAPHICS,
-                        m_render_pipelines[0].layout,
-                        1,
-                        1,
-                        &mesh.mesh_vertex_blending_descriptor_set,
-                        0,
-                        NULL);
-
-                    VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer};
-                    VkDeviceSize offsets[]        = {0};
-                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
-                        m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                        0,
-                        1,
-                        vertex_buffers,
-                        offsets);
-                    m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                        m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                        mesh.mesh_index_buffer,
-                        0,
-                        VK_INDEX_TYPE_UINT32);
-
-                    uint32_t drawcall_max_instance_count =
-                        (sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices) /
-                         sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices[0]));
-                    uint32_t drawcall_count =
-                        roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                    for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
-                    {
-                        uint32_t current_instance_count =
-                            ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                             drawcall_max_instance_count) ?
-                                (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                drawcall_max_instance_count;
-
-                        // perdrawcall storage buffer
-                        uint32_t perdrawcall_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] =
-                            perdrawcall_dynamic_offset + sizeof(MeshInefficientPickPerdrawcallStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                                   ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] <=
-                               (m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_begin[*m_vulkan_rhi->m_p_current_frame_index] +
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_size[*m_vulkan_rhi->m_p_current_frame_index]));
-
-                        MeshInefficientPickPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                            (*reinterpret_cast<MeshInefficientPickPerdrawcallStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                perdrawcall_dynamic_offset));
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            perdrawcall_storage_buffer_object.model_matrices[i] =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.node_ids[i] =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].node_id;
-                        }
-
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        if (mesh.enable_vertex_blending)
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[*m_vulkan_rhi->m_p_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[*m_vulkan_rhi->m_p_current_frame_index]));
-
-                            MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<
-                                        MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                for (uint32_t j = 0;
-                                     j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                     ++j)
-                                {
-                                    per_drawcall_vertex_blending_storage_buffer_object
-                                        .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices[j];
-                                }
-                            }
-                        }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
-
-                        // bind perdrawcall
-                        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                       perdrawcall_dynamic_offset,
-                                                       per_drawcall_vertex_blending_dynamic_offset};
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_render_pipelines[0].layout,
-                            0,
-                            1,
-                            &m_descriptor_infos[0].descriptor_set,
-                            sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0]),
-                            dynamic_offsets);
-
-                        m_vulkan_rhi->m_vk_cmd_draw_indexed(
-                            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                            mesh.mesh_index_count,
-                            current_instance_count,
-                            0,
-                            0,
-                            0);
-                    }
-                }
+                continue;
             }
-        }
 
-        if (m_vulkan_rhi->isDebugLabelEnabled())
-        {
-            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(
-                m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index]);
+            std::function<void(uint32_t)> callback = std::move(_pending_pick_callbacks[frame_index]);
+            _pending_pick_callbacks[frame_index]   = nullptr;
+            callback(_readback_ids[frame_index]);
         }
-
-        // end render pass
-        m_vulkan_rhi->m_vk_cmd_end_render_pass(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index]);
-
-        // end command buffer
-        VkResult res_end_command_buffer = m_vulkan_rhi->m_vk_end_command_buffer(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index]);
-        assert(VK_SUCCESS == res_end_command_buffer);
-
-        VkResult res_reset_fences = m_vulkan_rhi->m_vk_reset_fences(
-            m_vulkan_rhi->m_device,
-            1,
-            &m_vulkan_rhi->m_is_frame_in_flight_fences[*m_vulkan_rhi->m_p_current_frame_index]);
-        assert(VK_SUCCESS == res_reset_fences);
-
-        VkSubmitInfo submit_info         = {};
-        submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount   = 0;
-        submit_info.pWaitSemaphores      = NULL;
-        submit_info.pWaitDstStageMask    = 0;
-        submit_info.commandBufferCount   = 1;
-        submit_info.pCommandBuffers      = &m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index];
-        submit_info.signalSemaphoreCount = 0;
-        submit_info.pSignalSemaphores    = NULL;
-
-        VkResult res_queue_submit =
-            vkQueueSubmit(m_vulkan_rhi->m_graphics_queue,
-                          1,
-                          &submit_info,
-                          m_vulkan_rhi->m_is_frame_in_flight_fences[*m_vulkan_rhi->m_p_current_frame_index]);
-        assert(VK_SUCCESS == res_queue_submit);
-
-        auto new_index = (*m_vulkan_rhi->m_p_current_frame_index + 1) % m_vulkan_rhi->s_max_frames_in_flight;
-        *m_vulkan_rhi->m_p_current_frame_index = new_index;
-
-        // implicit host read barrier
-        res_wait_for_fences = m_vulkan_rhi->m_vk_wait_for_fences(m_vulkan_rhi->m_device,
-                                                                 m_vulkan_rhi->s_max_frames_in_flight,
-                                                                 m_vulkan_rhi->m_is_frame_in_flight_fences,
-                                                                 VK_TRUE,
-                                                                 UINT64_MAX);
-        assert(VK_SUCCESS == res_wait_for_fences);
-
-        auto command_buffer = m_vulkan_rhi->beginSingleTimeCommands();
-
-        VkBufferImageCopy region {};
-        region.bufferOffset                    = 0;
-        region.bufferRowLength                 = 0;
-        region.bufferImageHeight               = 0;
-        region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel       = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount     = 1;
-        region.imageOffset                     = {0, 0, 0};
-        region.imageExtent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height, 1};
-
-        uint32_t buffer_size = m_vulkan_rhi->m_swapchain_extent.width * m_vulkan_rhi->m_swapchain_extent.height * 4;
-        VkBuffer inefficient_staging_buffer;
-        VkDeviceMemory inefficient_staging_buffer_memory;
+    }
+    void PickPass::setupReadbackBuffer()
+    {
+        // one id per frame in flight, mapped for the lifetime of the pass
         VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
                                  m_vulkan_rhi->m_device,
-                                 buffer_size,
+                                 sizeof(uint32_t) * VulkanRHI::s_max_frames_in_flight,
                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                 inefficient_staging_buffer,
-                                 inefficient_staging_buffer_memory);
-
-        VkImageMemoryBarrier copy_to_buffer_barrier {};
-        copy_to_buffer_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        copy_to_buffer_barrier.pNext               = nullptr;
-        copy_to_buffer_barrier.srcAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        copy_to_buffer_barrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
-        copy_to_buffer_barrier.oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        copy_to_buffer_barrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        copy_to_buffer_barrier.srcQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
-        copy_to_buffer_barrier.dstQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
-        copy_to_buffer_barrier.image               = m_framebuffer.attachments[0].image;
-        copy_to_buffer_barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-        vkCmdPipelineBarrier(command_buffer,
-                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             0,
-                             0,
-                             nullptr,
-                             0,
-                             nullptr,
-                             1,
-                             &copy_to_buffer_barrier);
-
-        vkCmdCopyImageToBuffer(command_buffer,
-                               m_framebuffer.attachments[0].image,
-                               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                               inefficient_staging_buffer,
-                               1,
-                               &region);
-
-        m_vulkan_rhi->endSingleTimeCommands(command_buffer);
-
-        uint32_t* data = nullptr;
-        vkMapMemory(m_vulkan_rhi->m_device, inefficient_staging_buffer_memory, 0, buffer_size, 0, (void**)&data);
-
-#if 0
-        auto                 w = _rhi->_swapchain_extent.width;
-        auto                 h = _rhi->_swapchain_extent.height;
-        std::vector<uint8_t> image_data(w * h * 4);
-        for (int i = 0; i < h; i++)
-        {
-            for (int j = 0; j < w; j++)
-            {
-                image_data[4 * (i * w + j) + 0] = data[i * w + j];
-                image_data[4 * (i * w + j) + 1] = 0;
-                image_data[4 * (i * w + j) + 2] = 0;
-                image_data[4 * (i * w + j) + 3] = 0xFF;
-            }
-        }
-        stbi_write_png("pick.png", w, h, 4, image_data.data(), w * 4);
-#endif
-
-        uint32_t node_id = data[picked_pixel_index];
-        vkUnmapMemory(m_vulkan_rhi->m_device, inefficient_staging_buffer_memory);
-
-        vkDestroyBuffer(m_vulkan_rhi->m_device, inefficient_staging_buffer, nullptr);
-        vkFreeMemory(m_vulkan_rhi->m_device, inefficient_staging_buffer_memory, nullptr);
-
-        return node_id;
+                                 _readback_buffer,
+                                 _readback_buffer_memory);
+        vkMapMemory(m_vulkan_rhi->m_device,
+                    _readback_buffer_memory,
+                    0,
+                    VK_WHOLE_SIZE,
+                    0,
+                    reinterpret_cast<void**>(&_readback_ids));
+
+        _pending_pick_callbacks.resize(VulkanRHI::s_max_frames_in_flight);
     }
 } // namespace Piccolo
@@ -3,6 +3,9 @@
 #include "runtime/core/math/vector2.h"
 #include "runtime/function/render/render_pass.h"
 
+#include <functional>
+#include <vector>
+
 namespace Piccolo
 {
     class RenderResourceBase;
@@ -20,8 +23,12 @@ namespace Piccolo
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
         void draw() override final;
 
-        uint32_t pick(const Vector2& picked_uv);
-        void     recreateFramebuffer();
+        // the id under the cursor is rendered and copied by the next recorded frame, the callback gets it from
+        // resolvePendingPicks once that frame has completed on the gpu, 0 when nothing is under the cursor
+        void requestPick(const Vector2& picked_uv, std::function<void(uint32_t)> callback);
+        // never waits, runs the callbacks of the picks whose frame has completed
+        void resolvePendingPicks();
+        void recreateFramebuffer();
 
         MeshInefficientPickPerframeStorageBufferObject _mesh_inefficient_pick_perframe_storage_buffer_object;
 
@@ -32,12 +39,26 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
+        void setupReadbackBuffer();
 
     private:
+        struct PickRequest
+        {
+            Vector2                       uv;
+            std::function<void(uint32_t)> callback;
+        };
+
         VkImage        _object_id_image {VK_NULL_HANDLE};
         VkDeviceMemory _object_id_image_memory {VK_NULL_HANDLE};
         VkImageView    _object_id_image_view {VK_NULL_HANDLE};
 
         VkDescriptorSetLayout _per_mesh_layout {VK_NULL_HANDLE};
+
+        PickRequest _requested_pick;
+        // indexed by the frame index the pick was recorded with
+        std::vector<std::function<void(uint32_t)>> _pending_pick_callbacks;
+        VkBuffer                                   _readback_buffer {VK_NULL_HANDLE};
+        VkDeviceMemory                             _readback_buffer_memory {VK_NULL_HANDLE};
+        uint32_t*                                  _readback_ids {nullptr};
     };
 } // namespace Piccolo
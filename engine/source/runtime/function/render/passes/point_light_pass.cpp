@@ -6,7 +6,6 @@
 #include "runtime/function/render/passes/point_light_pass.h"
 
 #include <mesh_point_light_shadow_frag.h>
-#include <mesh_point_light_shadow_geom.h>
 #include <mesh_point_light_shadow_vert.h>
 
 #include <map>
@@ -40,18 +39,60 @@ namespace Piccolo
     }
     void PointLightShadowPass::draw()
     {
+        VkCommandBuffer command_buffer = m_vulkan_rhi->m_current_command_buffer;
+
+        if (!m_layers_layout_initialized)
+        {
+            VkImageMemoryBarrier undefined_to_shader_read_barrier {};
+            undefined_to_shader_read_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            undefined_to_shader_read_barrier.pNext               = nullptr;
+            undefined_to_shader_read_barrier.srcAccessMask       = 0;
+            undefined_to_shader_read_barrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
+            undefined_to_shader_read_barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+            undefined_to_shader_read_barrier.newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            undefined_to_shader_read_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            undefined_to_shader_read_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            undefined_to_shader_read_barrier.image               = m_framebuffer.attachments[0].image;
+            undefined_to_shader_read_barrier.subresourceRange    = {
+                VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, s_max_point_light_shadow_face_count};
+            vkCmdPipelineBarrier(command_buffer,
+                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                 0,
+                                 0,
+                                 nullptr,
+                                 0,
+                                 nullptr,
+                                 1,
+                                 &undefined_to_shader_read_barrier);
+            m_layers_layout_initialized = true;
+        }
+
+        uint32_t render_mask = *m_visiable_nodes.p_point_light_shadow_face_render_mask;
+        if (render_mask == 0)
+        {
+            return;
+        }
+
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
             VkDebugUtilsLabelEXT label_info = {
                 VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Point Light Shadow", {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
         }
 
-        drawModel();
+        for (uint32_t face_index = 0; face_index < s_max_point_light_shadow_face_count; ++face_index)
+        {
+            if (render_mask & (1U << face_index))
+            {
+                drawFace(command_buffer, face_index);
+            }
+        }
+        *m_visiable_nodes.p_point_light_shadow_face_valid_mask |= render_mask;
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
         }
     }
     void PointLightShadowPass::setupAttachments()
@@ -72,16 +113,30 @@ namespace Piccolo
                                 m_framebuffer.attachments[0].image,
                                 m_framebuffer.attachments[0].mem,
                                 0,
-                                2 * s_max_point_light_count,
+                                s_max_point_light_shadow_face_count,
                                 1);
         m_framebuffer.attachments[0].view = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
                                                                         m_framebuffer.attachments[0].image,
                                                                         m_framebuffer.attachments[0].format,
                                                                         VK_IMAGE_ASPECT_COLOR_BIT,
                                                                         VK_IMAGE_VIEW_TYPE_2D_ARRAY,
-                                                                        2 * s_max_point_light_count,
+                                                                        s_max_point_light_shadow_face_count,
                                                                         1);
 
+        // every face renders into its layer through a view of its own
+        m_face_color_image_views.resize(s_max_point_light_shadow_face_count);
+        for (uint32_t face_index = 0; face_index < s_max_point_light_shadow_face_count; ++face_index)
+        {
+            m_face_color_image_views[face_index] = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
+                                                                               m_framebuffer.attachments[0].image,
+                                                                               m_framebuffer.attachments[0].format,
+                                                                               VK_IMAGE_ASPECT_COLOR_BIT,
+                                                                               VK_IMAGE_VIEW_TYPE_2D,
+                                                                               1,
+                                                                               1,
+                                                                               face_index);
+        }
+
         // depth
         m_framebuffer.attachments[1].format = m_vulkan_rhi->m_depth_image_format;
         VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
@@ -95,14 +150,14 @@ namespace Piccolo
                                 m_framebuffer.attachments[1].image,
                                 m_framebuffer.attachments[1].mem,
                                 0,
-                                2 * s_max_point_light_count,
+                                1,
                                 1);
         m_framebuffer.attachments[1].view = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
                                                                         m_framebuffer.attachments[1].image,
                                                                         m_framebuffer.attachments[1].format,
                                                                         VK_IMAGE_ASPECT_DEPTH_BIT,
-                                                                        VK_IMAGE_VIEW_TYPE_2D_ARRAY,
-                                                                        2 * s_max_point_light_count,
+                                                                        VK_IMAGE_VIEW_TYPE_2D,
+                                                                        1,
                                                                         1);
     }
     void PointLightShadowPass::setupRenderPass()
@@ -147,9 +202,23 @@ namespace Piccolo
         shadow_pass.pColorAttachments       = &shadow_pass_color_attachment_reference;
         shadow_pass.pDepthStencilAttachment = &shadow_pass_depth_attachment_reference;
 
-        VkSubpassDependency dependencies[1] = {};
-
-        VkSubpassDependency& lighting_pass_dependency = dependencies[0];
+        VkSubpassDependency dependencies[2] = {};
+
+        // a face is cleared after the lighting of the previous frame read it, and after the previous face is done
+        // with the shared depth attachment
+        VkSubpassDependency& previous_pass_dependency = dependencies[0];
+        previous_pass_dependency.srcSubpass           = VK_SUBPASS_EXTERNAL;
+        previous_pass_dependency.dstSubpass           = 0;
+        previous_pass_dependency.srcStageMask =
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        previous_pass_dependency.dstStageMask =
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        previous_pass_dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        previous_pass_dependency.dstAccessMask =
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        previous_pass_dependency.dependencyFlags = 0;
+
+        VkSubpassDependency& lighting_pass_dependency = dependencies[1];
         lighting_pass_dependency.srcSubpass           = 0;
         lighting_pass_dependency.dstSubpass           = VK_SUBPASS_EXTERNAL;
         lighting_pass_dependency.srcStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -175,22 +244,28 @@ namespace Piccolo
     }
     void PointLightShadowPass::setupFramebuffer()
     {
-        VkImageView attachments[2] = {m_framebuffer.attachments[0].view, m_framebuffer.attachments[1].view};
-
-        VkFramebufferCreateInfo framebuffer_create_info {};
-        framebuffer_create_info.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebuffer_create_info.flags           = 0U;
-        framebuffer_create_info.renderPass      = m_framebuffer.render_pass;
-        framebuffer_create_info.attachmentCount = (sizeof(attachments) / sizeof(attachments[0]));
-        framebuffer_create_info.pAttachments    = attachments;
-        framebuffer_create_info.width           = s_point_light_shadow_map_dimension;
-        framebuffer_create_info.height          = s_point_light_shadow_map_dimension;
-        framebuffer_create_info.layers          = 2 * s_max_point_light_count;
-
-        if (vkCreateFramebuffer(
-                m_vulkan_rhi->m_device, &framebuffer_create_info, nullptr, &m_framebuffer.framebuffer) != VK_SUCCESS)
+        m_face_framebuffers.resize(s_max_point_light_shadow_face_count);
+        for (uint32_t face_index = 0; face_index < s_max_point_light_shadow_face_count; ++face_index)
         {
-            throw std::runtime_error("create point light shadow framebuffer");
+            VkImageView attachments[2] = {m_face_color_image_views[face_index], m_framebuffer.attachments[1].view};
+
+            VkFramebufferCreateInfo framebuffer_create_info {};
+            framebuffer_create_info.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebuffer_create_info.flags           = 0U;
+            framebuffer_create_info.renderPass      = m_framebuffer.render_pass;
+            framebuffer_create_info.attachmentCount = (sizeof(attachments) / sizeof(attachments[0]));
+            framebuffer_create_info.pAttachments    = attachments;
+            framebuffer_create_info.width           = s_point_light_shadow_map_dimension;
+            framebuffer_create_info.height          = s_point_light_shadow_map_dimension;
+            framebuffer_create_info.layers          = 1;
+
+            if (vkCreateFramebuffer(m_vulkan_rhi->m_device,
+                                    &framebuffer_create_info,
+                                    nullptr,
+                                    &m_face_framebuffers[face_index]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("create point light shadow framebuffer");
+            }
         }
     }
     void PointLightShadowPass::setupDescriptorSetLayout()
@@ -199,14 +274,14 @@ namespace Piccolo
 
         VkDescriptorSetLayoutBinding mesh_point_light_shadow_global_layout_bindings[3];
 
-        VkDescriptorSetLayoutBinding& mesh_point_light_shadow_global_layout_perframe_storage_buffer_binding =
+        VkDescriptorSetLayoutBinding& mesh_point_light_shadow_global_layout_perface_storage_buffer_binding =
             mesh_point_light_shadow_global_layout_bindings[0];
-        mesh_point_light_shadow_global_layout_perframe_storage_buffer_binding.binding = 0;
-        mesh_point_light_shadow_global_layout_perframe_storage_buffer_binding.descriptorType =
+        mesh_point_light_shadow_global_layout_perface_storage_buffer_binding.binding = 0;
+        mesh_point_light_shadow_global_layout_perface_storage_buffer_binding.descriptorType =
             VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-        mesh_point_light_shadow_global_layout_perframe_storage_buffer_binding.descriptorCount = 1;
-        mesh_point_light_shadow_global_layout_perframe_storage_buffer_binding.stageFlags =
-            VK_SHADER_STAGE_GEOMETRY_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        mesh_point_light_shadow_global_layout_perface_storage_buffer_binding.descriptorCount = 1;
+        mesh_point_light_shadow_global_layout_perface_storage_buffer_binding.stageFlags =
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
         VkDescriptorSetLayoutBinding& mesh_point_light_shadow_global_layout_perdrawcall_storage_buffer_binding =
             mesh_point_light_shadow_global_layout_bindings[1];
@@ -266,8 +341,6 @@ namespace Piccolo
 
         VkShaderModule vert_shader_module =
             VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_POINT_LIGHT_SHADOW_VERT);
-        VkShaderModule geom_shader_module =
-            VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_POINT_LIGHT_SHADOW_GEOM);
         VkShaderModule frag_shader_module =
             VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_POINT_LIGHT_SHADOW_FRAG);
 
@@ -277,12 +350,6 @@ namespace Piccolo
         vert_pipeline_shader_stage_create_info.module = vert_shader_module;
         vert_pipeline_shader_stage_create_info.pName  = "main";
 
-        VkPipelineShaderStageCreateInfo geom_pipeline_shader_stage_create_info {};
-        geom_pipeline_shader_stage_create_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        geom_pipeline_shader_stage_create_info.stage  = VK_SHADER_STAGE_GEOMETRY_BIT;
-        geom_pipeline_shader_stage_create_info.module = geom_shader_module;
-        geom_pipeline_shader_stage_create_info.pName  = "main";
-
         VkPipelineShaderStageCreateInfo frag_pipeline_shader_stage_create_info {};
         frag_pipeline_shader_stage_create_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         frag_pipeline_shader_stage_create_info.stage  = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -290,7 +357,6 @@ namespace Piccolo
         frag_pipeline_shader_stage_create_info.pName  = "main";
 
         VkPipelineShaderStageCreateInfo shader_stages[] = {vert_pipeline_shader_stage_create_info,
-                                                           geom_pipeline_shader_stage_create_info,
                                                            frag_pipeline_shader_stage_create_info};
 
         auto                                 vertex_binding_descriptions   = MeshVertex::getBindingDescriptions();
@@ -313,9 +379,9 @@ namespace Piccolo
         VkPipelineViewportStateCreateInfo viewport_state_create_info {};
         viewport_state_create_info.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewport_state_create_info.viewportCount = 1;
-        viewport_state_create_info.pViewports    = &m_vulkan_rhi->m_viewport;
+        viewport_state_create_info.pViewports    = &viewport;
         viewport_state_create_info.scissorCount  = 1;
-        viewport_state_create_info.pScissors     = &m_vulkan_rhi->m_scissor;
+        viewport_state_create_info.pScissors     = &scissor;
 
         VkPipelineRasterizationStateCreateInfo rasterization_state_create_info {};
         rasterization_state_create_info.sType            = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -389,14 +455,13 @@ namespace Piccolo
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
         if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
+                m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
             VK_SUCCESS)
         {
             throw std::runtime_error("create mesh point light shadow graphics pipeline");
         }
 
         vkDestroyShaderModule(m_vulkan_rhi->m_device, vert_shader_module, nullptr);
-        vkDestroyShaderModule(m_vulkan_rhi->m_device, geom_shader_module, nullptr);
         vkDestroyShaderModule(m_vulkan_rhi->m_device, frag_shader_module, nullptr);
     }
     void PointLightShadowPass::setupDescriptorSet()
@@ -415,15 +480,15 @@ namespace Piccolo
             throw std::runtime_error("allocate mesh point light shadow global descriptor set");
         }
 
-        VkDescriptorBufferInfo mesh_point_light_shadow_perframe_storage_buffer_info = {};
+        VkDescriptorBufferInfo mesh_point_light_shadow_perface_storage_buffer_info = {};
         // this offset plus dynamic_offset should not be greater than the size of the buffer
-        mesh_point_light_shadow_perframe_storage_buffer_info.offset = 0;
+        mesh_point_light_shadow_perface_storage_buffer_info.offset = 0;
         // the range means the size actually used by the shader per draw call
-        mesh_point_light_shadow_perframe_storage_buffer_info.range =
-            sizeof(MeshPointLightShadowPerframeStorageBufferObject);
-        mesh_point_light_shadow_perframe_storage_buffer_info.buffer =
+        mesh_point_light_shadow_perface_storage_buffer_info.range =
+            sizeof(MeshPointLightShadowPerfaceStorageBufferObject);
+        mesh_point_light_shadow_perface_storage_buffer_info.buffer =
             m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
-        assert(mesh_point_light_shadow_perframe_storage_buffer_info.range <
+        assert(mesh_point_light_shadow_perface_storage_buffer_info.range <
                m_global_render_resource->_storage_buffer._max_storage_buffer_range);
 
         VkDescriptorBufferInfo mesh_point_light_shadow_perdrawcall_storage_buffer_info = {};
@@ -448,17 +513,17 @@ namespace Piccolo
 
         VkWriteDescriptorSet descriptor_writes[3];
 
-        VkWriteDescriptorSet& mesh_point_light_shadow_perframe_storage_buffer_write_info = descriptor_writes[0];
-        mesh_point_light_shadow_perframe_storage_buffer_write_info.sType      = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        mesh_point_light_shadow_perframe_storage_buffer_write_info.pNext      = NULL;
-        mesh_point_light_shadow_perframe_storage_buffer_write_info.dstSet     = descriptor_set_to_write;
-        mesh_point_light_shadow_perframe_storage_buffer_write_info.dstBinding = 0;
-        mesh_point_light_shadow_perframe_storage_buffer_write_info.dstArrayElement = 0;
-        mesh_point_light_shadow_perframe_storage_buffer_write_info.descriptorType =
+        VkWriteDescriptorSet& mesh_point_light_shadow_perface_storage_buffer_write_info = descriptor_writes[0];
+        mesh_point_light_shadow_perface_storage_buffer_write_info.sType      = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_point_light_shadow_perface_storage_buffer_write_info.pNext      = NULL;
+        mesh_point_light_shadow_perface_storage_buffer_write_info.dstSet     = descriptor_set_to_write;
+        mesh_point_light_shadow_perface_storage_buffer_write_info.dstBinding = 0;
+        mesh_point_light_shadow_perface_storage_buffer_write_info.dstArrayElement = 0;
+        mesh_point_light_shadow_perface_storage_buffer_write_info.descriptorType =
             VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-        mesh_point_light_shadow_perframe_storage_buffer_write_info.descriptorCount = 1;
-        mesh_point_light_shadow_perframe_storage_buffer_write_info.pBufferInfo =
-            &mesh_point_light_shadow_perframe_storage_buffer_info;
+        mesh_point_light_shadow_perface_storage_buffer_write_info.descriptorCount = 1;
+        mesh_point_light_shadow_perface_storage_buffer_write_info.pBufferInfo =
+            &mesh_point_light_shadow_perface_storage_buffer_info;
 
         VkWriteDescriptorSet& mesh_point_light_shadow_perdrawcall_storage_buffer_write_info = descriptor_writes[1];
         mesh_point_light_shadow_perdrawcall_storage_buffer_write_info.sType  = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -492,38 +557,14 @@ namespace Piccolo
                                0,
                                NULL);
     }
-    void PointLightShadowPass::drawModel()
+    void PointLightShadowPass::drawFace(VkCommandBuffer command_buffer, uint32_t face_index)
     {
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
-
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> point_lights_mesh_drawcall_batch;
-
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_point_lights_visible_mesh_nodes))
-        {
-            auto& mesh_instanced = point_lights_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
-
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
-
-            mesh_nodes.push_back(temp);
-        }
+        const RenderDrawList& draw_list = m_visiable_nodes.p_point_light_shadow_face_draw_lists[face_index];
 
         VkRenderPassBeginInfo renderpass_begin_info {};
         renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
-        renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
+        renderpass_begin_info.framebuffer       = m_face_framebuffers[face_index];
         renderpass_begin_info.renderArea.offset = {0, 0};
         renderpass_begin_info.renderArea.extent = {s_point_light_shadow_map_dimension,
                                                    s_point_light_shadow_map_dimension};
@@ -534,8 +575,7 @@ namespace Piccolo
         renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
         renderpass_begin_info.pClearValues    = clear_values;
 
-        m_vulkan_rhi->m_vk_cmd_begin_render_pass(
-            m_vulkan_rhi->m_current_command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+        m_vulkan_rhi->m_vk_cmd_begin_render_pass(command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
         if (m_vulkan_rhi->isPointLightShadowEnabled())
         {
@@ -543,199 +583,155 @@ namespace Piccolo
             {
                 VkDebugUtilsLabelEXT label_info = {
                     VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
             }
 
-            m_vulkan_rhi->m_vk_cmd_bind_pipeline(m_vulkan_rhi->m_current_command_buffer,
+            m_vulkan_rhi->m_vk_cmd_bind_pipeline(command_buffer,
                                                  VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                  m_render_pipelines[0].pipeline);
 
-            // perframe storage buffer
-            uint32_t perframe_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-            MeshPointLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
-                (*reinterpret_cast<MeshPointLightShadowPerframeStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perframe_dynamic_offset));
-            perframe_storage_buffer_object = m_mesh_point_light_shadow_perframe_storage_buffer_object;
-
-            for (auto& pair1 : point_lights_mesh_drawcall_batch)
-            {
-                VulkanPBRMaterial& material       = (*pair1.first);
-                auto&              mesh_instanced = pair1.second;
+            // perface storage buffer
+            auto     perface_allocation     = allocateUpload<MeshPointLightShadowPerfaceStorageBufferObject>();
+            uint32_t perface_dynamic_offset = perface_allocation.dynamic_offset;
+
+            const Vector4* point_lights_position_and_radius =
+                m_mesh_point_light_shadow_perframe_storage_buffer_object.point_lights_position_and_radius;
+            const Vector4& point_light_position_and_radius = point_lights_position_and_radius[face_index / 2];
 
-                // TODO: render from near to far
+            MeshPointLightShadowPerfaceStorageBufferObject& perface_storage_buffer_object = *perface_allocation.data;
+            perface_storage_buffer_object.point_light_position = Vector3(point_light_position_and_radius.x,
+                                                                         point_light_position_and_radius.y,
+                                                                         point_light_position_and_radius.z);
+            perface_storage_buffer_object.point_light_radius   = point_light_position_and_radius.w;
+            perface_storage_buffer_object.hemisphere_sign      = (face_index % 2 == 0) ? -1.0f : 1.0f;
+
+            for (const RenderDrawBatch& batch : draw_list.getBatches())
+            {
+                VulkanMesh&           mesh       = *batch.m_mesh;
+                const RenderMeshNode* mesh_nodes = draw_list.getBatchNodes(batch);
 
-                for (auto& pair2 : mesh_instanced)
+                uint32_t total_instance_count = batch.m_node_count;
+                if (total_instance_count > 0)
                 {
-                    VulkanMesh& mesh       = (*pair2.first);
-                    auto&       mesh_nodes = pair2.second;
+                    // bind per mesh
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                                                                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                                m_render_pipelines[0].layout,
+                                                                1,
+                                                                1,
+                                                                &mesh.mesh_vertex_blending_descriptor_set,
+                                                                0,
+                                                                NULL);
+
+                    VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer};
+                    VkDeviceSize offsets[]        = {0};
+                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(command_buffer, 0, 1, vertex_buffers, offsets);
+                    m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                        command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
-                    uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                    if (total_instance_count > 0)
+                    uint32_t drawcall_max_instance_count =
+                        (sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
+                         sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
+                    uint32_t drawcall_count =
+                        roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                    for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
                     {
-                        // bind per mesh
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
-                                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                                    m_render_pipelines[0].layout,
-                                                                    1,
-                                                                    1,
-                                                                    &mesh.mesh_vertex_blending_descriptor_set,
-                                                                    0,
-                                                                    NULL);
-
-                        VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer};
-                        VkDeviceSize offsets[]        = {0};
-                        m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
-                            m_vulkan_rhi->m_current_command_buffer, 0, 1, vertex_buffers, offsets);
-                        m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                            m_vulkan_rhi->m_current_command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
-
-                        uint32_t drawcall_max_instance_count =
-                            (sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
-                             sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
-                        uint32_t drawcall_count =
-                            roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                        for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                        uint32_t current_instance_count =
+                            ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                             drawcall_max_instance_count) ?
+                                (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                                drawcall_max_instance_count;
+
+                        // perdrawcall storage buffer
+                        auto perdrawcall_allocation =
+                            allocateUpload<MeshPointLightShadowPerdrawcallStorageBufferObject>();
+                        uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                        MeshPointLightShadowPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                            *perdrawcall_allocation.data;
+                        for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            uint32_t current_instance_count =
-                                ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                                 drawcall_max_instance_count) ?
-                                    (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                    drawcall_max_instance_count;
-
-                            // perdrawcall storage buffer
-                            uint32_t perdrawcall_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                perdrawcall_dynamic_offset + sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                            MeshPointLightShadowPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                                (*reinterpret_cast<MeshPointLightShadowPerdrawcallStorageBufferObject*>(
-                                    reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                    ._global_upload_ringbuffer_memory_pointer) +
-                                    perdrawcall_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                    *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                                perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                                  -1.0;
-                            }
+                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                                isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]) ?
+                                    1.0 :
+                                    -1.0;
+                        }
 
-                            // per drawcall vertex blending storage buffer
-                            uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                            bool     least_one_enable_vertex_blending = true;
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
+                        // per drawcall vertex blending storage buffer
+                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
+                        bool     least_one_enable_vertex_blending = true;
+                        for (uint32_t i = 0; i < current_instance_count; ++i)
+                        {
+                            if (!isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                             {
-                                if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    least_one_enable_vertex_blending = false;
-                                    break;
-                                }
+                                least_one_enable_vertex_blending = false;
+                                break;
                             }
-                            if (mesh.enable_vertex_blending)
+                        }
+                        if (mesh.enable_vertex_blending)
+                        {
+                            auto per_drawcall_vertex_blending_allocation =
+                                allocateUpload<MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject>();
+                            per_drawcall_vertex_blending_dynamic_offset =
+                                per_drawcall_vertex_blending_allocation.dynamic_offset;
+
+                            MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject&
+                                per_drawcall_vertex_blending_storage_buffer_object =
+                                    *per_drawcall_vertex_blending_allocation.data;
+                            for (uint32_t i = 0; i < current_instance_count; ++i)
                             {
-                                per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                    per_drawcall_vertex_blending_dynamic_offset +
-                                    sizeof(MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                                assert(m_global_render_resource->_storage_buffer
-                                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                       (m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                        m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                                MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject&
-                                    per_drawcall_vertex_blending_storage_buffer_object =
-                                        (*reinterpret_cast<
-                                            MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject*>(
-                                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                            ._global_upload_ringbuffer_memory_pointer) +
-                                            per_drawcall_vertex_blending_dynamic_offset));
-                                for (uint32_t i = 0; i < current_instance_count; ++i)
+                                if (isShaderVertexBlending(
+                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                                 {
-                                    if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
+                                    for (uint32_t j = 0;
+                                         j <
+                                         mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
+                                         ++j)
                                     {
-                                        for (uint32_t j = 0;
-                                             j <
-                                             mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                             ++j)
-                                        {
-                                            per_drawcall_vertex_blending_storage_buffer_object
-                                                .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                    .joint_matrices[j];
-                                        }
+                                        per_drawcall_vertex_blending_storage_buffer_object
+                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
+                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
+                                                .joint_matrices[j];
                                     }
                                 }
                             }
-                            else
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = 0;
-                            }
-
-                            // bind perdrawcall
-                            uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                           perdrawcall_dynamic_offset,
-                                                           per_drawcall_vertex_blending_dynamic_offset};
-                            m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                                m_vulkan_rhi->m_current_command_buffer,
-                                VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                m_render_pipelines[0].layout,
-                                0,
-                                1,
-                                &m_descriptor_infos[0].descriptor_set,
-                                (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
-                                dynamic_offsets);
-
-                            m_vulkan_rhi->m_vk_cmd_draw_indexed(m_vulkan_rhi->m_current_command_buffer,
-                                                                mesh.mesh_index_count,
-                                                                current_instance_count,
-                                                                0,
-                                                                0,
-                                                                0);
                         }
+                        else
+                        {
+                            per_drawcall_vertex_blending_dynamic_offset = 0;
+                        }
+
+                        // bind perdrawcall
+                        uint32_t dynamic_offsets[3] = {perface_dynamic_offset,
+                                                       perdrawcall_dynamic_offset,
+                                                       per_drawcall_vertex_blending_dynamic_offset};
+                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_render_pipelines[0].layout,
+                            0,
+                            1,
+                            &m_descriptor_infos[0].descriptor_set,
+                            (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                            dynamic_offsets);
+
+                        drawMeshInstances(command_buffer,
+                                          mesh,
+                                          mesh_nodes + drawcall_max_instance_count * drawcall_index,
+                                          current_instance_count,
+                                          1);
                     }
                 }
             }
 
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
             }
         }
 
-        m_vulkan_rhi->m_vk_cmd_end_render_pass(m_vulkan_rhi->m_current_command_buffer);
+        m_vulkan_rhi->m_vk_cmd_end_render_pass(command_buffer);
     }
-
 } // namespace Piccolo
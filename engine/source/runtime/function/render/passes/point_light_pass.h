@@ -12,6 +12,9 @@ namespace Piccolo
         void initialize(const RenderPassInitInfo* init_info) override final;
         void postInitialize() override final;
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
+
+        // renders the faces in the render mask one after the other, each in its own render pass instance, so it is
+        // recorded into the primary command buffer rather than by the RenderCommandRecorder
         void draw() override final;
 
         void setPerMeshLayout(const VkDescriptorSetLayout& layout) { m_per_mesh_layout = layout; }
@@ -23,10 +26,19 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
-        void drawModel();
+
+        void drawFace(VkCommandBuffer command_buffer, uint32_t face_index);
 
     private:
         VkDescriptorSetLayout                           m_per_mesh_layout;
         MeshPointLightShadowPerframeStorageBufferObject m_mesh_point_light_shadow_perframe_storage_buffer_object;
+
+        // a face is a layer of the color attachment, the depth attachment is a single layer reused by every face
+        std::vector<VkImageView>   m_face_color_image_views;
+        std::vector<VkFramebuffer> m_face_framebuffers;
+
+        // the faces not rendered in a frame keep their layers from the previous frames, so the layers have to be in
+        // the shader read layout from the first frame
+        bool m_layers_layout_initialized {false};
     };
 } // namespace Piccolo
@@ -21,6 +21,7 @@ namespace Piccolo
 
         const PostProcessPassInitInfo* _init_info = static_cast<const PostProcessPassInitInfo*>(init_info);
         m_enable_fxaa                            = _init_info->enable_fxaa;
+        m_enable_fused_post_process              = _init_info->enable_fused_post_process;
         m_color_input_image_view                 = _init_info->color_input_image_view;
         m_bright_color_input_image_view          = _init_info->bright_color_input_image_view;
         setupAttachments();
@@ -161,7 +162,13 @@ namespace Piccolo
         swapchain_image_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         swapchain_image_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         swapchain_image_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        swapchain_image_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        swapchain_image_attachment_description.finalLayout    = m_vulkan_rhi->m_swapchain_image_final_layout;
+
+        if (m_enable_fused_post_process)
+        {
+            setupFusedRenderPass(attachments_dscp);
+            return;
+        }
 
         VkSubpassDescription subpasses[_post_process_subpass_count] = {};
 
@@ -392,6 +399,139 @@ namespace Piccolo
         }
     }
 
+    void PostProcessPass::setupFusedRenderPass(const VkAttachmentDescription* attachments_dscp)
+    {
+        // same attachments, but tone mapping, color grading, vignette and remap are one subpass, so the image only
+        // goes through three intermediate buffers: extra after the uber pass, odd after fxaa and even for the ui
+        VkSubpassDescription subpasses[_post_process_fused_subpass_count] = {};
+
+        VkAttachmentReference uber_pass_input_attachment_reference[2] {};
+        uber_pass_input_attachment_reference[0].attachment = _post_process_pass_color_input_image;
+        uber_pass_input_attachment_reference[0].layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        uber_pass_input_attachment_reference[1].attachment = _post_process_pass_bright_color_input_image;
+        uber_pass_input_attachment_reference[1].layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkAttachmentReference uber_pass_color_attachment_reference {};
+        uber_pass_color_attachment_reference.attachment = _post_process_pass_backup_buffer_extra;
+        uber_pass_color_attachment_reference.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription& uber_pass   = subpasses[_post_process_fused_subpass_uber];
+        uber_pass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        uber_pass.inputAttachmentCount    = 2;
+        uber_pass.pInputAttachments       = uber_pass_input_attachment_reference;
+        uber_pass.colorAttachmentCount    = 1;
+        uber_pass.pColorAttachments       = &uber_pass_color_attachment_reference;
+        uber_pass.pDepthStencilAttachment = NULL;
+        uber_pass.preserveAttachmentCount = 0;
+        uber_pass.pPreserveAttachments    = NULL;
+
+        VkAttachmentReference fxaa_pass_input_attachment_reference {};
+        fxaa_pass_input_attachment_reference.attachment = _post_process_pass_backup_buffer_extra;
+        fxaa_pass_input_attachment_reference.layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkAttachmentReference fxaa_pass_color_attachment_reference {};
+        fxaa_pass_color_attachment_reference.attachment = _post_process_pass_backup_buffer_odd;
+        fxaa_pass_color_attachment_reference.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription& fxaa_pass   = subpasses[_post_process_fused_subpass_fxaa];
+        fxaa_pass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        fxaa_pass.inputAttachmentCount    = 1;
+        fxaa_pass.pInputAttachments       = &fxaa_pass_input_attachment_reference;
+        fxaa_pass.colorAttachmentCount    = 1;
+        fxaa_pass.pColorAttachments       = &fxaa_pass_color_attachment_reference;
+        fxaa_pass.pDepthStencilAttachment = NULL;
+        fxaa_pass.preserveAttachmentCount = 0;
+        fxaa_pass.pPreserveAttachments    = NULL;
+
+        VkAttachmentReference ui_pass_color_attachment_reference {};
+        ui_pass_color_attachment_reference.attachment = _post_process_pass_backup_buffer_even;
+        ui_pass_color_attachment_reference.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        uint32_t ui_pass_preserve_attachment = _post_process_pass_backup_buffer_odd;
+
+        VkSubpassDescription& ui_pass   = subpasses[_post_process_fused_subpass_ui];
+        ui_pass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        ui_pass.inputAttachmentCount    = 0;
+        ui_pass.pInputAttachments       = NULL;
+        ui_pass.colorAttachmentCount    = 1;
+        ui_pass.pColorAttachments       = &ui_pass_color_attachment_reference;
+        ui_pass.pDepthStencilAttachment = NULL;
+        ui_pass.preserveAttachmentCount = 1;
+        ui_pass.pPreserveAttachments    = &ui_pass_preserve_attachment;
+
+        VkAttachmentReference combine_ui_pass_input_attachments_reference[2] = {};
+        combine_ui_pass_input_attachments_reference[0].attachment = _post_process_pass_backup_buffer_odd;
+        combine_ui_pass_input_attachments_reference[0].layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        combine_ui_pass_input_attachments_reference[1].attachment = _post_process_pass_backup_buffer_even;
+        combine_ui_pass_input_attachments_reference[1].layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkAttachmentReference combine_ui_pass_color_attachment_reference {};
+        combine_ui_pass_color_attachment_reference.attachment = _post_process_pass_swap_chain_image;
+        combine_ui_pass_color_attachment_reference.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription& combine_ui_pass = subpasses[_post_process_fused_subpass_combine_ui];
+        combine_ui_pass.pipelineBindPoint     = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        combine_ui_pass.inputAttachmentCount  = sizeof(combine_ui_pass_input_attachments_reference) /
+                                               sizeof(combine_ui_pass_input_attachments_reference[0]);
+        combine_ui_pass.pInputAttachments       = combine_ui_pass_input_attachments_reference;
+        combine_ui_pass.colorAttachmentCount    = 1;
+        combine_ui_pass.pColorAttachments       = &combine_ui_pass_color_attachment_reference;
+        combine_ui_pass.pDepthStencilAttachment = NULL;
+        combine_ui_pass.preserveAttachmentCount = 0;
+        combine_ui_pass.pPreserveAttachments    = NULL;
+
+        VkSubpassDependency dependencies[3] = {};
+        uint32_t            dependency_index = 0;
+
+        // fxaa samples the neighbours, so this one can not be by region
+        VkSubpassDependency& fxaa_pass_depend_on_uber_pass = dependencies[dependency_index++];
+        fxaa_pass_depend_on_uber_pass.srcSubpass           = _post_process_fused_subpass_uber;
+        fxaa_pass_depend_on_uber_pass.dstSubpass           = _post_process_fused_subpass_fxaa;
+        fxaa_pass_depend_on_uber_pass.srcStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        fxaa_pass_depend_on_uber_pass.dstStageMask         = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        fxaa_pass_depend_on_uber_pass.srcAccessMask        = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        fxaa_pass_depend_on_uber_pass.dstAccessMask        = VK_ACCESS_SHADER_READ_BIT;
+
+        VkSubpassDependency& ui_pass_depend_on_fxaa_pass = dependencies[dependency_index++];
+        ui_pass_depend_on_fxaa_pass.srcSubpass           = _post_process_fused_subpass_fxaa;
+        ui_pass_depend_on_fxaa_pass.dstSubpass           = _post_process_fused_subpass_ui;
+        ui_pass_depend_on_fxaa_pass.srcStageMask =
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        ui_pass_depend_on_fxaa_pass.dstStageMask =
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        ui_pass_depend_on_fxaa_pass.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        ui_pass_depend_on_fxaa_pass.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+        ui_pass_depend_on_fxaa_pass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+        VkSubpassDependency& combine_ui_pass_depend_on_ui_pass = dependencies[dependency_index++];
+        combine_ui_pass_depend_on_ui_pass.srcSubpass           = _post_process_fused_subpass_ui;
+        combine_ui_pass_depend_on_ui_pass.dstSubpass           = _post_process_fused_subpass_combine_ui;
+        combine_ui_pass_depend_on_ui_pass.srcStageMask =
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        combine_ui_pass_depend_on_ui_pass.dstStageMask =
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        combine_ui_pass_depend_on_ui_pass.srcAccessMask =
+            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        combine_ui_pass_depend_on_ui_pass.dstAccessMask =
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+        combine_ui_pass_depend_on_ui_pass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+        VkRenderPassCreateInfo renderpass_create_info {};
+        renderpass_create_info.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderpass_create_info.attachmentCount = _post_process_pass_attachment_count;
+        renderpass_create_info.pAttachments    = attachments_dscp;
+        renderpass_create_info.subpassCount    = (sizeof(subpasses) / sizeof(subpasses[0]));
+        renderpass_create_info.pSubpasses      = subpasses;
+        renderpass_create_info.dependencyCount = (sizeof(dependencies) / sizeof(dependencies[0]));
+        renderpass_create_info.pDependencies   = dependencies;
+
+        if (vkCreateRenderPass(m_vulkan_rhi->m_device, &renderpass_create_info, nullptr, &m_framebuffer.render_pass) !=
+            VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create render pass");
+        }
+    }
+
     void PostProcessPass::setupDescriptorSetLayout()
     {
         m_descriptor_infos.resize(_layout_type_count);
@@ -542,6 +682,11 @@ namespace Piccolo
             dynamic_state_create_info.dynamicStateCount = 2;
             dynamic_state_create_info.pDynamicStates    = dynamic_states;
 
+            // the axis is drawn in the ui subpass
+            const uint32_t ui_subpass = m_enable_fused_post_process ?
+                                            static_cast<uint32_t>(_post_process_fused_subpass_ui) :
+                                            static_cast<uint32_t>(_post_process_subpass_ui);
+
             VkGraphicsPipelineCreateInfo pipelineInfo {};
             pipelineInfo.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
             pipelineInfo.stageCount          = 2;
@@ -555,12 +700,12 @@ namespace Piccolo
             pipelineInfo.pDepthStencilState  = &depth_stencil_create_info;
             pipelineInfo.layout              = m_render_pipelines[_render_pipeline_type_axis].layout;
             pipelineInfo.renderPass          = m_framebuffer.render_pass;
-            pipelineInfo.subpass             = _post_process_subpass_ui;
+            pipelineInfo.subpass             = ui_subpass;
             pipelineInfo.basePipelineHandle  = VK_NULL_HANDLE;
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -694,14 +839,15 @@ namespace Piccolo
 
     }
 
-    void PostProcessPass::draw(VignettePass&     vignette_pass,
-                               RemapPass&        remap_pass,
-                               ColorGradingPass& color_grading_pass,
-                               FXAAPass&         fxaa_pass,
-                               ToneMappingPass&  tone_mapping_pass,
-                               UIPass&           ui_pass,
-                               CombineUIPass&    combine_ui_pass,
-                               uint32_t          current_swapchain_image_index)
+    void PostProcessPass::draw(VignettePass&        vignette_pass,
+                               RemapPass&           remap_pass,
+                               ColorGradingPass&    color_grading_pass,
+                               FXAAPass&            fxaa_pass,
+                               ToneMappingPass&     tone_mapping_pass,
+                               UberPostProcessPass& uber_post_process_pass,
+                               UIPass&              ui_pass,
+                               CombineUIPass&       combine_ui_pass,
+                               uint32_t             current_swapchain_image_index)
     {
         {
             VkRenderPassBeginInfo renderpass_begin_info {};
@@ -722,54 +868,75 @@ namespace Piccolo
                 m_vulkan_rhi->m_current_post_process_command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
         }
 
-        if (m_vulkan_rhi->isDebugLabelEnabled())
+        if (m_enable_fused_post_process)
         {
-            VkDebugUtilsLabelEXT label_info = {
-                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "ToneMapping", {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_post_process_command_buffer, &label_info);
+            uber_post_process_pass.draw();
+
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer,
+                                                VK_SUBPASS_CONTENTS_INLINE);
+
+            fxaa_pass.draw();
+
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer,
+                                                VK_SUBPASS_CONTENTS_INLINE);
         }
+        else
+        {
+            if (m_vulkan_rhi->isDebugLabelEnabled())
+            {
+                VkDebugUtilsLabelEXT label_info = {
+                    VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "ToneMapping", {1.0f, 1.0f, 1.0f, 1.0f}};
+                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(
+                    m_vulkan_rhi->m_current_post_process_command_buffer, &label_info);
+            }
 
-        tone_mapping_pass.draw();
+            tone_mapping_pass.draw();
 
-        m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer,
+                                                VK_SUBPASS_CONTENTS_INLINE);
 
-        color_grading_pass.draw();
+            color_grading_pass.draw();
 
-        m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer,
+                                                VK_SUBPASS_CONTENTS_INLINE);
 
-        fxaa_pass.draw();
-       
-        m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+            fxaa_pass.draw();
 
-        vignette_pass.draw();
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer,
+                                                VK_SUBPASS_CONTENTS_INLINE);
 
-        m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
-        
-        {
-            VkClearAttachment clear_attachments[1];
-            clear_attachments[0].aspectMask                  = VK_IMAGE_ASPECT_COLOR_BIT;
-            clear_attachments[0].colorAttachment             = _post_process_pass_backup_buffer_odd;
-            clear_attachments[0].clearValue.color.float32[0] = 0.0;
-            clear_attachments[0].clearValue.color.float32[1] = 0.0;
-            clear_attachments[0].clearValue.color.float32[2] = 0.0;
-            clear_attachments[0].clearValue.color.float32[3] = 0.0;
-            VkClearRect clear_rects[1];
-            clear_rects[0].baseArrayLayer     = 0;
-            clear_rects[0].layerCount         = 1;
-            clear_rects[0].rect.offset.x      = 0;
-            clear_rects[0].rect.offset.y      = 0;
-            clear_rects[0].rect.extent.width  = m_vulkan_rhi->m_swapchain_extent.width;
-            clear_rects[0].rect.extent.height = m_vulkan_rhi->m_swapchain_extent.height;
-            m_vulkan_rhi->m_vk_cmd_clear_attachments(m_vulkan_rhi->m_current_post_process_command_buffer,
-                                                     sizeof(clear_attachments) / sizeof(clear_attachments[0]),
-                                                     clear_attachments,
-                                                     sizeof(clear_rects) / sizeof(clear_rects[0]),
-                                                     clear_rects);
-        }
-        
-        remap_pass.draw();
+            vignette_pass.draw();
 
-        m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer,
+                                                VK_SUBPASS_CONTENTS_INLINE);
+
+            {
+                VkClearAttachment clear_attachments[1];
+                clear_attachments[0].aspectMask                  = VK_IMAGE_ASPECT_COLOR_BIT;
+                clear_attachments[0].colorAttachment             = _post_process_pass_backup_buffer_odd;
+                clear_attachments[0].clearValue.color.float32[0] = 0.0;
+                clear_attachments[0].clearValue.color.float32[1] = 0.0;
+                clear_attachments[0].clearValue.color.float32[2] = 0.0;
+                clear_attachments[0].clearValue.color.float32[3] = 0.0;
+                VkClearRect clear_rects[1];
+                clear_rects[0].baseArrayLayer     = 0;
+                clear_rects[0].layerCount         = 1;
+                clear_rects[0].rect.offset.x      = 0;
+                clear_rects[0].rect.offset.y      = 0;
+                clear_rects[0].rect.extent.width  = m_vulkan_rhi->m_swapchain_extent.width;
+                clear_rects[0].rect.extent.height = m_vulkan_rhi->m_swapchain_extent.height;
+                m_vulkan_rhi->m_vk_cmd_clear_attachments(m_vulkan_rhi->m_current_post_process_command_buffer,
+                                                         sizeof(clear_attachments) / sizeof(clear_attachments[0]),
+                                                         clear_attachments,
+                                                         sizeof(clear_rects) / sizeof(clear_rects[0]),
+                                                         clear_rects);
+            }
+
+            remap_pass.draw();
+
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_post_process_command_buffer,
+                                                VK_SUBPASS_CONTENTS_INLINE);
+        }
 
         VkClearAttachment clear_attachments[1];
         clear_attachments[0].aspectMask                  = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -808,24 +975,10 @@ namespace Piccolo
         if (!m_is_show_axis)
             return;
 
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-            perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-        assert(m_global_render_resource->_storage_buffer
-                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-               (m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-        (*reinterpret_cast<MeshPerframeStorageBufferObject*>(
-            reinterpret_cast<uintptr_t>(
-                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-            perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
+        auto     perframe_allocation     = allocateUpload<MeshPerframeStorageBufferObject>();
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+        *perframe_allocation.data = m_mesh_perframe_storage_buffer_object;
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
@@ -6,6 +6,7 @@
 #include "runtime/function/render/passes/combine_ui_pass.h"
 #include "runtime/function/render/passes/fxaa_pass.h"
 #include "runtime/function/render/passes/tone_mapping_pass.h"
+#include "runtime/function/render/passes/uber_post_process_pass.h"
 #include "runtime/function/render/passes/ui_pass.h"
 #include "runtime/function/render/passes/vignette_pass.h"
 #include "runtime/function/render/passes/remap_pass.h"
@@ -17,6 +18,7 @@ namespace Piccolo
     struct PostProcessPassInitInfo : RenderPassInitInfo
     {
         bool enable_fxaa;
+        bool enable_fused_post_process;
         VkImageView color_input_image_view;
         VkImageView bright_color_input_image_view;
     };
@@ -47,6 +49,7 @@ namespace Piccolo
             ColorGradingPass& color_grading_pass,
             FXAAPass& fxaa_pass,
             ToneMappingPass& tone_mapping_pass,
+            UberPostProcessPass& uber_post_process_pass,
             UIPass& ui_pass,
             CombineUIPass& combine_ui_pass,
             uint32_t          current_swapchain_image_index);
@@ -54,6 +57,7 @@ namespace Piccolo
 
         bool                                         m_is_show_axis{ false };
         bool                                         m_enable_fxaa{ true };
+        bool                                         m_enable_fused_post_process{ false };
         size_t                                       m_selected_axis{ 3 };
         MeshPerframeStorageBufferObject              m_mesh_perframe_storage_buffer_object;
         AxisStorageBufferObject                      m_axis_storage_buffer_object;
@@ -67,6 +71,7 @@ namespace Piccolo
     private:
         void setupAttachments();
         void setupRenderPass();
+        void setupFusedRenderPass(const VkAttachmentDescription* attachments_dscp);
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
@@ -37,7 +37,13 @@ namespace Piccolo
         }
     }
 
-    void PreDepthPass::draw() { drawModel(); }
+    void PreDepthPass::draw()
+    {
+        beginRenderPass(m_vulkan_rhi->m_current_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+        recordRenderPass(m_vulkan_rhi->m_current_command_buffer);
+        endRenderPass(m_vulkan_rhi->m_current_command_buffer);
+    }
+
     void PreDepthPass::setupAttachments()
     {
         m_framebuffer.attachments.resize(1);
@@ -336,7 +342,7 @@ namespace Piccolo
         pipelineInfo.pDynamicState = &dynamic_state_create_info;
 
         if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
+                m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
             VK_SUCCESS)
         {
             throw std::runtime_error("create mesh gbuffer graphics pipeline");
@@ -421,65 +427,37 @@ namespace Piccolo
                                NULL);
     }
 
-    void PreDepthPass::drawModel()
+    void PreDepthPass::beginRenderPass(VkCommandBuffer command_buffer, VkSubpassContents contents)
     {
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
+        VkRenderPassBeginInfo renderpass_begin_info {};
+        renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
+        renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
+        renderpass_begin_info.renderArea.offset = {0, 0};
+        renderpass_begin_info.renderArea.extent = {m_vulkan_rhi->m_swapchain_extent.width,
+                                                   m_vulkan_rhi->m_swapchain_extent.height};
+
+        VkClearValue clear_values[2];
+        clear_values[0].color                 = {1.0f};
+        clear_values[1].depthStencil          = {1.0f, 0};
+        renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
+        renderpass_begin_info.pClearValues    = clear_values;
+
+        m_vulkan_rhi->m_vk_cmd_begin_render_pass(command_buffer, &renderpass_begin_info, contents);
 
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>>
-            pre_depth_mesh_drawcall_batch;
-
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
+        if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            if (node.is_NBR_material)
-                continue;
-            auto& mesh_instanced = pre_depth_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
-
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
-
-            mesh_nodes.push_back(temp);
+            VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+                                               NULL,
+                                               "Pre Depth",
+                                               {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
         }
+    }
 
-        // begin pass
-        {
-            VkRenderPassBeginInfo renderpass_begin_info {};
-            renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
-            renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
-            renderpass_begin_info.renderArea.offset = {0, 0};
-            renderpass_begin_info.renderArea.extent = {m_vulkan_rhi->m_swapchain_extent.width,
-                                                       m_vulkan_rhi->m_swapchain_extent.height};
-
-            VkClearValue clear_values[2];
-            clear_values[0].color                 = {1.0f};
-            clear_values[1].depthStencil          = {1.0f, 0};
-            renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
-            renderpass_begin_info.pClearValues    = clear_values;
-
-            m_vulkan_rhi->m_vk_cmd_begin_render_pass(
-                m_vulkan_rhi->m_current_command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
-
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
-                                                   NULL,
-                                                   "Pre Depth",
-                                                   {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
-            }
-        }
+    void PreDepthPass::recordRenderPass(VkCommandBuffer command_buffer)
+    {
+        const RenderDrawList& draw_list = *m_visiable_nodes.p_main_camera_draw_list;
 
         // Mesh
 
@@ -487,14 +465,14 @@ namespace Piccolo
         {
             VkDebugUtilsLabelEXT label_info = {
                 VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh", {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
         }
 
-        m_vulkan_rhi->m_vk_cmd_bind_pipeline(m_vulkan_rhi->m_current_command_buffer,
+        m_vulkan_rhi->m_vk_cmd_bind_pipeline(command_buffer,
                                                 VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                 m_render_pipelines[0].pipeline);
 
-        vkCmdPushConstants(m_vulkan_rhi->m_current_command_buffer, 
+        vkCmdPushConstants(command_buffer, 
                            m_render_pipelines[0].layout, 
                            VK_SHADER_STAGE_VERTEX_BIT,
                            0,
@@ -504,180 +482,153 @@ namespace Piccolo
         VkViewport viewport {};
         viewport.x        = 0.0f;
         viewport.y        = 0.0f;
-        viewport.width    = m_vulkan_rhi->m_swapchain_extent.width;
-        viewport.height   = m_vulkan_rhi->m_swapchain_extent.height;
+        viewport.width    = m_vulkan_rhi->m_scene_extent.width;
+        viewport.height   = m_vulkan_rhi->m_scene_extent.height;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         VkRect2D scissor {};
         scissor.offset = {0, 0};
-        scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height};
-        m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &viewport);
-        m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
+        scissor.extent = {m_vulkan_rhi->m_scene_extent.width, m_vulkan_rhi->m_scene_extent.height};
+        m_vulkan_rhi->m_vk_cmd_set_viewport(command_buffer, 0, 1, &viewport);
+        m_vulkan_rhi->m_vk_cmd_set_scissor(command_buffer, 0, 1, &scissor);
 
 
-        for (auto& [material, mesh_instanced] : pre_depth_mesh_drawcall_batch)
+        for (const RenderDrawBatch& batch : draw_list.getBatches())
         {
-            // TODO: render from near to far
+            // nbr materials are drawn by the nbr pass
+            if (batch.m_is_NBR_material)
+            {
+                continue;
+            }
 
-            for (auto& [mesh, mesh_nodes] : mesh_instanced)
+            VulkanMesh*           mesh       = batch.m_mesh;
+            const RenderMeshNode* mesh_nodes = draw_list.getBatchNodes(batch);
+
+            uint32_t total_instance_count = batch.m_node_count;
+            if (total_instance_count > 0)
             {
-                uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                if (total_instance_count > 0)
+                // bind per mesh
+                m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                                                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                            m_render_pipelines[0].layout,
+                                                            1,
+                                                            1,
+                                                            &mesh->mesh_vertex_blending_descriptor_set,
+                                                            0,
+                                                            NULL);
+
+                VkBuffer     vertex_buffers[] = {mesh->mesh_vertex_position_buffer};
+                VkDeviceSize offsets[]        = {0};
+                m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(command_buffer, 0, 1, vertex_buffers, offsets);
+                m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                    command_buffer, mesh->mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
                 {
-                    // bind per mesh
-                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
-                                                                VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                                m_render_pipelines[0].layout,
-                                                                1,
-                                                                1,
-                                                                &mesh->mesh_vertex_blending_descriptor_set,
-                                                                0,
-                                                                NULL);
-
-                    VkBuffer     vertex_buffers[] = {mesh->mesh_vertex_position_buffer};
-                    VkDeviceSize offsets[]        = {0};
-                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
-                        m_vulkan_rhi->m_current_command_buffer, 0, 1, vertex_buffers, offsets);
-                    m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                        m_vulkan_rhi->m_current_command_buffer, mesh->mesh_index_buffer, 0, VK_INDEX_TYPE_UINT32);
-
-                    uint32_t drawcall_max_instance_count =
-                        (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
-                         sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
-                    uint32_t drawcall_count =
-                        roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                    for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                            drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // perdrawcall storage buffer
+                    auto     perdrawcall_allocation     = allocateUpload<MeshPerdrawcallStorageBufferObject>();
+                    uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                    MeshPerdrawcallStorageBufferObject&
+                        perdrawcall_storage_buffer_object = *perdrawcall_allocation.data;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
                     {
-                        uint32_t current_instance_count =
-                            ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                                drawcall_max_instance_count) ?
-                                (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                drawcall_max_instance_count;
-
-                        // perdrawcall storage buffer
-                        uint32_t perdrawcall_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                            perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                (m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                        MeshPerdrawcallStorageBufferObject&
-                            perdrawcall_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                                    reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                    ._global_upload_ringbuffer_memory_pointer) +
-                                    perdrawcall_dynamic_offset));
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                                -1.0;
-                        }
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]) ?
+                                1.0 :
+                                -1.0;
+                    }
 
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
+                    // per drawcall vertex blending storage buffer
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset;
+                    bool     least_one_enable_vertex_blending = true;
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        if (!isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                         {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
+                            least_one_enable_vertex_blending = false;
+                            break;
                         }
-                        if (least_one_enable_vertex_blending)
+                    }
+                    if (least_one_enable_vertex_blending)
+                    {
+                        auto per_drawcall_vertex_blending_allocation =
+                            allocateUpload<MeshPerdrawcallVertexBlendingStorageBufferObject>();
+                        per_drawcall_vertex_blending_dynamic_offset =
+                            per_drawcall_vertex_blending_allocation.dynamic_offset;
+
+                        MeshPerdrawcallVertexBlendingStorageBufferObject&
+                            per_drawcall_vertex_blending_storage_buffer_object =
+                                *per_drawcall_vertex_blending_allocation.data;
+                        for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                    (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
+                            if (isShaderVertexBlending(mesh_nodes[drawcall_max_instance_count * drawcall_index + i]))
                             {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
+                                for (uint32_t j = 0;
+                                        j <
+                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
+                                        ++j)
                                 {
-                                    for (uint32_t j = 0;
-                                            j <
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                            ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
+                                    per_drawcall_vertex_blending_storage_buffer_object
+                                        .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
+                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
+                                            .joint_matrices[j];
                                 }
                             }
                         }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
-
-                        // bind perdrawcall
-                        uint32_t dynamic_offsets[2] = {perdrawcall_dynamic_offset,
-                                                        per_drawcall_vertex_blending_dynamic_offset};
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                            m_vulkan_rhi->m_current_command_buffer,
-                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_render_pipelines[0].layout,
-                            0,
-                            1,
-                            &m_descriptor_infos[0].descriptor_set,
-                            (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
-                            dynamic_offsets);
-                        m_vulkan_rhi->m_vk_cmd_draw_indexed(m_vulkan_rhi->m_current_command_buffer,
-                                                            mesh->mesh_index_count,
-                                                            current_instance_count,
-                                                            0,
-                                                            0,
-                                                            0);
                     }
+                    else
+                    {
+                        per_drawcall_vertex_blending_dynamic_offset = 0;
+                    }
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[2] = {perdrawcall_dynamic_offset,
+                                                    per_drawcall_vertex_blending_dynamic_offset};
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        m_render_pipelines[0].layout,
+                        0,
+                        1,
+                        &m_descriptor_infos[0].descriptor_set,
+                        (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                        dynamic_offsets);
+                    drawMeshInstances(command_buffer,
+                                      *mesh,
+                                      mesh_nodes + drawcall_max_instance_count * drawcall_index,
+                                      current_instance_count,
+                                      1);
                 }
             }
         }
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
         }
-        
+    }
 
-        // Directional Light Shadow end pass
+    void PreDepthPass::endRenderPass(VkCommandBuffer command_buffer)
+    {
+        if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
-            }
-
-            m_vulkan_rhi->m_vk_cmd_end_render_pass(m_vulkan_rhi->m_current_command_buffer);
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
         }
+
+        m_vulkan_rhi->m_vk_cmd_end_render_pass(command_buffer);
     }
 } // namespace Piccolo
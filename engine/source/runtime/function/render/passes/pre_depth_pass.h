@@ -13,6 +13,11 @@ namespace Piccolo
         void postInitialize() override final;
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
         void draw() override final;
+
+        void beginRenderPass(VkCommandBuffer command_buffer, VkSubpassContents contents) override final;
+        void recordRenderPass(VkCommandBuffer command_buffer) override final;
+        void endRenderPass(VkCommandBuffer command_buffer) override final;
+
         void setPerMeshLayout(const VkDescriptorSetLayout& layout) { m_per_mesh_layout = layout; }
 
     private:
@@ -22,7 +27,6 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
-        void drawModel();
 
     private:
         VkDescriptorSetLayout m_per_mesh_layout;
@@ -64,7 +64,8 @@ namespace Piccolo
         const RenderResource* vulkan_resource = static_cast<const RenderResource*>(render_resource.get());
         if (vulkan_resource)
         {
-            m_brightness_threshold = vulkan_resource->m_render_global_effect_setting_object.bloomThreshold;
+            m_ssao_blur_push_constants_object.brightness_threshold =
+                vulkan_resource->m_render_global_effect_setting_object.bloomThreshold;
         }
 
     }
@@ -76,7 +77,7 @@ namespace Piccolo
         VkPushConstantRange pushConstantRange {};
         pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         pushConstantRange.offset     = 0;
-        pushConstantRange.size       = sizeof(float);
+        pushConstantRange.size       = sizeof(SSAOBlurPushConstantsObject);
 
         VkDescriptorSetLayout      descriptorset_layouts[1] = {m_descriptor_infos[0].layout};
         VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
@@ -213,7 +214,7 @@ namespace Piccolo
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
         if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
+                m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
             VK_SUCCESS)
         {
             throw std::runtime_error("create post process graphics pipeline");
@@ -301,24 +302,27 @@ namespace Piccolo
 
         m_vulkan_rhi->m_vk_cmd_bind_pipeline(
             m_vulkan_rhi->m_current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
-        
+
+        // the ssao only covers the scene region, the blur must not read past it
+        m_ssao_blur_push_constants_object.scene_extent_x = static_cast<int32_t>(m_vulkan_rhi->m_scene_extent.width);
+        m_ssao_blur_push_constants_object.scene_extent_y = static_cast<int32_t>(m_vulkan_rhi->m_scene_extent.height);
         vkCmdPushConstants(m_vulkan_rhi->m_current_command_buffer,
                            m_render_pipelines[0].layout,
                            VK_SHADER_STAGE_FRAGMENT_BIT,
                            0,
-                           sizeof(float),
-                           &m_brightness_threshold);
+                           sizeof(SSAOBlurPushConstantsObject),
+                           &m_ssao_blur_push_constants_object);
 
         VkViewport viewport {};
         viewport.x        = 0.0f;
         viewport.y        = 0.0f;
-        viewport.width    = m_vulkan_rhi->m_swapchain_extent.width;
-        viewport.height   = m_vulkan_rhi->m_swapchain_extent.height;
+        viewport.width    = m_vulkan_rhi->m_scene_extent.width;
+        viewport.height   = m_vulkan_rhi->m_scene_extent.height;
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         VkRect2D scissor {};
         scissor.offset = {0, 0};
-        scissor.extent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height};
+        scissor.extent = {m_vulkan_rhi->m_scene_extent.width, m_vulkan_rhi->m_scene_extent.height};
         m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &viewport);
         m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &scissor);
         m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
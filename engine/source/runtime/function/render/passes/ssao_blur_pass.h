@@ -4,6 +4,13 @@
 
 namespace Piccolo
 {
+    struct SSAOBlurPushConstantsObject
+    {
+        float   brightness_threshold;
+        int32_t scene_extent_x;
+        int32_t scene_extent_y;
+    };
+
     struct SSAOBlurPassInitInfo : RenderPassInitInfo
     {
         VkRenderPass render_pass;
@@ -23,6 +30,6 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
-        float m_brightness_threshold;
+        SSAOBlurPushConstantsObject m_ssao_blur_push_constants_object;
     };
 } // namespace Piccolo
@@ -27,19 +27,20 @@ namespace Piccolo
     {
         m_descriptor_infos.resize(1);
 
+        // the color and the bright color are sampled, the scene rendered into their top left is upscaled
         VkDescriptorSetLayoutBinding post_process_global_layout_bindings[2] = {};
 
         VkDescriptorSetLayoutBinding& post_process_global_layout_input_attachment_binding =
             post_process_global_layout_bindings[0];
         post_process_global_layout_input_attachment_binding.binding         = 0;
-        post_process_global_layout_input_attachment_binding.descriptorType  = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        post_process_global_layout_input_attachment_binding.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         post_process_global_layout_input_attachment_binding.descriptorCount = 1;
         post_process_global_layout_input_attachment_binding.stageFlags      = VK_SHADER_STAGE_FRAGMENT_BIT;
 
         VkDescriptorSetLayoutBinding& post_process_global_layout_bloom_input_attachment_binding =
             post_process_global_layout_bindings[1];
         post_process_global_layout_bloom_input_attachment_binding.binding   = 1;
-        post_process_global_layout_bloom_input_attachment_binding.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        post_process_global_layout_bloom_input_attachment_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         post_process_global_layout_bloom_input_attachment_binding.descriptorCount = 1;
         post_process_global_layout_bloom_input_attachment_binding.stageFlags      = VK_SHADER_STAGE_FRAGMENT_BIT;
 
@@ -62,11 +63,18 @@ namespace Piccolo
     {
         m_render_pipelines.resize(1);
 
+        VkPushConstantRange pushConstantRange {};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushConstantRange.offset     = 0;
+        pushConstantRange.size       = sizeof(ToneMappingConstantObject);
+
         VkDescriptorSetLayout      descriptorset_layouts[1] = {m_descriptor_infos[0].layout};
         VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
-        pipeline_layout_create_info.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipeline_layout_create_info.setLayoutCount = 1;
-        pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
+        pipeline_layout_create_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount         = 1;
+        pipeline_layout_create_info.pSetLayouts            = descriptorset_layouts;
+        pipeline_layout_create_info.pushConstantRangeCount = 1;
+        pipeline_layout_create_info.pPushConstantRanges    = &pushConstantRange;
 
         if (vkCreatePipelineLayout(
                 m_vulkan_rhi->m_device, &pipeline_layout_create_info, nullptr, &m_render_pipelines[0].layout) !=
@@ -185,7 +193,7 @@ namespace Piccolo
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
         if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
+                m_vulkan_rhi->m_device, m_vulkan_rhi->m_pipeline_cache, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
             VK_SUCCESS)
         {
             throw std::runtime_error("create post process graphics pipeline");
@@ -216,13 +224,13 @@ namespace Piccolo
     {
         VkDescriptorImageInfo post_process_per_frame_input_attachment_info = {};
         post_process_per_frame_input_attachment_info.sampler =
-            VulkanUtil::getOrCreateNearestSampler(m_vulkan_rhi->m_physical_device, m_vulkan_rhi->m_device);
+            VulkanUtil::getOrCreateLinearSampler(m_vulkan_rhi->m_physical_device, m_vulkan_rhi->m_device);
         post_process_per_frame_input_attachment_info.imageView   = color_attachment;
         post_process_per_frame_input_attachment_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         VkDescriptorImageInfo post_process_per_frame_bloom_input_attachment_info = {};
         post_process_per_frame_bloom_input_attachment_info.sampler =
-            VulkanUtil::getOrCreateNearestSampler(m_vulkan_rhi->m_physical_device, m_vulkan_rhi->m_device);
+            VulkanUtil::getOrCreateLinearSampler(m_vulkan_rhi->m_physical_device, m_vulkan_rhi->m_device);
         post_process_per_frame_bloom_input_attachment_info.imageView   = bright_color_attachment;
         post_process_per_frame_bloom_input_attachment_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
@@ -235,7 +243,7 @@ namespace Piccolo
         post_process_descriptor_input_attachment_write_info.dstSet          = m_descriptor_infos[0].descriptor_set;
         post_process_descriptor_input_attachment_write_info.dstBinding      = 0;
         post_process_descriptor_input_attachment_write_info.dstArrayElement = 0;
-        post_process_descriptor_input_attachment_write_info.descriptorType  = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        post_process_descriptor_input_attachment_write_info.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         post_process_descriptor_input_attachment_write_info.descriptorCount = 1;
         post_process_descriptor_input_attachment_write_info.pImageInfo = &post_process_per_frame_input_attachment_info;
         
@@ -246,7 +254,7 @@ namespace Piccolo
         post_process_descriptor_bloom_input_attachment_write_info.dstSet          = m_descriptor_infos[0].descriptor_set;
         post_process_descriptor_bloom_input_attachment_write_info.dstBinding      = 1;
         post_process_descriptor_bloom_input_attachment_write_info.dstArrayElement = 0;
-        post_process_descriptor_bloom_input_attachment_write_info.descriptorType  = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        post_process_descriptor_bloom_input_attachment_write_info.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         post_process_descriptor_bloom_input_attachment_write_info.descriptorCount = 1;
         post_process_descriptor_bloom_input_attachment_write_info.pImageInfo = &post_process_per_frame_bloom_input_attachment_info;
 
@@ -292,6 +300,18 @@ namespace Piccolo
                                                     0,
                                                     NULL);
 
+        ToneMappingConstantObject tone_mapping_constant_object;
+        tone_mapping_constant_object.render_scale_x =
+            static_cast<float>(m_vulkan_rhi->m_scene_extent.width) / m_vulkan_rhi->m_swapchain_extent.width;
+        tone_mapping_constant_object.render_scale_y =
+            static_cast<float>(m_vulkan_rhi->m_scene_extent.height) / m_vulkan_rhi->m_swapchain_extent.height;
+        vkCmdPushConstants(m_vulkan_rhi->m_current_post_process_command_buffer,
+                           m_render_pipelines[0].layout,
+                           VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0,
+                           sizeof(ToneMappingConstantObject),
+                           &tone_mapping_constant_object);
+
         vkCmdDraw(m_vulkan_rhi->m_current_post_process_command_buffer, 3, 1, 0, 0);
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
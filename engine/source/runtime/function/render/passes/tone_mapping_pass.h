@@ -11,6 +11,13 @@ namespace Piccolo
         VkImageView  bright_color_attachment;
     };
 
+    struct ToneMappingConstantObject
+    {
+        // the share of the color the scene is rendered into
+        float render_scale_x;
+        float render_scale_y;
+    };
+
     class ToneMappingPass : public RenderPass
     {
     public:
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "runtime/function/render/render_pass.h"
+
+namespace Piccolo
+{
+    struct UberPostProcessPassInitInfo : RenderPassInitInfo
+    {
+        VkRenderPass render_pass;
+        VkImageView  color_attachment;
+        VkImageView  bright_color_attachment;
+    };
+
+    struct UberPostProcessConstantObject
+    {
+        float color_grading_effect;
+        float brightness;
+        float contrast;
+        float saturation;
+        float temperature;
+        float vignette_cutoff;
+        float vignette_exponent;
+        float _padding_vignette_exponent;
+        // the share of the color the scene is rendered into
+        float render_scale_x;
+        float render_scale_y;
+    };
+
+    // tone mapping, color grading, vignette and remap in one full screen pass. tone mapping is always on, the other
+    // effects are specialization constants, so there is one pipeline per set of enabled effects
+    class UberPostProcessPass : public RenderPass
+    {
+    public:
+        enum EffectBit : uint32_t
+        {
+            _effect_color_grading     = 1u << 0,
+            _effect_vignette          = 1u << 1,
+            _effect_combination_count = 1u << 2
+        };
+
+        void initialize(const RenderPassInitInfo* init_info) override final;
+        void draw() override final;
+        void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
+        void updateAfterFramebufferRecreate(VkImageView color_attachment, VkImageView bright_color_attachment);
+
+    private:
+        void setupDescriptorSetLayout();
+        void setupPipelines();
+        void setupDescriptorSet();
+
+    private:
+        UberPostProcessConstantObject m_uber_post_process_constant_object;
+        uint32_t                      m_enabled_effects {0};
+    };
+} // namespace Piccolo
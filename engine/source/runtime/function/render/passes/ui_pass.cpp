@@ -17,7 +17,9 @@ namespace Piccolo
     {
         RenderPass::initialize(nullptr);
 
-        m_framebuffer.render_pass = static_cast<const UIPassInitInfo*>(init_info)->render_pass;
+        const UIPassInitInfo* _init_info = static_cast<const UIPassInitInfo*>(init_info);
+        m_framebuffer.render_pass        = _init_info->render_pass;
+        m_subpass                        = _init_info->subpass;
     }
 
     void UIPass::initializeUIRenderBackend(WindowUI* window_ui)
@@ -32,7 +34,8 @@ namespace Piccolo
         init_info.QueueFamily               = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
         init_info.Queue                     = m_vulkan_rhi->m_graphics_queue;
         init_info.DescriptorPool            = m_vulkan_rhi->m_descriptor_pool;
-        init_info.Subpass                   = _post_process_subpass_ui;
+        init_info.PipelineCache             = m_vulkan_rhi->m_pipeline_cache;
+        init_info.Subpass                   = m_subpass;
 
         // may be different from the real swapchain image count
         // see ImGui_ImplVulkanH_GetMinImageCountFromPresentMode
@@ -0,0 +1,233 @@
+#include "runtime/function/render/render_bvh.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Piccolo
+{
+    // the hierarchy is median split, so its depth never exceeds log2(leaf count) + 1
+    static const size_t s_bvh_max_traversal_depth = 64;
+
+    void RenderBVH::build(const std::vector<BoundingBox>& leaf_bounds)
+    {
+        clear();
+
+        if (leaf_bounds.empty())
+        {
+            return;
+        }
+
+        m_nodes.reserve(leaf_bounds.size() * 2 - 1);
+        m_leaf_nodes.resize(leaf_bounds.size(), s_invalid_node);
+
+        std::vector<uint32_t> leaf_order(leaf_bounds.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(leaf_order.size()); ++i)
+        {
+            leaf_order[i] = i;
+        }
+
+        buildRange(leaf_order, leaf_bounds, 0, leaf_order.size(), s_invalid_node);
+    }
+
+    uint32_t RenderBVH::buildRange(std::vector<uint32_t>&          leaf_order,
+                                   const std::vector<BoundingBox>& leaf_bounds,
+                                   size_t                          begin,
+                                   size_t                          end,
+                                   uint32_t                        parent)
+    {
+        uint32_t node_index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_nodes[node_index].m_parent = parent;
+
+        if (end - begin == 1)
+        {
+            uint32_t leaf                 = leaf_order[begin];
+            m_nodes[node_index].m_bounds  = leaf_bounds[leaf];
+            m_nodes[node_index].m_leaf    = leaf;
+            m_leaf_nodes[leaf]            = node_index;
+            return node_index;
+        }
+
+        // split at the median centroid along the longest axis of the centroid bounds
+        BoundingBox centroid_bounds(leaf_bounds[leaf_order[begin]].min_bound, leaf_bounds[leaf_order[begin]].min_bound);
+        for (size_t i = begin; i < end; ++i)
+        {
+            const BoundingBox& bounds = leaf_bounds[leaf_order[i]];
+            centroid_bounds.merge((bounds.min_bound + bounds.max_bound) * 0.5f);
+        }
+
+        Vector3 centroid_extent = centroid_bounds.max_bound - centroid_bounds.min_bound;
+        size_t  axis            = 0;
+        if (centroid_extent.y > centroid_extent.x)
+        {
+            axis = 1;
+        }
+        if (centroid_extent.z > centroid_extent[axis])
+        {
+            axis = 2;
+        }
+
+        size_t middle = begin + (end - begin) / 2;
+        std::nth_element(leaf_order.begin() + begin,
+                         leaf_order.begin() + middle,
+                         leaf_order.begin() + end,
+                         [&leaf_bounds, axis](uint32_t lhs, uint32_t rhs) {
+                             return leaf_bounds[lhs].min_bound[axis] + leaf_bounds[lhs].max_bound[axis] <
+                                    leaf_bounds[rhs].min_bound[axis] + leaf_bounds[rhs].max_bound[axis];
+                         });
+
+        uint32_t left  = buildRange(leaf_order, leaf_bounds, begin, middle, node_index);
+        uint32_t right = buildRange(leaf_order, leaf_bounds, middle, end, node_index);
+
+        // m_nodes may have been reallocated by the recursion
+        Node& node    = m_nodes[node_index];
+        node.m_left   = left;
+        node.m_right  = right;
+        node.m_bounds = m_nodes[left].m_bounds;
+        node.m_bounds.merge(m_nodes[right].m_bounds);
+        return node_index;
+    }
+
+    void RenderBVH::refit(size_t leaf_index, const BoundingBox& leaf_bounds)
+    {
+        assert(leaf_index < m_leaf_nodes.size());
+
+        uint32_t node_index            = m_leaf_nodes[leaf_index];
+        m_nodes[node_index].m_bounds   = leaf_bounds;
+        node_index                     = m_nodes[node_index].m_parent;
+
+        while (node_index != s_invalid_node)
+        {
+            Node&       node        = m_nodes[node_index];
+            BoundingBox new_bounds  = m_nodes[node.m_left].m_bounds;
+            new_bounds.merge(m_nodes[node.m_right].m_bounds);
+
+            if (new_bounds.min_bound == node.m_bounds.min_bound && new_bounds.max_bound == node.m_bounds.max_bound)
+            {
+                // the ancestors are not affected
+                break;
+            }
+
+            node.m_bounds = new_bounds;
+            node_index    = node.m_parent;
+        }
+    }
+
+    void RenderBVH::queryFrustum(const ClusterFrustum& frustum, std::vector<size_t>& leaves) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        uint32_t stack[s_bvh_max_traversal_depth];
+        size_t   stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0)
+        {
+            const Node& node = m_nodes[stack[--stack_size]];
+
+            if (!TiledFrustumIntersectBox(frustum, node.m_bounds))
+            {
+                continue;
+            }
+
+            if (node.isLeaf())
+            {
+                leaves.push_back(node.m_leaf);
+            }
+            else if (TiledFrustumContainBox(frustum, node.m_bounds))
+            {
+                // the whole subtree is visible, no need to test the children
+                collectLeaves(node.m_left, leaves);
+                collectLeaves(node.m_right, leaves);
+            }
+            else
+            {
+                assert(stack_size + 2 <= s_bvh_max_traversal_depth);
+                stack[stack_size++] = node.m_right;
+                stack[stack_size++] = node.m_left;
+            }
+        }
+    }
+
+    void RenderBVH::querySpheres(const std::vector<BoundingSphere>& spheres, std::vector<size_t>& leaves) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        uint32_t stack[s_bvh_max_traversal_depth];
+        size_t   stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0)
+        {
+            const Node& node = m_nodes[stack[--stack_size]];
+
+            bool intersect_with_spheres = true;
+            for (const BoundingSphere& sphere : spheres)
+            {
+                if (!BoxIntersectsWithSphere(node.m_bounds, sphere))
+                {
+                    intersect_with_spheres = false;
+                    break;
+                }
+            }
+
+            if (!intersect_with_spheres)
+            {
+                continue;
+            }
+
+            if (node.isLeaf())
+            {
+                leaves.push_back(node.m_leaf);
+            }
+            else
+            {
+                assert(stack_size + 2 <= s_bvh_max_traversal_depth);
+                stack[stack_size++] = node.m_right;
+                stack[stack_size++] = node.m_left;
+            }
+        }
+    }
+
+    void RenderBVH::collectLeaves(uint32_t node_index, std::vector<size_t>& leaves) const
+    {
+        uint32_t stack[s_bvh_max_traversal_depth];
+        size_t   stack_size = 0;
+        stack[stack_size++] = node_index;
+
+        while (stack_size > 0)
+        {
+            const Node& node = m_nodes[stack[--stack_size]];
+            if (node.isLeaf())
+            {
+                leaves.push_back(node.m_leaf);
+            }
+            else
+            {
+                stack[stack_size++] = node.m_right;
+                stack[stack_size++] = node.m_left;
+            }
+        }
+    }
+
+    BoundingBox RenderBVH::getBounds() const
+    {
+        if (m_nodes.empty())
+        {
+            return BoundingBox(Vector3(FLT_MAX, FLT_MAX, FLT_MAX), Vector3(FLT_MIN, FLT_MIN, FLT_MIN));
+        }
+        return m_nodes[0].m_bounds;
+    }
+
+    void RenderBVH::clear()
+    {
+        m_nodes.clear();
+        m_leaf_nodes.clear();
+    }
+} // namespace Piccolo
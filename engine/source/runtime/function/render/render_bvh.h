@@ -0,0 +1,59 @@
+#pragma once
+
+#include "runtime/function/render/render_helper.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    // bounding volume hierarchy over the world space bounds of the render entities
+    // leaf i always refers to the entity i of the array the hierarchy is built from
+    class RenderBVH
+    {
+    public:
+        static constexpr uint32_t s_invalid_node = UINT32_MAX;
+
+        // rebuild the whole hierarchy, used when entities are inserted or removed
+        void build(const std::vector<BoundingBox>& leaf_bounds);
+
+        // update the bounds of one leaf and enlarge or shrink its ancestors, used when the transform changes
+        void refit(size_t leaf_index, const BoundingBox& leaf_bounds);
+
+        // collect the leaves whose bounds intersect the frustum
+        void queryFrustum(const ClusterFrustum& frustum, std::vector<size_t>& leaves) const;
+
+        // collect the leaves whose bounds intersect all the spheres
+        void querySpheres(const std::vector<BoundingSphere>& spheres, std::vector<size_t>& leaves) const;
+
+        // bounds of the whole hierarchy
+        BoundingBox getBounds() const;
+
+        size_t getLeafCount() const { return m_leaf_nodes.size(); }
+
+        void clear();
+
+    private:
+        struct Node
+        {
+            BoundingBox m_bounds;
+            uint32_t    m_parent {s_invalid_node};
+            uint32_t    m_left {s_invalid_node};
+            uint32_t    m_right {s_invalid_node};
+            uint32_t    m_leaf {s_invalid_node};
+
+            bool isLeaf() const { return m_leaf != s_invalid_node; }
+        };
+
+        std::vector<Node>     m_nodes;
+        std::vector<uint32_t> m_leaf_nodes;
+
+        uint32_t buildRange(std::vector<uint32_t>&          leaf_order,
+                            const std::vector<BoundingBox>& leaf_bounds,
+                            size_t                          begin,
+                            size_t                          end,
+                            uint32_t                        parent);
+
+        void collectLeaves(uint32_t node_index, std::vector<size_t>& leaves) const;
+    };
+} // namespace Piccolo
@@ -0,0 +1,96 @@
+#include "runtime/function/render/render_command_recorder.h"
+
+#include "runtime/core/base/thread_pool.h"
+
+#include "runtime/function/render/render_pass.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
+
+#include <stdexcept>
+
+namespace Piccolo
+{
+    void RenderCommandRecorder::initialize(std::shared_ptr<VulkanRHI>  rhi,
+                                           std::shared_ptr<ThreadPool> thread_pool,
+                                           std::vector<RenderPass*>    passes)
+    {
+        m_vulkan_rhi  = rhi;
+        m_thread_pool = thread_pool;
+        m_passes      = std::move(passes);
+
+        size_t command_buffer_count = VulkanRHI::s_max_frames_in_flight * m_passes.size();
+        m_command_pools.resize(command_buffer_count);
+        m_command_buffers.resize(command_buffer_count);
+
+        VkCommandPoolCreateInfo command_pool_create_info {};
+        command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.pNext            = NULL;
+        command_pool_create_info.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        command_pool_create_info.queueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
+
+        for (size_t i = 0; i < command_buffer_count; ++i)
+        {
+            if (vkCreateCommandPool(m_vulkan_rhi->m_device, &command_pool_create_info, NULL, &m_command_pools[i]) !=
+                VK_SUCCESS)
+            {
+                throw std::runtime_error("vk create command pool");
+            }
+
+            VkCommandBufferAllocateInfo command_buffer_allocate_info {};
+            command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            command_buffer_allocate_info.commandPool        = m_command_pools[i];
+            command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            command_buffer_allocate_info.commandBufferCount = 1;
+
+            if (vkAllocateCommandBuffers(
+                    m_vulkan_rhi->m_device, &command_buffer_allocate_info, &m_command_buffers[i]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("vk allocate command buffers");
+            }
+        }
+    }
+
+    void RenderCommandRecorder::record()
+    {
+        size_t first_command_buffer = m_vulkan_rhi->m_current_frame_index * m_passes.size();
+
+        // a chunk per pass, the calling thread records as well
+        m_thread_pool->parallelFor(m_passes.size(), 1, [&](size_t chunk_index, size_t begin, size_t end) {
+            RenderPass*     pass           = m_passes[begin];
+            VkCommandBuffer command_buffer = m_command_buffers[first_command_buffer + begin];
+
+            VkResult res_reset_command_pool = m_vulkan_rhi->m_vk_reset_command_pool(
+                m_vulkan_rhi->m_device, m_command_pools[first_command_buffer + begin], 0);
+            assert(VK_SUCCESS == res_reset_command_pool);
+
+            VkCommandBufferInheritanceInfo inheritance_info {};
+            inheritance_info.sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritance_info.renderPass  = pass->m_framebuffer.render_pass;
+            inheritance_info.subpass     = 0;
+            inheritance_info.framebuffer = pass->m_framebuffer.framebuffer;
+
+            VkCommandBufferBeginInfo command_buffer_begin_info {};
+            command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            command_buffer_begin_info.flags =
+                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            command_buffer_begin_info.pInheritanceInfo = &inheritance_info;
+
+            VkResult res_begin_command_buffer =
+                m_vulkan_rhi->m_vk_begin_command_buffer(command_buffer, &command_buffer_begin_info);
+            assert(VK_SUCCESS == res_begin_command_buffer);
+
+            pass->recordRenderPass(command_buffer);
+
+            VkResult res_end_command_buffer = m_vulkan_rhi->m_vk_end_command_buffer(command_buffer);
+            assert(VK_SUCCESS == res_end_command_buffer);
+        });
+
+        for (size_t i = 0; i < m_passes.size(); ++i)
+        {
+            m_passes[i]->beginRenderPass(m_vulkan_rhi->m_current_command_buffer,
+                                         VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            vkCmdExecuteCommands(
+                m_vulkan_rhi->m_current_command_buffer, 1, &m_command_buffers[first_command_buffer + i]);
+            m_passes[i]->endRenderPass(m_vulkan_rhi->m_current_command_buffer);
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <vector>
+
+namespace Piccolo
+{
+    class RenderPass;
+    class ThreadPool;
+    class VulkanRHI;
+
+    // records independent render passes into secondary command buffers on the worker threads of a pool.
+    // the primary command buffer then begins every render pass and executes its secondary command buffer,
+    // in the order the passes were given
+    class RenderCommandRecorder
+    {
+    public:
+        void initialize(std::shared_ptr<VulkanRHI>  rhi,
+                        std::shared_ptr<ThreadPool> thread_pool,
+                        std::vector<RenderPass*>    passes);
+
+        // records into the current command buffer, which must be outside of any render pass
+        void record();
+
+    private:
+        std::shared_ptr<VulkanRHI>  m_vulkan_rhi;
+        std::shared_ptr<ThreadPool> m_thread_pool;
+        std::vector<RenderPass*>    m_passes;
+
+        // one command pool per frame in flight and per pass, so that a pool is never used by two threads at once
+        // and is only reset after the fence of its frame
+        std::vector<VkCommandPool>   m_command_pools;
+        std::vector<VkCommandBuffer> m_command_buffers;
+    };
+} // namespace Piccolo
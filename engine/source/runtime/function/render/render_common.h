@@ -4,6 +4,7 @@
 #include "runtime/core/math/vector3.h"
 #include "runtime/core/math/vector4.h"
 
+#include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_type.h"
 
 #include <vk_mem_alloc.h>
@@ -12,14 +13,30 @@
 namespace Piccolo
 {
     static const uint32_t s_point_light_shadow_map_dimension       = 2048;
+    // the atlas holding the cascades of the directional light shadow
     static const uint32_t s_directional_light_shadow_map_dimension = 4096;
 
     // TODO: 64 may not be the best
     static uint32_t const s_mesh_per_drawcall_max_instance_count = 64;
     static uint32_t const s_mesh_vertex_blending_max_joint_count = 1024;
     static uint32_t const s_max_point_light_count                = 15;
+    static uint32_t const s_max_directional_light_cascade_count  = 4;
+    // the two paraboloids of every point light, the face i is the layer i of the point light shadow map
+    static uint32_t const s_max_point_light_shadow_face_count = 2 * s_max_point_light_count;
+    // the point lights are culled into the clusters of the main camera view, the first s_max_point_light_count of
+    // them cast shadows. the view is split into tiles in screen space and exponential slices in view depth
+    static uint32_t const s_max_clustered_point_light_count     = 1024;
+    static uint32_t const s_light_cluster_count_x               = 16;
+    static uint32_t const s_light_cluster_count_y               = 9;
+    static uint32_t const s_light_cluster_count_z               = 24;
+    static uint32_t const s_light_cluster_max_point_light_count = 128;
+    static uint32_t const s_light_cluster_count =
+        s_light_cluster_count_x * s_light_cluster_count_y * s_light_cluster_count_z;
     // should sync the macros in "shader_include/constants.h"
 
+    // skinned_vertex_offset of the mesh nodes which the mesh skinning pass does not skin
+    static uint32_t const s_invalid_skinned_vertex_offset = 0xffffffff;
+
     struct VulkanSceneDirectionalLight
     {
         Vector3 direction;
@@ -36,20 +53,59 @@ namespace Piccolo
         float   _padding_intensity;
     };
 
+    struct VulkanDirectionalLightCascades
+    {
+        Matrix4x4 proj_views[s_max_directional_light_cascade_count];
+        // from the uv of the cascade to the uv of the atlas, scale in xy and offset in zw
+        Vector4   atlas_scale_offsets[s_max_directional_light_cascade_count];
+        uint32_t  cascade_count;
+        uint32_t  _padding_cascade_count_1;
+        uint32_t  _padding_cascade_count_2;
+        uint32_t  _padding_cascade_count_3;
+    };
+
     struct MeshPerframeStorageBufferObject
     {
-        Matrix4x4                   proj_view_matrix;
-        Vector3                     camera_position;
-        float                       _padding_camera_position;
-        Vector3                     ambient_light;
-        float                       _padding_ambient_light;
-        uint32_t                    point_light_num;
-        uint32_t                    _padding_point_light_num_1;
-        uint32_t                    _padding_point_light_num_2;
-        uint32_t                    _padding_point_light_num_3;
-        VulkanScenePointLight       scene_point_lights[s_max_point_light_count];
-        VulkanSceneDirectionalLight scene_directional_light;
-        Matrix4x4                   directional_light_proj_view;
+        Matrix4x4                      proj_view_matrix;
+        Vector3                        camera_position;
+        float                          _padding_camera_position;
+        Vector3                        ambient_light;
+        float                          _padding_ambient_light;
+        uint32_t                       point_light_num;
+        uint32_t                       _padding_point_light_num_1;
+        uint32_t                       _padding_point_light_num_2;
+        uint32_t                       _padding_point_light_num_3;
+        VulkanScenePointLight          scene_point_lights[s_max_point_light_count];
+        VulkanSceneDirectionalLight    scene_directional_light;
+        VulkanDirectionalLightCascades directional_light_cascades;
+        // the scene extent over the swapchain extent, from the uv of the viewport to the uv of the targets
+        float                          render_scale_x;
+        float                          render_scale_y;
+        float                          _padding_render_scale_1;
+        float                          _padding_render_scale_2;
+    };
+
+    struct VulkanLightClusteringGrid
+    {
+        Matrix4x4 view_matrix;
+        // x, y, width and height in pixels of the viewport of the main camera
+        Vector4   viewport;
+        // view space xy at the view depth one of the ndc xy
+        float     inverse_proj_scale_x;
+        float     inverse_proj_scale_y;
+        float     z_near;
+        float     z_far;
+        // the slice of a view depth is log(depth) * slice_scale + slice_bias
+        float     slice_scale;
+        float     slice_bias;
+        uint32_t  point_light_num;
+        uint32_t  _padding_point_light_num;
+    };
+
+    struct LightClusteringPerframeStorageBufferObject
+    {
+        VulkanLightClusteringGrid grid;
+        VulkanScenePointLight     point_lights[s_max_clustered_point_light_count];
     };
 
     struct NBRMeshPerframeStorageBufferObject
@@ -60,6 +116,10 @@ namespace Piccolo
         Vector3                     camera_position;
         float                       _padding_camera_position;
         VulkanSceneDirectionalLight scene_directional_light;
+        float                       render_scale_x;
+        float                       render_scale_y;
+        float                       _padding_render_scale_1;
+        float                       _padding_render_scale_2;
     };
     
     struct NBROutlineMeshPerframeStorageBufferObject
@@ -82,6 +142,18 @@ namespace Piccolo
         Matrix4x4 model_matrix;
     };
 
+    // one per static object in the persistent instance buffer of the gpu driven base pass
+    struct VulkanGPUDrivenMeshInstance
+    {
+        Matrix4x4 model_matrix;
+        Vector4   bounding_box_min;
+        Vector4   bounding_box_max;
+        uint32_t  batch_index;
+        uint32_t  batch_first_instance;
+        uint32_t  _padding_batch_1;
+        uint32_t  _padding_batch_2;
+    };
+
     struct MeshPerdrawcallStorageBufferObject
     {
         VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
@@ -92,6 +164,11 @@ namespace Piccolo
         Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
     };
 
+    struct MeshSkinningJointStorageBufferObject
+    {
+        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count];
+    };
+
     struct MeshPerMaterialUniformBufferObject
     {
         Vector4 baseColorFactor {0.0f, 0.0f, 0.0f, 0.0f};
@@ -173,6 +250,17 @@ namespace Piccolo
         Vector4  point_lights_position_and_radius[s_max_point_light_count];
     };
 
+    // one hemisphere of the dual paraboloid shadow of a point light, -1 for the layer 2 * i and 1 for 2 * i + 1
+    struct MeshPointLightShadowPerfaceStorageBufferObject
+    {
+        Vector3 point_light_position;
+        float   point_light_radius;
+        float   hemisphere_sign;
+        float   _padding_hemisphere_sign_0;
+        float   _padding_hemisphere_sign_1;
+        float   _padding_hemisphere_sign_2;
+    };
+
     struct MeshPointLightShadowPerdrawcallStorageBufferObject
     {
         VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
@@ -327,6 +415,9 @@ namespace Piccolo
 
         VkDescriptorSet mesh_vertex_blending_descriptor_set;
 
+        // created by the mesh skinning pass the first time it skins the mesh
+        VkDescriptorSet mesh_skinning_descriptor_set {VK_NULL_HANDLE};
+
         VkBuffer      mesh_vertex_varying_buffer;
         VmaAllocation mesh_vertex_varying_buffer_allocation;
 
@@ -403,13 +494,18 @@ namespace Piccolo
     struct RenderMeshNode
     {
         const Matrix4x4*   model_matrix {nullptr};
+        const BoundingBox* world_bounding_box {nullptr};
         const Matrix4x4*   joint_matrices {nullptr};
         uint32_t           joint_count {0};
+        // first vertex of the instance in the vertex buffers written by the mesh skinning pass
+        uint32_t           skinned_vertex_offset {s_invalid_skinned_vertex_offset};
         VulkanMesh*        ref_mesh {nullptr};
         VulkanPBRMaterial* ref_material {nullptr};
         VulkanNBRMaterial* ref_material_nbr {nullptr};
         uint32_t           node_id;
         uint32_t           nbr_mesh_id {10000};
+        size_t             mesh_asset_id {0};
+        size_t             material_asset_id {0};
         bool               is_NBR_material {false};
         bool               enable_vertex_blending {false};
     };
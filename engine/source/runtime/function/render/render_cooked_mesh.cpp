@@ -0,0 +1,241 @@
+#include "runtime/function/render/render_cooked_mesh.h"
+
+#include "runtime/platform/file_service/mapped_file.h"
+#include "runtime/resource/config_manager/config_manager.h"
+
+#include "runtime/function/global/global_context.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <system_error>
+
+namespace Piccolo
+{
+    static const uint32_t s_cooked_mesh_magic   = 0x48534d50; // "PMSH"
+    static const uint32_t s_cooked_mesh_version = 2;
+
+    // streams start on this alignment so they can be read in place
+    static const uint64_t s_cooked_mesh_stream_alignment = 16;
+
+    enum CookedMeshFlags : uint32_t
+    {
+        CookedMeshFlagVertexColor     = 1 << 0,
+        CookedMeshFlagSkeletonBinding = 1 << 1,
+    };
+
+    struct CookedMeshStream
+    {
+        uint64_t m_offset {0};
+        uint64_t m_size {0};
+    };
+
+    struct CookedMeshHeader
+    {
+        uint32_t         m_magic {s_cooked_mesh_magic};
+        uint32_t         m_version {s_cooked_mesh_version};
+        uint32_t         m_flags {0};
+        uint32_t         m_vertex_stride {sizeof(MeshVertexDataDefinition)};
+        uint64_t         m_source_file_size {0};
+        int64_t          m_source_write_time {0};
+        float            m_bounding_box_min[3] {};
+        float            m_bounding_box_max[3] {};
+        CookedMeshStream m_vertex_stream;
+        CookedMeshStream m_index_stream;
+        CookedMeshStream m_skeleton_binding_stream;
+    };
+
+    static bool getSourceFileStamp(const std::filesystem::path& source_mesh_path,
+                                   uint64_t&                    file_size,
+                                   int64_t&                     write_time)
+    {
+        std::error_code error;
+        file_size = static_cast<uint64_t>(std::filesystem::file_size(source_mesh_path, error));
+        if (error)
+        {
+            return false;
+        }
+        write_time = static_cast<int64_t>(std::filesystem::last_write_time(source_mesh_path, error).time_since_epoch().count());
+        return !error;
+    }
+
+    static bool isValidStream(const CookedMeshStream& stream, size_t file_size)
+    {
+        if (stream.m_size == 0)
+        {
+            return true;
+        }
+        return stream.m_offset % s_cooked_mesh_stream_alignment == 0 && stream.m_offset < file_size &&
+               stream.m_size <= file_size - stream.m_offset;
+    }
+
+    static uint64_t alignStreamOffset(uint64_t offset)
+    {
+        return (offset + s_cooked_mesh_stream_alignment - 1) / s_cooked_mesh_stream_alignment *
+               s_cooked_mesh_stream_alignment;
+    }
+
+    std::filesystem::path getCookedMeshPath(const std::string& mesh_file, bool use_vertex_color)
+    {
+        std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
+
+        char path_hash[17];
+        snprintf(path_hash, sizeof(path_hash), "%016llx", static_cast<unsigned long long>(std::hash<std::string> {}(mesh_file)));
+
+        std::string cooked_mesh_name = std::filesystem::path(mesh_file).stem().generic_string() + "_" + path_hash;
+        if (use_vertex_color)
+        {
+            cooked_mesh_name += "_vc";
+        }
+        cooked_mesh_name += ".mesh";
+
+        return config_manager->getRootFolder() / "cache" / "mesh" / cooked_mesh_name;
+    }
+
+    bool loadCookedMesh(const std::filesystem::path& cooked_mesh_path,
+                        const std::filesystem::path& source_mesh_path,
+                        bool                         use_vertex_color,
+                        RenderMeshData&              mesh_data,
+                        AxisAlignedBox&              bounding_box)
+    {
+        uint64_t source_file_size;
+        int64_t  source_write_time;
+        if (!getSourceFileStamp(source_mesh_path, source_file_size, source_write_time))
+        {
+            return false;
+        }
+
+        std::shared_ptr<MappedFile> mapped_file = std::make_shared<MappedFile>();
+        if (!mapped_file->open(cooked_mesh_path) || mapped_file->getSize() < sizeof(CookedMeshHeader))
+        {
+            return false;
+        }
+
+        CookedMeshHeader header;
+        memcpy(&header, mapped_file->getData(), sizeof(CookedMeshHeader));
+
+        uint32_t expected_vertex_color_flag = use_vertex_color ? CookedMeshFlagVertexColor : 0;
+        if (header.m_magic != s_cooked_mesh_magic || header.m_version != s_cooked_mesh_version ||
+            header.m_vertex_stride != sizeof(MeshVertexDataDefinition) ||
+            (header.m_flags & CookedMeshFlagVertexColor) != expected_vertex_color_flag ||
+            header.m_source_file_size != source_file_size || header.m_source_write_time != source_write_time)
+        {
+            return false;
+        }
+
+        size_t file_size = mapped_file->getSize();
+        if (!isValidStream(header.m_vertex_stream, file_size) || !isValidStream(header.m_index_stream, file_size) ||
+            !isValidStream(header.m_skeleton_binding_stream, file_size))
+        {
+            return false;
+        }
+
+        // the buffers point into the mapping and keep it alive
+        uint8_t* data = const_cast<uint8_t*>(mapped_file->getData());
+
+        mesh_data.m_static_mesh_data.m_vertex_buffer = std::make_shared<BufferData>(
+            mapped_file, data + header.m_vertex_stream.m_offset, header.m_vertex_stream.m_size);
+        mesh_data.m_static_mesh_data.m_index_buffer = std::make_shared<BufferData>(
+            mapped_file, data + header.m_index_stream.m_offset, header.m_index_stream.m_size);
+        if (header.m_flags & CookedMeshFlagSkeletonBinding)
+        {
+            mesh_data.m_skeleton_binding_buffer =
+                std::make_shared<BufferData>(mapped_file,
+                                             data + header.m_skeleton_binding_stream.m_offset,
+                                             header.m_skeleton_binding_stream.m_size);
+        }
+
+        bounding_box.merge(
+            Vector3(header.m_bounding_box_min[0], header.m_bounding_box_min[1], header.m_bounding_box_min[2]));
+        bounding_box.merge(
+            Vector3(header.m_bounding_box_max[0], header.m_bounding_box_max[1], header.m_bounding_box_max[2]));
+
+        return true;
+    }
+
+    bool saveCookedMesh(const std::filesystem::path& cooked_mesh_path,
+                        const std::filesystem::path& source_mesh_path,
+                        bool                         use_vertex_color,
+                        const RenderMeshData&        mesh_data,
+                        const AxisAlignedBox&        bounding_box)
+    {
+        const std::shared_ptr<BufferData>& vertex_buffer = mesh_data.m_static_mesh_data.m_vertex_buffer;
+        const std::shared_ptr<BufferData>& index_buffer  = mesh_data.m_static_mesh_data.m_index_buffer;
+        const std::shared_ptr<BufferData>& binding_buffer = mesh_data.m_skeleton_binding_buffer;
+        if (!vertex_buffer || !index_buffer)
+        {
+            return false;
+        }
+
+        CookedMeshHeader header;
+        if (!getSourceFileStamp(source_mesh_path, header.m_source_file_size, header.m_source_write_time))
+        {
+            return false;
+        }
+
+        header.m_flags = use_vertex_color ? CookedMeshFlagVertexColor : 0;
+        if (binding_buffer)
+        {
+            header.m_flags |= CookedMeshFlagSkeletonBinding;
+        }
+
+        const Vector3& min_corner = bounding_box.getMinCorner();
+        const Vector3& max_corner = bounding_box.getMaxCorner();
+        for (int i = 0; i < 3; ++i)
+        {
+            header.m_bounding_box_min[i] = min_corner[i];
+            header.m_bounding_box_max[i] = max_corner[i];
+        }
+
+        header.m_vertex_stream = {alignStreamOffset(sizeof(CookedMeshHeader)), vertex_buffer->m_size};
+        header.m_index_stream  = {alignStreamOffset(header.m_vertex_stream.m_offset + header.m_vertex_stream.m_size),
+                                  index_buffer->m_size};
+        header.m_skeleton_binding_stream = {
+            alignStreamOffset(header.m_index_stream.m_offset + header.m_index_stream.m_size),
+            binding_buffer ? binding_buffer->m_size : 0};
+
+        std::error_code error;
+        std::filesystem::create_directories(cooked_mesh_path.parent_path(), error);
+        if (error)
+        {
+            return false;
+        }
+
+        // write to a temporary file first so a cooked mesh is never seen half written
+        std::filesystem::path temporary_path = cooked_mesh_path;
+        temporary_path += ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return false;
+            }
+
+            uint64_t written_size = 0;
+            auto     write_stream = [&file, &written_size](const CookedMeshStream& stream, const void* data) {
+                const char padding[s_cooked_mesh_stream_alignment] = {};
+                file.write(padding, static_cast<std::streamsize>(stream.m_offset - written_size));
+                file.write(static_cast<const char*>(data), static_cast<std::streamsize>(stream.m_size));
+                written_size = stream.m_offset + stream.m_size;
+            };
+
+            write_stream({0, sizeof(CookedMeshHeader)}, &header);
+            write_stream(header.m_vertex_stream, vertex_buffer->m_data);
+            write_stream(header.m_index_stream, index_buffer->m_data);
+            if (binding_buffer)
+            {
+                write_stream(header.m_skeleton_binding_stream, binding_buffer->m_data);
+            }
+
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary_path, cooked_mesh_path, error);
+        return !error;
+    }
+} // namespace Piccolo
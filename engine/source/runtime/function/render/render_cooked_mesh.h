@@ -0,0 +1,28 @@
+#pragma once
+
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/function/render/render_type.h"
+
+#include <filesystem>
+#include <string>
+
+namespace Piccolo
+{
+    // cooked meshes are binary copies of the loaded mesh streams, written the first time a source mesh is loaded.
+    // the streams are laid out as the upload path consumes them and loading only maps the file, without parsing
+
+    std::filesystem::path getCookedMeshPath(const std::string& mesh_file, bool use_vertex_color);
+
+    // fails if the cooked mesh is missing, invalid or older than the source mesh
+    bool loadCookedMesh(const std::filesystem::path& cooked_mesh_path,
+                        const std::filesystem::path& source_mesh_path,
+                        bool                         use_vertex_color,
+                        RenderMeshData&              mesh_data,
+                        AxisAlignedBox&              bounding_box);
+
+    bool saveCookedMesh(const std::filesystem::path& cooked_mesh_path,
+                        const std::filesystem::path& source_mesh_path,
+                        bool                         use_vertex_color,
+                        const RenderMeshData&        mesh_data,
+                        const AxisAlignedBox&        bounding_box);
+} // namespace Piccolo
@@ -0,0 +1,359 @@
+#include "runtime/function/render/render_cooked_texture.h"
+
+#include "runtime/function/render/render_texture_compressor.h"
+#include "runtime/platform/file_service/mapped_file.h"
+#include "runtime/resource/config_manager/config_manager.h"
+
+#include "runtime/function/global/global_context.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace Piccolo
+{
+    static const uint32_t s_cooked_texture_magic   = 0x58455450; // "PTEX"
+    static const uint32_t s_cooked_texture_version = 1;
+
+    static const uint64_t s_cooked_texture_data_alignment = 16;
+
+    struct CookedTextureHeader
+    {
+        uint32_t m_magic {s_cooked_texture_magic};
+        uint32_t m_version {s_cooked_texture_version};
+        uint32_t m_format {0};
+        uint32_t m_width {0};
+        uint32_t m_height {0};
+        uint32_t m_mip_levels {0};
+        uint64_t m_source_file_size {0};
+        int64_t  m_source_write_time {0};
+        uint64_t m_data_offset {0};
+        uint64_t m_data_size {0};
+    };
+
+    static bool getSourceFileStamp(const std::filesystem::path& source_texture_path,
+                                   uint64_t&                    file_size,
+                                   int64_t&                     write_time)
+    {
+        std::error_code error;
+        file_size = static_cast<uint64_t>(std::filesystem::file_size(source_texture_path, error));
+        if (error)
+        {
+            return false;
+        }
+        write_time =
+            static_cast<int64_t>(std::filesystem::last_write_time(source_texture_path, error).time_since_epoch().count());
+        return !error;
+    }
+
+    static uint32_t getBlockByteSize(PICCOLO_PIXEL_FORMAT format)
+    {
+        switch (format)
+        {
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC4_UNORM:
+                return 8;
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC5_UNORM:
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_UNORM:
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_SRGB:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
+    // the full chain down to 1x1, the same count the upload path uses
+    static uint32_t getMipLevelCount(uint32_t width, uint32_t height)
+    {
+        return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    }
+
+    static uint64_t getMipChainByteSize(PICCOLO_PIXEL_FORMAT format, uint32_t width, uint32_t height)
+    {
+        uint64_t size = 0;
+        for (uint32_t mip_level = 0; mip_level < getMipLevelCount(width, height); ++mip_level)
+        {
+            uint64_t level_width  = std::max(width >> mip_level, 1u);
+            uint64_t level_height = std::max(height >> mip_level, 1u);
+            size += (level_width + 3) / 4 * ((level_height + 3) / 4) * getBlockByteSize(format);
+        }
+        return size;
+    }
+
+    static float srgbToLinear(float value)
+    {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float linearToSrgb(float value)
+    {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    // box filter the level to half its size, srgb color is averaged in linear space
+    static std::vector<uint8_t>
+    downsampleLevel(const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, bool is_srgb)
+    {
+        static float s_srgb_to_linear_table[256];
+        static bool  s_srgb_to_linear_table_ready = [] {
+            for (int value = 0; value < 256; ++value)
+            {
+                s_srgb_to_linear_table[value] = srgbToLinear(value / 255.0f);
+            }
+            return true;
+        }();
+        (void)s_srgb_to_linear_table_ready;
+
+        uint32_t next_width  = std::max(width >> 1, 1u);
+        uint32_t next_height = std::max(height >> 1, 1u);
+
+        std::vector<uint8_t> next_pixels(size_t(next_width) * next_height * 4);
+        for (uint32_t y = 0; y < next_height; ++y)
+        {
+            uint32_t y0 = std::min(y * 2, height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, height - 1);
+            for (uint32_t x = 0; x < next_width; ++x)
+            {
+                uint32_t       x0         = std::min(x * 2, width - 1);
+                uint32_t       x1         = std::min(x * 2 + 1, width - 1);
+                const uint8_t* samples[4] = {&pixels[(size_t(y0) * width + x0) * 4],
+                                             &pixels[(size_t(y0) * width + x1) * 4],
+                                             &pixels[(size_t(y1) * width + x0) * 4],
+                                             &pixels[(size_t(y1) * width + x1) * 4]};
+
+                uint8_t* next_pixel = &next_pixels[(size_t(y) * next_width + x) * 4];
+                for (int channel = 0; channel < 4; ++channel)
+                {
+                    float sum = 0.0f;
+                    for (const uint8_t* sample : samples)
+                    {
+                        sum += (is_srgb && channel < 3) ? s_srgb_to_linear_table[sample[channel]] :
+                                                          sample[channel] / 255.0f;
+                    }
+
+                    float average = sum * 0.25f;
+                    if (is_srgb && channel < 3)
+                    {
+                        average = linearToSrgb(average);
+                    }
+                    next_pixel[channel] = static_cast<uint8_t>(std::lround(std::min(std::max(average, 0.0f), 1.0f) * 255.0f));
+                }
+            }
+        }
+        return next_pixels;
+    }
+
+    static void compressLevel(const std::vector<uint8_t>& pixels,
+                              uint32_t                    width,
+                              uint32_t                    height,
+                              PICCOLO_PIXEL_FORMAT        format,
+                              uint8_t*                    blocks)
+    {
+        uint32_t block_byte_size = getBlockByteSize(format);
+        for (uint32_t block_y = 0; block_y < (height + 3) / 4; ++block_y)
+        {
+            for (uint32_t block_x = 0; block_x < (width + 3) / 4; ++block_x)
+            {
+                // blocks past the edge repeat the edge pixels
+                uint8_t block_pixels[16 * 4];
+                for (uint32_t y = 0; y < 4; ++y)
+                {
+                    for (uint32_t x = 0; x < 4; ++x)
+                    {
+                        uint32_t source_x = std::min(block_x * 4 + x, width - 1);
+                        uint32_t source_y = std::min(block_y * 4 + y, height - 1);
+                        memcpy(&block_pixels[(y * 4 + x) * 4], &pixels[(size_t(source_y) * width + source_x) * 4], 4);
+                    }
+                }
+
+                switch (format)
+                {
+                    case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC4_UNORM:
+                        compressBC4Block(block_pixels, blocks);
+                        break;
+                    case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC5_UNORM:
+                        compressBC5Block(block_pixels, blocks);
+                        break;
+                    default:
+                        compressBC7Block(block_pixels, blocks);
+                        break;
+                }
+                blocks += block_byte_size;
+            }
+        }
+    }
+
+    std::filesystem::path getCookedTexturePath(const std::string& texture_file, PICCOLO_PIXEL_FORMAT format)
+    {
+        std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
+
+        char path_hash[17];
+        snprintf(path_hash,
+                 sizeof(path_hash),
+                 "%016llx",
+                 static_cast<unsigned long long>(std::hash<std::string> {}(texture_file)));
+
+        std::string cooked_texture_name = std::filesystem::path(texture_file).stem().generic_string() + "_" +
+                                          path_hash + "_" + std::to_string(static_cast<uint32_t>(format)) + ".tex";
+
+        return config_manager->getRootFolder() / "cache" / "texture" / cooked_texture_name;
+    }
+
+    bool loadCookedTexture(const std::filesystem::path& cooked_texture_path,
+                           const std::filesystem::path& source_texture_path,
+                           PICCOLO_PIXEL_FORMAT         format,
+                           TextureData&                 texture)
+    {
+        uint64_t source_file_size;
+        int64_t  source_write_time;
+        if (!getSourceFileStamp(source_texture_path, source_file_size, source_write_time))
+        {
+            return false;
+        }
+
+        std::shared_ptr<MappedFile> mapped_file = std::make_shared<MappedFile>();
+        if (!mapped_file->open(cooked_texture_path) || mapped_file->getSize() < sizeof(CookedTextureHeader))
+        {
+            return false;
+        }
+
+        CookedTextureHeader header;
+        memcpy(&header, mapped_file->getData(), sizeof(CookedTextureHeader));
+
+        if (header.m_magic != s_cooked_texture_magic || header.m_version != s_cooked_texture_version ||
+            header.m_format != static_cast<uint32_t>(format) || header.m_width == 0 || header.m_height == 0 ||
+            header.m_source_file_size != source_file_size || header.m_source_write_time != source_write_time)
+        {
+            return false;
+        }
+
+        size_t file_size = mapped_file->getSize();
+        if (header.m_mip_levels != getMipLevelCount(header.m_width, header.m_height) ||
+            header.m_data_size != getMipChainByteSize(format, header.m_width, header.m_height) ||
+            header.m_data_offset % s_cooked_texture_data_alignment != 0 || header.m_data_offset > file_size ||
+            header.m_data_size > file_size - header.m_data_offset)
+        {
+            return false;
+        }
+
+        // the pixels point into the mapping and keep it alive
+        texture.m_pixels       = const_cast<uint8_t*>(mapped_file->getData()) + header.m_data_offset;
+        texture.m_pixels_owner = mapped_file;
+        texture.m_width        = header.m_width;
+        texture.m_height       = header.m_height;
+        texture.m_depth        = 1;
+        texture.m_mip_levels   = header.m_mip_levels;
+        texture.m_array_layers = 1;
+        texture.m_format       = format;
+        texture.m_type         = PICCOLO_IMAGE_TYPE::PICCOLO_IMAGE_TYPE_2D;
+
+        return true;
+    }
+
+    bool saveCookedTexture(const std::filesystem::path& cooked_texture_path,
+                           const std::filesystem::path& source_texture_path,
+                           const TextureData&           texture)
+    {
+        if (!texture.isValid() || getBlockByteSize(texture.m_format) == 0)
+        {
+            return false;
+        }
+
+        CookedTextureHeader header;
+        if (!getSourceFileStamp(source_texture_path, header.m_source_file_size, header.m_source_write_time))
+        {
+            return false;
+        }
+
+        header.m_format      = static_cast<uint32_t>(texture.m_format);
+        header.m_width       = texture.m_width;
+        header.m_height      = texture.m_height;
+        header.m_mip_levels  = texture.m_mip_levels;
+        header.m_data_offset = (sizeof(CookedTextureHeader) + s_cooked_texture_data_alignment - 1) /
+                               s_cooked_texture_data_alignment * s_cooked_texture_data_alignment;
+        header.m_data_size = getMipChainByteSize(texture.m_format, texture.m_width, texture.m_height);
+
+        std::error_code error;
+        std::filesystem::create_directories(cooked_texture_path.parent_path(), error);
+        if (error)
+        {
+            return false;
+        }
+
+        // write to a temporary file first so a cooked texture is never seen half written. textures are shared
+        // between materials and may be cooked by several loading threads at once, each writes its own file
+        std::filesystem::path temporary_path = cooked_texture_path;
+        temporary_path += "." + std::to_string(std::hash<std::thread::id> {}(std::this_thread::get_id())) + ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return false;
+            }
+
+            const char padding[s_cooked_texture_data_alignment] = {};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(CookedTextureHeader));
+            file.write(padding, static_cast<std::streamsize>(header.m_data_offset - sizeof(CookedTextureHeader)));
+            file.write(static_cast<const char*>(texture.m_pixels), static_cast<std::streamsize>(header.m_data_size));
+
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary_path, cooked_texture_path, error);
+        return !error;
+    }
+
+    std::shared_ptr<TextureData> cookTexture(const TextureData& source_texture, PICCOLO_PIXEL_FORMAT format)
+    {
+        if (!source_texture.isValid() || getBlockByteSize(format) == 0 ||
+            (source_texture.m_format != PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_R8G8B8A8_UNORM &&
+             source_texture.m_format != PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_R8G8B8A8_SRGB))
+        {
+            return nullptr;
+        }
+
+        uint32_t width      = source_texture.m_width;
+        uint32_t height     = source_texture.m_height;
+        uint32_t mip_levels = getMipLevelCount(width, height);
+
+        std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
+        texture->m_pixels                    = malloc(getMipChainByteSize(format, width, height));
+        texture->m_width                     = width;
+        texture->m_height                    = height;
+        texture->m_depth                     = 1;
+        texture->m_mip_levels                = mip_levels;
+        texture->m_array_layers              = 1;
+        texture->m_format                    = format;
+        texture->m_type                      = PICCOLO_IMAGE_TYPE::PICCOLO_IMAGE_TYPE_2D;
+
+        bool is_srgb = format == PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_SRGB;
+
+        const uint8_t*       source_pixels = static_cast<const uint8_t*>(source_texture.m_pixels);
+        std::vector<uint8_t> level_pixels(source_pixels, source_pixels + size_t(width) * height * 4);
+
+        uint8_t* blocks = static_cast<uint8_t*>(texture->m_pixels);
+        for (uint32_t mip_level = 0; mip_level < mip_levels; ++mip_level)
+        {
+            uint32_t level_width  = std::max(width >> mip_level, 1u);
+            uint32_t level_height = std::max(height >> mip_level, 1u);
+
+            compressLevel(level_pixels, level_width, level_height, format, blocks);
+            blocks += size_t((level_width + 3) / 4) * ((level_height + 3) / 4) * getBlockByteSize(format);
+
+            if (mip_level + 1 < mip_levels)
+            {
+                level_pixels = downsampleLevel(level_pixels, level_width, level_height, is_srgb);
+            }
+        }
+
+        return texture;
+    }
+} // namespace Piccolo
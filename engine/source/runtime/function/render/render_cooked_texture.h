@@ -0,0 +1,29 @@
+#pragma once
+
+#include "runtime/function/render/render_type.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace Piccolo
+{
+    // cooked textures are block compressed copies of the source textures with the whole mip chain precomputed,
+    // written the first time a source texture is loaded. the levels are stored from the largest to the smallest
+    // one after another, as the upload path copies them
+
+    std::filesystem::path getCookedTexturePath(const std::string& texture_file, PICCOLO_PIXEL_FORMAT format);
+
+    // fails if the cooked texture is missing, invalid or older than the source texture
+    bool loadCookedTexture(const std::filesystem::path& cooked_texture_path,
+                           const std::filesystem::path& source_texture_path,
+                           PICCOLO_PIXEL_FORMAT         format,
+                           TextureData&                 texture);
+
+    bool saveCookedTexture(const std::filesystem::path& cooked_texture_path,
+                           const std::filesystem::path& source_texture_path,
+                           const TextureData&           texture);
+
+    // build the mip chain of an rgba8 texture and compress it to one of the block compressed formats
+    std::shared_ptr<TextureData> cookTexture(const TextureData& source_texture, PICCOLO_PIXEL_FORMAT format);
+} // namespace Piccolo
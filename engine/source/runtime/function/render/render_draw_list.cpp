@@ -0,0 +1,139 @@
+#include "runtime/function/render/render_draw_list.h"
+
+#include <cstring>
+
+namespace Piccolo
+{
+    // key layout from the most significant bit:
+    // 1 bit pass (pbr before nbr), 1 bit vertex blending, 6 bits pipeline, 16 bits material, 16 bits mesh,
+    // 24 bits depth
+    static const uint32_t s_draw_key_pass_shift            = 63;
+    static const uint32_t s_draw_key_vertex_blending_shift = 62;
+    static const uint32_t s_draw_key_pipeline_shift        = 56;
+    static const uint32_t s_draw_key_material_shift        = 40;
+    static const uint32_t s_draw_key_mesh_shift            = 24;
+    static const uint64_t s_draw_key_pipeline_mask         = 0x3f;
+    static const uint64_t s_draw_key_asset_mask            = 0xffff;
+    static const uint64_t s_draw_key_depth_mask            = 0xffffff;
+
+    static const uint32_t s_radix_sort_digit_bits  = 8;
+    static const uint32_t s_radix_sort_digit_count = 1 << s_radix_sort_digit_bits;
+
+    uint64_t RenderDrawList::getSortKey(const RenderMeshNode& node, const Vector3& view_position)
+    {
+        Vector3 offset = node.model_matrix->getTrans() - view_position;
+
+        // the bits of a non negative float sort like the float, keep the 24 most significant ones
+        float    distance_squared = offset.squaredLength();
+        uint32_t distance_bits;
+        memcpy(&distance_bits, &distance_squared, sizeof(distance_bits));
+        uint64_t depth = (distance_bits >> 7) & s_draw_key_depth_mask;
+
+        // asset ids are only used for grouping, batches are split by the asset pointers anyway
+        uint64_t pass            = node.is_NBR_material ? 1 : 0;
+        uint64_t vertex_blending = node.enable_vertex_blending ? 1 : 0;
+        uint64_t pipeline        = node.is_NBR_material ? (node.nbr_mesh_id & s_draw_key_pipeline_mask) : 0;
+        uint64_t material        = node.material_asset_id & s_draw_key_asset_mask;
+        uint64_t mesh            = node.mesh_asset_id & s_draw_key_asset_mask;
+
+        return (pass << s_draw_key_pass_shift) | (vertex_blending << s_draw_key_vertex_blending_shift) |
+               (pipeline << s_draw_key_pipeline_shift) | (material << s_draw_key_material_shift) |
+               (mesh << s_draw_key_mesh_shift) | depth;
+    }
+
+    void RenderDrawList::build(const std::vector<RenderMeshNode>& visible_mesh_nodes, const Vector3& view_position)
+    {
+        m_sort_items.resize(visible_mesh_nodes.size());
+        for (size_t node_index = 0; node_index < visible_mesh_nodes.size(); ++node_index)
+        {
+            m_sort_items[node_index] = {getSortKey(visible_mesh_nodes[node_index], view_position),
+                                        static_cast<uint32_t>(node_index)};
+        }
+
+        radixSort();
+
+        m_nodes.clear();
+        m_batches.clear();
+        for (const SortItem& item : m_sort_items)
+        {
+            m_nodes.push_back(visible_mesh_nodes[item.m_node_index]);
+            RenderMeshNode& node = m_nodes.back();
+
+            // joint matrices mark the instances to blend
+            if (!node.enable_vertex_blending)
+            {
+                node.joint_matrices = nullptr;
+                node.joint_count    = 0;
+            }
+
+            bool is_new_batch = m_batches.empty();
+            if (!is_new_batch)
+            {
+                const RenderDrawBatch& batch = m_batches.back();
+                is_new_batch = batch.m_is_NBR_material != node.is_NBR_material || batch.m_mesh != node.ref_mesh ||
+                               batch.m_material != node.ref_material || batch.m_material_nbr != node.ref_material_nbr ||
+                               batch.m_nbr_mesh_id != node.nbr_mesh_id ||
+                               batch.m_enable_vertex_blending != node.enable_vertex_blending;
+            }
+
+            if (is_new_batch)
+            {
+                RenderDrawBatch batch;
+                batch.m_material               = node.ref_material;
+                batch.m_material_nbr           = node.ref_material_nbr;
+                batch.m_mesh                   = node.ref_mesh;
+                batch.m_first_node             = static_cast<uint32_t>(m_nodes.size() - 1);
+                batch.m_nbr_mesh_id            = node.nbr_mesh_id;
+                batch.m_is_NBR_material        = node.is_NBR_material;
+                batch.m_enable_vertex_blending = node.enable_vertex_blending;
+                m_batches.push_back(batch);
+            }
+            ++m_batches.back().m_node_count;
+        }
+
+        ++m_version;
+    }
+
+    void RenderDrawList::clear()
+    {
+        m_sort_items.clear();
+        m_nodes.clear();
+        m_batches.clear();
+        ++m_version;
+    }
+
+    void RenderDrawList::radixSort()
+    {
+        m_sort_items_swap.resize(m_sort_items.size());
+
+        for (uint32_t shift = 0; shift < 64; shift += s_radix_sort_digit_bits)
+        {
+            uint32_t digit_counts[s_radix_sort_digit_count] = {};
+            for (const SortItem& item : m_sort_items)
+            {
+                ++digit_counts[(item.m_key >> shift) & (s_radix_sort_digit_count - 1)];
+            }
+
+            // all keys share this digit, the order would not change
+            if (m_sort_items.empty() ||
+                digit_counts[(m_sort_items[0].m_key >> shift) & (s_radix_sort_digit_count - 1)] == m_sort_items.size())
+            {
+                continue;
+            }
+
+            uint32_t digit_offsets[s_radix_sort_digit_count];
+            uint32_t offset = 0;
+            for (uint32_t digit = 0; digit < s_radix_sort_digit_count; ++digit)
+            {
+                digit_offsets[digit] = offset;
+                offset += digit_counts[digit];
+            }
+
+            for (const SortItem& item : m_sort_items)
+            {
+                m_sort_items_swap[digit_offsets[(item.m_key >> shift) & (s_radix_sort_digit_count - 1)]++] = item;
+            }
+            m_sort_items.swap(m_sort_items_swap);
+        }
+    }
+} // namespace Piccolo
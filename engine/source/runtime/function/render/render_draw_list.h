@@ -0,0 +1,58 @@
+#pragma once
+
+#include "runtime/function/render/render_common.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    // visible mesh nodes that share material and mesh, drawn as instances of one draw
+    struct RenderDrawBatch
+    {
+        VulkanPBRMaterial* m_material {nullptr};
+        VulkanNBRMaterial* m_material_nbr {nullptr};
+        VulkanMesh*        m_mesh {nullptr};
+        uint32_t           m_first_node {0};
+        uint32_t           m_node_count {0};
+        uint32_t           m_nbr_mesh_id {10000};
+        bool               m_is_NBR_material {false};
+        bool               m_enable_vertex_blending {false};
+    };
+
+    // the visible mesh nodes of one view, sorted once per frame by a 64 bit key of
+    // (pass, vertex blending, pipeline, material, mesh, depth) so that every pass drawing the view walks the same contiguous
+    // instance ranges in a deterministic order. the arrays are kept between frames
+    class RenderDrawList
+    {
+    public:
+        // depth is the distance to view_position, sorted front to back within a batch
+        void build(const std::vector<RenderMeshNode>& visible_mesh_nodes, const Vector3& view_position);
+        void clear();
+
+        const std::vector<RenderMeshNode>&  getNodes() const { return m_nodes; }
+        const std::vector<RenderDrawBatch>& getBatches() const { return m_batches; }
+        const RenderMeshNode* getBatchNodes(const RenderDrawBatch& batch) const { return &m_nodes[batch.m_first_node]; }
+
+        // changes on every build and clear, lets the consumers cache what they derive from the list
+        uint64_t getVersion() const { return m_version; }
+
+        static uint64_t getSortKey(const RenderMeshNode& node, const Vector3& view_position);
+
+    private:
+        struct SortItem
+        {
+            uint64_t m_key;
+            uint32_t m_node_index;
+        };
+
+        // stable lsd radix sort by m_key, digits shared by all keys are skipped
+        void radixSort();
+
+        std::vector<SortItem>        m_sort_items;
+        std::vector<SortItem>        m_sort_items_swap;
+        std::vector<RenderMeshNode>  m_nodes;
+        std::vector<RenderDrawBatch> m_batches;
+        uint64_t                     m_version {0};
+    };
+} // namespace Piccolo
@@ -8,22 +8,10 @@
 
 namespace Piccolo
 {
-    class RenderEntity
+    // material parameters are only read when the material is created, keep them apart from the culling data
+    struct RenderEntityMaterialParameters
     {
-    public:
-        uint32_t  m_instance_id {0};
-        Matrix4x4 m_model_matrix {Matrix4x4::IDENTITY};
-
-        // mesh
-        size_t                 m_mesh_asset_id {0};
-        bool                   m_enable_vertex_blending {false};
-        std::vector<Matrix4x4> m_joint_matrices;
-        AxisAlignedBox         m_bounding_box;
-        uint32_t               m_nbr_mesh_id {10000};
-
-        // material
-        bool    m_is_NBR_material {false};
-        size_t  m_material_asset_id {0};
+        // pbr
         bool    m_blend {false};
         bool    m_double_sided {false};
         Vector4 m_base_color_factor {1.0f, 1.0f, 1.0f, 1.0f};
@@ -33,6 +21,7 @@ namespace Piccolo
         float   m_occlusion_strength {1.0f};
         Vector3 m_emissive_factor {1.0f, 1.0f, 1.0f};
 
+        // nbr
         uint32_t m_area; // 0 body, 1 hair, 2 face
         Vector3 m_front_face_tint_color;
         float   m_alpha;
@@ -61,4 +50,23 @@ namespace Piccolo
         float   m_emission_mix_base_color;
         float   m_emission_intensity;
     };
+
+    class RenderEntity
+    {
+    public:
+        uint32_t  m_instance_id {0};
+        Matrix4x4 m_model_matrix {Matrix4x4::IDENTITY};
+
+        // mesh
+        size_t                 m_mesh_asset_id {0};
+        bool                   m_enable_vertex_blending {false};
+        std::vector<Matrix4x4> m_joint_matrices;
+        AxisAlignedBox         m_bounding_box;
+        uint32_t               m_nbr_mesh_id {10000};
+
+        // material
+        bool                           m_is_NBR_material {false};
+        size_t                         m_material_asset_id {0};
+        RenderEntityMaterialParameters m_material_parameters;
+    };
 } // namespace Piccolo
@@ -0,0 +1,110 @@
+#include "runtime/function/render/render_entity_store.h"
+
+#include <cassert>
+
+namespace Piccolo
+{
+    static RenderEntityHandles getEntityHandles(const RenderEntity& entity)
+    {
+        RenderEntityHandles handles;
+        handles.m_mesh_asset_id          = entity.m_mesh_asset_id;
+        handles.m_material_asset_id      = entity.m_material_asset_id;
+        handles.m_nbr_mesh_id            = entity.m_nbr_mesh_id;
+        handles.m_is_NBR_material        = entity.m_is_NBR_material;
+        handles.m_enable_vertex_blending = entity.m_enable_vertex_blending;
+        return handles;
+    }
+
+    size_t RenderEntityStore::addEntity(const RenderEntity& entity)
+    {
+        size_t entity_index = size();
+        m_instance_id_entity_index_map[entity.m_instance_id] = entity_index;
+
+        m_instance_ids.push_back(entity.m_instance_id);
+        m_world_bounding_boxes.emplace_back();
+        m_model_matrices.emplace_back();
+        m_handles.emplace_back();
+        m_joint_matrices.emplace_back();
+        m_local_bounding_boxes.emplace_back();
+        m_material_parameters.emplace_back();
+
+        updateEntity(entity_index, entity);
+        return entity_index;
+    }
+
+    void RenderEntityStore::updateEntity(size_t entity_index, const RenderEntity& entity)
+    {
+        assert(m_instance_ids[entity_index] == entity.m_instance_id);
+
+        BoundingBox local_bounding_box {entity.m_bounding_box.getMinCorner(), entity.m_bounding_box.getMaxCorner()};
+
+        m_instance_ids[entity_index]         = entity.m_instance_id;
+        m_world_bounding_boxes[entity_index] = BoundingBoxTransform(local_bounding_box, entity.m_model_matrix);
+        m_model_matrices[entity_index]       = entity.m_model_matrix;
+        m_handles[entity_index]              = getEntityHandles(entity);
+        m_joint_matrices[entity_index]       = entity.m_joint_matrices;
+        m_local_bounding_boxes[entity_index] = local_bounding_box;
+        m_material_parameters[entity_index]  = entity.m_material_parameters;
+    }
+
+    void RenderEntityStore::updateEntityTransform(size_t                        entity_index,
+                                                  const Matrix4x4&              model_matrix,
+                                                  const std::vector<Matrix4x4>& joint_matrices)
+    {
+        m_world_bounding_boxes[entity_index] = BoundingBoxTransform(m_local_bounding_boxes[entity_index], model_matrix);
+        m_model_matrices[entity_index]       = model_matrix;
+        m_joint_matrices[entity_index]       = joint_matrices;
+    }
+
+    template<typename T>
+    static void swapAndPop(std::vector<T>& array, size_t index)
+    {
+        if (index + 1 != array.size())
+        {
+            array[index] = std::move(array.back());
+        }
+        array.pop_back();
+    }
+
+    void RenderEntityStore::removeEntity(size_t entity_index)
+    {
+        m_instance_id_entity_index_map.erase(m_instance_ids[entity_index]);
+
+        size_t last_entity_index = size() - 1;
+        if (entity_index != last_entity_index)
+        {
+            m_instance_id_entity_index_map[m_instance_ids[last_entity_index]] = entity_index;
+        }
+
+        swapAndPop(m_instance_ids, entity_index);
+        swapAndPop(m_world_bounding_boxes, entity_index);
+        swapAndPop(m_model_matrices, entity_index);
+        swapAndPop(m_handles, entity_index);
+        swapAndPop(m_joint_matrices, entity_index);
+        swapAndPop(m_local_bounding_boxes, entity_index);
+        swapAndPop(m_material_parameters, entity_index);
+    }
+
+    void RenderEntityStore::clear()
+    {
+        m_instance_ids.clear();
+        m_world_bounding_boxes.clear();
+        m_model_matrices.clear();
+        m_handles.clear();
+        m_joint_matrices.clear();
+        m_local_bounding_boxes.clear();
+        m_material_parameters.clear();
+        m_instance_id_entity_index_map.clear();
+    }
+
+    bool RenderEntityStore::findEntity(uint32_t instance_id, size_t& entity_index) const
+    {
+        auto find_it = m_instance_id_entity_index_map.find(instance_id);
+        if (find_it != m_instance_id_entity_index_map.end())
+        {
+            entity_index = find_it->second;
+            return true;
+        }
+        return false;
+    }
+} // namespace Piccolo
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "runtime/function/render/render_entity.h"
+#include "runtime/function/render/render_helper.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    struct RenderEntityHandles
+    {
+        size_t   m_mesh_asset_id {0};
+        size_t   m_material_asset_id {0};
+        uint32_t m_nbr_mesh_id {10000};
+        bool     m_is_NBR_material {false};
+        bool     m_enable_vertex_blending {false};
+    };
+
+    // structure of arrays storage of the render entities
+    // every array is indexed by the entity index, the arrays are kept dense so removing an entity moves the last
+    // entity into its place. always look entities up by instance id instead of keeping entity indices around
+    class RenderEntityStore
+    {
+    public:
+        size_t size() const { return m_instance_ids.size(); }
+        bool   empty() const { return m_instance_ids.empty(); }
+
+        size_t addEntity(const RenderEntity& entity);
+        void   updateEntity(size_t entity_index, const RenderEntity& entity);
+        void   updateEntityTransform(size_t                        entity_index,
+                                     const Matrix4x4&              model_matrix,
+                                     const std::vector<Matrix4x4>& joint_matrices);
+        void   removeEntity(size_t entity_index); // swap and pop
+        void   clear();
+
+        bool findEntity(uint32_t instance_id, size_t& entity_index) const;
+
+        // hot data, read by culling and batching every frame
+        const std::vector<uint32_t>&            getInstanceIds() const { return m_instance_ids; }
+        const std::vector<BoundingBox>&         getWorldBoundingBoxes() const { return m_world_bounding_boxes; }
+        const std::vector<Matrix4x4>&           getModelMatrices() const { return m_model_matrices; }
+        const std::vector<RenderEntityHandles>& getHandles() const { return m_handles; }
+
+        // cold data
+        const std::vector<std::vector<Matrix4x4>>& getJointMatrices() const { return m_joint_matrices; }
+        const std::vector<BoundingBox>&            getLocalBoundingBoxes() const { return m_local_bounding_boxes; }
+        const std::vector<RenderEntityMaterialParameters>& getMaterialParameters() const
+        {
+            return m_material_parameters;
+        }
+
+    private:
+        std::vector<uint32_t>            m_instance_ids;
+        std::vector<BoundingBox>         m_world_bounding_boxes;
+        std::vector<Matrix4x4>           m_model_matrices;
+        std::vector<RenderEntityHandles> m_handles;
+
+        std::vector<std::vector<Matrix4x4>>         m_joint_matrices;
+        std::vector<BoundingBox>                    m_local_bounding_boxes;
+        std::vector<RenderEntityMaterialParameters> m_material_parameters;
+
+        std::unordered_map<uint32_t, size_t> m_instance_id_entity_index_map;
+    };
+} // namespace Piccolo
@@ -0,0 +1,147 @@
+#include "runtime/function/render/render_gpu_profiler.h"
+#include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler_system.h"
+
+namespace Piccolo
+{
+    void RenderGPUProfiler::initialize(std::shared_ptr<VulkanRHI> rhi, std::shared_ptr<ProfilerSystem> profiler)
+    {
+        m_vulkan_rhi = rhi;
+        m_profiler   = profiler;
+        if (!m_profiler)
+        {
+            return;
+        }
+
+        uint32_t queue_family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_vulkan_rhi->m_physical_device, &queue_family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(
+            m_vulkan_rhi->m_physical_device, &queue_family_count, queue_families.data());
+
+        const uint32_t timestamp_valid_bits =
+            queue_families[m_vulkan_rhi->m_queue_indices.m_graphics_family.value()].timestampValidBits;
+        if (timestamp_valid_bits == 0)
+        {
+            LOG_WARN("the graphics queue does not support timestamps, the gpu passes are not profiled");
+            return;
+        }
+
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(m_vulkan_rhi->m_physical_device, &physical_device_properties);
+        m_timestamp_period_ns = physical_device_properties.limits.timestampPeriod;
+        m_timestamp_mask      = timestamp_valid_bits >= 64 ? ~0ull : (1ull << timestamp_valid_bits) - 1;
+
+        VkQueryPoolCreateInfo query_pool_create_info {};
+        query_pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        query_pool_create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+        query_pool_create_info.queryCount = 2 * s_max_scope_count;
+
+        m_frame_queries.resize(VulkanRHI::s_max_frames_in_flight);
+        for (FrameQueries& frame_queries : m_frame_queries)
+        {
+            if (vkCreateQueryPool(
+                    m_vulkan_rhi->m_device, &query_pool_create_info, nullptr, &frame_queries.query_pool) !=
+                VK_SUCCESS)
+            {
+                throw std::runtime_error("create gpu profiler query pool");
+            }
+            frame_queries.scope_names.reserve(s_max_scope_count);
+        }
+
+        m_enabled = true;
+    }
+
+    void RenderGPUProfiler::beginFrame()
+    {
+        if (!m_enabled)
+        {
+            return;
+        }
+
+        // the fence of this frame index has been waited, so the queries recorded with it are available
+        FrameQueries& frame_queries = m_frame_queries[m_vulkan_rhi->m_current_frame_index];
+        if (!frame_queries.scope_names.empty())
+        {
+            readFrameQueries(frame_queries);
+        }
+
+        vkCmdResetQueryPool(
+            m_vulkan_rhi->m_current_command_buffer, frame_queries.query_pool, 0, 2 * s_max_scope_count);
+        frame_queries.frame_serial = m_profiler->getFrameSerial();
+        frame_queries.scope_names.clear();
+    }
+
+    uint32_t RenderGPUProfiler::beginScope(VkCommandBuffer command_buffer, const char* name)
+    {
+        if (!m_enabled)
+        {
+            return s_invalid_scope;
+        }
+
+        FrameQueries& frame_queries = m_frame_queries[m_vulkan_rhi->m_current_frame_index];
+        if (frame_queries.scope_names.size() >= s_max_scope_count)
+        {
+            return s_invalid_scope;
+        }
+
+        const uint32_t scope = static_cast<uint32_t>(frame_queries.scope_names.size());
+        frame_queries.scope_names.push_back(name);
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame_queries.query_pool, 2 * scope);
+        return scope;
+    }
+
+    void RenderGPUProfiler::endScope(VkCommandBuffer command_buffer, uint32_t scope)
+    {
+        if (!m_enabled || scope == s_invalid_scope)
+        {
+            return;
+        }
+
+        FrameQueries& frame_queries = m_frame_queries[m_vulkan_rhi->m_current_frame_index];
+        vkCmdWriteTimestamp(
+            command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame_queries.query_pool, 2 * scope + 1);
+    }
+
+    void RenderGPUProfiler::readFrameQueries(FrameQueries& frame_queries)
+    {
+        const uint32_t        query_count = 2 * static_cast<uint32_t>(frame_queries.scope_names.size());
+        std::vector<uint64_t> timestamps(query_count);
+
+        // no wait flag, a frame that was never submitted (e.g. the swapchain was recreated) is simply skipped
+        if (vkGetQueryPoolResults(m_vulkan_rhi->m_device,
+                                  frame_queries.query_pool,
+                                  0,
+                                  query_count,
+                                  timestamps.size() * sizeof(uint64_t),
+                                  timestamps.data(),
+                                  sizeof(uint64_t),
+                                  VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        const double us_per_tick = static_cast<double>(m_timestamp_period_ns) / 1000.0;
+
+        uint64_t                   frame_duration_us = 0;
+        std::vector<ProfilerEvent> events(frame_queries.scope_names.size());
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            const uint64_t begin_ticks = timestamps[2 * i] & m_timestamp_mask;
+            const uint64_t end_ticks   = timestamps[2 * i + 1] & m_timestamp_mask;
+
+            events[i].name        = frame_queries.scope_names[i];
+            events[i].begin_us    = static_cast<uint64_t>(begin_ticks * us_per_tick);
+            events[i].duration_us = static_cast<uint64_t>(((end_ticks - begin_ticks) & m_timestamp_mask) * us_per_tick);
+
+            frame_duration_us += events[i].duration_us;
+        }
+        // the scopes are not nested, so they sum up to the gpu time of the frame
+        m_last_frame_time_ms = static_cast<float>(frame_duration_us) / 1000.0f;
+        m_last_frame_serial  = frame_queries.frame_serial;
+
+        m_profiler->addGPUEvents(frame_queries.frame_serial, std::move(events));
+    }
+} // namespace Piccolo
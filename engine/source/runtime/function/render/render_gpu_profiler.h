@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <vector>
+
+namespace Piccolo
+{
+    class ProfilerSystem;
+    class VulkanRHI;
+
+    // times the render passes with timestamp queries, one query pool per frame in flight. the results of a frame
+    // are read when its frame index comes around again, after the fence of the frame, so the readback never waits
+    class RenderGPUProfiler
+    {
+    public:
+        void initialize(std::shared_ptr<VulkanRHI> rhi, std::shared_ptr<ProfilerSystem> profiler);
+
+        // reads the results of the previous frame with the current frame index and resets its queries, recorded into
+        // the current command buffer outside of any render pass
+        void beginFrame();
+
+        // the name must outlive the profiler. returns the scope to end, or an invalid one once the queries of the
+        // frame are used up
+        uint32_t beginScope(VkCommandBuffer command_buffer, const char* name);
+        void     endScope(VkCommandBuffer command_buffer, uint32_t scope);
+
+        // the summed scopes of the last frame read back, 0 until one is. the serial changes with every frame read
+        float    getLastFrameTimeMs() const { return m_last_frame_time_ms; }
+        uint64_t getLastFrameSerial() const { return m_last_frame_serial; }
+
+        static constexpr uint32_t s_max_scope_count {64};
+        static constexpr uint32_t s_invalid_scope {~0u};
+
+    private:
+        struct FrameQueries
+        {
+            VkQueryPool              query_pool {VK_NULL_HANDLE};
+            uint64_t                 frame_serial {0};
+            std::vector<const char*> scope_names;
+        };
+
+        void readFrameQueries(FrameQueries& frame_queries);
+
+        std::shared_ptr<VulkanRHI>      m_vulkan_rhi;
+        std::shared_ptr<ProfilerSystem> m_profiler;
+
+        bool                      m_enabled {false};
+        float                     m_timestamp_period_ns {1.0f};
+        uint64_t                  m_timestamp_mask {~0ull};
+        std::vector<FrameQueries> m_frame_queries;
+        float                     m_last_frame_time_ms {0.0f};
+        uint64_t                  m_last_frame_serial {0};
+    };
+
+    // times the commands recorded during the lifetime of the scope
+    class RenderGPUProfileScope
+    {
+    public:
+        RenderGPUProfileScope(RenderGPUProfiler* profiler, VkCommandBuffer command_buffer, const char* name) :
+            m_profiler(profiler), m_command_buffer(command_buffer)
+        {
+            if (m_profiler)
+            {
+                m_scope = m_profiler->beginScope(m_command_buffer, name);
+            }
+        }
+
+        ~RenderGPUProfileScope()
+        {
+            if (m_profiler)
+            {
+                m_profiler->endScope(m_command_buffer, m_scope);
+            }
+        }
+
+        RenderGPUProfileScope(const RenderGPUProfileScope&) = delete;
+        RenderGPUProfileScope& operator=(const RenderGPUProfileScope&) = delete;
+
+    private:
+        RenderGPUProfiler* m_profiler;
+        VkCommandBuffer    m_command_buffer;
+        uint32_t           m_scope {RenderGPUProfiler::s_invalid_scope};
+    };
+} // namespace Piccolo
@@ -1,11 +1,23 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 namespace Piccolo
 {
     static const size_t s_invalid_guid = 0;
 
+    // a guid packs (slot index + 1) in the low bits and the generation of the slot in the high bits,
+    // so a guid that was freed and whose slot got reused is detected as stale.
+    // guids fit in 32 bits since instance ids are used as uint32_t node ids
+    static const uint32_t s_guid_slot_bits       = 24;
+    static const uint32_t s_guid_generation_bits = 8;
+    static const size_t   s_guid_slot_mask       = (size_t(1) << s_guid_slot_bits) - 1;
+    static const uint32_t s_guid_generation_mask = (uint32_t(1) << s_guid_generation_bits) - 1;
+
     template<typename T>
     class GuidAllocator
     {
@@ -14,38 +26,48 @@ namespace Piccolo
 
         size_t allocGuid(const T& t)
         {
-            auto find_it = m_elements_guid_map.find(t);
-            if (find_it != m_elements_guid_map.end())
+            auto insert_result = m_elements_guid_map.try_emplace(t, s_invalid_guid);
+            if (!insert_result.second)
             {
-                return find_it->second;
+                return insert_result.first->second;
             }
 
-            for (size_t i = 0; i < m_guid_elements_map.size() + 1; i++)
+            size_t slot_index;
+            if (!m_free_slots.empty())
             {
-                size_t guid = i + 1;
-                if (m_guid_elements_map.find(guid) == m_guid_elements_map.end())
-                {
-                    m_guid_elements_map.insert(std::make_pair(guid, t));
-                    m_elements_guid_map.insert(std::make_pair(t, guid));
-                    return guid;
-                }
+                slot_index = m_free_slots.back();
+                m_free_slots.pop_back();
             }
+            else
+            {
+                slot_index = m_slots.size();
+                assert(slot_index < s_guid_slot_mask);
+                m_slots.emplace_back();
+            }
+
+            Slot& slot     = m_slots[slot_index];
+            slot.m_element = t;
+            slot.m_alive   = true;
 
-            return s_invalid_guid;
+            size_t guid                 = makeGuid(slot_index, slot.m_generation);
+            insert_result.first->second = guid;
+            return guid;
         }
 
-        bool getGuidRelatedElement(size_t guid, T& t)
+        bool isAliveGuid(size_t guid) const { return findSlot(guid) != nullptr; }
+
+        bool getGuidRelatedElement(size_t guid, T& t) const
         {
-            auto find_it = m_guid_elements_map.find(guid);
-            if (find_it != m_guid_elements_map.end())
+            const Slot* slot = findSlot(guid);
+            if (slot)
             {
-                t = find_it->second;
+                t = slot->m_element;
                 return true;
             }
             return false;
         }
 
-        bool getElementGuid(const T& t, size_t& guid)
+        bool getElementGuid(const T& t, size_t& guid) const
         {
             auto find_it = m_elements_guid_map.find(t);
             if (find_it != m_elements_guid_map.end())
@@ -56,16 +78,14 @@ namespace Piccolo
             return false;
         }
 
-        bool hasElement(const T& t) { return m_elements_guid_map.find(t) != m_elements_guid_map.end(); }
+        bool hasElement(const T& t) const { return m_elements_guid_map.find(t) != m_elements_guid_map.end(); }
 
         void freeGuid(size_t guid)
         {
-            auto find_it = m_guid_elements_map.find(guid);
-            if (find_it != m_guid_elements_map.end())
+            if (findSlot(guid))
             {
-                const auto& ele = find_it->second;
-                m_elements_guid_map.erase(ele);
-                m_guid_elements_map.erase(guid);
+                m_elements_guid_map.erase(m_slots[getSlotIndex(guid)].m_element);
+                releaseSlot(getSlotIndex(guid));
             }
         }
 
@@ -74,31 +94,92 @@ namespace Piccolo
             auto find_it = m_elements_guid_map.find(t);
             if (find_it != m_elements_guid_map.end())
             {
-                const auto& guid = find_it->second;
-                m_elements_guid_map.erase(t);
-                m_guid_elements_map.erase(guid);
+                size_t slot_index = getSlotIndex(find_it->second);
+                m_elements_guid_map.erase(find_it);
+                releaseSlot(slot_index);
             }
         }
 
         std::vector<size_t> getAllocatedGuids() const
         {
             std::vector<size_t> allocated_guids;
-            for (const auto& ele : m_guid_elements_map)
+            allocated_guids.reserve(m_elements_guid_map.size());
+            for (size_t slot_index = 0; slot_index < m_slots.size(); ++slot_index)
             {
-                allocated_guids.push_back(ele.first);
+                if (m_slots[slot_index].m_alive)
+                {
+                    allocated_guids.push_back(makeGuid(slot_index, m_slots[slot_index].m_generation));
+                }
             }
             return allocated_guids;
         }
 
         void clear()
         {
+            // keep the slots so that the guids handed out before are still detected as stale
             m_elements_guid_map.clear();
-            m_guid_elements_map.clear();
+            m_free_slots.clear();
+            for (size_t slot_index = m_slots.size(); slot_index > 0; --slot_index)
+            {
+                if (m_slots[slot_index - 1].m_alive)
+                {
+                    releaseSlot(slot_index - 1);
+                }
+                else
+                {
+                    m_free_slots.push_back(slot_index - 1);
+                }
+            }
         }
 
     private:
+        struct Slot
+        {
+            T        m_element {};
+            uint32_t m_generation {0};
+            bool     m_alive {false};
+        };
+
+        static size_t makeGuid(size_t slot_index, uint32_t generation)
+        {
+            return (size_t(generation) << s_guid_slot_bits) | (slot_index + 1);
+        }
+
+        static size_t getSlotIndex(size_t guid) { return (guid & s_guid_slot_mask) - 1; }
+
+        const Slot* findSlot(size_t guid) const
+        {
+            if (!isValidGuid(guid))
+            {
+                return nullptr;
+            }
+
+            size_t slot_index = getSlotIndex(guid);
+            if (slot_index >= m_slots.size())
+            {
+                return nullptr;
+            }
+
+            const Slot& slot = m_slots[slot_index];
+            if (!slot.m_alive || makeGuid(slot_index, slot.m_generation) != guid)
+            {
+                return nullptr;
+            }
+            return &slot;
+        }
+
+        void releaseSlot(size_t slot_index)
+        {
+            Slot& slot        = m_slots[slot_index];
+            slot.m_element    = T {};
+            slot.m_alive      = false;
+            slot.m_generation = (slot.m_generation + 1) & s_guid_generation_mask;
+            m_free_slots.push_back(slot_index);
+        }
+
         std::unordered_map<T, size_t> m_elements_guid_map;
-        std::unordered_map<size_t, T> m_guid_elements_map;
+        std::vector<Slot>             m_slots;
+        std::vector<size_t>           m_free_slots;
     };
 
 } // namespace Piccolo
@@ -179,6 +179,37 @@ namespace Piccolo
         return true;
     }
 
+    bool TiledFrustumContainBox(ClusterFrustum const& f, BoundingBox const& b)
+    {
+        Vector4 box_center((b.max_bound.x + b.min_bound.x) * 0.5,
+                           (b.max_bound.y + b.min_bound.y) * 0.5,
+                           (b.max_bound.z + b.min_bound.z) * 0.5,
+                           1.0);
+
+        Vector3 box_extents((b.max_bound.x - b.min_bound.x) * 0.5,
+                            (b.max_bound.y - b.min_bound.y) * 0.5,
+                            (b.max_bound.z - b.min_bound.z) * 0.5);
+
+        Vector4 const* planes[6] = {
+            &f.m_plane_right, &f.m_plane_left, &f.m_plane_top, &f.m_plane_bottom, &f.m_plane_near, &f.m_plane_far};
+
+        for (Vector4 const* plane : planes)
+        {
+            // the normal of the plane is pointing outward
+            float signed_distance_from_plane = plane->dotProduct(box_center);
+            float radius_project_plane =
+                Vector3(fabs(plane->x), fabs(plane->y), fabs(plane->z)).dotProduct(box_extents);
+
+            bool inside = signed_distance_from_plane <= -radius_project_plane;
+            if (!inside)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     BoundingBox BoundingBoxTransform(BoundingBox const& b, Matrix4x4 const& m)
     {
         // we follow the "BoundingBox::Transform"
@@ -259,129 +290,140 @@ namespace Piccolo
         return true;
     }
 
-    Matrix4x4 CalculateDirectionalLightCamera(RenderScene& scene, RenderCamera& camera)
+    bool PointLightShadowFaceIntersectBox(BoundingSphere const& light_bounding_sphere,
+                                          uint32_t              face_index,
+                                          BoundingBox const&    b)
     {
-        Matrix4x4 proj_view_matrix;
+        if (face_index % 2 == 0 ? b.min_bound.z > light_bounding_sphere.m_center.z :
+                                  b.max_bound.z < light_bounding_sphere.m_center.z)
+        {
+            return false;
+        }
+        return BoxIntersectsWithSphere(b, light_bounding_sphere);
+    }
 
-        Matrix4x4 view_matrix = camera.getViewMatrix();
-        Matrix4x4 proj_matrix = camera.getPersProjMatrix();
-        proj_view_matrix      = proj_matrix * view_matrix;
+    void CalculateDirectionalLightCascades(RenderScene&  scene,
+                                           RenderCamera& camera,
+                                           uint32_t      cascade_count,
+                                           float         split_lambda,
+                                           uint32_t      first_cached_cascade,
+                                           Matrix4x4*    cascade_proj_views)
+    {
+        // the cached cascades are larger by this part of their radius, and only move by steps that keep their slice
+        // inside of them
+        static const float s_cached_cascade_padding = 0.125f;
 
+        Matrix4x4 proj_view_matrix         = camera.getPersProjMatrix() * camera.getViewMatrix();
         Matrix4x4 inverse_proj_view_matrix = proj_view_matrix.inverse();
 
-        //Vector3 const g_frustum_points_ndc_space[8] = { Vector3(-1.0f, -1.0f, 0.0f),
-        //                                                Vector3(1.0f, -1.0f, 0.0f),
-        //                                                Vector3(-1.0f, 1.0f, 0.0f),
-        //                                                Vector3(1.0f, 1.0f, 0.0f),
-        //                                                Vector3(-1.0f, -1.0f, 1.0f),
-        //                                                Vector3(1.0f, -1.0f, 1.0f),
-        //                                                Vector3(-1.0f, 1.0f, 1.0f),
-        //                                                Vector3(1.0f, 1.0f, 1.0f) };
-
-        //std::vector<Vector4> corners;
-
-        //for (int i = 0; i < 8; ++i)
-        //{
-        //    Vector4 corner = inverse_proj_view_matrix * Vector4(g_frustum_points_ndc_space[i], 1.f);
-        //    corners.push_back(corner / corner.w);
-        //}
-        //// 8ҵһĹԴռAABB
-        //float near_len = (corners[3] - corners[0]).dotProduct(corners[3] - corners[0]);
-
-        //float far_len = (corners[7] - corners[4]).dotProduct(corners[7] - corners[4]);
+        // the corners of the near and the far planes of the camera
+        Vector3 near_corners[4];
+        Vector3 far_corners[4];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            float x = (i == 1 || i == 2) ? 1.0f : -1.0f;
+            float y = (i >= 2) ? 1.0f : -1.0f;
 
-        //float len = camera.m_zfar - camera.m_znear;
+            Vector4 near_corner = inverse_proj_view_matrix * Vector4(x, y, 0.0f, 1.0f);
+            Vector4 far_corner  = inverse_proj_view_matrix * Vector4(x, y, 1.0f, 1.0f);
+            near_corners[i]     = Vector3(near_corner.x, near_corner.y, near_corner.z) / near_corner.w;
+            far_corners[i]      = Vector3(far_corner.x, far_corner.y, far_corner.z) / far_corner.w;
+        }
 
-        //float x = (len / 2.0f) + ((far_len - near_len) / (8 * len));
+        // the root of the scene bvh bounds all the entities
+        BoundingBox scene_bounding_box       = scene.getRenderEntitiesBoundingBox();
+        bool        scene_bounding_box_valid = scene_bounding_box.min_bound.x <= scene_bounding_box.max_bound.x;
 
-        //float radius = std::sqrt(x * x + near_len * 0.25f);
+        // no cascade is spent beyond the farthest entity
+        float z_near      = camera.m_znear;
+        float z_far       = camera.m_zfar;
+        float shadows_far = z_far;
+        if (scene_bounding_box_valid)
+        {
+            float scene_far = z_near;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                Vector3 corner((i & 1) ? scene_bounding_box.max_bound.x : scene_bounding_box.min_bound.x,
+                               (i & 2) ? scene_bounding_box.max_bound.y : scene_bounding_box.min_bound.y,
+                               (i & 4) ? scene_bounding_box.max_bound.z : scene_bounding_box.min_bound.z);
+                scene_far = std::max(scene_far, (corner - camera.position()).dotProduct(camera.forward()));
+            }
+            shadows_far = std::min(z_far, std::max(scene_far, z_near * 2.0f));
+        }
 
-        //Vector4 Center = (view_matrix).inverse() * Vector4(0.0, 0.0, -(camera.m_znear), 1.0);
-        //Vector3    frustumCenter = Vector3(Center.x, Center.y, Center.z);
-        //const auto lightView     = Math::makeLookAtMatrix(
-        //    frustumCenter + scene.m_directional_light.m_direction, frustumCenter, Vector3(0.0f, 1.0f, 0.0f));
+        // the light view only rotates with the light, so moving the camera only translates the cascades
+        Vector3   light_direction = scene.m_directional_light.m_direction.normalisedCopy();
+        Vector3   light_up        = std::abs(light_direction.z) < 0.99f ? Vector3::UNIT_Z : Vector3::UNIT_Y;
+        Matrix4x4 light_view      = Math::makeLookAtMatrix(Vector3::ZERO, -light_direction, light_up);
 
-        //const Matrix4x4 lightProjection =
-        //     Math::makeOrthographicProjectionMatrix(-radius/2, radius/2, -radius/2, radius/2, -10.f * radius, 10.f * radius);
-        //Matrix4x4 lightVPMatrix = lightProjection * lightView;
-        //return lightVPMatrix;
+        BoundingBox scene_bounding_box_light_view;
+        if (scene_bounding_box_valid)
+        {
+            scene_bounding_box_light_view = BoundingBoxTransform(scene_bounding_box, light_view);
+        }
 
-        BoundingBox frustum_bounding_box;
-        // CascadedShadowMaps11 / CreateFrustumPointsFromCascadeInterval
+        float cascade_dimension = static_cast<float>(s_directional_light_shadow_map_dimension /
+                                                     getDirectionalLightCascadeGridSize(cascade_count));
+        float slice_near        = z_near;
+        for (uint32_t cascade_index = 0; cascade_index < cascade_count; ++cascade_index)
         {
-            Vector3 const g_frustum_points_ndc_space[8] = {Vector3(-1.0f, -1.0f, 1.0f),
-                                                             Vector3(1.0f, -1.0f, 1.0f),
-                                                             Vector3(1.0f, 1.0f, 1.0f),
-                                                             Vector3(-1.0f, 1.0f, 1.0f),
-                                                             Vector3(-1.0f, -1.0f, 0.0f),
-                                                             Vector3(1.0f, -1.0f, 0.0f),
-                                                             Vector3(1.0f, 1.0f, 0.0f),
-                                                             Vector3(-1.0f, 1.0f, 0.0f)};
-
-            Matrix4x4 inverse_proj_view_matrix = proj_view_matrix.inverse();
-
-            frustum_bounding_box.min_bound = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
-            frustum_bounding_box.max_bound = Vector3(FLT_MIN, FLT_MIN, FLT_MIN);
-
-            size_t const CORNER_COUNT = 8;
-            for (size_t i = 0; i < CORNER_COUNT; ++i)
+            // practical split scheme, between the logarithmic and the uniform splits
+            float split         = static_cast<float>(cascade_index + 1) / static_cast<float>(cascade_count);
+            float log_split     = z_near * std::pow(shadows_far / z_near, split);
+            float uniform_split = z_near + (shadows_far - z_near) * split;
+            float slice_far     = split_lambda * log_split + (1.0f - split_lambda) * uniform_split;
+
+            // the bounding sphere of the slice keeps its size when the camera rotates
+            float   near_t = (slice_near - z_near) / (z_far - z_near);
+            float   far_t  = (slice_far - z_near) / (z_far - z_near);
+            Vector3 slice_corners[8];
+            Vector3 slice_center = Vector3::ZERO;
+            for (size_t i = 0; i < 4; ++i)
             {
-                Vector4 frustum_point_with_w = inverse_proj_view_matrix * Vector4(g_frustum_points_ndc_space[i].x,
-                                                                                      g_frustum_points_ndc_space[i].y,
-                                                                                      g_frustum_points_ndc_space[i].z,
-                                                                                      1.0);
-                Vector3   frustum_point        = Vector3(frustum_point_with_w.x / frustum_point_with_w.w,
-                                                frustum_point_with_w.y / frustum_point_with_w.w,
-                                                frustum_point_with_w.z / frustum_point_with_w.w);
-
-                frustum_bounding_box.merge(frustum_point);
+                slice_corners[i]     = near_corners[i] + (far_corners[i] - near_corners[i]) * near_t;
+                slice_corners[i + 4] = near_corners[i] + (far_corners[i] - near_corners[i]) * far_t;
+                slice_center += slice_corners[i] + slice_corners[i + 4];
             }
-        }
+            slice_center /= 8.0f;
 
-        BoundingBox scene_bounding_box;
-        {
-            scene_bounding_box.min_bound = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
-            scene_bounding_box.max_bound = Vector3(FLT_MIN, FLT_MIN, FLT_MIN);
+            float radius = 0.0f;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                radius = std::max(radius, slice_center.distance(slice_corners[i]));
+            }
+            radius = std::ceil(radius * 16.0f) / 16.0f;
 
-            for (const RenderEntity& entity : scene.m_render_entities)
+            // snapped to whole texels, the shadows do not shimmer while the camera moves
+            float texel_size = 2.0f * radius / cascade_dimension;
+            float snap_size  = texel_size;
+            if (cascade_index >= first_cached_cascade)
             {
-                BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                     entity.m_bounding_box.getMaxCorner()};
+                float padding = radius * s_cached_cascade_padding;
+                radius += padding;
+                texel_size = 2.0f * radius / cascade_dimension;
+                snap_size  = std::max(texel_size, std::floor(padding / Math::sqrt(3.0f) / texel_size) * texel_size);
+            }
+
+            Vector4 center_light_view = light_view * Vector4(slice_center, 1.0f);
+            Vector3 center(std::floor(center_light_view.x / snap_size) * snap_size,
+                           std::floor(center_light_view.y / snap_size) * snap_size,
+                           std::floor(center_light_view.z / snap_size) * snap_size);
 
-                BoundingBox mesh_bounding_box_world =
-                    BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
-                scene_bounding_box.merge(mesh_bounding_box_world);
+            // the entities between the light and the slice cast their shadows into it as well
+            float z_top    = center.z + radius;
+            float z_bottom = center.z - radius;
+            if (scene_bounding_box_valid)
+            {
+                z_top    = std::max(z_top, scene_bounding_box_light_view.max_bound.z);
+                z_bottom = std::max(z_bottom, scene_bounding_box_light_view.min_bound.z);
+                z_bottom = std::min(z_bottom, z_top - texel_size);
             }
-        }
 
-        // CascadedShadowMaps11 / ComputeNearAndFar
-        Matrix4x4 light_view;
-        Matrix4x4 light_proj;
-        {
-            Vector3 box_center((frustum_bounding_box.max_bound.x + frustum_bounding_box.min_bound.x) * 0.5,
-                                 (frustum_bounding_box.max_bound.y + frustum_bounding_box.min_bound.y) * 0.5,
-                                 (frustum_bounding_box.max_bound.z + frustum_bounding_box.min_bound.z));
-            Vector3 box_extents((frustum_bounding_box.max_bound.x - frustum_bounding_box.min_bound.x) * 0.5,
-                                  (frustum_bounding_box.max_bound.y - frustum_bounding_box.min_bound.y) * 0.5,
-                                  (frustum_bounding_box.max_bound.z - frustum_bounding_box.min_bound.z) * 0.5);
-
-            Vector3 eye =
-                box_center + scene.m_directional_light.m_direction * box_extents.length();
-            Vector3 center = box_center;
-            light_view       = Math::makeLookAtMatrix(eye, center, Vector3(0.0, 0.0, 1.0));
-
-            BoundingBox frustum_bounding_box_light_view = BoundingBoxTransform(frustum_bounding_box, light_view);
-            BoundingBox scene_bounding_box_light_view   = BoundingBoxTransform(scene_bounding_box, light_view);
-            light_proj = Math::makeOrthographicProjectionMatrix01(
-                std::max(frustum_bounding_box_light_view.min_bound.x, scene_bounding_box_light_view.min_bound.x),
-                std::min(frustum_bounding_box_light_view.max_bound.x, scene_bounding_box_light_view.max_bound.x),
-                std::max(frustum_bounding_box_light_view.min_bound.y, scene_bounding_box_light_view.min_bound.y),
-                std::min(frustum_bounding_box_light_view.max_bound.y, scene_bounding_box_light_view.max_bound.y),
-                -scene_bounding_box_light_view.max_bound.z, // the objects which are nearer than the frustum bounding box may caster shadow as well
-                -std::max(frustum_bounding_box_light_view.min_bound.z, scene_bounding_box_light_view.min_bound.z)) ;
-        }
+            Matrix4x4 light_proj = Math::makeOrthographicProjectionMatrix01(
+                center.x - radius, center.x + radius, center.y - radius, center.y + radius, -z_top, -z_bottom);
 
-        Matrix4x4 light_proj_view = (light_proj * light_view);
-        return light_proj_view;
+            cascade_proj_views[cascade_index] = light_proj * light_view;
+            slice_near                        = slice_far;
+        }
     }
 } // namespace Piccolo
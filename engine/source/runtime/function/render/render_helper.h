@@ -77,9 +77,31 @@ namespace Piccolo
 
     bool TiledFrustumIntersectBox(ClusterFrustum const& f, BoundingBox const& b);
 
+    // true only if the box is completely inside the frustum
+    bool TiledFrustumContainBox(ClusterFrustum const& f, BoundingBox const& b);
+
     BoundingBox BoundingBoxTransform(BoundingBox const& b, Matrix4x4 const& m);
 
     bool BoxIntersectsWithSphere(BoundingBox const& b, BoundingSphere const& s);
 
-    Matrix4x4 CalculateDirectionalLightCamera(RenderScene& scene, RenderCamera& camera);
+    // the faces of a point light shadow are the paraboloids of the hemispheres below (even faces) and above (odd
+    // faces) the light, inside of its bounding sphere
+    bool PointLightShadowFaceIntersectBox(BoundingSphere const& light_bounding_sphere,
+                                          uint32_t              face_index,
+                                          BoundingBox const&    b);
+
+    // the cascades of the directional light shadow share one atlas, in a grid of this size
+    static inline uint32_t getDirectionalLightCascadeGridSize(uint32_t cascade_count)
+    {
+        return cascade_count > 1 ? 2 : 1;
+    }
+
+    // splits the view of the camera in slices fitted by the cascades, the cascades from the first cached one move by
+    // larger steps so that they can be reused while the camera stays inside of them
+    void CalculateDirectionalLightCascades(RenderScene&  scene,
+                                           RenderCamera& camera,
+                                           uint32_t      cascade_count,
+                                           float         split_lambda,
+                                           uint32_t      first_cached_cascade,
+                                           Matrix4x4*    cascade_proj_views);
 } // namespace Piccolo
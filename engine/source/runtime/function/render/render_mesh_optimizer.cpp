@@ -0,0 +1,241 @@
+#include "runtime/function/render/render_mesh_optimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Piccolo
+{
+    static const uint32_t s_invalid_vertex_cache_index = UINT32_MAX;
+
+    static const float s_cache_decay_power   = 1.5f;
+    static const float s_last_triangle_score = 0.75f;
+    static const float s_valence_boost_scale = 2.0f;
+    static const float s_valence_boost_power = 0.5f;
+
+    static float calculateVertexScore(int32_t cache_position, uint32_t remaining_valence)
+    {
+        if (remaining_valence == 0)
+        {
+            // no triangle needs this vertex anymore
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+        if (cache_position >= 0)
+        {
+            if (cache_position < 3)
+            {
+                // the vertices of the last triangle are scored fixed so that the next triangle does not simply
+                // continue a strip
+                score = s_last_triangle_score;
+            }
+            else
+            {
+                float scaler = 1.0f / (s_mesh_optimizer_vertex_cache_size - 3);
+                score        = std::pow(1.0f - (cache_position - 3) * scaler, s_cache_decay_power);
+            }
+        }
+
+        // prefer vertices with few remaining triangles to get rid of lone triangles early
+        score += s_valence_boost_scale * std::pow(static_cast<float>(remaining_valence), -s_valence_boost_power);
+        return score;
+    }
+
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count)
+    {
+        size_t index_count    = indices.size();
+        size_t triangle_count = index_count / 3;
+        if (triangle_count == 0)
+        {
+            return;
+        }
+
+        // triangles adjacent to each vertex, the first remaining_valence entries are the ones not emitted yet
+        std::vector<uint32_t> remaining_valence(vertex_count, 0);
+        for (uint32_t index : indices)
+        {
+            ++remaining_valence[index];
+        }
+
+        std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+        for (size_t vertex = 0; vertex < vertex_count; ++vertex)
+        {
+            adjacency_offsets[vertex + 1] = adjacency_offsets[vertex] + remaining_valence[vertex];
+        }
+
+        std::vector<uint32_t> adjacency(index_count);
+        {
+            std::vector<uint32_t> fill_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+            for (size_t triangle = 0; triangle < triangle_count; ++triangle)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    adjacency[fill_offsets[indices[triangle * 3 + corner]]++] = static_cast<uint32_t>(triangle);
+                }
+            }
+        }
+
+        std::vector<int32_t> cache_positions(vertex_count, -1);
+        std::vector<float>   vertex_scores(vertex_count);
+        for (size_t vertex = 0; vertex < vertex_count; ++vertex)
+        {
+            vertex_scores[vertex] = calculateVertexScore(-1, remaining_valence[vertex]);
+        }
+
+        std::vector<float> triangle_scores(triangle_count);
+        std::vector<bool>  triangle_emitted(triangle_count, false);
+
+        size_t best_triangle       = 0;
+        float  best_triangle_score = -1.0f;
+        for (size_t triangle = 0; triangle < triangle_count; ++triangle)
+        {
+            triangle_scores[triangle] = vertex_scores[indices[triangle * 3 + 0]] +
+                                        vertex_scores[indices[triangle * 3 + 1]] +
+                                        vertex_scores[indices[triangle * 3 + 2]];
+            if (triangle_scores[triangle] > best_triangle_score)
+            {
+                best_triangle       = triangle;
+                best_triangle_score = triangle_scores[triangle];
+            }
+        }
+
+        std::vector<uint32_t> output_indices;
+        output_indices.reserve(index_count);
+
+        // the cache holds up to three more entries while the vertices of the emitted triangle are pushed
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> next_cache;
+        cache.reserve(s_mesh_optimizer_vertex_cache_size + 3);
+        next_cache.reserve(s_mesh_optimizer_vertex_cache_size + 3);
+
+        size_t scan_cursor = 0;
+        while (output_indices.size() < index_count)
+        {
+            if (best_triangle_score < 0.0f)
+            {
+                // nothing in the cache is connected to a remaining triangle, start over at the next one
+                while (triangle_emitted[scan_cursor])
+                {
+                    ++scan_cursor;
+                }
+                best_triangle = scan_cursor;
+            }
+
+            const uint32_t* triangle_vertices = &indices[best_triangle * 3];
+            output_indices.insert(output_indices.end(), triangle_vertices, triangle_vertices + 3);
+            triangle_emitted[best_triangle] = true;
+
+            next_cache.assign(triangle_vertices, triangle_vertices + 3);
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                uint32_t vertex = triangle_vertices[corner];
+
+                // move the emitted triangle behind the remaining ones of the vertex
+                uint32_t* vertex_adjacency = &adjacency[adjacency_offsets[vertex]];
+                uint32_t* emitted_entry =
+                    std::find(vertex_adjacency, vertex_adjacency + remaining_valence[vertex], best_triangle);
+                assert(emitted_entry != vertex_adjacency + remaining_valence[vertex]);
+                std::swap(*emitted_entry, vertex_adjacency[remaining_valence[vertex] - 1]);
+                --remaining_valence[vertex];
+            }
+
+            for (uint32_t vertex : cache)
+            {
+                if (vertex != triangle_vertices[0] && vertex != triangle_vertices[1] && vertex != triangle_vertices[2])
+                {
+                    next_cache.push_back(vertex);
+                }
+            }
+            std::swap(cache, next_cache);
+
+            // vertices pushed out of the cache only lose their cache bonus
+            for (size_t cache_index = s_mesh_optimizer_vertex_cache_size; cache_index < cache.size(); ++cache_index)
+            {
+                uint32_t vertex         = cache[cache_index];
+                cache_positions[vertex] = -1;
+                vertex_scores[vertex]   = calculateVertexScore(-1, remaining_valence[vertex]);
+            }
+
+            for (size_t cache_index = 0; cache_index < cache.size(); ++cache_index)
+            {
+                uint32_t vertex = cache[cache_index];
+                if (cache_index < s_mesh_optimizer_vertex_cache_size)
+                {
+                    cache_positions[vertex] = static_cast<int32_t>(cache_index);
+                    vertex_scores[vertex]   = calculateVertexScore(cache_positions[vertex], remaining_valence[vertex]);
+                }
+            }
+
+            // rescore the remaining triangles around the cache and pick the next one
+            best_triangle_score = -1.0f;
+            for (uint32_t vertex : cache)
+            {
+                const uint32_t* vertex_adjacency = &adjacency[adjacency_offsets[vertex]];
+                for (uint32_t adjacency_index = 0; adjacency_index < remaining_valence[vertex]; ++adjacency_index)
+                {
+                    uint32_t triangle         = vertex_adjacency[adjacency_index];
+                    triangle_scores[triangle] = vertex_scores[indices[triangle * 3 + 0]] +
+                                                vertex_scores[indices[triangle * 3 + 1]] +
+                                                vertex_scores[indices[triangle * 3 + 2]];
+                    if (triangle_scores[triangle] > best_triangle_score)
+                    {
+                        best_triangle       = triangle;
+                        best_triangle_score = triangle_scores[triangle];
+                    }
+                }
+            }
+
+            if (cache.size() > s_mesh_optimizer_vertex_cache_size)
+            {
+                cache.resize(s_mesh_optimizer_vertex_cache_size);
+            }
+        }
+
+        indices.swap(output_indices);
+    }
+
+    void optimizeVertexFetch(std::vector<MeshVertexDataDefinition>& vertices, std::vector<uint32_t>& indices)
+    {
+        std::vector<uint32_t>                 remap(vertices.size(), s_invalid_vertex_cache_index);
+        std::vector<MeshVertexDataDefinition> reordered_vertices;
+        reordered_vertices.reserve(vertices.size());
+
+        for (uint32_t& index : indices)
+        {
+            if (remap[index] == s_invalid_vertex_cache_index)
+            {
+                remap[index] = static_cast<uint32_t>(reordered_vertices.size());
+                reordered_vertices.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        // vertices that no triangle references are dropped
+        vertices.swap(reordered_vertices);
+    }
+
+    float calculateACMR(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size)
+    {
+        size_t triangle_count = indices.size() / 3;
+        if (triangle_count == 0)
+        {
+            return 0.0f;
+        }
+
+        // a vertex is in the fifo cache if fewer than cache_size misses happened since it was last loaded
+        std::vector<uint32_t> cache_timestamps(vertex_count, 0);
+        uint32_t              timestamp  = cache_size + 1;
+        size_t                miss_count = 0;
+        for (uint32_t index : indices)
+        {
+            if (timestamp - cache_timestamps[index] > cache_size)
+            {
+                cache_timestamps[index] = timestamp++;
+                ++miss_count;
+            }
+        }
+
+        return static_cast<float>(miss_count) / static_cast<float>(triangle_count);
+    }
+} // namespace Piccolo
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "runtime/function/render/render_type.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    // size of the post transform cache the index order is optimized for
+    static const uint32_t s_mesh_optimizer_vertex_cache_size = 32;
+
+    // reorder the triangles for post transform cache locality, using tom forsyth's linear speed vertex cache
+    // optimisation
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count);
+
+    // reorder the vertices in the order the indices first reference them, for vertex fetch locality
+    void optimizeVertexFetch(std::vector<MeshVertexDataDefinition>& vertices, std::vector<uint32_t>& indices);
+
+    // average number of vertex shader invocations per triangle for a fifo cache of cache_size vertices
+    float calculateACMR(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size);
+} // namespace Piccolo
@@ -117,6 +117,14 @@ namespace Piccolo
         bool   isValid() const { return m_go_id != k_invalid_gobject_id && m_part_id != k_invalid_part_id; }
     };
 
+    // transform and pose of a part that is already in the render scene, sent instead of the full part desc
+    struct GameObjectPartTransformDesc
+    {
+        GameObjectPartId       m_part_id;
+        Matrix4x4              m_transform_matrix {Matrix4x4::IDENTITY};
+        std::vector<Matrix4x4> m_joint_matrices;
+    };
+
     class GameObjectDesc
     {
     public:
@@ -2,10 +2,12 @@
 
 #include "runtime/core/base/macro.h"
 
+#include "runtime/function/render/render_mesh.h"
 #include "runtime/function/render/render_resource.h"
 #include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
 
-Piccolo::VisiableNodes Piccolo::RenderPass::m_visiable_nodes;
+Piccolo::VisiableNodes        Piccolo::RenderPass::m_visiable_nodes;
+Piccolo::SkinnedVertexBuffers Piccolo::RenderPass::m_skinned_vertex_buffers;
 
 namespace Piccolo
 {
@@ -41,6 +43,75 @@ namespace Piccolo
         return images;
     }
 
+    void RenderPass::bindSkinnedVertexBuffers(VkCommandBuffer command_buffer,
+                                              uint32_t        skinned_vertex_offset,
+                                              uint32_t        vertex_binding_count) const
+    {
+        assert(vertex_binding_count <= 2);
+
+        VkDeviceSize vertex_offset    = skinned_vertex_offset;
+        VkBuffer     vertex_buffers[] = {m_skinned_vertex_buffers.position_buffer,
+                                     m_skinned_vertex_buffers.varying_enable_blending_buffer};
+        VkDeviceSize offsets[]        = {sizeof(MeshVertex::VulkanMeshVertexPostition) * vertex_offset,
+                                  sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) * vertex_offset};
+        m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(command_buffer, 0, vertex_binding_count, vertex_buffers, offsets);
+    }
+
+    void RenderPass::drawMeshInstances(VkCommandBuffer       command_buffer,
+                                       const VulkanMesh&     mesh,
+                                       const RenderMeshNode* mesh_nodes,
+                                       uint32_t              instance_count,
+                                       uint32_t              vertex_binding_count) const
+    {
+        assert(vertex_binding_count <= 2);
+
+        VkBuffer     mesh_vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                          mesh.mesh_vertex_varying_enable_blending_buffer};
+        VkDeviceSize mesh_offsets[]        = {0, 0};
+
+        bool     skinned_vertex_buffers_bound = false;
+        uint32_t first_static_instance        = 0;
+        for (uint32_t i = 0; i <= instance_count; ++i)
+        {
+            // the end of the drawcall flushes the last static instances
+            bool pre_skinned =
+                i < instance_count && mesh_nodes[i].skinned_vertex_offset != s_invalid_skinned_vertex_offset;
+            if (i < instance_count && !pre_skinned)
+            {
+                continue;
+            }
+
+            if (first_static_instance < i)
+            {
+                if (skinned_vertex_buffers_bound)
+                {
+                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
+                        command_buffer, 0, vertex_binding_count, mesh_vertex_buffers, mesh_offsets);
+                    skinned_vertex_buffers_bound = false;
+                }
+                m_vulkan_rhi->m_vk_cmd_draw_indexed(
+                    command_buffer, mesh.mesh_index_count, i - first_static_instance, 0, 0, first_static_instance);
+            }
+
+            // gl_InstanceIndex still selects the instance data of the drawcall
+            if (pre_skinned)
+            {
+                bindSkinnedVertexBuffers(command_buffer, mesh_nodes[i].skinned_vertex_offset, vertex_binding_count);
+                skinned_vertex_buffers_bound = true;
+                m_vulkan_rhi->m_vk_cmd_draw_indexed(command_buffer, mesh.mesh_index_count, 1, 0, 0, i);
+            }
+
+            first_static_instance = i + 1;
+        }
+
+        // the next drawcall of the batch expects the vertex buffers of the mesh
+        if (skinned_vertex_buffers_bound)
+        {
+            m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
+                command_buffer, 0, vertex_binding_count, mesh_vertex_buffers, mesh_offsets);
+        }
+    }
+
     std::vector<VkDescriptorSetLayout> RenderPass::getDescriptorSetLayouts() const
     {
         std::vector<VkDescriptorSetLayout> layouts;
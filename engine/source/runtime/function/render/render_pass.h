@@ -1,6 +1,7 @@
 #pragma once
 
 #include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_pass_base.h"
 #include "runtime/function/render/render_resource.h"
 
@@ -62,12 +63,40 @@ namespace Piccolo
         _post_process_subpass_count
     };
 
+    // the post process subpasses when tone mapping, color grading, vignette and remap are fused into one pass
+    enum
+    {
+        _post_process_fused_subpass_uber = 0,
+        _post_process_fused_subpass_fxaa,
+        _post_process_fused_subpass_ui,
+        _post_process_fused_subpass_combine_ui,
+        _post_process_fused_subpass_count
+    };
+
     struct VisiableNodes
     {
-        std::vector<RenderMeshNode>*              p_directional_light_visible_mesh_nodes {nullptr};
-        std::vector<RenderMeshNode>*              p_point_lights_visible_mesh_nodes {nullptr};
-        std::vector<RenderMeshNode>*              p_main_camera_visible_mesh_nodes {nullptr};
-        RenderAxisNode*                           p_axis_node {nullptr};
+        // one draw list per cascade, only the ones in the render mask are up to date
+        RenderDrawList* p_directional_light_cascade_draw_lists {nullptr};
+        uint32_t*       p_directional_light_cascade_render_mask {nullptr};
+        // the shadow pass marks the cached cascades valid once it has recorded them, a dropped frame keeps them dirty
+        uint32_t*       p_directional_light_cached_cascade_valid_mask {nullptr};
+        // one draw list per point light shadow face, likewise
+        RenderDrawList* p_point_light_shadow_face_draw_lists {nullptr};
+        uint32_t*       p_point_light_shadow_face_render_mask {nullptr};
+        uint32_t*       p_point_light_shadow_face_valid_mask {nullptr};
+        RenderDrawList* p_main_camera_draw_list {nullptr};
+        RenderDrawList* p_gpu_driven_draw_list {nullptr};
+        RenderAxisNode* p_axis_node {nullptr};
+        // the visible skinned instances, each once
+        std::vector<RenderMeshNode>* p_skinned_mesh_nodes {nullptr};
+    };
+
+    // written by the mesh skinning pass for the current frame, with the layout of the vertex bindings 0 and 1 of
+    // the meshes. a skinned instance starts at its skinned_vertex_offset
+    struct SkinnedVertexBuffers
+    {
+        VkBuffer position_buffer {VK_NULL_HANDLE};
+        VkBuffer varying_enable_blending_buffer {VK_NULL_HANDLE};
     };
 
     class RenderPass : public RenderPassBase
@@ -115,13 +144,60 @@ namespace Piccolo
 
         virtual void draw();
 
+        // passes recorded by RenderCommandRecorder begin and end their render pass on the primary command buffer
+        // and record the commands inside it into a secondary one on a worker thread
+        virtual void beginRenderPass(VkCommandBuffer command_buffer, VkSubpassContents contents) {}
+        virtual void recordRenderPass(VkCommandBuffer command_buffer) {}
+        virtual void endRenderPass(VkCommandBuffer command_buffer) {}
+
         virtual VkRenderPass                       getRenderPass() const;
         virtual std::vector<VkImageView>           getFramebufferImageViews() const;
         virtual std::vector<VkImage>               getFramebufferImages() const;
         virtual std::vector<VkDescriptorSetLayout> getDescriptorSetLayouts() const;
 
-        static VisiableNodes m_visiable_nodes;
+        static VisiableNodes        m_visiable_nodes;
+        static SkinnedVertexBuffers m_skinned_vertex_buffers;
+
+        // bytes of the upload ring buffer this pass used in the frame it was last recorded
+        uint32_t getUploadByteCount() const { return m_upload_byte_count; }
+
+    protected:
+        // count elements of the current frame's upload ring buffer, may be called by passes recorded in parallel
+        template<typename T>
+        RenderUploadAllocation<T> allocateUpload(uint32_t count = 1)
+        {
+            RenderUploadAllocator& allocator = m_global_render_resource->_storage_buffer._global_upload_allocator;
+            if (m_upload_frame_serial != allocator.getFrameSerial())
+            {
+                m_upload_frame_serial = allocator.getFrameSerial();
+                m_upload_byte_count   = 0;
+            }
+            m_upload_byte_count += static_cast<uint32_t>(sizeof(T)) * count;
+            return allocator.allocate<T>(count);
+        }
+
+        // the vertex shaders only blend the instances with a pose which the mesh skinning pass has not skinned
+        static bool isShaderVertexBlending(const RenderMeshNode& node)
+        {
+            return node.joint_matrices && node.skinned_vertex_offset == s_invalid_skinned_vertex_offset;
+        }
+
+        // binds the skinned vertices of an instance to the first vertex_binding_count bindings, 1 for the position
+        // only and 2 with the normal and the tangent
+        void bindSkinnedVertexBuffers(VkCommandBuffer command_buffer,
+                                      uint32_t        skinned_vertex_offset,
+                                      uint32_t        vertex_binding_count) const;
+
+        // draws the instances of a drawcall with the vertex buffers of the mesh bound. the static instances share
+        // draws, the ones skinned by the mesh skinning pass are drawn one by one with their skinned vertices bound
+        void drawMeshInstances(VkCommandBuffer       command_buffer,
+                               const VulkanMesh&     mesh,
+                               const RenderMeshNode* mesh_nodes,
+                               uint32_t              instance_count,
+                               uint32_t              vertex_binding_count) const;
 
     private:
+        uint64_t m_upload_frame_serial {0};
+        uint32_t m_upload_byte_count {0};
     };
 } // namespace Piccolo
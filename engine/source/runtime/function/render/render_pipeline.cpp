@@ -1,4 +1,7 @@
 #include "runtime/function/render/render_pipeline.h"
+#include "runtime/function/render/render_command_recorder.h"
+#include "runtime/function/render/render_gpu_profiler.h"
+#include "runtime/function/render/render_resolution_scaler.h"
 #include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
 
 #include "runtime/function/render/passes/color_grading_pass.h"
@@ -6,11 +9,15 @@
 #include "runtime/function/render/passes/ssao_blur_pass.h"
 #include "runtime/function/render/passes/combine_ui_pass.h"
 #include "runtime/function/render/passes/directional_light_pass.h"
+#include "runtime/function/render/passes/light_clustering_pass.h"
 #include "runtime/function/render/passes/main_camera_pass.h"
+#include "runtime/function/render/passes/mesh_culling_pass.h"
+#include "runtime/function/render/passes/mesh_skinning_pass.h"
 #include "runtime/function/render/passes/post_process_pass.h"
 #include "runtime/function/render/passes/pick_pass.h"
 #include "runtime/function/render/passes/point_light_pass.h"
 #include "runtime/function/render/passes/tone_mapping_pass.h"
+#include "runtime/function/render/passes/uber_post_process_pass.h"
 #include "runtime/function/render/passes/ui_pass.h"
 #include "runtime/function/render/passes/particle_pass.h"
 #include "runtime/function/render/passes/blur_pass.h"
@@ -20,6 +27,8 @@
 #include "runtime/function/render/passes/nbr_pass.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler_system.h"
+#include "runtime/function/global/global_context.h"
 
 namespace Piccolo
 {
@@ -33,6 +42,7 @@ namespace Piccolo
         m_color_grading_pass      = std::make_shared<ColorGradingPass>();
         m_vignette_pass           = std::make_shared<VignettePass>();
         m_remap_pass              = std::make_shared<RemapPass>();
+        m_uber_post_process_pass  = std::make_shared<UberPostProcessPass>();
         m_ssao_generate_pass      = std::make_shared<SSAOGeneratePass>();
         m_ssao_blur_pass          = std::make_shared<SSAOBlurPass>();
         m_ui_pass                 = std::make_shared<UIPass>();
@@ -45,6 +55,9 @@ namespace Piccolo
         m_pcf_mask_gen_pass       = std::make_shared<PCFMaskGenPass>();
         m_pcf_mask_blur_pass      = std::make_shared<PCFMaskBlurPass>();
         m_nbr_pass                = std::make_shared<NBRPass>();
+        m_mesh_culling_pass       = std::make_shared<MeshCullingPass>();
+        m_mesh_skinning_pass      = std::make_shared<MeshSkinningPass>();
+        m_light_clustering_pass   = std::make_shared<LightClusteringPass>();
 
         RenderPassCommonInfo pass_common_info;
         pass_common_info.rhi             = m_rhi;
@@ -60,6 +73,7 @@ namespace Piccolo
         m_color_grading_pass->setCommonInfo(pass_common_info);
         m_vignette_pass->setCommonInfo(pass_common_info);
         m_remap_pass->setCommonInfo(pass_common_info);
+        m_uber_post_process_pass->setCommonInfo(pass_common_info);
         m_ui_pass->setCommonInfo(pass_common_info);
         m_combine_ui_pass->setCommonInfo(pass_common_info);
         m_pick_pass->setCommonInfo(pass_common_info);
@@ -70,6 +84,9 @@ namespace Piccolo
         m_pcf_mask_gen_pass->setCommonInfo(pass_common_info);
         m_pcf_mask_blur_pass->setCommonInfo(pass_common_info);
         m_nbr_pass->setCommonInfo(pass_common_info);
+        m_mesh_culling_pass->setCommonInfo(pass_common_info);
+        m_mesh_skinning_pass->setCommonInfo(pass_common_info);
+        m_light_clustering_pass->setCommonInfo(pass_common_info);
 
         m_point_light_shadow_pass->initialize(nullptr);
         m_directional_light_pass->initialize(nullptr);
@@ -106,7 +123,20 @@ namespace Piccolo
         main_camera_pass->m_pcf_mask_image_view =
             std::static_pointer_cast<RenderPass>(m_pcf_mask_blur_pass)->m_framebuffer.attachments[0].view;
 
+        MeshCullingPassInitInfo mesh_culling_init_info;
+        mesh_culling_init_info.enable_gpu_driven_culling = init_info.enable_gpu_driven_culling;
+        m_mesh_culling_pass->initialize(&mesh_culling_init_info);
+
+        MeshSkinningPassInitInfo mesh_skinning_init_info;
+        mesh_skinning_init_info.enable_compute_skinning = init_info.enable_compute_skinning;
+        m_mesh_skinning_pass->initialize(&mesh_skinning_init_info);
+
+        m_light_clustering_pass->initialize(nullptr);
+
         main_camera_pass->setParticlePass(particle_pass);
+        main_camera_pass->setMeshCullingPass(std::static_pointer_cast<MeshCullingPass>(m_mesh_culling_pass));
+        main_camera_pass->setLightClusteringPass(
+            std::static_pointer_cast<LightClusteringPass>(m_light_clustering_pass));
         m_main_camera_pass->initialize(nullptr);
 
         std::static_pointer_cast<ParticlePass>(m_particle_pass)->setupParticlePass();
@@ -143,47 +173,70 @@ namespace Piccolo
         m_ssao_blur_pass->initialize(&ssao_blur_init_info);
 
         PostProcessPassInitInfo post_process_init_info;
-        post_process_init_info.enable_fxaa = false;
+        post_process_init_info.enable_fxaa               = false;
+        post_process_init_info.enable_fused_post_process = init_info.enable_fused_post_process;
         post_process_init_info.color_input_image_view =
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_color_output_image];
         post_process_init_info.bright_color_input_image_view =
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_bright_color_output_image];
         m_post_process_pass->initialize(&post_process_init_info);
 
-        ToneMappingPassInitInfo tone_mapping_init_info;
-        tone_mapping_init_info.render_pass = _post_process_pass->getRenderPass();
-        tone_mapping_init_info.color_attachment =
-            _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_color_output_image];
-        tone_mapping_init_info.bright_color_attachment =
-            _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_bright_color_output_image];
-        m_tone_mapping_pass->initialize(&tone_mapping_init_info);
+        if (init_info.enable_fused_post_process)
+        {
+            UberPostProcessPassInitInfo uber_post_process_init_info;
+            uber_post_process_init_info.render_pass = _post_process_pass->getRenderPass();
+            uber_post_process_init_info.color_attachment =
+                _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_color_output_image];
+            uber_post_process_init_info.bright_color_attachment =
+                _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_bright_color_output_image];
+            m_uber_post_process_pass->initialize(&uber_post_process_init_info);
+        }
+        else
+        {
+            ToneMappingPassInitInfo tone_mapping_init_info;
+            tone_mapping_init_info.render_pass = _post_process_pass->getRenderPass();
+            tone_mapping_init_info.color_attachment =
+                _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_color_output_image];
+            tone_mapping_init_info.bright_color_attachment =
+                _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_bright_color_output_image];
+            m_tone_mapping_pass->initialize(&tone_mapping_init_info);
+
+            ColorGradingPassInitInfo color_grading_init_info;
+            color_grading_init_info.render_pass = _post_process_pass->getRenderPass();
+            color_grading_init_info.input_attachment =
+                _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_odd];
+            m_color_grading_pass->initialize(&color_grading_init_info);
+
+            VignettePassInitInfo vignette_init_info;
+            vignette_init_info.render_pass = _post_process_pass->getRenderPass();
+            vignette_init_info.input_attachment =
+                _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_extra];
+            m_vignette_pass->initialize(&vignette_init_info);
+
+            RemapPassInitInfo remap_init_info;
+            remap_init_info.render_pass = _post_process_pass->getRenderPass();
+            remap_init_info.input_attachment =
+                _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_ultra];
+            m_remap_pass->initialize(&remap_init_info);
+        }
 
-        ColorGradingPassInitInfo color_grading_init_info;
-        color_grading_init_info.render_pass = _post_process_pass->getRenderPass();
-        color_grading_init_info.input_attachment =
-            _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_odd];
-        m_color_grading_pass->initialize(&color_grading_init_info);
-        
+        // in the fused render pass fxaa reads the uber pass output and the later subpasses move up
         FXAAPassInitInfo fxaa_init_info;
         fxaa_init_info.render_pass = _post_process_pass->getRenderPass();
         fxaa_init_info.input_attachment =
-            _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_even];
+            _post_process_pass->getFramebufferImageViews()[init_info.enable_fused_post_process ?
+                                                               _post_process_pass_backup_buffer_extra :
+                                                               _post_process_pass_backup_buffer_even];
+        fxaa_init_info.subpass = init_info.enable_fused_post_process ?
+                                     static_cast<uint32_t>(_post_process_fused_subpass_fxaa) :
+                                     static_cast<uint32_t>(_post_process_subpass_fxaa);
         m_fxaa_pass->initialize(&fxaa_init_info);
-        
-        VignettePassInitInfo vignette_init_info;
-        vignette_init_info.render_pass = _post_process_pass->getRenderPass();
-        vignette_init_info.input_attachment =
-            _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_extra];
-        m_vignette_pass->initialize(&vignette_init_info);
-
-        RemapPassInitInfo remap_init_info;
-        remap_init_info.render_pass = _post_process_pass->getRenderPass();
-        remap_init_info.input_attachment =
-            _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_ultra];
-        m_remap_pass->initialize(&remap_init_info);
 
         UIPassInitInfo ui_init_info;
         ui_init_info.render_pass = _post_process_pass->getRenderPass();
+        ui_init_info.subpass = init_info.enable_fused_post_process ?
+                                   static_cast<uint32_t>(_post_process_fused_subpass_ui) :
+                                   static_cast<uint32_t>(_post_process_subpass_ui);
         m_ui_pass->initialize(&ui_init_info);
 
         CombineUIPassInitInfo combine_ui_init_info;
@@ -192,6 +245,9 @@ namespace Piccolo
             _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_odd];
         combine_ui_init_info.ui_input_attachment =
             _post_process_pass->getFramebufferImageViews()[_post_process_pass_backup_buffer_even];
+        combine_ui_init_info.subpass = init_info.enable_fused_post_process ?
+                                           static_cast<uint32_t>(_post_process_fused_subpass_combine_ui) :
+                                           static_cast<uint32_t>(_post_process_subpass_combine_ui);
         m_combine_ui_pass->initialize(&combine_ui_init_info);
 
         PickPassInitInfo pick_init_info;
@@ -206,6 +262,26 @@ namespace Piccolo
                                                          ->getFramebufferImageViews()[_main_camera_pass_bright_color_output_image];
         m_blur_pass->initialize(&blur_pass_init_info);
 
+        if (init_info.command_recording_thread_pool)
+        {
+            m_command_recorder = std::make_shared<RenderCommandRecorder>();
+            m_command_recorder->initialize(std::static_pointer_cast<VulkanRHI>(m_rhi),
+                                           init_info.command_recording_thread_pool,
+                                           {static_cast<RenderPass*>(m_directional_light_pass.get()),
+                                            static_cast<RenderPass*>(m_pre_depth_pass.get())});
+        }
+
+        m_gpu_profiler = std::make_shared<RenderGPUProfiler>();
+        m_gpu_profiler->initialize(std::static_pointer_cast<VulkanRHI>(m_rhi),
+                                   g_runtime_global_context.m_profiler_system);
+
+        // driven by the frame times of the gpu profiler
+        if (init_info.enable_dynamic_resolution && g_runtime_global_context.m_profiler_system)
+        {
+            m_resolution_scaler = std::make_shared<RenderResolutionScaler>();
+            m_resolution_scaler->initialize(init_info.dynamic_resolution_target_gpu_time_ms,
+                                            init_info.dynamic_resolution_min_scale);
+        }
     }
 
     void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource)
@@ -213,10 +289,10 @@ namespace Piccolo
         VulkanRHI*      vulkan_rhi      = static_cast<VulkanRHI*>(rhi.get());
         RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
 
-        vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
-
         vulkan_rhi->waitForFences();
 
+        vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
+
         vulkan_rhi->resetCommandPool();
 
         bool recreate_swapchain =
@@ -226,10 +302,15 @@ namespace Piccolo
             return;
         }
 
+        // the skinned vertices are shared by all the mesh passes below
+        static_cast<MeshSkinningPass*>(m_mesh_skinning_pass.get())->draw();
+
         static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
 
         static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
 
+        static_cast<LightClusteringPass*>(m_light_clustering_pass.get())->draw();
+
         ColorGradingPass& color_grading_pass = *(static_cast<ColorGradingPass*>(m_color_grading_pass.get()));
         VignettePass&     vignette_pass      = *(static_cast<VignettePass*>(m_vignette_pass.get()));
         RemapPass&        remap_pass         = *(static_cast<RemapPass*>(m_remap_pass.get()));
@@ -251,9 +332,15 @@ namespace Piccolo
                           particle_pass,
                           vulkan_rhi->m_current_swapchain_image_index);
 
+        // the particles are only simulated by the deferred path, which chains the simulation to its graphics submits
+        particle_pass.copyNormalAndDepthImage();
+
+        static_cast<PickPass*>(m_pick_pass.get())->draw();
+
         vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
-        static_cast<ParticlePass*>(m_particle_pass.get())->copyNormalAndDepthImage();
-        static_cast<ParticlePass*>(m_particle_pass.get())->simulate();
+
+        // the forward path always renders at the full resolution
+        vulkan_rhi->m_scene_extent = vulkan_rhi->m_swapchain_extent;
     }
 
     void RenderPipeline::deferredRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource)
@@ -261,10 +348,10 @@ namespace Piccolo
         VulkanRHI*      vulkan_rhi      = static_cast<VulkanRHI*>(rhi.get());
         RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
 
-        vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
-
         vulkan_rhi->waitForFences();
 
+        vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
+
         vulkan_rhi->resetCommandPool();
 
         bool recreate_swapchain =
@@ -284,15 +371,57 @@ namespace Piccolo
             vulkan_rhi->m_command_buffers[vulkan_rhi->m_current_frame_index], &command_buffer_begin_info);
         assert(VK_SUCCESS == res_begin_command_buffer);
 
-        static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
+        PROFILE_SCOPE("RenderPipeline::deferredRender");
 
-        static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
+        m_gpu_profiler->beginFrame();
 
-        static_cast<PreDepthPass*>(m_pre_depth_pass.get())->draw();
+        RenderGPUProfiler* gpu_profiler   = m_gpu_profiler.get();
+        VkCommandBuffer    command_buffer = vulkan_rhi->m_command_buffers[vulkan_rhi->m_current_frame_index];
 
-        static_cast<PCFMaskGenPass*>(m_pcf_mask_gen_pass.get())->draw();
+        {
+            // the skinned vertices are shared by all the mesh passes below
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "MeshSkinningPass");
+            static_cast<MeshSkinningPass*>(m_mesh_skinning_pass.get())->draw();
+        }
 
-        static_cast<PCFMaskBlurPass*>(m_pcf_mask_blur_pass.get())->draw();
+        if (m_command_recorder)
+        {
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "DirectionalLightShadowPass+PreDepthPass");
+            m_command_recorder->record();
+        }
+        else
+        {
+            {
+                RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "DirectionalLightShadowPass");
+                static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
+            }
+            {
+                RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "PreDepthPass");
+                static_cast<PreDepthPass*>(m_pre_depth_pass.get())->draw();
+            }
+        }
+
+        {
+            // one render pass per face, so it can not be recorded into a single secondary command buffer
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "PointLightShadowPass");
+            static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
+        }
+        {
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "PCFMaskGenPass");
+            static_cast<PCFMaskGenPass*>(m_pcf_mask_gen_pass.get())->draw();
+        }
+        {
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "PCFMaskBlurPass");
+            static_cast<PCFMaskBlurPass*>(m_pcf_mask_blur_pass.get())->draw();
+        }
+        {
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "MeshCullingPass");
+            static_cast<MeshCullingPass*>(m_mesh_culling_pass.get())->draw();
+        }
+        {
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "LightClusteringPass");
+            static_cast<LightClusteringPass*>(m_light_clustering_pass.get())->draw();
+        }
 
         ColorGradingPass& color_grading_pass = *(static_cast<ColorGradingPass*>(m_color_grading_pass.get()));
         VignettePass&     vignette_pass      = *(static_cast<VignettePass*>(m_vignette_pass.get()));
@@ -306,33 +435,57 @@ namespace Piccolo
         CombineUIPass&    combine_ui_pass    = *(static_cast<CombineUIPass*>(m_combine_ui_pass.get()));
         ParticlePass&     particle_pass      = *(static_cast<ParticlePass*>(m_particle_pass.get()));
 
+        UberPostProcessPass& uber_post_process_pass =
+            *(static_cast<UberPostProcessPass*>(m_uber_post_process_pass.get()));
+
         static_cast<ParticlePass*>(m_particle_pass.get())
             ->setRenderCommandBufferHandle(
                 static_cast<MainCameraPass*>(m_main_camera_pass.get())->getRenderCommandBuffer());
 
-        static_cast<MainCameraPass*>(m_main_camera_pass.get())
-            ->draw(nbr_pass,
-                   ssao_blur_pass,
-                   ssao_generate_pass,
-                   particle_pass,
-                   vulkan_rhi->m_current_swapchain_image_index);
-        
+        {
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "MainCameraPass");
+            static_cast<MainCameraPass*>(m_main_camera_pass.get())
+                ->draw(nbr_pass,
+                       ssao_blur_pass,
+                       ssao_generate_pass,
+                       particle_pass,
+                       vulkan_rhi->m_current_swapchain_image_index);
+        }
+        {
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "ParticlePass::copyNormalAndDepthImage");
+            particle_pass.copyNormalAndDepthImage();
+        }
+        {
+            RenderGPUProfileScope gpu_scope(gpu_profiler, command_buffer, "PickPass");
+            static_cast<PickPass*>(m_pick_pass.get())->draw();
+        }
+
          // end command buffer
         VkResult res_end_command_buffer_0 = vulkan_rhi->m_vk_end_command_buffer(
             vulkan_rhi->m_command_buffers[vulkan_rhi->m_current_frame_index]);
         assert(VK_SUCCESS == res_end_command_buffer_0);
 
         // first submit & release synchronization amount
-        VkPipelineStageFlags wait_stages_0[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+        // the particles simulated during the previous frame are drawn by this one, and the simulation of this frame
+        // waits for the depth and normal images copied at its end
+        VkSemaphore wait_semaphores_0[2] = {
+            vulkan_rhi->m_image_available_for_render_semaphores[vulkan_rhi->m_current_frame_index],
+            particle_pass.getSimulationFinishedSemaphore()};
+        VkPipelineStageFlags wait_stages_0[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                                VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                                                    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT};
+        VkSemaphore signal_semaphores_0[2] = {
+            vulkan_rhi->m_image_available_for_bloom_blur_semaphores[vulkan_rhi->m_current_frame_index],
+            particle_pass.getDepthAndNormalCopiedSemaphore()};
         VkSubmitInfo         submit_info_0   = {};
         submit_info_0.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info_0.waitSemaphoreCount     = 1;
-        submit_info_0.pWaitSemaphores        = &(vulkan_rhi->m_image_available_for_render_semaphores[vulkan_rhi->m_current_frame_index]);
+        submit_info_0.waitSemaphoreCount     = wait_semaphores_0[1] != VK_NULL_HANDLE ? 2 : 1;
+        submit_info_0.pWaitSemaphores        = wait_semaphores_0;
         submit_info_0.pWaitDstStageMask      = wait_stages_0;
         submit_info_0.commandBufferCount     = 1;
         submit_info_0.pCommandBuffers        = &(vulkan_rhi->m_command_buffers[vulkan_rhi->m_current_frame_index]);
-        submit_info_0.signalSemaphoreCount   = 1;
-        submit_info_0.pSignalSemaphores      = &(vulkan_rhi->m_image_available_for_bloom_blur_semaphores[vulkan_rhi->m_current_frame_index]);
+        submit_info_0.signalSemaphoreCount   = 2;
+        submit_info_0.pSignalSemaphores      = signal_semaphores_0;
         VkResult res_queue_submit_0 = vkQueueSubmit(vulkan_rhi->m_graphics_queue,
                                                     1,
                                                     &submit_info_0, 
@@ -342,28 +495,34 @@ namespace Piccolo
 
         static_cast<BlurPass*>(m_blur_pass.get())->gassBlur();
 
+        // runs on the compute queue alongside the post process of this frame
+        particle_pass.simulate();
+
         VkResult res_begin_post_process_command_buffer = vulkan_rhi->m_vk_begin_command_buffer(
             vulkan_rhi->m_post_process_command_buffers[vulkan_rhi->m_current_frame_index], &command_buffer_begin_info);
         assert(VK_SUCCESS == res_begin_post_process_command_buffer);
 
-        static_cast<PostProcessPass*>(m_post_process_pass.get())
-            ->draw(vignette_pass,
-                   remap_pass,
-                   color_grading_pass,
-                   fxaa_pass,
-                   tone_mapping_pass,
-                   ui_pass,
-                   combine_ui_pass,
-                   vulkan_rhi->m_current_swapchain_image_index);
+        {
+            VkCommandBuffer post_process_command_buffer =
+                vulkan_rhi->m_post_process_command_buffers[vulkan_rhi->m_current_frame_index];
+            RenderGPUProfileScope gpu_scope(gpu_profiler, post_process_command_buffer, "PostProcessPass");
+            static_cast<PostProcessPass*>(m_post_process_pass.get())
+                ->draw(vignette_pass,
+                       remap_pass,
+                       color_grading_pass,
+                       fxaa_pass,
+                       tone_mapping_pass,
+                       uber_post_process_pass,
+                       ui_pass,
+                       combine_ui_pass,
+                       vulkan_rhi->m_current_swapchain_image_index);
+        }
 
         // end command buffer
         VkResult res_end_command_buffer_1 = vulkan_rhi->m_vk_end_command_buffer(
             vulkan_rhi->m_post_process_command_buffers[vulkan_rhi->m_current_frame_index]);
         assert(VK_SUCCESS == res_end_command_buffer_1);
 
-        VkSemaphore semaphores[2] = {
-            vulkan_rhi->m_image_available_for_texturescopy_semaphores[vulkan_rhi->m_current_frame_index],
-            vulkan_rhi->m_image_finished_for_presentation_semaphores[vulkan_rhi->m_current_frame_index]};
         // submit command buffer
         VkPipelineStageFlags wait_stages_1[] = {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT};
         VkSubmitInfo         submit_info_1   = {};
@@ -373,8 +532,8 @@ namespace Piccolo
         submit_info_1.pWaitDstStageMask      = wait_stages_1;
         submit_info_1.commandBufferCount     = 1;
         submit_info_1.pCommandBuffers        = &vulkan_rhi->m_post_process_command_buffers[vulkan_rhi->m_current_frame_index];
-        submit_info_1.signalSemaphoreCount   = 2;
-        submit_info_1.pSignalSemaphores      = semaphores;
+        submit_info_1.signalSemaphoreCount   = 1;
+        submit_info_1.pSignalSemaphores      = &vulkan_rhi->m_image_finished_for_presentation_semaphores[vulkan_rhi->m_current_frame_index];
 
         VkResult res_reset_fences = vulkan_rhi->m_vk_reset_fences(
             vulkan_rhi->m_device, 1, &vulkan_rhi->m_is_frame_in_flight_fences[vulkan_rhi->m_current_frame_index]);
@@ -387,8 +546,16 @@ namespace Piccolo
         assert(VK_SUCCESS == res_queue_submit);
 
         vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
-        static_cast<ParticlePass*>(m_particle_pass.get())->copyNormalAndDepthImage();
-        static_cast<ParticlePass*>(m_particle_pass.get())->simulate();
+
+        // the scene extent of the next frame, before its per-frame buffers are updated. the targets keep the
+        // swapchain size, only their top left is rendered and the post process upscales it
+        if (m_resolution_scaler)
+        {
+            m_resolution_scaler->update(m_gpu_profiler->getLastFrameSerial(),
+                                        m_gpu_profiler->getLastFrameTimeMs(),
+                                        g_runtime_global_context.m_profiler_system->getFrameSerial());
+            vulkan_rhi->m_scene_extent = m_resolution_scaler->getScaledExtent(vulkan_rhi->m_swapchain_extent);
+        }
     }
 
     void RenderPipeline::passUpdateAfterRecreateSwapchain()
@@ -406,33 +573,55 @@ namespace Piccolo
         PickPass&         pick_pass          = *(static_cast<PickPass*>(m_pick_pass.get()));
         ParticlePass&     particle_pass      = *(static_cast<ParticlePass*>(m_particle_pass.get()));
 
+        UberPostProcessPass& uber_post_process_pass =
+            *(static_cast<UberPostProcessPass*>(m_uber_post_process_pass.get()));
+
         main_camera_pass.updateAfterFramebufferRecreate();
         ssao_generate_pass.updateAfterFramebufferRecreate(
             main_camera_pass.getFramebufferImageViews()[_main_camera_pass_gbuffer_a]);
         ssao_blur_pass.updateAfterFramebufferRecreate(
             main_camera_pass.getFramebufferImageViews()[_main_camera_pass_backup_buffer_odd],
             main_camera_pass.getFramebufferImageViews()[_main_camera_pass_backup_buffer_even]);
-        tone_mapping_pass.updateAfterFramebufferRecreate(
-            main_camera_pass.getFramebufferImageViews()[_main_camera_pass_color_output_image],
-            main_camera_pass.getFramebufferImageViews()[_main_camera_pass_bright_color_output_image]);
-        color_grading_pass.updateAfterFramebufferRecreate(
-            post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_odd]);
+        const bool enable_fused_post_process =
+            static_cast<PostProcessPass*>(m_post_process_pass.get())->m_enable_fused_post_process;
+        if (enable_fused_post_process)
+        {
+            uber_post_process_pass.updateAfterFramebufferRecreate(
+                main_camera_pass.getFramebufferImageViews()[_main_camera_pass_color_output_image],
+                main_camera_pass.getFramebufferImageViews()[_main_camera_pass_bright_color_output_image]);
+        }
+        else
+        {
+            tone_mapping_pass.updateAfterFramebufferRecreate(
+                main_camera_pass.getFramebufferImageViews()[_main_camera_pass_color_output_image],
+                main_camera_pass.getFramebufferImageViews()[_main_camera_pass_bright_color_output_image]);
+            color_grading_pass.updateAfterFramebufferRecreate(
+                post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_odd]);
+            vignette_pass.updateAfterFramebufferRecreate(
+                post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_extra]);
+            remap_pass.updateAfterFramebufferRecreate(
+                post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_ultra]);
+        }
         fxaa_pass.updateAfterFramebufferRecreate(
-            post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_even]);
-        vignette_pass.updateAfterFramebufferRecreate(
-            post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_extra]);
-        remap_pass.updateAfterFramebufferRecreate(
-            post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_ultra]);
+            post_process_pass.getFramebufferImageViews()[enable_fused_post_process ?
+                                                             _post_process_pass_backup_buffer_extra :
+                                                             _post_process_pass_backup_buffer_even]);
         combine_ui_pass.updateAfterFramebufferRecreate(
             post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_odd],
             post_process_pass.getFramebufferImageViews()[_post_process_pass_backup_buffer_even]);
         pick_pass.recreateFramebuffer();
         particle_pass.updateAfterFramebufferRecreate();
     }
-    uint32_t RenderPipeline::getGuidOfPickedMesh(const Vector2& picked_uv)
+    void RenderPipeline::requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback)
+    {
+        PickPass& pick_pass = *(static_cast<PickPass*>(m_pick_pass.get()));
+        pick_pass.requestPick(picked_uv, std::move(callback));
+    }
+
+    void RenderPipeline::resolvePendingPicks()
     {
         PickPass& pick_pass = *(static_cast<PickPass*>(m_pick_pass.get()));
-        return pick_pass.pick(picked_uv);
+        pick_pass.resolvePendingPicks();
     }
 
     void RenderPipeline::setAxisVisibleState(bool state)
@@ -4,6 +4,10 @@
 
 namespace Piccolo
 {
+    class RenderCommandRecorder;
+    class RenderGPUProfiler;
+    class RenderResolutionScaler;
+
     class RenderPipeline : public RenderPipelineBase
     {
     public:
@@ -17,10 +21,17 @@ namespace Piccolo
 
         void passUpdateAfterRecreateSwapchain();
 
-        virtual uint32_t getGuidOfPickedMesh(const Vector2& picked_uv) override final;
+        virtual void requestGuidOfPickedMesh(const Vector2&                picked_uv,
+                                             std::function<void(uint32_t)> callback) override final;
+        virtual void resolvePendingPicks() override final;
 
         void setAxisVisibleState(bool state);
 
         void setSelectedAxis(size_t selected_axis);
+
+    private:
+        std::shared_ptr<RenderCommandRecorder>  m_command_recorder;
+        std::shared_ptr<RenderGPUProfiler>      m_gpu_profiler;
+        std::shared_ptr<RenderResolutionScaler> m_resolution_scaler;
     };
 } // namespace Piccolo
@@ -14,12 +14,15 @@ namespace Piccolo
         m_ssao_blur_pass->preparePassData(render_resource);
         m_vignette_pass->preparePassData(render_resource);
         m_color_grading_pass->preparePassData(render_resource);
+        m_uber_post_process_pass->preparePassData(render_resource);
         m_blur_pass->preparePassData(render_resource);
         m_point_light_shadow_pass->preparePassData(render_resource);
         m_particle_pass->preparePassData(render_resource);
         m_pre_depth_pass->preparePassData(render_resource);
         m_pcf_mask_gen_pass->preparePassData(render_resource);
         m_nbr_pass->preparePassData(render_resource);
+        m_mesh_culling_pass->preparePassData(render_resource);
+        m_light_clustering_pass->preparePassData(render_resource);
     }
     void RenderPipelineBase::forwardRender(std::shared_ptr<RHI>                rhi,
                                            std::shared_ptr<RenderResourceBase> render_resource)
@@ -3,6 +3,7 @@
 #include "runtime/core/math/vector2.h"
 #include "runtime/function/render/render_pass_base.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -10,12 +11,22 @@ namespace Piccolo
 {
     class RHI;
     class RenderResourceBase;
+    class ThreadPool;
     class WindowUI;
 
     struct RenderPipelineInitInfo
     {
         bool                                enable_fxaa {false};
+        bool                                enable_gpu_driven_culling {false};
+        bool                                enable_compute_skinning {false};
+        bool                                enable_fused_post_process {false};
+        // scales the resolution of the 3d passes to keep the gpu time of the deferred frames under the target
+        bool                                enable_dynamic_resolution {false};
+        float                               dynamic_resolution_target_gpu_time_ms {14.0f};
+        float                               dynamic_resolution_min_scale {0.5f};
         std::shared_ptr<RenderResourceBase> render_resource;
+        // when set, the shadow and pre-depth passes are recorded in parallel on its workers
+        std::shared_ptr<ThreadPool> command_recording_thread_pool;
     };
 
     class RenderPipelineBase
@@ -31,8 +42,9 @@ namespace Piccolo
         virtual void forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource);
         virtual void deferredRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource);
 
-        void             initializeUIRenderBackend(WindowUI* window_ui);
-        virtual uint32_t getGuidOfPickedMesh(const Vector2& picked_uv) = 0;
+        void         initializeUIRenderBackend(WindowUI* window_ui);
+        virtual void requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback) = 0;
+        virtual void resolvePendingPicks()                                                                     = 0;
 
     protected:
         std::shared_ptr<RHI> m_rhi;
@@ -48,6 +60,7 @@ namespace Piccolo
         std::shared_ptr<RenderPassBase> m_remap_pass;
         std::shared_ptr<RenderPassBase> m_fxaa_pass;
         std::shared_ptr<RenderPassBase> m_tone_mapping_pass;
+        std::shared_ptr<RenderPassBase> m_uber_post_process_pass;
         std::shared_ptr<RenderPassBase> m_ui_pass;
         std::shared_ptr<RenderPassBase> m_combine_ui_pass;
         std::shared_ptr<RenderPassBase> m_pick_pass;
@@ -57,6 +70,9 @@ namespace Piccolo
         std::shared_ptr<RenderPassBase> m_pcf_mask_gen_pass;
         std::shared_ptr<RenderPassBase> m_pcf_mask_blur_pass;
         std::shared_ptr<RenderPassBase> m_nbr_pass;
+        std::shared_ptr<RenderPassBase> m_mesh_culling_pass;
+        std::shared_ptr<RenderPassBase> m_mesh_skinning_pass;
+        std::shared_ptr<RenderPassBase> m_light_clustering_pass;
 
     };
 } // namespace Piccolo
@@ -0,0 +1,67 @@
+#include "runtime/function/render/render_resolution_scaler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Piccolo
+{
+    void RenderResolutionScaler::initialize(float target_frame_time_ms, float min_scale)
+    {
+        m_target_frame_time_ms = std::max(target_frame_time_ms, 0.1f);
+        m_min_scale            = std::clamp(min_scale, s_scale_step, 1.0f);
+        m_scale                = 1.0f;
+    }
+
+    void RenderResolutionScaler::update(uint64_t frame_serial, float frame_time_ms, uint64_t current_frame_serial)
+    {
+        // no new frame was read back, or it was rendered before the last change of the scale
+        if (frame_serial == m_last_frame_serial || frame_serial <= m_scale_frame_serial)
+        {
+            return;
+        }
+        m_last_frame_serial = frame_serial;
+
+        if (m_sample_count == 0)
+        {
+            m_average_frame_time_ms = frame_time_ms;
+        }
+        else
+        {
+            m_average_frame_time_ms += (frame_time_ms - m_average_frame_time_ms) * s_frame_time_smoothing;
+        }
+        if (++m_sample_count < s_min_sample_count)
+        {
+            return;
+        }
+
+        const bool over_budget = m_average_frame_time_ms > m_target_frame_time_ms;
+        if (!over_budget && m_average_frame_time_ms >= m_target_frame_time_ms * s_scale_up_headroom)
+        {
+            return;
+        }
+
+        const float ideal_scale =
+            m_scale * std::sqrt(m_target_frame_time_ms / std::max(m_average_frame_time_ms, 0.01f));
+
+        float scale = m_scale + (ideal_scale - m_scale) * s_scale_damping;
+        scale       = std::round(scale / s_scale_step) * s_scale_step;
+        scale       = over_budget ? std::min(scale, m_scale - s_scale_step) : std::max(scale, m_scale + s_scale_step);
+        scale       = std::clamp(scale, m_min_scale, 1.0f);
+        if (std::abs(scale - m_scale) < 0.5f * s_scale_step)
+        {
+            return;
+        }
+
+        m_scale              = scale;
+        m_sample_count       = 0;
+        m_scale_frame_serial = current_frame_serial;
+    }
+
+    VkExtent2D RenderResolutionScaler::getScaledExtent(VkExtent2D extent) const
+    {
+        VkExtent2D scaled_extent;
+        scaled_extent.width  = std::max(1u, static_cast<uint32_t>(extent.width * m_scale + 0.5f));
+        scaled_extent.height = std::max(1u, static_cast<uint32_t>(extent.height * m_scale + 0.5f));
+        return scaled_extent;
+    }
+} // namespace Piccolo
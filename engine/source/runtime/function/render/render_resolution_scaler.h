@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+namespace Piccolo
+{
+    // keeps the gpu time of a frame under a budget by scaling the resolution the 3d passes render at. the gpu time
+    // goes about with the pixel count, so the scale moves by the square root of the budget over the measured time
+    class RenderResolutionScaler
+    {
+    public:
+        void initialize(float target_frame_time_ms, float min_scale);
+
+        // feeds the gpu time of a frame read back by the profiler. current_frame_serial is the frame just recorded,
+        // a new scale is used from the next one on and the times of the frames before it are skipped
+        void update(uint64_t frame_serial, float frame_time_ms, uint64_t current_frame_serial);
+
+        float      getScale() const { return m_scale; }
+        VkExtent2D getScaledExtent(VkExtent2D extent) const;
+
+    private:
+        // the weight of a new frame time in the moving average
+        static constexpr float s_frame_time_smoothing {0.1f};
+        // the frames averaged at a scale before it is changed again
+        static constexpr uint32_t s_min_sample_count {8};
+        // the scales are multiples of the step, so a jittering time does not change the size every few frames
+        static constexpr float s_scale_step {0.05f};
+        // the scale only goes up once the time is this far under the budget, so it does not oscillate
+        static constexpr float s_scale_up_headroom {0.85f};
+        // the share of the way to the ideal scale taken at once, the costs which do not scale with the pixel count
+        // make the square root overshoot
+        static constexpr float s_scale_damping {0.5f};
+
+        float    m_target_frame_time_ms {14.0f};
+        float    m_min_scale {0.5f};
+        float    m_scale {1.0f};
+        float    m_average_frame_time_ms {0.0f};
+        uint32_t m_sample_count {0};
+        uint64_t m_last_frame_serial {0};
+        uint64_t m_scale_frame_serial {0};
+    };
+} // namespace Piccolo
@@ -10,6 +10,8 @@
 
 #include "runtime/core/base/macro.h"
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 namespace Piccolo
@@ -142,8 +144,11 @@ namespace Piccolo
                                               std::shared_ptr<RenderCamera> camera)
     {
         VulkanRHI* raw_rhi = static_cast<VulkanRHI*>(rhi.get());
-        uint32_t window_width = raw_rhi->m_swapchain_extent.width;
-        uint32_t window_height = raw_rhi->m_swapchain_extent.height;
+        // the pixels the 3d passes render, the top left of the swapchain sized targets
+        uint32_t window_width   = raw_rhi->m_scene_extent.width;
+        uint32_t window_height  = raw_rhi->m_scene_extent.height;
+        float    render_scale_x = static_cast<float>(window_width) / raw_rhi->m_swapchain_extent.width;
+        float    render_scale_y = static_cast<float>(window_height) / raw_rhi->m_swapchain_extent.height;
 
         Matrix4x4 view_matrix = camera->getViewMatrix();
         Matrix4x4 proj_matrix = camera->getPersProjMatrix();
@@ -153,7 +158,9 @@ namespace Piccolo
 
         // ambient light
         Vector3  ambient_light   = render_scene->m_ambient_light.m_irradiance;
-        uint32_t point_light_num = static_cast<uint32_t>(render_scene->m_point_light_list.m_lights.size());
+        uint32_t clustered_point_light_num = std::min(
+            static_cast<uint32_t>(render_scene->m_point_light_list.m_lights.size()), s_max_clustered_point_light_count);
+        uint32_t point_light_num = std::min(clustered_point_light_num, s_max_point_light_count);
 
         // set ubo data
         m_particle_collision_perframe_storage_buffer_object.view_matrix      = view_matrix;
@@ -164,6 +171,8 @@ namespace Piccolo
         m_mesh_perframe_storage_buffer_object.camera_position = camera_position;
         m_mesh_perframe_storage_buffer_object.ambient_light = ambient_light;
         m_mesh_perframe_storage_buffer_object.point_light_num = point_light_num;
+        m_mesh_perframe_storage_buffer_object.render_scale_x = render_scale_x;
+        m_mesh_perframe_storage_buffer_object.render_scale_y = render_scale_y;
 
 
         m_mesh_point_light_shadow_perframe_storage_buffer_object.point_light_num = point_light_num;
@@ -184,6 +193,33 @@ namespace Piccolo
                 Vector4(point_light_position, radius);
         }
 
+        // every point light is culled into the clusters, the first ones also cast shadows
+        VulkanLightClusteringGrid& light_clustering_grid = m_light_clustering_perframe_storage_buffer_object.grid;
+        for (uint32_t i = 0; i < clustered_point_light_num; i++)
+        {
+            const PointLight& point_light = render_scene->m_point_light_list.m_lights[i];
+
+            VulkanScenePointLight& clustered_point_light =
+                m_light_clustering_perframe_storage_buffer_object.point_lights[i];
+            clustered_point_light.position  = point_light.m_position;
+            clustered_point_light.radius    = point_light.calculateRadius();
+            clustered_point_light.intensity = point_light.m_flux / (4.0f * Math_PI);
+        }
+
+        // the camera keeps its near and far planes swapped
+        float z_near = std::min(camera->m_znear, camera->m_zfar);
+        float z_far  = std::max(camera->m_znear, camera->m_zfar);
+
+        light_clustering_grid.view_matrix          = view_matrix;
+        light_clustering_grid.viewport             = Vector4(0.0f, 0.0f, window_width, window_height);
+        light_clustering_grid.inverse_proj_scale_x = 1.0f / proj_matrix[0][0];
+        light_clustering_grid.inverse_proj_scale_y = 1.0f / proj_matrix[1][1];
+        light_clustering_grid.z_near               = z_near;
+        light_clustering_grid.z_far                = z_far;
+        light_clustering_grid.slice_scale          = s_light_cluster_count_z / std::log(z_far / z_near);
+        light_clustering_grid.slice_bias           = -std::log(z_near) * light_clustering_grid.slice_scale;
+        light_clustering_grid.point_light_num      = clustered_point_light_num;
+
         // directional light
         m_mesh_perframe_storage_buffer_object.scene_directional_light.direction =
             render_scene->m_directional_light.m_direction.normalisedCopy();
@@ -196,6 +232,8 @@ namespace Piccolo
         m_nbr_mesh_perframe_storage_buffer_object.scene_directional_light.direction =
             render_scene->m_directional_light.m_direction.normalisedCopy();
         m_nbr_mesh_perframe_storage_buffer_object.scene_directional_light.color = render_scene->m_directional_light.m_color;
+        m_nbr_mesh_perframe_storage_buffer_object.render_scale_x = render_scale_x;
+        m_nbr_mesh_perframe_storage_buffer_object.render_scale_y = render_scale_y;
 
         m_nbr_outline_mesh_perframe_storage_buffer_object.proj_view_matrix = proj_view_matrix;
         m_nbr_outline_mesh_perframe_storage_buffer_object.proj_matrix = proj_matrix;
@@ -537,33 +575,33 @@ namespace Piccolo
                     MeshPerNBRMaterialUniformBufferObject& nbr_material_uniform_buffer_info =
                         (*static_cast<MeshPerNBRMaterialUniformBufferObject*>(staging_buffer_data));
 
-                    nbr_material_uniform_buffer_info._area                              = entity.m_area;
-                    nbr_material_uniform_buffer_info._front_face_tint_color             = entity.m_front_face_tint_color;
-                    nbr_material_uniform_buffer_info._alpha                             = entity.m_alpha;
-                    nbr_material_uniform_buffer_info._back_face_tint_color              = entity.m_back_face_tint_color;
-                    nbr_material_uniform_buffer_info._alpha_clip                        = entity.m_alpha_clip;
-                    nbr_material_uniform_buffer_info._indirect_light_usage              = entity.m_indirect_light_usage;
-                    nbr_material_uniform_buffer_info._indirect_light_mix_base_color     = entity.m_indirect_light_mix_base_color;
-                    nbr_material_uniform_buffer_info._indirect_light_occlusion_usage    = entity.m_indirect_light_occlusion_usage;
-                    nbr_material_uniform_buffer_info._main_light_color_usage            = entity.m_main_light_color_usage;
-                    nbr_material_uniform_buffer_info._shadow_threshold_center           = entity.m_shadow_threshold_center;
-                    nbr_material_uniform_buffer_info._shadow_threshold_softness         = entity.m_shadow_threshold_softness;
-                    nbr_material_uniform_buffer_info._shadow_ramp_offset                = entity.m_shadow_ramp_offset;
-                    nbr_material_uniform_buffer_info._face_shadow_offset                = entity.m_face_shadow_offset;
-                    nbr_material_uniform_buffer_info._face_shadow_transition_softness   = entity.m_face_shadow_transition_softness;
-                    nbr_material_uniform_buffer_info._specular_exponent                 = entity.m_specular_exponent;
-                    nbr_material_uniform_buffer_info._specular_Ks_non_metal             = entity.m_specular_Ks_non_metal;
-                    nbr_material_uniform_buffer_info._specular_Ks_metal                 = entity.m_specular_Ks_metal;
-                    nbr_material_uniform_buffer_info._specular_brightness               = entity.m_specular_brightness;
-                    nbr_material_uniform_buffer_info._rim_light_width                   = entity.m_rim_light_width;
-                    nbr_material_uniform_buffer_info._rim_light_threshold               = entity.m_rim_light_threshold;
-                    nbr_material_uniform_buffer_info._rim_light_fadeout                 = entity.m_rim_light_fadeout;
-                    nbr_material_uniform_buffer_info._rim_light_brightness              = entity.m_rim_light_brightness;
-                    nbr_material_uniform_buffer_info._rim_light_tint_color              = entity.m_rim_light_tint_color;
-                    nbr_material_uniform_buffer_info._rim_light_mix_albedo              = entity.m_rim_light_mix_albedo;
-                    nbr_material_uniform_buffer_info._emission_tint_color               = entity.m_emission_tint_color;
-                    nbr_material_uniform_buffer_info._emission_mix_base_color           = entity.m_emission_mix_base_color;
-                    nbr_material_uniform_buffer_info._emission_intensity                = entity.m_emission_intensity;
+                    nbr_material_uniform_buffer_info._area                              = entity.m_material_parameters.m_area;
+                    nbr_material_uniform_buffer_info._front_face_tint_color             = entity.m_material_parameters.m_front_face_tint_color;
+                    nbr_material_uniform_buffer_info._alpha                             = entity.m_material_parameters.m_alpha;
+                    nbr_material_uniform_buffer_info._back_face_tint_color              = entity.m_material_parameters.m_back_face_tint_color;
+                    nbr_material_uniform_buffer_info._alpha_clip                        = entity.m_material_parameters.m_alpha_clip;
+                    nbr_material_uniform_buffer_info._indirect_light_usage              = entity.m_material_parameters.m_indirect_light_usage;
+                    nbr_material_uniform_buffer_info._indirect_light_mix_base_color     = entity.m_material_parameters.m_indirect_light_mix_base_color;
+                    nbr_material_uniform_buffer_info._indirect_light_occlusion_usage    = entity.m_material_parameters.m_indirect_light_occlusion_usage;
+                    nbr_material_uniform_buffer_info._main_light_color_usage            = entity.m_material_parameters.m_main_light_color_usage;
+                    nbr_material_uniform_buffer_info._shadow_threshold_center           = entity.m_material_parameters.m_shadow_threshold_center;
+                    nbr_material_uniform_buffer_info._shadow_threshold_softness         = entity.m_material_parameters.m_shadow_threshold_softness;
+                    nbr_material_uniform_buffer_info._shadow_ramp_offset                = entity.m_material_parameters.m_shadow_ramp_offset;
+                    nbr_material_uniform_buffer_info._face_shadow_offset                = entity.m_material_parameters.m_face_shadow_offset;
+                    nbr_material_uniform_buffer_info._face_shadow_transition_softness   = entity.m_material_parameters.m_face_shadow_transition_softness;
+                    nbr_material_uniform_buffer_info._specular_exponent                 = entity.m_material_parameters.m_specular_exponent;
+                    nbr_material_uniform_buffer_info._specular_Ks_non_metal             = entity.m_material_parameters.m_specular_Ks_non_metal;
+                    nbr_material_uniform_buffer_info._specular_Ks_metal                 = entity.m_material_parameters.m_specular_Ks_metal;
+                    nbr_material_uniform_buffer_info._specular_brightness               = entity.m_material_parameters.m_specular_brightness;
+                    nbr_material_uniform_buffer_info._rim_light_width                   = entity.m_material_parameters.m_rim_light_width;
+                    nbr_material_uniform_buffer_info._rim_light_threshold               = entity.m_material_parameters.m_rim_light_threshold;
+                    nbr_material_uniform_buffer_info._rim_light_fadeout                 = entity.m_material_parameters.m_rim_light_fadeout;
+                    nbr_material_uniform_buffer_info._rim_light_brightness              = entity.m_material_parameters.m_rim_light_brightness;
+                    nbr_material_uniform_buffer_info._rim_light_tint_color              = entity.m_material_parameters.m_rim_light_tint_color;
+                    nbr_material_uniform_buffer_info._rim_light_mix_albedo              = entity.m_material_parameters.m_rim_light_mix_albedo;
+                    nbr_material_uniform_buffer_info._emission_tint_color               = entity.m_material_parameters.m_emission_tint_color;
+                    nbr_material_uniform_buffer_info._emission_mix_base_color           = entity.m_material_parameters.m_emission_mix_base_color;
+                    nbr_material_uniform_buffer_info._emission_intensity                = entity.m_material_parameters.m_emission_intensity;
 
                     vkUnmapMemory(vulkan_context->m_device, inefficient_staging_buffer_memory);
 
@@ -826,14 +864,14 @@ namespace Piccolo
 
                     MeshPerMaterialUniformBufferObject& material_uniform_buffer_info =
                         (*static_cast<MeshPerMaterialUniformBufferObject*>(staging_buffer_data));
-                    material_uniform_buffer_info.is_blend          = entity.m_blend;
-                    material_uniform_buffer_info.is_double_sided   = entity.m_double_sided;
-                    material_uniform_buffer_info.baseColorFactor   = entity.m_base_color_factor;
-                    material_uniform_buffer_info.metallicFactor    = entity.m_metallic_factor;
-                    material_uniform_buffer_info.roughnessFactor   = entity.m_roughness_factor;
-                    material_uniform_buffer_info.normalScale       = entity.m_normal_scale;
-                    material_uniform_buffer_info.occlusionStrength = entity.m_occlusion_strength;
-                    material_uniform_buffer_info.emissiveFactor    = entity.m_emissive_factor;
+                    material_uniform_buffer_info.is_blend          = entity.m_material_parameters.m_blend;
+                    material_uniform_buffer_info.is_double_sided   = entity.m_material_parameters.m_double_sided;
+                    material_uniform_buffer_info.baseColorFactor   = entity.m_material_parameters.m_base_color_factor;
+                    material_uniform_buffer_info.metallicFactor    = entity.m_material_parameters.m_metallic_factor;
+                    material_uniform_buffer_info.roughnessFactor   = entity.m_material_parameters.m_roughness_factor;
+                    material_uniform_buffer_info.normalScale       = entity.m_material_parameters.m_normal_scale;
+                    material_uniform_buffer_info.occlusionStrength = entity.m_material_parameters.m_occlusion_strength;
+                    material_uniform_buffer_info.emissiveFactor    = entity.m_material_parameters.m_emissive_factor;
 
                     vkUnmapMemory(vulkan_context->m_device, inefficient_staging_buffer_memory);
 
@@ -1149,7 +1187,9 @@ namespace Piccolo
             VmaAllocationCreateInfo allocInfo = {};
             allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
 
-            bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            // the positions, normals and tangents are read by the mesh skinning pass too
+            bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                               VK_BUFFER_USAGE_TRANSFER_DST_BIT;
             bufferInfo.size  = vertex_position_buffer_size;
             vmaCreateBuffer(vulkan_context->m_assets_allocator,
                             &bufferInfo,
@@ -1610,9 +1650,19 @@ namespace Piccolo
                                       texture_data.face_map_image_format);
     }
 
-    VulkanMesh& RenderResource::getEntityMesh(RenderEntity entity)
+    VulkanMesh& RenderResource::getEntityMesh(const RenderEntity& entity)
     {
-        size_t assetid = entity.m_mesh_asset_id;
+        return getVulkanMesh(entity.m_mesh_asset_id);
+    }
+
+    VulkanMaterial& RenderResource::getEntityMaterial(const RenderEntity& entity)
+    {
+        return getVulkanMaterial(entity.m_material_asset_id, entity.m_is_NBR_material);
+    }
+
+    VulkanMesh& RenderResource::getVulkanMesh(size_t mesh_asset_id)
+    {
+        size_t assetid = mesh_asset_id;
 
         auto it = m_vulkan_meshes.find(assetid);
         if (it != m_vulkan_meshes.end())
@@ -1625,10 +1675,10 @@ namespace Piccolo
         }
     }
 
-    VulkanMaterial& RenderResource::getEntityMaterial(RenderEntity entity)
+    VulkanMaterial& RenderResource::getVulkanMaterial(size_t material_asset_id, bool is_NBR_material)
     {
-        size_t assetid = entity.m_material_asset_id;
-        if (entity.m_is_NBR_material)
+        size_t assetid = material_asset_id;
+        if (is_NBR_material)
         {
             auto it = m_vulkan_nbr_materials.find(assetid);
             if (it != m_vulkan_nbr_materials.end())
@@ -1656,8 +1706,7 @@ namespace Piccolo
 
     void RenderResource::resetRingBufferOffset(uint8_t current_frame_index)
     {
-        m_global_render_resource._storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
-            m_global_render_resource._storage_buffer._global_upload_ringbuffers_begin[current_frame_index];
+        m_global_render_resource._storage_buffer._global_upload_allocator.beginFrame(current_frame_index);
     }
 
     void RenderResource::createAndMapStorageBuffer(std::shared_ptr<RHI> rhi)
@@ -1688,17 +1737,6 @@ namespace Piccolo
                                  _storage_buffer._global_upload_ringbuffer,
                                  _storage_buffer._global_upload_ringbuffer_memory);
 
-        _storage_buffer._global_upload_ringbuffers_begin.resize(frames_in_flight);
-        _storage_buffer._global_upload_ringbuffers_end.resize(frames_in_flight);
-        _storage_buffer._global_upload_ringbuffers_size.resize(frames_in_flight);
-        for (uint32_t i = 0; i < frames_in_flight; ++i)
-        {
-            _storage_buffer._global_upload_ringbuffers_begin[i] = (global_storage_buffer_size * i) / frames_in_flight;
-            _storage_buffer._global_upload_ringbuffers_size[i] =
-                (global_storage_buffer_size * (i + 1)) / frames_in_flight -
-                (global_storage_buffer_size * i) / frames_in_flight;
-        }
-
         // axis
         VulkanUtil::createBuffer(raw_rhi->m_physical_device,
                                  raw_rhi->m_device,
@@ -1725,6 +1763,18 @@ namespace Piccolo
                     0,
                     &_storage_buffer._global_upload_ringbuffer_memory_pointer);
 
+        // the frames in flight share the whole ring buffer, a frame which runs out of space waits for older ones
+        _storage_buffer._global_upload_allocator.initialize(
+            _storage_buffer._global_upload_ringbuffer_memory_pointer,
+            global_storage_buffer_size,
+            _storage_buffer._min_storage_buffer_offset_alignment,
+            frames_in_flight,
+            [raw_rhi](uint32_t frame_index) {
+                VkResult res_wait_for_fences = raw_rhi->m_vk_wait_for_fences(
+                    raw_rhi->m_device, 1, &raw_rhi->m_is_frame_in_flight_fences[frame_index], VK_TRUE, UINT64_MAX);
+                assert(VK_SUCCESS == res_wait_for_fences);
+            });
+
         vkMapMemory(raw_rhi->m_device,
                     _storage_buffer._axis_inefficient_storage_buffer_memory,
                     0,
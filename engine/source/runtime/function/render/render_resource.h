@@ -5,6 +5,7 @@
 #include "runtime/function/render/rhi.h"
 
 #include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_upload_allocator.h"
 
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
@@ -88,9 +89,7 @@ namespace Piccolo
         VkBuffer              _global_upload_ringbuffer;
         VkDeviceMemory        _global_upload_ringbuffer_memory;
         void*                 _global_upload_ringbuffer_memory_pointer;
-        std::vector<uint32_t> _global_upload_ringbuffers_begin;
-        std::vector<uint32_t> _global_upload_ringbuffers_end;
-        std::vector<uint32_t> _global_upload_ringbuffers_size;
+        RenderUploadAllocator _global_upload_allocator;
 
         VkBuffer       _global_null_descriptor_storage_buffer;
         VkDeviceMemory _global_null_descriptor_storage_buffer_memory;
@@ -132,9 +131,13 @@ namespace Piccolo
                                           std::shared_ptr<RenderScene>  render_scene,
                                           std::shared_ptr<RenderCamera> camera) override final;
 
-        VulkanMesh& getEntityMesh(RenderEntity entity);
+        VulkanMesh& getEntityMesh(const RenderEntity& entity);
 
-        VulkanMaterial& getEntityMaterial(RenderEntity entity);
+        VulkanMaterial& getEntityMaterial(const RenderEntity& entity);
+
+        VulkanMesh& getVulkanMesh(size_t mesh_asset_id);
+
+        VulkanMaterial& getVulkanMaterial(size_t material_asset_id, bool is_NBR_material);
 
         void resetRingBufferOffset(uint8_t current_frame_index);
 
@@ -149,13 +152,12 @@ namespace Piccolo
         NBRMeshPerframeStorageBufferObject              m_nbr_mesh_perframe_storage_buffer_object;
         NBROutlineMeshPerframeStorageBufferObject       m_nbr_outline_mesh_perframe_storage_buffer_object;
         MeshPointLightShadowPerframeStorageBufferObject m_mesh_point_light_shadow_perframe_storage_buffer_object;
-        MeshDirectionalLightShadowPerframeStorageBufferObject
-                                                       m_mesh_directional_light_shadow_perframe_storage_buffer_object;
         SSAOGeneratePerframeStorageBufferObject        m_ssao_generate_perframe_storage_buffer_object;
         AxisStorageBufferObject                        m_axis_storage_buffer_object;
         MeshInefficientPickPerframeStorageBufferObject m_mesh_inefficient_pick_perframe_storage_buffer_object;
         ParticleBillboardPerframeStorageBufferObject   m_particlebillboard_perframe_storage_buffer_object;
         ParticleCollisionPerframeStorageBufferObject   m_particle_collision_perframe_storage_buffer_object;
+        LightClusteringPerframeStorageBufferObject     m_light_clustering_perframe_storage_buffer_object;
 
         // cached mesh and material
         std::map<size_t, VulkanMesh>        m_vulkan_meshes;
@@ -7,6 +7,9 @@
 #include "runtime/resource/res_type/data/mesh_data.h"
 
 #include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_cooked_mesh.h"
+#include "runtime/function/render/render_cooked_texture.h"
+#include "runtime/function/render/render_mesh_optimizer.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -15,11 +18,33 @@
 #include "tiny_obj_loader.h"
 
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace Piccolo
 {
+    // vertices are welded when all their attributes match, the tangent is accumulated afterwards
+    // so only its handedness is part of the key
+    struct StaticMeshVertexKey
+    {
+        MeshVertexDataDefinition m_vertex {};
+        uint32_t                 m_tangent_flipped {0};
+
+        bool operator==(const StaticMeshVertexKey& rhs) const { return memcmp(this, &rhs, sizeof(*this)) == 0; }
+    };
+
+    struct StaticMeshVertexKeyHash
+    {
+        size_t operator()(const StaticMeshVertexKey& key) const
+        {
+            return std::hash<std::string_view> {}(
+                std::string_view(reinterpret_cast<const char*>(&key), sizeof(StaticMeshVertexKey)));
+        }
+    };
+
     std::shared_ptr<TextureData> RenderResourceBase::loadTextureHDR(std::string file, int desired_channels)
     {
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
@@ -82,6 +107,46 @@ namespace Piccolo
         return texture;
     }
 
+    std::shared_ptr<TextureData> RenderResourceBase::loadCompressedTexture(std::string          file,
+                                                                           PICCOLO_PIXEL_FORMAT compressed_format)
+    {
+        bool is_srgb = compressed_format == PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_SRGB;
+        if (!m_enable_texture_compression || file.empty())
+        {
+            return loadTexture(file, is_srgb);
+        }
+
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+        ASSERT(asset_manager);
+
+        std::filesystem::path texture_path        = asset_manager->getFullPath(file);
+        std::filesystem::path cooked_texture_path = getCookedTexturePath(texture_path.generic_string(), compressed_format);
+
+        std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
+        if (loadCookedTexture(cooked_texture_path, texture_path, compressed_format, *texture))
+        {
+            return texture;
+        }
+
+        std::shared_ptr<TextureData> source_texture = loadTexture(file, is_srgb);
+        if (!source_texture)
+        {
+            return nullptr;
+        }
+
+        texture = cookTexture(*source_texture, compressed_format);
+        if (!texture)
+        {
+            return source_texture;
+        }
+
+        if (!saveCookedTexture(cooked_texture_path, texture_path, *texture))
+        {
+            LOG_WARN("failed to save cooked texture {}", cooked_texture_path.generic_string());
+        }
+        return texture;
+    }
+
     RenderMeshData RenderResourceBase::loadMeshData(const MeshSourceDesc& source, AxisAlignedBox& bounding_box, bool use_vertex_color)
     {
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
@@ -89,6 +154,15 @@ namespace Piccolo
 
         RenderMeshData ret;
 
+        // the cooked mesh is used as long as it is newer than the source mesh
+        std::filesystem::path cooked_mesh_path = getCookedMeshPath(source.m_mesh_file, use_vertex_color);
+        if (loadCookedMesh(cooked_mesh_path, source.m_mesh_file, use_vertex_color, ret, bounding_box))
+        {
+            std::lock_guard<std::mutex> lock(m_bounding_box_cache_mutex);
+            m_bounding_box_cache_map.insert(std::make_pair(source, bounding_box));
+            return ret;
+        }
+
         if (std::filesystem::path(source.m_mesh_file).extension() == ".obj")
         {
             ret.m_static_mesh_data = loadStaticMesh(source.m_mesh_file, bounding_box, use_vertex_color);
@@ -147,7 +221,16 @@ namespace Piccolo
             }
         }
 
-        m_bounding_box_cache_map.insert(std::make_pair(source, bounding_box));
+        if (ret.m_static_mesh_data.m_vertex_buffer &&
+            !saveCookedMesh(cooked_mesh_path, source.m_mesh_file, use_vertex_color, ret, bounding_box))
+        {
+            LOG_WARN("failed to write cooked mesh {} for {}", cooked_mesh_path.generic_string(), source.m_mesh_file);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_bounding_box_cache_mutex);
+            m_bounding_box_cache_map.insert(std::make_pair(source, bounding_box));
+        }
 
         return ret;
     }
@@ -155,20 +238,32 @@ namespace Piccolo
     RenderMaterialData RenderResourceBase::loadMaterialData(const MaterialSourceDesc& source)
     {
         RenderMaterialData ret;
-        ret.m_base_color_texture         = loadTexture(source.m_base_color_file, true);
-        ret.m_metallic_roughness_texture = loadTexture(source.m_metallic_roughness_file);
-        ret.m_normal_texture             = loadTexture(source.m_normal_file);
-        ret.m_occlusion_texture          = loadTexture(source.m_occlusion_file);
-        ret.m_emissive_texture           = loadTexture(source.m_emissive_file);
-        ret.m_light_map_texture          = loadTexture(source.m_light_map_texture_file);
-        ret.m_ramp_warm_texture          = loadTexture(source.m_ramp_warm_texture_file,true);
-        ret.m_ramp_cool_texture          = loadTexture(source.m_ramp_cool_texture_file,true);
-        ret.m_face_map_texture           = loadTexture(source.m_face_map_texture_file);
+        ret.m_base_color_texture =
+            loadCompressedTexture(source.m_base_color_file, PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_SRGB);
+        ret.m_metallic_roughness_texture =
+            loadCompressedTexture(source.m_metallic_roughness_file, PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_UNORM);
+        // the shaders rebuild z from the two channels
+        ret.m_normal_texture =
+            loadCompressedTexture(source.m_normal_file, PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC5_UNORM);
+        ret.m_occlusion_texture =
+            loadCompressedTexture(source.m_occlusion_file, PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC4_UNORM);
+        ret.m_emissive_texture =
+            loadCompressedTexture(source.m_emissive_file, PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_UNORM);
+        // all four channels of the light map and the face map are used
+        ret.m_light_map_texture = loadCompressedTexture(source.m_light_map_texture_file,
+                                                        PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_UNORM);
+        // ramps are a few texels high and sampled with the nearest sampler, blocks would bleed between the rows
+        ret.m_ramp_warm_texture = loadTexture(source.m_ramp_warm_texture_file, true);
+        ret.m_ramp_cool_texture = loadTexture(source.m_ramp_cool_texture_file, true);
+        ret.m_face_map_texture  = loadCompressedTexture(source.m_face_map_texture_file,
+                                                       PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_UNORM);
         return ret;
     }
 
     AxisAlignedBox RenderResourceBase::getCachedBoudingBox(const MeshSourceDesc& source) const
     {
+        std::lock_guard<std::mutex> lock(m_bounding_box_cache_mutex);
+
         auto find_it = m_bounding_box_cache_map.find(source);
         if (find_it != m_bounding_box_cache_map.end())
         {
@@ -203,6 +298,10 @@ namespace Piccolo
 
 
         std::vector<MeshVertexDataDefinition> mesh_vertices;
+        std::vector<Vector3>                  mesh_tangents;
+        std::vector<uint32_t>                 mesh_indices;
+
+        std::unordered_map<StaticMeshVertexKey, uint32_t, StaticMeshVertexKeyHash> welded_vertex_map;
 
         for (size_t s = 0; s < shapes.size(); s++)
         {
@@ -225,7 +324,6 @@ namespace Piccolo
                     continue;
                 }
 
-                // expanding vertex data is not efficient and is for testing purposes only
                 for (size_t v = 0; v < fv; v++)
                 {
                     auto idx = shapes[s].mesh.indices[index_offset + v];
@@ -305,6 +403,7 @@ namespace Piccolo
                 }
 
                 Vector3 tangent {1, 0, 0};
+                bool    tangent_flipped = false;
                 {
                     Vector3 edge1    = vertex[1] - vertex[0];
                     Vector3 edge2    = vertex[2] - vertex[1];
@@ -317,6 +416,8 @@ namespace Piccolo
                     else if (divide < 0.0f && divide > -0.000001f)
                         divide = -0.000001f;
 
+                    tangent_flipped = divide < 0.0f;
+
                     float df  = 1.0f / divide;
                     tangent.x = df * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
                     tangent.y = df * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
@@ -326,7 +427,8 @@ namespace Piccolo
 
                 for (size_t i = 0; i < 3; i++)
                 {
-                    MeshVertexDataDefinition mesh_vert {};
+                    StaticMeshVertexKey       vertex_key;
+                    MeshVertexDataDefinition& mesh_vert = vertex_key.m_vertex;
 
                     mesh_vert.x = vertex[i].x;
                     mesh_vert.y = vertex[i].y;
@@ -339,34 +441,62 @@ namespace Piccolo
                     mesh_vert.u = uv[i].x;
                     mesh_vert.v = uv[i].y;
 
-                    mesh_vert.tx = tangent.x;
-                    mesh_vert.ty = tangent.y;
-                    mesh_vert.tz = tangent.z;
-                    
                     mesh_vert.cx = color[i].x;
                     mesh_vert.cy = color[i].y;
                     mesh_vert.cz = color[i].z;
 
+                    vertex_key.m_tangent_flipped = tangent_flipped ? 1 : 0;
 
-                    mesh_vertices.push_back(mesh_vert);
+                    auto insert_result =
+                        welded_vertex_map.try_emplace(vertex_key, static_cast<uint32_t>(mesh_vertices.size()));
+                    if (insert_result.second)
+                    {
+                        mesh_vertices.push_back(mesh_vert);
+                        mesh_tangents.push_back(Vector3::ZERO);
+                    }
+
+                    uint32_t vertex_index = insert_result.first->second;
+                    mesh_tangents[vertex_index] += tangent;
+                    mesh_indices.push_back(vertex_index);
                 }
             }
         }
 
+        // the tangent of a welded vertex is the average of the face tangents around it
+        for (size_t i = 0; i < mesh_vertices.size(); i++)
+        {
+            Vector3 tangent = mesh_tangents[i];
+            tangent         = tangent.squaredLength() > 0.000001f ? tangent.normalisedCopy() : Vector3(1, 0, 0);
+
+            mesh_vertices[i].tx = tangent.x;
+            mesh_vertices[i].ty = tangent.y;
+            mesh_vertices[i].tz = tangent.z;
+        }
+
+        size_t expanded_vertex_count = mesh_indices.size();
+        float  acmr_before = calculateACMR(mesh_indices, mesh_vertices.size(), s_mesh_optimizer_vertex_cache_size);
+
+        optimizeVertexCache(mesh_indices, mesh_vertices.size());
+        optimizeVertexFetch(mesh_vertices, mesh_indices);
+
+        float acmr_after = calculateACMR(mesh_indices, mesh_vertices.size(), s_mesh_optimizer_vertex_cache_size);
+        LOG_INFO("loadMesh {}: {} vertices welded to {}, acmr {:.3f} -> {:.3f}",
+                 filename,
+                 expanded_vertex_count,
+                 mesh_vertices.size(),
+                 acmr_before,
+                 acmr_after);
+
         uint32_t stride           = sizeof(MeshVertexDataDefinition);
         mesh_data.m_vertex_buffer = std::make_shared<BufferData>(mesh_vertices.size() * stride);
-        mesh_data.m_index_buffer  = std::make_shared<BufferData>(mesh_vertices.size() * sizeof(uint32_t));
+        mesh_data.m_index_buffer  = std::make_shared<BufferData>(mesh_indices.size() * sizeof(uint32_t));
 
         assert(mesh_vertices.size() <= std::numeric_limits<uint32_t>::max()); // take care of the index range, should be
                                                                               // consistent with the index range used by
                                                                               // vulkan
 
-        uint32_t* indices = (uint32_t*)mesh_data.m_index_buffer->m_data;
-        for (size_t i = 0; i < mesh_vertices.size(); i++)
-        {
-            ((MeshVertexDataDefinition*)(mesh_data.m_vertex_buffer->m_data))[i] = mesh_vertices[i];
-            indices[i]                                                          = static_cast<uint32_t>(i);
-        }
+        memcpy(mesh_data.m_vertex_buffer->m_data, mesh_vertices.data(), mesh_vertices.size() * stride);
+        memcpy(mesh_data.m_index_buffer->m_data, mesh_indices.data(), mesh_indices.size() * sizeof(uint32_t));
 
         return mesh_data;
     }
@@ -5,6 +5,7 @@
 #include "runtime/function/render/render_type.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -39,15 +40,23 @@ namespace Piccolo
                                           std::shared_ptr<RenderCamera> camera) = 0;
 
         // TODO: data caching
+        // the load functions only read from disk and may be called from the asset loading threads
         std::shared_ptr<TextureData> loadTextureHDR(std::string file, int desired_channels = 4);
         std::shared_ptr<TextureData> loadTexture(std::string file, bool is_srgb = false);
+        // block compressed with a precomputed mip chain, cooked on the first load.
+        // falls back to loadTexture when texture compression is disabled
+        std::shared_ptr<TextureData> loadCompressedTexture(std::string file, PICCOLO_PIXEL_FORMAT compressed_format);
         RenderMeshData               loadMeshData(const MeshSourceDesc& source, AxisAlignedBox& bounding_box, bool use_vertex_color = false);
         RenderMaterialData           loadMaterialData(const MaterialSourceDesc& source);
         AxisAlignedBox               getCachedBoudingBox(const MeshSourceDesc& source) const;
 
+        // set before any load, the device must support the block compressed formats
+        bool m_enable_texture_compression {false};
+
     private:
         StaticMeshData loadStaticMesh(std::string mesh_file, AxisAlignedBox& bounding_box, bool use_vertex_color = false);
 
         std::unordered_map<MeshSourceDesc, AxisAlignedBox> m_bounding_box_cache_map;
+        mutable std::mutex                                 m_bounding_box_cache_mutex;
     };
 } // namespace Piccolo
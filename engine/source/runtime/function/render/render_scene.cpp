@@ -1,26 +1,212 @@
 #include "runtime/function/render/render_scene.h"
+
+#include "runtime/core/base/macro.h"
+
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_pass.h"
 #include "runtime/function/render/render_resource.h"
 
+#include <algorithm>
+
 namespace Piccolo
 {
     void RenderScene::updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
                                            std::shared_ptr<RenderCamera>   camera)
     {
-        updateVisibleObjectsDirectionalLight(render_resource, camera);
-        updateVisibleObjectsPointLight(render_resource);
-        updateVisibleObjectsMainCamera(render_resource, camera);
+        PROFILE_SCOPE("RenderScene::updateVisibleObjects");
+
+        bool render_entities_changed = m_render_entities_bvh_dirty || !m_render_entities_to_refit.empty();
+        updateRenderEntitiesBVH();
+
+        if (m_enable_gpu_driven_culling && render_entities_changed)
+        {
+            updateGPUDrivenObjects(render_resource);
+        }
+
+        // decides which cascades and point light shadow faces are culled and rendered this frame
+        updateDirectionalLightCascades(render_resource, camera);
+        updatePointLightShadowFaces();
+
+        if (m_culling_thread_pool)
+        {
+            updateVisibleObjectsParallel(render_resource, camera);
+        }
+        else
+        {
+            updateVisibleObjectsDirectionalLight(render_resource);
+            updateVisibleObjectsPointLight(render_resource);
+            updateVisibleObjectsMainCamera(render_resource, camera);
+        }
+
+        if (m_enable_compute_skinning)
+        {
+            updateSkinnedObjects();
+        }
+
+        // shadow views are sorted by the distance to the camera too, depth only orders the instances of a batch
+        for (uint32_t cascade_index = 0; cascade_index < m_directional_light_cascade_count; ++cascade_index)
+        {
+            if (m_directional_light_cascade_render_mask & (1U << cascade_index))
+            {
+                m_directional_light_cascade_draw_lists[cascade_index].build(
+                    m_directional_light_cascade_visible_mesh_nodes[cascade_index], camera->position());
+            }
+        }
+        for (uint32_t face_index = 0; face_index < s_max_point_light_shadow_face_count; ++face_index)
+        {
+            uint32_t face_bit = 1U << face_index;
+            if (!(m_point_light_shadow_face_render_mask & face_bit))
+            {
+                continue;
+            }
+
+            // a face with skinned casters is rendered again every frame, they move without changing their bounds
+            const std::vector<RenderMeshNode>& visible_mesh_nodes =
+                m_point_light_shadow_face_visible_mesh_nodes[face_index];
+            m_point_light_shadow_face_skinned_caster_mask &= ~face_bit;
+            for (const RenderMeshNode& node : visible_mesh_nodes)
+            {
+                if (node.enable_vertex_blending)
+                {
+                    m_point_light_shadow_face_skinned_caster_mask |= face_bit;
+                    break;
+                }
+            }
+
+            m_point_light_shadow_face_draw_lists[face_index].build(visible_mesh_nodes, camera->position());
+        }
+        m_main_camera_draw_list.build(m_main_camera_visible_mesh_nodes, camera->position());
+
         updateVisibleObjectsAxis(render_resource);
         updateVisibleObjectsParticle(render_resource);
     }
 
     void RenderScene::setVisibleNodesReference()
     {
-        RenderPass::m_visiable_nodes.p_directional_light_visible_mesh_nodes = &m_directional_light_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_point_lights_visible_mesh_nodes      = &m_point_lights_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_main_camera_visible_mesh_nodes       = &m_main_camera_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_axis_node                            = &m_axis_node;
+        RenderPass::m_visiable_nodes.p_directional_light_cascade_draw_lists = m_directional_light_cascade_draw_lists;
+        RenderPass::m_visiable_nodes.p_directional_light_cascade_render_mask =
+            &m_directional_light_cascade_render_mask;
+        RenderPass::m_visiable_nodes.p_directional_light_cached_cascade_valid_mask =
+            &m_directional_light_cached_cascade_valid_mask;
+        RenderPass::m_visiable_nodes.p_point_light_shadow_face_draw_lists = m_point_light_shadow_face_draw_lists;
+        RenderPass::m_visiable_nodes.p_point_light_shadow_face_render_mask = &m_point_light_shadow_face_render_mask;
+        RenderPass::m_visiable_nodes.p_point_light_shadow_face_valid_mask  = &m_point_light_shadow_face_valid_mask;
+        RenderPass::m_visiable_nodes.p_main_camera_draw_list = &m_main_camera_draw_list;
+        RenderPass::m_visiable_nodes.p_gpu_driven_draw_list  = &m_gpu_driven_draw_list;
+        RenderPass::m_visiable_nodes.p_skinned_mesh_nodes    = &m_skinned_mesh_nodes;
+        RenderPass::m_visiable_nodes.p_axis_node             = &m_axis_node;
+    }
+
+    void RenderScene::setCullingThreadPool(std::shared_ptr<ThreadPool> thread_pool)
+    {
+        m_culling_thread_pool = thread_pool;
+    }
+
+    void RenderScene::setGPUDrivenCullingEnabled(bool enable)
+    {
+        m_enable_gpu_driven_culling = enable;
+        m_gpu_driven_draw_list.clear();
+        m_render_entities_bvh_dirty = true;
+    }
+
+    void RenderScene::setDirectionalLightCascades(uint32_t cascade_count,
+                                                  float    split_lambda,
+                                                  uint32_t first_cached_cascade)
+    {
+        m_directional_light_cascade_count = std::clamp(cascade_count, 1U, s_max_directional_light_cascade_count);
+        m_directional_light_cascade_split_lambda      = std::clamp(split_lambda, 0.0f, 1.0f);
+        m_directional_light_first_cached_cascade      = first_cached_cascade;
+        m_directional_light_cached_cascade_valid_mask = 0;
+    }
+
+    void RenderScene::setComputeSkinningEnabled(bool enable)
+    {
+        m_enable_compute_skinning = enable;
+        m_skinned_mesh_nodes.clear();
+    }
+
+    bool RenderScene::hasRenderEntity(uint32_t instance_id) const
+    {
+        size_t entity_index;
+        return m_render_entity_store.findEntity(instance_id, entity_index);
+    }
+
+    void RenderScene::addRenderEntity(const RenderEntity& entity)
+    {
+        size_t entity_index = m_render_entity_store.addEntity(entity);
+        m_render_entities_bvh_dirty = true;
+
+        addEntityChangedBoundingBox(entity_index, m_render_entity_store.getWorldBoundingBoxes()[entity_index]);
+    }
+
+    void RenderScene::updateRenderEntity(const RenderEntity& entity)
+    {
+        size_t entity_index;
+        if (m_render_entity_store.findEntity(entity.m_instance_id, entity_index))
+        {
+            addEntityChangedBoundingBox(entity_index, m_render_entity_store.getWorldBoundingBoxes()[entity_index]);
+            m_render_entity_store.updateEntity(entity_index, entity);
+            m_render_entities_to_refit.push_back(entity_index);
+            addEntityChangedBoundingBox(entity_index, m_render_entity_store.getWorldBoundingBoxes()[entity_index]);
+        }
+    }
+
+    void RenderScene::updateRenderEntityTransform(uint32_t                      instance_id,
+                                                  const Matrix4x4&              model_matrix,
+                                                  const std::vector<Matrix4x4>& joint_matrices)
+    {
+        size_t entity_index;
+        if (m_render_entity_store.findEntity(instance_id, entity_index))
+        {
+            BoundingBox previous_bounding_box = m_render_entity_store.getWorldBoundingBoxes()[entity_index];
+            m_render_entity_store.updateEntityTransform(entity_index, model_matrix, joint_matrices);
+            m_render_entities_to_refit.push_back(entity_index);
+
+            // the transform updates do not always move the entity
+            const BoundingBox& bounding_box = m_render_entity_store.getWorldBoundingBoxes()[entity_index];
+            if (bounding_box.min_bound != previous_bounding_box.min_bound ||
+                bounding_box.max_bound != previous_bounding_box.max_bound)
+            {
+                addEntityChangedBoundingBox(entity_index, previous_bounding_box);
+                addEntityChangedBoundingBox(entity_index, bounding_box);
+            }
+        }
+    }
+
+    BoundingBox RenderScene::getRenderEntitiesBoundingBox() const { return m_render_entities_bvh.getBounds(); }
+
+    void RenderScene::updateRenderEntitiesBVH()
+    {
+        const std::vector<BoundingBox>& world_bounding_boxes = m_render_entity_store.getWorldBoundingBoxes();
+        if (m_render_entities_bvh_dirty)
+        {
+            m_render_entities_bvh.build(world_bounding_boxes);
+            m_render_entities_bvh_dirty = false;
+        }
+        else
+        {
+            for (size_t entity_index : m_render_entities_to_refit)
+            {
+                m_render_entities_bvh.refit(entity_index, world_bounding_boxes[entity_index]);
+            }
+        }
+        m_render_entities_to_refit.clear();
+    }
+
+    void RenderScene::addEntityChangedBoundingBox(size_t entity_index, const BoundingBox& bounding_box)
+    {
+        m_entities_changed_bounding_boxes.push_back(bounding_box);
+
+        // the skinned entities never cast shadows into the cached cascades
+        if (!m_render_entity_store.getHandles()[entity_index].m_enable_vertex_blending)
+        {
+            m_static_entities_changed_bounding_boxes.push_back(bounding_box);
+        }
+    }
+
+    bool RenderScene::isDirectionalLightCascadeCached(uint32_t cascade_index) const
+    {
+        return cascade_index >= m_directional_light_first_cached_cascade;
     }
 
     GuidAllocator<GameObjectPartId>& RenderScene::getInstanceIdAllocator() { return m_instance_id_allocator; }
@@ -34,7 +220,10 @@ namespace Piccolo
 
     void RenderScene::addInstanceIdToMap(uint32_t instance_id, GObjectID go_id)
     {
-        m_mesh_object_id_map[instance_id] = go_id;
+        if (m_mesh_object_id_map.try_emplace(instance_id, go_id).second)
+        {
+            m_object_instance_ids_map[go_id].push_back(instance_id);
+        }
     }
 
     GObjectID RenderScene::getGObjectIDByMeshID(uint32_t mesh_id) const
@@ -49,97 +238,168 @@ namespace Piccolo
 
     void RenderScene::deleteEntityByGObjectID(GObjectID go_id)
     {
-        for (auto it = m_mesh_object_id_map.begin(); it != m_mesh_object_id_map.end(); it++)
+        auto find_it = m_object_instance_ids_map.find(go_id);
+        if (find_it == m_object_instance_ids_map.end())
         {
-            if (it->second == go_id)
-            {
-                m_mesh_object_id_map.erase(it);
-                break;
-            }
+            return;
         }
 
-        GameObjectPartId part_id = {go_id, 0};
-        size_t           find_guid;
-        if (m_instance_id_allocator.getElementGuid(part_id, find_guid))
+        // remove every part of the object
+        for (uint32_t instance_id : find_it->second)
         {
-            for (auto it = m_render_entities.begin(); it != m_render_entities.end(); it++)
+            m_mesh_object_id_map.erase(instance_id);
+
+            size_t entity_index;
+            if (m_render_entity_store.findEntity(instance_id, entity_index))
             {
-                if (it->m_instance_id == find_guid)
-                {
-                    m_render_entities.erase(it);
-                    break;
-                }
+                addEntityChangedBoundingBox(entity_index, m_render_entity_store.getWorldBoundingBoxes()[entity_index]);
+                m_render_entity_store.removeEntity(entity_index);
+                m_render_entities_bvh_dirty = true;
             }
+
+            m_instance_id_allocator.freeGuid(instance_id);
         }
+
+        m_object_instance_ids_map.erase(find_it);
     }
 
     void RenderScene::clearForLevelReloading()
     {
         m_instance_id_allocator.clear();
         m_mesh_object_id_map.clear();
-        m_render_entities.clear();
+        m_object_instance_ids_map.clear();
+        m_render_entity_store.clear();
+        m_render_entities_bvh.clear();
+        m_render_entities_bvh_dirty = true;
+        m_render_entities_to_refit.clear();
+
+        // the draw lists point into the entity store
+        for (RenderDrawList& draw_list : m_directional_light_cascade_draw_lists)
+        {
+            draw_list.clear();
+        }
+        for (RenderDrawList& draw_list : m_point_light_shadow_face_draw_lists)
+        {
+            draw_list.clear();
+        }
+        m_main_camera_draw_list.clear();
+        m_gpu_driven_draw_list.clear();
+        m_skinned_mesh_nodes.clear();
+
+        m_directional_light_cached_cascade_valid_mask = 0;
+        m_point_light_shadow_face_valid_mask          = 0;
+        m_point_light_shadow_face_skinned_caster_mask = 0;
+        m_entities_changed_bounding_boxes.clear();
+        m_static_entities_changed_bounding_boxes.clear();
     }
 
-    void RenderScene::updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
-                                                           std::shared_ptr<RenderCamera>   camera)
+    void RenderScene::updateDirectionalLightCascades(std::shared_ptr<RenderResource> render_resource,
+                                                     std::shared_ptr<RenderCamera>   camera)
     {
-        Matrix4x4 directional_light_proj_view = CalculateDirectionalLightCamera(*this, *camera);
-
-        render_resource->m_mesh_perframe_storage_buffer_object.directional_light_proj_view =
-            directional_light_proj_view;
-        render_resource->m_mesh_directional_light_shadow_perframe_storage_buffer_object.light_proj_view =
-            directional_light_proj_view;
-
-        m_directional_light_visible_mesh_nodes.clear();
-
-        ClusterFrustum frustum =
-            CreateClusterFrustumFromMatrix(directional_light_proj_view, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
-
-        for (const RenderEntity& entity : m_render_entities)
+        Matrix4x4 cascade_proj_views[s_max_directional_light_cascade_count];
+        CalculateDirectionalLightCascades(*this,
+                                          *camera,
+                                          m_directional_light_cascade_count,
+                                          m_directional_light_cascade_split_lambda,
+                                          m_directional_light_first_cached_cascade,
+                                          cascade_proj_views);
+
+        VulkanDirectionalLightCascades& cascades =
+            render_resource->m_mesh_perframe_storage_buffer_object.directional_light_cascades;
+        uint32_t grid_size     = getDirectionalLightCascadeGridSize(m_directional_light_cascade_count);
+        float    tile_scale    = 1.0f / static_cast<float>(grid_size);
+        cascades.cascade_count = m_directional_light_cascade_count;
+
+        m_directional_light_cascade_render_mask = 0;
+        for (uint32_t cascade_index = 0; cascade_index < m_directional_light_cascade_count; ++cascade_index)
         {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
-
-            if (TiledFrustumIntersectBox(frustum, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
+            float tile_x = static_cast<float>(cascade_index % grid_size) * tile_scale;
+            float tile_y = static_cast<float>(cascade_index / grid_size) * tile_scale;
+
+            cascades.proj_views[cascade_index]          = cascade_proj_views[cascade_index];
+            cascades.atlas_scale_offsets[cascade_index] = Vector4(tile_scale, tile_scale, tile_x, tile_y);
+
+            // a cached cascade keeps its shadows as long as it does not move and no static entity in it changes
+            uint32_t cascade_bit    = 1U << cascade_index;
+            bool     render_cascade = true;
+            if (isDirectionalLightCascadeCached(cascade_index) &&
+                (m_directional_light_cached_cascade_valid_mask & cascade_bit) &&
+                cascade_proj_views[cascade_index] == m_directional_light_cascade_proj_views[cascade_index])
             {
-                m_directional_light_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_directional_light_visible_mesh_nodes.back();
-
-                temp_node.model_matrix = &entity.m_model_matrix;
-
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
+                render_cascade = false;
+                for (const BoundingBox& bounding_box : m_static_entities_changed_bounding_boxes)
                 {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
+                    if (TiledFrustumIntersectBox(m_directional_light_cascade_frustums[cascade_index], bounding_box))
+                    {
+                        render_cascade = true;
+                        break;
+                    }
                 }
-                temp_node.node_id = entity.m_instance_id;
+            }
 
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
+            if (render_cascade)
+            {
+                m_directional_light_cascade_render_mask |= cascade_bit;
+                m_directional_light_cascade_proj_views[cascade_index] = cascade_proj_views[cascade_index];
+                m_directional_light_cascade_frustums[cascade_index]   = CreateClusterFrustumFromMatrix(
+                    cascade_proj_views[cascade_index], -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+            }
+        }
 
-                temp_node.is_NBR_material = entity.m_is_NBR_material;
+        // the cascades to render stay invalid until the shadow pass has recorded them
+        m_directional_light_cached_cascade_valid_mask &= ~m_directional_light_cascade_render_mask;
+        m_static_entities_changed_bounding_boxes.clear();
+    }
 
-                if (entity.m_is_NBR_material)
-                {
-                    VulkanNBRMaterial& material_asset = static_cast<VulkanNBRMaterial&>(render_resource->getEntityMaterial(entity));
-                    temp_node.ref_material_nbr        = &material_asset;
-                    temp_node.nbr_mesh_id      = entity.m_nbr_mesh_id;
-                }
-                else
+    void RenderScene::updatePointLightShadowFaces()
+    {
+        std::vector<BoundingSphere> point_lights_bounding_spheres = getPointLightsBoundingSpheres();
+        uint32_t                    point_light_count = static_cast<uint32_t>(point_lights_bounding_spheres.size());
+
+        uint32_t face_count = std::min(2 * point_light_count, s_max_point_light_shadow_face_count);
+
+        m_point_light_shadow_face_render_mask = 0;
+        for (uint32_t face_index = 0; face_index < face_count; ++face_index)
+        {
+            // a face keeps its shadows as long as its light does not move and no entity in it changes
+            const BoundingSphere& light_bounding_sphere = point_lights_bounding_spheres[face_index / 2];
+            const BoundingSphere& cached_bounding_sphere =
+                m_point_light_shadow_face_light_bounding_spheres[face_index];
+
+            uint32_t face_bit    = 1U << face_index;
+            bool     render_face = true;
+            if ((m_point_light_shadow_face_valid_mask & face_bit) &&
+                !(m_point_light_shadow_face_skinned_caster_mask & face_bit) &&
+                light_bounding_sphere.m_center == cached_bounding_sphere.m_center &&
+                light_bounding_sphere.m_radius == cached_bounding_sphere.m_radius)
+            {
+                render_face = false;
+                for (const BoundingBox& bounding_box : m_entities_changed_bounding_boxes)
                 {
-                    VulkanPBRMaterial& material_asset = static_cast<VulkanPBRMaterial&>(render_resource->getEntityMaterial(entity));
-                    temp_node.ref_material            = &material_asset;
+                    if (PointLightShadowFaceIntersectBox(light_bounding_sphere, face_index, bounding_box))
+                    {
+                        render_face = true;
+                        break;
+                    }
                 }
             }
+
+            if (render_face)
+            {
+                m_point_light_shadow_face_render_mask |= face_bit;
+                m_point_light_shadow_face_light_bounding_spheres[face_index] = light_bounding_sphere;
+            }
         }
+
+        // the faces of the removed lights are rendered again when the lights come back, the faces to render stay
+        // invalid until the shadow pass has recorded them
+        uint32_t face_mask = (1U << face_count) - 1;
+        m_point_light_shadow_face_valid_mask &= ~m_point_light_shadow_face_render_mask & face_mask;
+        m_entities_changed_bounding_boxes.clear();
     }
 
-    void RenderScene::updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource)
+    std::vector<BoundingSphere> RenderScene::getPointLightsBoundingSpheres() const
     {
-        m_point_lights_visible_mesh_nodes.clear();
-
         std::vector<BoundingSphere> point_lights_bounding_spheres;
         uint32_t                    point_light_num = static_cast<uint32_t>(m_point_light_list.m_lights.size());
         point_lights_bounding_spheres.resize(point_light_num);
@@ -148,55 +408,184 @@ namespace Piccolo
             point_lights_bounding_spheres[i].m_center = m_point_light_list.m_lights[i].m_position;
             point_lights_bounding_spheres[i].m_radius = m_point_light_list.m_lights[i].calculateRadius();
         }
+        return point_lights_bounding_spheres;
+    }
+
+    void RenderScene::updateVisibleObjectsParallel(std::shared_ptr<RenderResource> render_resource,
+                                                   std::shared_ptr<RenderCamera>   camera)
+    {
+        static const size_t s_culling_chunk_size = 256;
+
+        std::vector<BoundingSphere> point_lights_bounding_spheres = getPointLightsBoundingSpheres();
+
+        Matrix4x4      proj_view_matrix = camera->getPersProjMatrix() * camera->getViewMatrix();
+        ClusterFrustum main_camera_frustum =
+            CreateClusterFrustumFromMatrix(proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+
+        const std::vector<BoundingBox>&         world_bounding_boxes = m_render_entity_store.getWorldBoundingBoxes();
+        const std::vector<RenderEntityHandles>& handles              = m_render_entity_store.getHandles();
 
-        for (const RenderEntity& entity : m_render_entities)
+        size_t chunk_count = ThreadPool::getChunkCount(m_render_entity_store.size(), s_culling_chunk_size);
+        if (m_culling_chunk_results.size() < chunk_count)
         {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
+            m_culling_chunk_results.resize(chunk_count);
+        }
 
-            bool intersect_with_point_lights = true;
-            for (size_t i = 0; i < point_light_num; i++)
-            {
-                if (!BoxIntersectsWithSphere(BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix),
-                                             point_lights_bounding_spheres[i]))
+        // every chunk tests its entities against all the views, reading only the contiguous world bounds
+        m_culling_thread_pool->parallelFor(
+            m_render_entity_store.size(), s_culling_chunk_size, [&](size_t chunk_index, size_t begin, size_t end) {
+                CullingChunkResult& result = m_culling_chunk_results[chunk_index];
+                for (std::vector<RenderMeshNode>& visible_mesh_nodes :
+                     result.m_directional_light_cascade_visible_mesh_nodes)
                 {
-                    intersect_with_point_lights = false;
-                    break;
+                    visible_mesh_nodes.clear();
                 }
+                for (std::vector<RenderMeshNode>& visible_mesh_nodes :
+                     result.m_point_light_shadow_face_visible_mesh_nodes)
+                {
+                    visible_mesh_nodes.clear();
+                }
+                result.m_main_camera_visible_mesh_nodes.clear();
+
+                for (size_t entity_index = begin; entity_index < end; ++entity_index)
+                {
+                    const BoundingBox& entity_bounding_box = world_bounding_boxes[entity_index];
+
+                    for (uint32_t cascade_index = 0; cascade_index < m_directional_light_cascade_count;
+                         ++cascade_index)
+                    {
+                        if ((m_directional_light_cascade_render_mask & (1U << cascade_index)) &&
+                            !(isDirectionalLightCascadeCached(cascade_index) &&
+                              handles[entity_index].m_enable_vertex_blending) &&
+                            TiledFrustumIntersectBox(m_directional_light_cascade_frustums[cascade_index],
+                                                     entity_bounding_box))
+                        {
+                            addVisibleMeshNode(render_resource,
+                                               entity_index,
+                                               result.m_directional_light_cascade_visible_mesh_nodes[cascade_index]);
+                        }
+                    }
+
+                    for (uint32_t face_index = 0; face_index < s_max_point_light_shadow_face_count; ++face_index)
+                    {
+                        if ((m_point_light_shadow_face_render_mask & (1U << face_index)) &&
+                            PointLightShadowFaceIntersectBox(
+                                point_lights_bounding_spheres[face_index / 2], face_index, entity_bounding_box))
+                        {
+                            addVisibleMeshNode(render_resource,
+                                               entity_index,
+                                               result.m_point_light_shadow_face_visible_mesh_nodes[face_index]);
+                        }
+                    }
+
+                    if (TiledFrustumIntersectBox(main_camera_frustum, entity_bounding_box))
+                    {
+                        addVisibleMeshNode(render_resource, entity_index, result.m_main_camera_visible_mesh_nodes);
+                    }
+                }
+            });
+
+        // merge in chunk order, so the result is in the entity order like the serial path
+        for (std::vector<RenderMeshNode>& visible_mesh_nodes : m_directional_light_cascade_visible_mesh_nodes)
+        {
+            visible_mesh_nodes.clear();
+        }
+        for (std::vector<RenderMeshNode>& visible_mesh_nodes : m_point_light_shadow_face_visible_mesh_nodes)
+        {
+            visible_mesh_nodes.clear();
+        }
+        m_main_camera_visible_mesh_nodes.clear();
+        for (size_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+        {
+            const CullingChunkResult& result = m_culling_chunk_results[chunk_index];
+            for (uint32_t cascade_index = 0; cascade_index < m_directional_light_cascade_count; ++cascade_index)
+            {
+                std::vector<RenderMeshNode>& visible_mesh_nodes =
+                    m_directional_light_cascade_visible_mesh_nodes[cascade_index];
+                visible_mesh_nodes.insert(visible_mesh_nodes.end(),
+                                          result.m_directional_light_cascade_visible_mesh_nodes[cascade_index].begin(),
+                                          result.m_directional_light_cascade_visible_mesh_nodes[cascade_index].end());
             }
+            for (uint32_t face_index = 0; face_index < s_max_point_light_shadow_face_count; ++face_index)
+            {
+                std::vector<RenderMeshNode>& visible_mesh_nodes =
+                    m_point_light_shadow_face_visible_mesh_nodes[face_index];
+                visible_mesh_nodes.insert(visible_mesh_nodes.end(),
+                                          result.m_point_light_shadow_face_visible_mesh_nodes[face_index].begin(),
+                                          result.m_point_light_shadow_face_visible_mesh_nodes[face_index].end());
+            }
+            m_main_camera_visible_mesh_nodes.insert(m_main_camera_visible_mesh_nodes.end(),
+                                                    result.m_main_camera_visible_mesh_nodes.begin(),
+                                                    result.m_main_camera_visible_mesh_nodes.end());
+        }
+    }
 
-            if (intersect_with_point_lights)
+    void RenderScene::updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource)
+    {
+        const std::vector<RenderEntityHandles>& handles = m_render_entity_store.getHandles();
+        for (uint32_t cascade_index = 0; cascade_index < m_directional_light_cascade_count; ++cascade_index)
+        {
+            if (!(m_directional_light_cascade_render_mask & (1U << cascade_index)))
             {
-                m_point_lights_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_point_lights_visible_mesh_nodes.back();
+                continue;
+            }
 
-                temp_node.model_matrix = &entity.m_model_matrix;
+            std::vector<RenderMeshNode>& visible_mesh_nodes =
+                m_directional_light_cascade_visible_mesh_nodes[cascade_index];
+            visible_mesh_nodes.clear();
 
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
+            m_visible_entity_indices.clear();
+            m_render_entities_bvh.queryFrustum(m_directional_light_cascade_frustums[cascade_index],
+                                               m_visible_entity_indices);
+
+            // keep the entity order so that the draw order does not depend on the bvh layout
+            std::sort(m_visible_entity_indices.begin(), m_visible_entity_indices.end());
+            for (size_t entity_index : m_visible_entity_indices)
+            {
+                if (isDirectionalLightCascadeCached(cascade_index) && handles[entity_index].m_enable_vertex_blending)
                 {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
+                    continue;
                 }
-                temp_node.node_id = entity.m_instance_id;
+                addVisibleMeshNode(render_resource, entity_index, visible_mesh_nodes);
+            }
+        }
+    }
 
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
+    void RenderScene::updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource)
+    {
+        std::vector<BoundingSphere> point_lights_bounding_spheres = getPointLightsBoundingSpheres();
+        for (uint32_t face_index = 0; face_index < s_max_point_light_shadow_face_count; face_index += 2)
+        {
+            // the two faces of a light share the query of its bounding sphere
+            uint32_t light_face_mask = (m_point_light_shadow_face_render_mask >> face_index) & 3U;
+            if (light_face_mask == 0)
+            {
+                continue;
+            }
 
-                temp_node.is_NBR_material        = entity.m_is_NBR_material;
-                if (entity.m_is_NBR_material)
-                {
-                    VulkanNBRMaterial& material_asset =
-                        static_cast<VulkanNBRMaterial&>(render_resource->getEntityMaterial(entity));
-                    temp_node.ref_material_nbr = &material_asset;
-                    temp_node.nbr_mesh_id      = entity.m_nbr_mesh_id;
-                }
-                else
+            m_point_light_shadow_face_visible_mesh_nodes[face_index].clear();
+            m_point_light_shadow_face_visible_mesh_nodes[face_index + 1].clear();
+
+            const BoundingSphere& light_bounding_sphere = point_lights_bounding_spheres[face_index / 2];
+
+            m_visible_entity_indices.clear();
+            m_render_entities_bvh.querySpheres({light_bounding_sphere}, m_visible_entity_indices);
+
+            const std::vector<BoundingBox>& world_bounding_boxes = m_render_entity_store.getWorldBoundingBoxes();
+            std::sort(m_visible_entity_indices.begin(), m_visible_entity_indices.end());
+            for (size_t entity_index : m_visible_entity_indices)
+            {
+                for (uint32_t light_face_index = 0; light_face_index < 2; ++light_face_index)
                 {
-                    VulkanPBRMaterial& material_asset =
-                        static_cast<VulkanPBRMaterial&>(render_resource->getEntityMaterial(entity));
-                    temp_node.ref_material = &material_asset;
+                    if ((light_face_mask & (1U << light_face_index)) &&
+                        PointLightShadowFaceIntersectBox(light_bounding_sphere,
+                                                         face_index + light_face_index,
+                                                         world_bounding_boxes[entity_index]))
+                    {
+                        addVisibleMeshNode(render_resource,
+                                           entity_index,
+                                           m_point_light_shadow_face_visible_mesh_nodes[face_index + light_face_index]);
+                    }
                 }
             }
         }
@@ -213,42 +602,122 @@ namespace Piccolo
 
         ClusterFrustum f = CreateClusterFrustumFromMatrix(proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
 
-        for (const RenderEntity& entity : m_render_entities)
+        m_visible_entity_indices.clear();
+        m_render_entities_bvh.queryFrustum(f, m_visible_entity_indices);
+
+        std::sort(m_visible_entity_indices.begin(), m_visible_entity_indices.end());
+        for (size_t entity_index : m_visible_entity_indices)
         {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
+            addVisibleMeshNode(render_resource, entity_index, m_main_camera_visible_mesh_nodes);
+        }
+    }
 
-            if (TiledFrustumIntersectBox(f, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
+    void RenderScene::addVisibleMeshNode(std::shared_ptr<RenderResource> render_resource,
+                                         size_t                          entity_index,
+                                         std::vector<RenderMeshNode>&    visible_mesh_nodes) const
+    {
+        const RenderEntityHandles&    handles        = m_render_entity_store.getHandles()[entity_index];
+        const std::vector<Matrix4x4>& joint_matrices = m_render_entity_store.getJointMatrices()[entity_index];
+
+        visible_mesh_nodes.emplace_back();
+        RenderMeshNode& temp_node    = visible_mesh_nodes.back();
+        temp_node.model_matrix       = &m_render_entity_store.getModelMatrices()[entity_index];
+        temp_node.world_bounding_box = &m_render_entity_store.getWorldBoundingBoxes()[entity_index];
+
+        assert(joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
+        if (!joint_matrices.empty())
+        {
+            temp_node.joint_count    = static_cast<uint32_t>(joint_matrices.size());
+            temp_node.joint_matrices = joint_matrices.data();
+        }
+        temp_node.node_id = m_render_entity_store.getInstanceIds()[entity_index];
+
+        VulkanMesh& mesh_asset           = render_resource->getVulkanMesh(handles.m_mesh_asset_id);
+        temp_node.ref_mesh               = &mesh_asset;
+        temp_node.mesh_asset_id          = handles.m_mesh_asset_id;
+        temp_node.material_asset_id      = handles.m_material_asset_id;
+        temp_node.enable_vertex_blending = handles.m_enable_vertex_blending;
+
+        temp_node.is_NBR_material = handles.m_is_NBR_material;
+        if (handles.m_is_NBR_material)
+        {
+            VulkanNBRMaterial& material_asset = static_cast<VulkanNBRMaterial&>(
+                render_resource->getVulkanMaterial(handles.m_material_asset_id, handles.m_is_NBR_material));
+            temp_node.ref_material_nbr = &material_asset;
+            temp_node.nbr_mesh_id      = handles.m_nbr_mesh_id;
+        }
+        else
+        {
+            VulkanPBRMaterial& material_asset = static_cast<VulkanPBRMaterial&>(
+                render_resource->getVulkanMaterial(handles.m_material_asset_id, handles.m_is_NBR_material));
+            temp_node.ref_material = &material_asset;
+        }
+    }
+
+    void RenderScene::updateGPUDrivenObjects(std::shared_ptr<RenderResource> render_resource)
+    {
+        m_gpu_driven_mesh_nodes.clear();
+
+        const std::vector<RenderEntityHandles>& handles = m_render_entity_store.getHandles();
+        for (size_t entity_index = 0; entity_index < m_render_entity_store.size(); ++entity_index)
+        {
+            // skinned and nbr objects keep going through the cpu culled draw lists
+            if (!handles[entity_index].m_is_NBR_material && !handles[entity_index].m_enable_vertex_blending)
             {
-                m_main_camera_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_main_camera_visible_mesh_nodes.back();
-                temp_node.model_matrix    = &entity.m_model_matrix;
+                addVisibleMeshNode(render_resource, entity_index, m_gpu_driven_mesh_nodes);
+            }
+        }
 
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
-                temp_node.node_id = entity.m_instance_id;
+        // there is no view to sort by, the gpu compacts the visible instances of each batch
+        m_gpu_driven_draw_list.build(m_gpu_driven_mesh_nodes, Vector3::ZERO);
+    }
+
+    void RenderScene::updateSkinnedObjects()
+    {
+        m_skinned_mesh_nodes.clear();
+        m_skinned_vertex_offsets.clear();
 
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
+        static const uint32_t s_max_view_count =
+            s_max_directional_light_cascade_count + s_max_point_light_shadow_face_count + 1;
 
-                temp_node.is_NBR_material = entity.m_is_NBR_material;
-                if (entity.m_is_NBR_material)
+        // an instance visible in several views is skinned once, every view draws the same skinned vertices
+        uint32_t                     skinned_vertex_count = 0;
+        std::vector<RenderMeshNode>* views_visible_mesh_nodes[s_max_view_count];
+        uint32_t                     view_count = 0;
+        for (uint32_t cascade_index = 0; cascade_index < m_directional_light_cascade_count; ++cascade_index)
+        {
+            if (m_directional_light_cascade_render_mask & (1U << cascade_index))
+            {
+                views_visible_mesh_nodes[view_count++] = &m_directional_light_cascade_visible_mesh_nodes[cascade_index];
+            }
+        }
+        for (uint32_t face_index = 0; face_index < s_max_point_light_shadow_face_count; ++face_index)
+        {
+            if (m_point_light_shadow_face_render_mask & (1U << face_index))
+            {
+                views_visible_mesh_nodes[view_count++] = &m_point_light_shadow_face_visible_mesh_nodes[face_index];
+            }
+        }
+        views_visible_mesh_nodes[view_count++] = &m_main_camera_visible_mesh_nodes;
+
+        for (uint32_t view_index = 0; view_index < view_count; ++view_index)
+        {
+            std::vector<RenderMeshNode>* visible_mesh_nodes = views_visible_mesh_nodes[view_index];
+            for (RenderMeshNode& node : *visible_mesh_nodes)
+            {
+                // entities without a pose yet are drawn as static meshes
+                if (!node.joint_matrices || !node.ref_mesh->enable_vertex_blending)
                 {
-                    VulkanNBRMaterial& material_asset =
-                        static_cast<VulkanNBRMaterial&>(render_resource->getEntityMaterial(entity));
-                    temp_node.ref_material_nbr = &material_asset;
-                    temp_node.nbr_mesh_id      = entity.m_nbr_mesh_id;
+                    continue;
                 }
-                else
+
+                // the joint matrices belong to exactly one entity
+                auto result = m_skinned_vertex_offsets.emplace(node.joint_matrices, skinned_vertex_count);
+                node.skinned_vertex_offset = result.first->second;
+                if (result.second)
                 {
-                    VulkanPBRMaterial& material_asset =
-                        static_cast<VulkanPBRMaterial&>(render_resource->getEntityMaterial(entity));
-                    temp_node.ref_material = &material_asset;
+                    m_skinned_mesh_nodes.push_back(node);
+                    skinned_vertex_count += node.ref_mesh->mesh_vertex_count;
                 }
             }
         }
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "runtime/core/base/thread_pool.h"
+
 #include "runtime/function/framework/object/object_id_allocator.h"
 
 #include "runtime/function/render/light.h"
+#include "runtime/function/render/render_bvh.h"
 #include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_entity.h"
+#include "runtime/function/render/render_entity_store.h"
 #include "runtime/function/render/render_guid_allocator.h"
 #include "runtime/function/render/render_object.h"
 
@@ -24,18 +29,38 @@ namespace Piccolo
         PDirectionalLight m_directional_light;
         PointLightList    m_point_light_list;
 
-        // render entities
-        std::vector<RenderEntity> m_render_entities;
+        // render entities, stored as separate arrays of hot and cold data
+        RenderEntityStore m_render_entity_store;
 
         // axis, for editor
         std::optional<RenderEntity> m_render_axis;
 
-        // visible objects (updated per frame)
-        std::vector<RenderMeshNode> m_directional_light_visible_mesh_nodes;
-        std::vector<RenderMeshNode> m_point_lights_visible_mesh_nodes;
+        // visible objects (updated per frame), the cascades and the point light shadow faces only for the ones in
+        // their render masks
+        std::vector<RenderMeshNode>
+            m_directional_light_cascade_visible_mesh_nodes[s_max_directional_light_cascade_count];
+        std::vector<RenderMeshNode> m_point_light_shadow_face_visible_mesh_nodes[s_max_point_light_shadow_face_count];
         std::vector<RenderMeshNode> m_main_camera_visible_mesh_nodes;
         RenderAxisNode              m_axis_node;
 
+        // the visible objects sorted into batches, consumed by the passes
+        RenderDrawList m_directional_light_cascade_draw_lists[s_max_directional_light_cascade_count];
+        RenderDrawList m_point_light_shadow_face_draw_lists[s_max_point_light_shadow_face_count];
+        RenderDrawList m_main_camera_draw_list;
+
+        // the cascades of the directional light to render this frame, the others keep their shadows from before
+        uint32_t m_directional_light_cascade_render_mask {0};
+
+        // the faces of the point light shadows to render this frame, the others keep their shadows from before
+        uint32_t m_point_light_shadow_face_render_mask {0};
+
+        // every static pbr object whatever the view, culled on the gpu by the mesh culling pass.
+        // only rebuilt when the render entities change
+        RenderDrawList m_gpu_driven_draw_list;
+
+        // every skinned instance visible in any view, once, with the skinned_vertex_offset the views refer to
+        std::vector<RenderMeshNode> m_skinned_mesh_nodes;
+
         // update visible objects in each frame
         void updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
                                   std::shared_ptr<RenderCamera>   camera);
@@ -43,6 +68,30 @@ namespace Piccolo
         // set visible nodes ptr in render pass
         void setVisibleNodesReference();
 
+        // cull all the views at once over chunks of the render entities on the thread pool, nullptr to cull serially
+        void setCullingThreadPool(std::shared_ptr<ThreadPool> thread_pool);
+
+        // keep m_gpu_driven_draw_list up to date for the gpu driven base pass
+        void setGPUDrivenCullingEnabled(bool enable);
+
+        // the cascades from the first cached one are only rendered again when they move or a static entity inside of
+        // them changes, and skinned entities do not cast shadows into them
+        void setDirectionalLightCascades(uint32_t cascade_count, float split_lambda, uint32_t first_cached_cascade);
+
+        // gather the visible skinned instances for the mesh skinning pass, the passes then draw them as static meshes
+        void setComputeSkinningEnabled(bool enable);
+
+        // entities must be added, updated and removed through these so that the bvh stays in sync
+        bool hasRenderEntity(uint32_t instance_id) const;
+        void addRenderEntity(const RenderEntity& entity);
+        void updateRenderEntity(const RenderEntity& entity);
+        void updateRenderEntityTransform(uint32_t                      instance_id,
+                                         const Matrix4x4&              model_matrix,
+                                         const std::vector<Matrix4x4>& joint_matrices);
+
+        // world space bounds of all render entities
+        BoundingBox getRenderEntitiesBoundingBox() const;
+
         GuidAllocator<GameObjectPartId>&   getInstanceIdAllocator();
         GuidAllocator<MeshSourceDesc>&     getMeshAssetIdAllocator();
         GuidAllocator<MaterialSourceDesc>& getMaterialAssetdAllocator();
@@ -58,13 +107,69 @@ namespace Piccolo
         GuidAllocator<MeshSourceDesc>     m_mesh_asset_id_allocator;
         GuidAllocator<MaterialSourceDesc> m_material_asset_id_allocator;
 
-        std::unordered_map<uint32_t, GObjectID> m_mesh_object_id_map;
-
-        void updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
-                                                  std::shared_ptr<RenderCamera>   camera);
+        std::unordered_map<uint32_t, GObjectID>              m_mesh_object_id_map;
+        std::unordered_map<GObjectID, std::vector<uint32_t>> m_object_instance_ids_map;
+
+        // bvh over the world space bounds of the render entities, leaf i is the entity i of m_render_entity_store
+        RenderBVH           m_render_entities_bvh;
+        bool                m_render_entities_bvh_dirty {true};
+        std::vector<size_t> m_render_entities_to_refit;
+        std::vector<size_t> m_visible_entity_indices;
+
+        struct CullingChunkResult
+        {
+            std::vector<RenderMeshNode>
+                m_directional_light_cascade_visible_mesh_nodes[s_max_directional_light_cascade_count];
+            std::vector<RenderMeshNode>
+                m_point_light_shadow_face_visible_mesh_nodes[s_max_point_light_shadow_face_count];
+            std::vector<RenderMeshNode> m_main_camera_visible_mesh_nodes;
+        };
+
+        std::shared_ptr<ThreadPool>     m_culling_thread_pool;
+        std::vector<CullingChunkResult> m_culling_chunk_results;
+
+        bool                        m_enable_gpu_driven_culling {false};
+        std::vector<RenderMeshNode> m_gpu_driven_mesh_nodes;
+
+        bool                                           m_enable_compute_skinning {false};
+        std::unordered_map<const Matrix4x4*, uint32_t> m_skinned_vertex_offsets;
+
+        uint32_t       m_directional_light_cascade_count {1};
+        float          m_directional_light_cascade_split_lambda {0.75f};
+        uint32_t       m_directional_light_first_cached_cascade {s_max_directional_light_cascade_count};
+        Matrix4x4      m_directional_light_cascade_proj_views[s_max_directional_light_cascade_count];
+        ClusterFrustum m_directional_light_cascade_frustums[s_max_directional_light_cascade_count];
+        uint32_t       m_directional_light_cached_cascade_valid_mask {0};
+
+        // the light of every face when it was last rendered, and the faces which had skinned casters then
+        BoundingSphere m_point_light_shadow_face_light_bounding_spheres[s_max_point_light_shadow_face_count];
+        uint32_t       m_point_light_shadow_face_valid_mask {0};
+        uint32_t       m_point_light_shadow_face_skinned_caster_mask {0};
+
+        // world space bounds before and after the changes of the entities since the last frame, the static ones
+        // alone for the cached cascades
+        std::vector<BoundingBox> m_entities_changed_bounding_boxes;
+        std::vector<BoundingBox> m_static_entities_changed_bounding_boxes;
+
+        void updateRenderEntitiesBVH();
+        void addEntityChangedBoundingBox(size_t entity_index, const BoundingBox& bounding_box);
+        bool isDirectionalLightCascadeCached(uint32_t cascade_index) const;
+        void updateDirectionalLightCascades(std::shared_ptr<RenderResource> render_resource,
+                                            std::shared_ptr<RenderCamera>   camera);
+        void updatePointLightShadowFaces();
+        std::vector<BoundingSphere> getPointLightsBoundingSpheres() const;
+        void addVisibleMeshNode(std::shared_ptr<RenderResource> render_resource,
+                                size_t                          entity_index,
+                                std::vector<RenderMeshNode>&    visible_mesh_nodes) const;
+
+        void updateVisibleObjectsParallel(std::shared_ptr<RenderResource> render_resource,
+                                          std::shared_ptr<RenderCamera>   camera);
+        void updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource);
         void updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource);
         void updateVisibleObjectsMainCamera(std::shared_ptr<RenderResource> render_resource,
                                             std::shared_ptr<RenderCamera>   camera);
+        void updateGPUDrivenObjects(std::shared_ptr<RenderResource> render_resource);
+        void updateSkinnedObjects();
         void updateVisibleObjectsAxis(std::shared_ptr<RenderResource> render_resource);
         void updateVisibleObjectsParticle(std::shared_ptr<RenderResource> render_resource);
     };
@@ -12,6 +12,11 @@ namespace Piccolo
 
     void GameObjectResourceDesc::pop() { m_game_object_descs.pop_front(); }
 
+    void GameObjectTransformRequest::add(GameObjectPartTransformDesc&& desc)
+    {
+        m_transform_descs.push_back(std::move(desc));
+    }
+
     void ParticleSubmitRequest::add(ParticleEmitterDesc& desc) { m_emitter_descs.push_back(desc); }
 
     unsigned int ParticleSubmitRequest::getEmitterCount() const { return m_emitter_descs.size(); }
@@ -47,6 +52,7 @@ namespace Piccolo
         return !(m_swap_data[m_render_swap_data_index].m_level_resource_desc.has_value() ||
                  m_swap_data[m_render_swap_data_index].m_game_object_resource_desc.has_value() ||
                  m_swap_data[m_render_swap_data_index].m_game_object_to_delete.has_value() ||
+                 m_swap_data[m_render_swap_data_index].m_game_object_transform_request.has_value() ||
                  m_swap_data[m_render_swap_data_index].m_camera_swap_data.has_value() ||
                  m_swap_data[m_render_swap_data_index].m_particle_submit_request.has_value() ||
                  m_swap_data[m_render_swap_data_index].m_emitter_tick_request.has_value() ||
@@ -68,6 +74,11 @@ namespace Piccolo
         m_swap_data[m_render_swap_data_index].m_game_object_to_delete.reset();
     }
 
+    void RenderSwapContext::resetGameObjectTransformSwapData()
+    {
+        m_swap_data[m_render_swap_data_index].m_game_object_transform_request.reset();
+    }
+
     void RenderSwapContext::resetPartilceBatchSwapData()
     {
         m_swap_data[m_render_swap_data_index].m_particle_submit_request.reset();
@@ -90,6 +101,7 @@ namespace Piccolo
         resetLevelRsourceSwapData();
         resetGameObjectResourceSwapData();
         resetGameObjectToDelete();
+        resetGameObjectTransformSwapData();
         resetCameraSwapData();
         resetEmitterTickSwapData();
         resetEmitterTransformSwapData();
@@ -125,6 +137,20 @@ namespace Piccolo
         }
     }
 
+    void RenderSwapData::updateGameObjectTransform(GameObjectPartTransformDesc&& desc)
+    {
+        if (m_game_object_transform_request.has_value())
+        {
+            m_game_object_transform_request->add(std::move(desc));
+        }
+        else
+        {
+            GameObjectTransformRequest request;
+            request.add(std::move(desc));
+            m_game_object_transform_request = std::move(request);
+        }
+    }
+
     void RenderSwapData::addNewParticleEmitter(ParticleEmitterDesc& desc)
     {
         if (m_particle_submit_request.has_value())
@@ -52,6 +52,13 @@ namespace Piccolo
         GameObjectDesc& getNextProcessObject();
     };
 
+    struct GameObjectTransformRequest
+    {
+        std::vector<GameObjectPartTransformDesc> m_transform_descs;
+
+        void add(GameObjectPartTransformDesc&& desc);
+    };
+
     struct ParticleSubmitRequest
     {
         std::vector<ParticleEmitterDesc> m_emitter_descs;
@@ -83,16 +90,18 @@ namespace Piccolo
 
     struct RenderSwapData
     {
-        std::optional<LevelResourceDesc>       m_level_resource_desc;
-        std::optional<GameObjectResourceDesc>  m_game_object_resource_desc;
-        std::optional<GameObjectResourceDesc>  m_game_object_to_delete;
-        std::optional<CameraSwapData>          m_camera_swap_data;
-        std::optional<ParticleSubmitRequest>   m_particle_submit_request;
-        std::optional<EmitterTickRequest>      m_emitter_tick_request;
-        std::optional<EmitterTransformRequest> m_emitter_transform_request;
+        std::optional<LevelResourceDesc>          m_level_resource_desc;
+        std::optional<GameObjectResourceDesc>     m_game_object_resource_desc;
+        std::optional<GameObjectResourceDesc>     m_game_object_to_delete;
+        std::optional<GameObjectTransformRequest> m_game_object_transform_request;
+        std::optional<CameraSwapData>             m_camera_swap_data;
+        std::optional<ParticleSubmitRequest>      m_particle_submit_request;
+        std::optional<EmitterTickRequest>         m_emitter_tick_request;
+        std::optional<EmitterTransformRequest>    m_emitter_transform_request;
 
         void addDirtyGameObject(GameObjectDesc&& desc);
         void addDeleteGameObject(GameObjectDesc&& desc);
+        void updateGameObjectTransform(GameObjectPartTransformDesc&& desc);
 
         void addNewParticleEmitter(ParticleEmitterDesc& desc);
         void addTickParticleEmitter(ParticleEmitterID id);
@@ -115,6 +124,7 @@ namespace Piccolo
         void            resetLevelRsourceSwapData();
         void            resetGameObjectResourceSwapData();
         void            resetGameObjectToDelete();
+        void            resetGameObjectTransformSwapData();
         void            resetCameraSwapData();
         void            resetPartilceBatchSwapData();
         void            resetEmitterTickSwapData();
@@ -1,6 +1,7 @@
 #include "runtime/function/render/render_system.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/base/thread_pool.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
 #include "runtime/resource/config_manager/config_manager.h"
@@ -18,8 +19,18 @@
 
 #include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
 
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <chrono>
+
 namespace Piccolo
 {
+    static const uint32_t s_asset_loading_thread_count = 2;
+    // the render thread records one of the three parallel passes itself
+    static const uint32_t s_command_recording_thread_count = 2;
+
     RenderSystem::~RenderSystem() {}
 
     void RenderSystem::initialize(RenderSystemInitInfo init_info)
@@ -50,6 +61,8 @@ namespace Piccolo
             global_rendering_res.m_color_grading_map;
 
         m_render_resource = std::make_shared<RenderResource>();
+        m_render_resource->m_enable_texture_compression =
+            global_rendering_res.m_enable_texture_compression && m_rhi->isTextureCompressionBCEnabled();
         m_render_resource->uploadGlobalRenderResource(m_rhi, level_resource_desc);
 
         // setup render camera
@@ -69,10 +82,45 @@ namespace Piccolo
         m_render_scene->m_directional_light.m_color = global_rendering_res.m_directional_light.m_color.toVector3();
         m_render_scene->setVisibleNodesReference();
 
+        if (global_rendering_res.m_enable_parallel_culling)
+        {
+            m_culling_thread_pool = std::make_shared<ThreadPool>();
+            m_culling_thread_pool->initialize();
+            m_render_scene->setCullingThreadPool(m_culling_thread_pool);
+        }
+        m_render_scene->setGPUDrivenCullingEnabled(global_rendering_res.m_enable_gpu_driven_culling);
+        m_render_scene->setDirectionalLightCascades(
+            static_cast<uint32_t>(std::max(global_rendering_res.m_directional_light_cascade_count, 1)),
+            global_rendering_res.m_directional_light_cascade_split_lambda,
+            static_cast<uint32_t>(std::max(global_rendering_res.m_directional_light_first_cached_cascade, 0)));
+        m_render_scene->setComputeSkinningEnabled(global_rendering_res.m_enable_compute_skinning);
+
+        // without worker threads the asset loads run in place
+        m_asset_loading_thread_pool = std::make_shared<ThreadPool>();
+        if (global_rendering_res.m_enable_async_asset_loading)
+        {
+            m_asset_loading_thread_pool->initialize(s_asset_loading_thread_count);
+        }
+
         // initialize render pipeline
         RenderPipelineInitInfo pipeline_init_info;
-        pipeline_init_info.enable_fxaa     = global_rendering_res.m_enable_fxaa;
-        pipeline_init_info.render_resource = m_render_resource;
+        pipeline_init_info.enable_fxaa               = global_rendering_res.m_enable_fxaa;
+        pipeline_init_info.enable_gpu_driven_culling = global_rendering_res.m_enable_gpu_driven_culling;
+        pipeline_init_info.enable_compute_skinning   = global_rendering_res.m_enable_compute_skinning;
+        pipeline_init_info.enable_fused_post_process = global_rendering_res.m_enable_fused_post_process;
+        pipeline_init_info.render_resource           = m_render_resource;
+
+        pipeline_init_info.enable_dynamic_resolution = global_rendering_res.m_enable_dynamic_resolution;
+        pipeline_init_info.dynamic_resolution_target_gpu_time_ms =
+            global_rendering_res.m_dynamic_resolution_target_gpu_time_ms;
+        pipeline_init_info.dynamic_resolution_min_scale = global_rendering_res.m_dynamic_resolution_min_scale;
+
+        if (global_rendering_res.m_enable_parallel_command_recording)
+        {
+            m_command_recording_thread_pool = std::make_shared<ThreadPool>();
+            m_command_recording_thread_pool->initialize(s_command_recording_thread_count);
+            pipeline_init_info.command_recording_thread_pool = m_command_recording_thread_pool;
+        }
 
         m_render_pipeline        = std::make_shared<RenderPipeline>();
         m_render_pipeline->m_rhi = m_rhi;
@@ -91,6 +139,11 @@ namespace Piccolo
 
     void RenderSystem::tick()
     {
+        PROFILE_SCOPE("RenderSystem::tick");
+
+        // the picks of the frames that completed on the gpu, before the scene is touched by the swap data
+        m_render_pipeline->resolvePendingPicks();
+
         // process swap data between logic and render contexts
         processSwapData();
 
@@ -151,9 +204,9 @@ namespace Piccolo
         return {x, y, width, height};
     }
 
-    uint32_t RenderSystem::getGuidOfPickedMesh(const Vector2& picked_uv)
+    void RenderSystem::requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback)
     {
-        return m_render_pipeline->getGuidOfPickedMesh(picked_uv);
+        m_render_pipeline->requestGuidOfPickedMesh(picked_uv, std::move(callback));
     }
 
     GObjectID RenderSystem::getGObjectIDByMeshID(uint32_t mesh_id) const
@@ -201,12 +254,40 @@ namespace Piccolo
     void RenderSystem::clearForLevelReloading()
     {
         m_render_scene->clearForLevelReloading();
+        m_render_entities_waiting_for_assets.clear();
 
         ParticleSubmitRequest request;
 
         m_swap_context.getLogicSwapData().m_particle_submit_request = request;
     }
 
+    uint32_t RenderSystem::getPendingAssetLoadCount() const
+    {
+        return static_cast<uint32_t>(m_pending_mesh_loads.size() + m_pending_material_loads.size());
+    }
+
+    bool RenderSystem::saveLastFrameImage(const std::string& file_path)
+    {
+        VulkanRHI* vulkan_rhi = static_cast<VulkanRHI*>(m_rhi.get());
+
+        std::vector<uint8_t> pixels;
+        if (!vulkan_rhi->readbackPresentedImage(pixels))
+        {
+            return false;
+        }
+
+        // bgra to opaque rgba
+        for (size_t i = 0; i < pixels.size(); i += 4)
+        {
+            std::swap(pixels[i], pixels[i + 2]);
+            pixels[i + 3] = 0xFF;
+        }
+
+        const int width  = static_cast<int>(vulkan_rhi->m_swapchain_extent.width);
+        const int height = static_cast<int>(vulkan_rhi->m_swapchain_extent.height);
+        return stbi_write_png(file_path.c_str(), width, height, 4, pixels.data(), width * 4) != 0;
+    }
+
     void RenderSystem::setRenderPipelineType(RENDER_PIPELINE_TYPE pipeline_type)
     {
         m_render_pipeline_type = pipeline_type;
@@ -217,8 +298,92 @@ namespace Piccolo
         m_render_pipeline->initializeUIRenderBackend(window_ui);
     }
 
+    void RenderSystem::requestMeshLoad(size_t                mesh_asset_id,
+                                       const MeshSourceDesc& mesh_source,
+                                       bool                  use_vertex_color)
+    {
+        std::shared_ptr<RenderResourceBase> render_resource = m_render_resource;
+
+        m_pending_mesh_loads[mesh_asset_id] =
+            m_asset_loading_thread_pool->submit([render_resource, mesh_source, use_vertex_color]() {
+                // the bounding box is cached by the render resource
+                AxisAlignedBox bounding_box;
+                return render_resource->loadMeshData(mesh_source, bounding_box, use_vertex_color);
+            });
+    }
+
+    void RenderSystem::requestMaterialLoad(const RenderEntity& render_entity, const MaterialSourceDesc& material_source)
+    {
+        std::shared_ptr<RenderResourceBase> render_resource = m_render_resource;
+
+        PendingMaterialLoad& material_load = m_pending_material_loads[render_entity.m_material_asset_id];
+        material_load.m_render_entity      = render_entity;
+        material_load.m_material_data      = m_asset_loading_thread_pool->submit(
+            [render_resource, material_source]() { return render_resource->loadMaterialData(material_source); });
+    }
+
+    void RenderSystem::processPendingAssetLoads()
+    {
+        // upload the assets that finished loading
+        for (auto it = m_pending_mesh_loads.begin(); it != m_pending_mesh_loads.end();)
+        {
+            if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++it;
+                continue;
+            }
+
+            RenderEntity render_entity;
+            render_entity.m_mesh_asset_id = it->first;
+            m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, it->second.get());
+
+            it = m_pending_mesh_loads.erase(it);
+        }
+
+        for (auto it = m_pending_material_loads.begin(); it != m_pending_material_loads.end();)
+        {
+            if (it->second.m_material_data.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++it;
+                continue;
+            }
+
+            m_render_resource->uploadGameObjectRenderResource(
+                m_rhi, it->second.m_render_entity, it->second.m_material_data.get());
+
+            it = m_pending_material_loads.erase(it);
+        }
+
+        // add the entities whose mesh and material are both uploaded
+        for (auto it = m_render_entities_waiting_for_assets.begin(); it != m_render_entities_waiting_for_assets.end();)
+        {
+            RenderEntity& render_entity = it->second.m_render_entity;
+            if (m_pending_mesh_loads.count(render_entity.m_mesh_asset_id) != 0 ||
+                m_pending_material_loads.count(render_entity.m_material_asset_id) != 0)
+            {
+                ++it;
+                continue;
+            }
+
+            render_entity.m_bounding_box = m_render_resource->getCachedBoudingBox(it->second.m_mesh_source);
+
+            if (m_render_scene->hasRenderEntity(render_entity.m_instance_id))
+            {
+                m_render_scene->updateRenderEntity(render_entity);
+            }
+            else
+            {
+                m_render_scene->addRenderEntity(render_entity);
+            }
+
+            it = m_render_entities_waiting_for_assets.erase(it);
+        }
+    }
+
     void RenderSystem::processSwapData()
     {
+        PROFILE_SCOPE("RenderSystem::processSwapData");
+
         RenderSwapData& swap_data = m_swap_context.getRenderSwapData();
 
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
@@ -245,8 +410,6 @@ namespace Piccolo
                     const auto&      game_object_part = gobject.getObjectParts()[part_index];
                     GameObjectPartId part_id          = {gobject.getId(), part_index};
 
-                    bool is_entity_in_scene = m_render_scene->getInstanceIdAllocator().hasElement(part_id);
-
                     RenderEntity render_entity;
                     render_entity.m_instance_id =
                         static_cast<uint32_t>(m_render_scene->getInstanceIdAllocator().allocGuid(part_id));
@@ -258,19 +421,14 @@ namespace Piccolo
                     MeshSourceDesc mesh_source    = {game_object_part.m_mesh_desc.m_mesh_file};
                     bool           is_mesh_loaded = m_render_scene->getMeshAssetIdAllocator().hasElement(mesh_source);
 
-                    RenderMeshData mesh_data;
+                    render_entity.m_mesh_asset_id = m_render_scene->getMeshAssetIdAllocator().allocGuid(mesh_source);
                     if (!is_mesh_loaded)
                     {
                         auto id               = game_object_part.m_material_desc.m_nbr_mesh_id;
                         bool use_vertex_color = id == 2 || id == 4 || id == 5;
-                        mesh_data = m_render_resource->loadMeshData(mesh_source, render_entity.m_bounding_box, use_vertex_color);
-                    }
-                    else
-                    {
-                        render_entity.m_bounding_box = m_render_resource->getCachedBoudingBox(mesh_source);
+                        requestMeshLoad(render_entity.m_mesh_asset_id, mesh_source, use_vertex_color);
                     }
 
-                    render_entity.m_mesh_asset_id = m_render_scene->getMeshAssetIdAllocator().allocGuid(mesh_source);
                     render_entity.m_enable_vertex_blending =
                         game_object_part.m_skeleton_animation_result.m_transforms.size() > 1; // take care
                     render_entity.m_joint_matrices.resize(
@@ -313,75 +471,52 @@ namespace Piccolo
                     }
                     bool is_material_loaded = m_render_scene->getMaterialAssetdAllocator().hasElement(material_source);
 
-                    RenderMaterialData material_data;
-                    if (!is_material_loaded)
-                    {
-                        material_data = m_render_resource->loadMaterialData(material_source);
-                    }
-
                     render_entity.m_is_NBR_material = game_object_part.m_material_desc.m_is_NBR_material;
                     render_entity.m_material_asset_id =
                         m_render_scene->getMaterialAssetdAllocator().allocGuid(material_source);
 
                     if (render_entity.m_is_NBR_material)
                     {
-                        render_entity.m_nbr_mesh_id                       = game_object_part.m_material_desc.m_nbr_mesh_id;
-                        render_entity.m_area                              = game_object_part.m_material_desc.m_area;
-                        render_entity.m_front_face_tint_color             = game_object_part.m_material_desc.m_front_face_tint_color;
-                        render_entity.m_alpha                             = game_object_part.m_material_desc.m_alpha;
-                        render_entity.m_back_face_tint_color              = game_object_part.m_material_desc.m_back_face_tint_color;
-                        render_entity.m_alpha_clip                        = game_object_part.m_material_desc.m_alpha_clip;
-                        render_entity.m_indirect_light_usage              = game_object_part.m_material_desc.m_indirect_light_usage;
-                        render_entity.m_indirect_light_mix_base_color     = game_object_part.m_material_desc.m_indirect_light_mix_base_color;
-                        render_entity.m_indirect_light_occlusion_usage    = game_object_part.m_material_desc.m_indirect_light_occlusion_usage;
-                        render_entity.m_main_light_color_usage            = game_object_part.m_material_desc.m_main_light_color_usage;
-                        render_entity.m_shadow_threshold_center           = game_object_part.m_material_desc.m_shadow_threshold_center;
-                        render_entity.m_shadow_threshold_softness         = game_object_part.m_material_desc.m_shadow_threshold_softness;
-                        render_entity.m_shadow_ramp_offset                = game_object_part.m_material_desc.m_shadow_ramp_offset;
-                        render_entity.m_face_shadow_offset                = game_object_part.m_material_desc.m_face_shadow_offset;
-                        render_entity.m_face_shadow_transition_softness   = game_object_part.m_material_desc.m_face_shadow_transition_softness;
-                        render_entity.m_specular_exponent                 = game_object_part.m_material_desc.m_specular_exponent;
-                        render_entity.m_specular_Ks_non_metal             = game_object_part.m_material_desc.m_specular_Ks_non_metal;
-                        render_entity.m_specular_Ks_metal                 = game_object_part.m_material_desc.m_specular_Ks_metal;
-                        render_entity.m_specular_brightness               = game_object_part.m_material_desc.m_specular_brightness;
-                        render_entity.m_rim_light_width                   = game_object_part.m_material_desc.m_rim_light_width;
-                        render_entity.m_rim_light_threshold               = game_object_part.m_material_desc.m_rim_light_threshold;
-                        render_entity.m_rim_light_fadeout                 = game_object_part.m_material_desc.m_rim_light_fadeout;
-                        render_entity.m_rim_light_brightness              = game_object_part.m_material_desc.m_rim_light_brightness;
-                        render_entity.m_rim_light_tint_color              = game_object_part.m_material_desc.m_rim_light_tint_color;
-                        render_entity.m_rim_light_mix_albedo              = game_object_part.m_material_desc.m_rim_light_mix_albedo;
-                        render_entity.m_emission_tint_color               = game_object_part.m_material_desc.m_emission_tint_color;
-                        render_entity.m_emission_mix_base_color           = game_object_part.m_material_desc.m_emission_mix_base_color;
-                        render_entity.m_emission_intensity                = game_object_part.m_material_desc.m_emission_intensity;
-                    }
-
-                    // create game object on the graphics api side
-                    if (!is_mesh_loaded)
-                    {
-                        m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, mesh_data);
+                        render_entity.m_nbr_mesh_id = game_object_part.m_material_desc.m_nbr_mesh_id;
+
+                        RenderEntityMaterialParameters& material_parameters = render_entity.m_material_parameters;
+                        material_parameters.m_area                              = game_object_part.m_material_desc.m_area;
+                        material_parameters.m_front_face_tint_color             = game_object_part.m_material_desc.m_front_face_tint_color;
+                        material_parameters.m_alpha                             = game_object_part.m_material_desc.m_alpha;
+                        material_parameters.m_back_face_tint_color              = game_object_part.m_material_desc.m_back_face_tint_color;
+                        material_parameters.m_alpha_clip                        = game_object_part.m_material_desc.m_alpha_clip;
+                        material_parameters.m_indirect_light_usage              = game_object_part.m_material_desc.m_indirect_light_usage;
+                        material_parameters.m_indirect_light_mix_base_color     = game_object_part.m_material_desc.m_indirect_light_mix_base_color;
+                        material_parameters.m_indirect_light_occlusion_usage    = game_object_part.m_material_desc.m_indirect_light_occlusion_usage;
+                        material_parameters.m_main_light_color_usage            = game_object_part.m_material_desc.m_main_light_color_usage;
+                        material_parameters.m_shadow_threshold_center           = game_object_part.m_material_desc.m_shadow_threshold_center;
+                        material_parameters.m_shadow_threshold_softness         = game_object_part.m_material_desc.m_shadow_threshold_softness;
+                        material_parameters.m_shadow_ramp_offset                = game_object_part.m_material_desc.m_shadow_ramp_offset;
+                        material_parameters.m_face_shadow_offset                = game_object_part.m_material_desc.m_face_shadow_offset;
+                        material_parameters.m_face_shadow_transition_softness   = game_object_part.m_material_desc.m_face_shadow_transition_softness;
+                        material_parameters.m_specular_exponent                 = game_object_part.m_material_desc.m_specular_exponent;
+                        material_parameters.m_specular_Ks_non_metal             = game_object_part.m_material_desc.m_specular_Ks_non_metal;
+                        material_parameters.m_specular_Ks_metal                 = game_object_part.m_material_desc.m_specular_Ks_metal;
+                        material_parameters.m_specular_brightness               = game_object_part.m_material_desc.m_specular_brightness;
+                        material_parameters.m_rim_light_width                   = game_object_part.m_material_desc.m_rim_light_width;
+                        material_parameters.m_rim_light_threshold               = game_object_part.m_material_desc.m_rim_light_threshold;
+                        material_parameters.m_rim_light_fadeout                 = game_object_part.m_material_desc.m_rim_light_fadeout;
+                        material_parameters.m_rim_light_brightness              = game_object_part.m_material_desc.m_rim_light_brightness;
+                        material_parameters.m_rim_light_tint_color              = game_object_part.m_material_desc.m_rim_light_tint_color;
+                        material_parameters.m_rim_light_mix_albedo              = game_object_part.m_material_desc.m_rim_light_mix_albedo;
+                        material_parameters.m_emission_tint_color               = game_object_part.m_material_desc.m_emission_tint_color;
+                        material_parameters.m_emission_mix_base_color           = game_object_part.m_material_desc.m_emission_mix_base_color;
+                        material_parameters.m_emission_intensity                = game_object_part.m_material_desc.m_emission_intensity;
                     }
 
+                    // the material uniforms are created from the first entity using the material
                     if (!is_material_loaded)
                     {
-                        m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, material_data);
+                        requestMaterialLoad(render_entity, material_source);
                     }
 
-                    // add object to render scene if needed
-                    if (!is_entity_in_scene)
-                    {
-                        m_render_scene->m_render_entities.push_back(render_entity);
-                    }
-                    else
-                    {
-                        for (auto& entity : m_render_scene->m_render_entities)
-                        {
-                            if (entity.m_instance_id == render_entity.m_instance_id)
-                            {
-                                entity = render_entity;
-                                break;
-                            }
-                        }
-                    }
+                    // the entity is added to or updated in the render scene once its mesh and material are uploaded
+                    m_render_entities_waiting_for_assets[render_entity.m_instance_id] = {render_entity, mesh_source};
                 }
                 // after finished processing, pop this game object
                 swap_data.m_game_object_resource_desc->pop();
@@ -391,12 +526,53 @@ namespace Piccolo
             m_swap_context.resetGameObjectResourceSwapData();
         }
 
+        // create game objects on the graphics api side
+        processPendingAssetLoads();
+
+        // update transform and pose of objects already in the scene
+        if (swap_data.m_game_object_transform_request.has_value())
+        {
+            for (const GameObjectPartTransformDesc& transform_desc :
+                 swap_data.m_game_object_transform_request->m_transform_descs)
+            {
+                size_t instance_id;
+                if (m_render_scene->getInstanceIdAllocator().getElementGuid(transform_desc.m_part_id, instance_id))
+                {
+                    auto waiting_it = m_render_entities_waiting_for_assets.find(static_cast<uint32_t>(instance_id));
+                    if (waiting_it != m_render_entities_waiting_for_assets.end())
+                    {
+                        waiting_it->second.m_render_entity.m_model_matrix   = transform_desc.m_transform_matrix;
+                        waiting_it->second.m_render_entity.m_joint_matrices = transform_desc.m_joint_matrices;
+                    }
+
+                    m_render_scene->updateRenderEntityTransform(static_cast<uint32_t>(instance_id),
+                                                                transform_desc.m_transform_matrix,
+                                                                transform_desc.m_joint_matrices);
+                }
+            }
+
+            m_swap_context.resetGameObjectTransformSwapData();
+        }
+
         // remove deleted objects
         if (swap_data.m_game_object_to_delete.has_value())
         {
             while (!swap_data.m_game_object_to_delete->isEmpty())
             {
                 GameObjectDesc gobject = swap_data.m_game_object_to_delete->getNextProcessObject();
+
+                for (auto it = m_render_entities_waiting_for_assets.begin();
+                     it != m_render_entities_waiting_for_assets.end();)
+                {
+                    if (m_render_scene->getGObjectIDByMeshID(it->first) == gobject.getId())
+                    {
+                        it = m_render_entities_waiting_for_assets.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
                 m_render_scene->deleteEntityByGObjectID(gobject.getId());
                 swap_data.m_game_object_to_delete->pop();
             }
@@ -6,8 +6,11 @@
 #include "runtime/function/render/render_type.h"
 
 #include <array>
+#include <functional>
+#include <future>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 
 namespace Piccolo
 {
@@ -18,6 +21,7 @@ namespace Piccolo
     class RenderScene;
     class RenderCamera;
     class WindowUI;
+    class ThreadPool;
 
     struct RenderSystemInitInfo
     {
@@ -50,7 +54,7 @@ namespace Piccolo
         void      setRenderPipelineType(RENDER_PIPELINE_TYPE pipeline_type);
         void      initializeUIRenderBackend(WindowUI* window_ui);
         void      updateEngineContentViewport(float offset_x, float offset_y, float width, float height);
-        uint32_t  getGuidOfPickedMesh(const Vector2& picked_uv);
+        void      requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback);
         GObjectID getGObjectIDByMeshID(uint32_t mesh_id) const;
 
         EngineContentViewport getEngineContentViewport() const;
@@ -63,7 +67,25 @@ namespace Piccolo
 
         void clearForLevelReloading();
 
+        // meshes and materials that are still loading, the entities using them are not drawn yet
+        uint32_t getPendingAssetLoadCount() const;
+
+        // headless only, writes the last rendered frame as a png
+        bool saveLastFrameImage(const std::string& file_path);
+
     private:
+        struct PendingMaterialLoad
+        {
+            RenderEntity                    m_render_entity;
+            std::future<RenderMaterialData> m_material_data;
+        };
+
+        struct RenderEntityWaitingForAssets
+        {
+            RenderEntity   m_render_entity;
+            MeshSourceDesc m_mesh_source;
+        };
+
         RENDER_PIPELINE_TYPE m_render_pipeline_type {RENDER_PIPELINE_TYPE::DEFERRED_PIPELINE};
 
         RenderSwapContext m_swap_context;
@@ -73,7 +95,17 @@ namespace Piccolo
         std::shared_ptr<RenderScene>        m_render_scene;
         std::shared_ptr<RenderResourceBase> m_render_resource;
         std::shared_ptr<RenderPipelineBase> m_render_pipeline;
+        std::shared_ptr<ThreadPool>         m_culling_thread_pool;
+        std::shared_ptr<ThreadPool>         m_asset_loading_thread_pool;
+        std::shared_ptr<ThreadPool>         m_command_recording_thread_pool;
+
+        std::unordered_map<size_t, std::future<RenderMeshData>>    m_pending_mesh_loads;
+        std::unordered_map<size_t, PendingMaterialLoad>            m_pending_material_loads;
+        std::unordered_map<uint32_t, RenderEntityWaitingForAssets> m_render_entities_waiting_for_assets;
 
         void processSwapData();
+        void requestMeshLoad(size_t mesh_asset_id, const MeshSourceDesc& mesh_source, bool use_vertex_color);
+        void requestMaterialLoad(const RenderEntity& render_entity, const MaterialSourceDesc& material_source);
+        void processPendingAssetLoads();
     };
 } // namespace Piccolo
@@ -0,0 +1,300 @@
+#include "runtime/function/render/render_texture_compressor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+namespace Piccolo
+{
+    static const int s_block_pixel_count = 16;
+
+    // bc7 mode 6: one subset, rgba endpoints with 7 bits per channel plus a p bit per endpoint, 4 bit indices
+    static const uint32_t s_bc7_mode6_weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    struct BC7Mode6Endpoints
+    {
+        uint8_t m_values[2][4]; // 7 bit values
+        uint8_t m_p_bits[2];
+    };
+
+    static uint8_t getEndpointChannel(const BC7Mode6Endpoints& endpoints, int endpoint, int channel)
+    {
+        return static_cast<uint8_t>((endpoints.m_values[endpoint][channel] << 1) | endpoints.m_p_bits[endpoint]);
+    }
+
+    static uint32_t findBC7Mode6Indices(const uint8_t*           rgba_pixels,
+                                        const BC7Mode6Endpoints& endpoints,
+                                        uint8_t*                 indices)
+    {
+        int palette[16][4];
+        for (int weight_index = 0; weight_index < 16; ++weight_index)
+        {
+            uint32_t weight = s_bc7_mode6_weights[weight_index];
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                uint32_t e0                    = getEndpointChannel(endpoints, 0, channel);
+                uint32_t e1                    = getEndpointChannel(endpoints, 1, channel);
+                palette[weight_index][channel] = static_cast<int>(((64 - weight) * e0 + weight * e1 + 32) >> 6);
+            }
+        }
+
+        uint32_t total_error = 0;
+        for (int pixel = 0; pixel < s_block_pixel_count; ++pixel)
+        {
+            const uint8_t* color      = rgba_pixels + pixel * 4;
+            uint32_t       best_error = UINT32_MAX;
+            for (int weight_index = 0; weight_index < 16; ++weight_index)
+            {
+                uint32_t error = 0;
+                for (int channel = 0; channel < 4; ++channel)
+                {
+                    int difference = palette[weight_index][channel] - color[channel];
+                    error += static_cast<uint32_t>(difference * difference);
+                }
+                if (error < best_error)
+                {
+                    best_error     = error;
+                    indices[pixel] = static_cast<uint8_t>(weight_index);
+                }
+            }
+            total_error += best_error;
+        }
+        return total_error;
+    }
+
+    // quantize the endpoints for every p bit combination and keep the best one
+    static uint32_t quantizeBC7Mode6Endpoints(const uint8_t*     rgba_pixels,
+                                              const float        unquantized[2][4],
+                                              BC7Mode6Endpoints& best_endpoints,
+                                              uint8_t*           best_indices)
+    {
+        uint32_t best_error = UINT32_MAX;
+        for (int p_bits = 0; p_bits < 4; ++p_bits)
+        {
+            BC7Mode6Endpoints endpoints;
+            endpoints.m_p_bits[0] = static_cast<uint8_t>(p_bits & 1);
+            endpoints.m_p_bits[1] = static_cast<uint8_t>(p_bits >> 1);
+            for (int endpoint = 0; endpoint < 2; ++endpoint)
+            {
+                for (int channel = 0; channel < 4; ++channel)
+                {
+                    float value = (unquantized[endpoint][channel] - endpoints.m_p_bits[endpoint]) * 0.5f;
+                    endpoints.m_values[endpoint][channel] =
+                        static_cast<uint8_t>(std::min(std::max(std::lround(value), 0L), 127L));
+                }
+            }
+
+            uint8_t  indices[s_block_pixel_count];
+            uint32_t error = findBC7Mode6Indices(rgba_pixels, endpoints, indices);
+            if (error < best_error)
+            {
+                best_error     = error;
+                best_endpoints = endpoints;
+                memcpy(best_indices, indices, s_block_pixel_count);
+            }
+        }
+        return best_error;
+    }
+
+    class BlockBitWriter
+    {
+    public:
+        explicit BlockBitWriter(uint8_t* block) : m_block(block) { memset(m_block, 0, 16); }
+
+        void write(uint32_t value, uint32_t bit_count)
+        {
+            for (uint32_t bit = 0; bit < bit_count; ++bit, ++m_bit_position)
+            {
+                if (value & (1u << bit))
+                {
+                    m_block[m_bit_position >> 3] |= static_cast<uint8_t>(1u << (m_bit_position & 7));
+                }
+            }
+        }
+
+    private:
+        uint8_t* m_block;
+        uint32_t m_bit_position {0};
+    };
+
+    void compressBC7Block(const uint8_t* rgba_pixels, uint8_t* block)
+    {
+        // principal axis of the block colors
+        float mean[4] = {};
+        for (int pixel = 0; pixel < s_block_pixel_count; ++pixel)
+        {
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                mean[channel] += rgba_pixels[pixel * 4 + channel];
+            }
+        }
+        for (int channel = 0; channel < 4; ++channel)
+        {
+            mean[channel] /= s_block_pixel_count;
+        }
+
+        float covariance[4][4] = {};
+        for (int pixel = 0; pixel < s_block_pixel_count; ++pixel)
+        {
+            float difference[4];
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                difference[channel] = rgba_pixels[pixel * 4 + channel] - mean[channel];
+            }
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    covariance[row][column] += difference[row] * difference[column];
+                }
+            }
+        }
+
+        float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            float next_axis[4] = {};
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    next_axis[row] += covariance[row][column] * axis[column];
+                }
+            }
+
+            float length = std::sqrt(next_axis[0] * next_axis[0] + next_axis[1] * next_axis[1] +
+                                     next_axis[2] * next_axis[2] + next_axis[3] * next_axis[3]);
+            if (length < 1e-6f)
+            {
+                // a flat block, any axis works
+                break;
+            }
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                axis[channel] = next_axis[channel] / length;
+            }
+        }
+
+        float min_projection = FLT_MAX;
+        float max_projection = -FLT_MAX;
+        for (int pixel = 0; pixel < s_block_pixel_count; ++pixel)
+        {
+            float projection = 0.0f;
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                projection += (rgba_pixels[pixel * 4 + channel] - mean[channel]) * axis[channel];
+            }
+            min_projection = std::min(min_projection, projection);
+            max_projection = std::max(max_projection, projection);
+        }
+
+        float unquantized[2][4];
+        for (int channel = 0; channel < 4; ++channel)
+        {
+            unquantized[0][channel] = std::min(std::max(mean[channel] + min_projection * axis[channel], 0.0f), 255.0f);
+            unquantized[1][channel] = std::min(std::max(mean[channel] + max_projection * axis[channel], 0.0f), 255.0f);
+        }
+
+        BC7Mode6Endpoints endpoints;
+        uint8_t           indices[s_block_pixel_count];
+        uint32_t          error = quantizeBC7Mode6Endpoints(rgba_pixels, unquantized, endpoints, indices);
+
+        // refine the endpoints once by least squares for the chosen indices
+        if (error > 0)
+        {
+            float alpha_alpha = 0.0f, alpha_beta = 0.0f, beta_beta = 0.0f;
+            float alpha_color[4] = {}, beta_color[4] = {};
+            for (int pixel = 0; pixel < s_block_pixel_count; ++pixel)
+            {
+                float beta  = s_bc7_mode6_weights[indices[pixel]] / 64.0f;
+                float alpha = 1.0f - beta;
+                alpha_alpha += alpha * alpha;
+                alpha_beta += alpha * beta;
+                beta_beta += beta * beta;
+                for (int channel = 0; channel < 4; ++channel)
+                {
+                    alpha_color[channel] += alpha * rgba_pixels[pixel * 4 + channel];
+                    beta_color[channel] += beta * rgba_pixels[pixel * 4 + channel];
+                }
+            }
+
+            float determinant = alpha_alpha * beta_beta - alpha_beta * alpha_beta;
+            if (std::fabs(determinant) > 1e-6f)
+            {
+                float refined[2][4];
+                for (int channel = 0; channel < 4; ++channel)
+                {
+                    refined[0][channel] =
+                        (beta_beta * alpha_color[channel] - alpha_beta * beta_color[channel]) / determinant;
+                    refined[1][channel] =
+                        (alpha_alpha * beta_color[channel] - alpha_beta * alpha_color[channel]) / determinant;
+                    refined[0][channel] = std::min(std::max(refined[0][channel], 0.0f), 255.0f);
+                    refined[1][channel] = std::min(std::max(refined[1][channel], 0.0f), 255.0f);
+                }
+
+                BC7Mode6Endpoints refined_endpoints;
+                uint8_t           refined_indices[s_block_pixel_count];
+                uint32_t refined_error = quantizeBC7Mode6Endpoints(rgba_pixels, refined, refined_endpoints, refined_indices);
+                if (refined_error < error)
+                {
+                    endpoints = refined_endpoints;
+                    memcpy(indices, refined_indices, s_block_pixel_count);
+                }
+            }
+        }
+
+        // the most significant bit of the first index is implicit zero, swap the endpoints if it is set
+        if (indices[0] & 8)
+        {
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                std::swap(endpoints.m_values[0][channel], endpoints.m_values[1][channel]);
+            }
+            std::swap(endpoints.m_p_bits[0], endpoints.m_p_bits[1]);
+            for (int pixel = 0; pixel < s_block_pixel_count; ++pixel)
+            {
+                indices[pixel] = static_cast<uint8_t>(15 - indices[pixel]);
+            }
+        }
+
+        BlockBitWriter writer(block);
+        writer.write(1u << 6, 7);
+        for (int channel = 0; channel < 4; ++channel)
+        {
+            writer.write(endpoints.m_values[0][channel], 7);
+            writer.write(endpoints.m_values[1][channel], 7);
+        }
+        writer.write(endpoints.m_p_bits[0], 1);
+        writer.write(endpoints.m_p_bits[1], 1);
+        writer.write(indices[0], 3);
+        for (int pixel = 1; pixel < s_block_pixel_count; ++pixel)
+        {
+            writer.write(indices[pixel], 4);
+        }
+    }
+
+    void compressBC4Block(const uint8_t* rgba_pixels, uint8_t* block)
+    {
+        uint8_t red[s_block_pixel_count];
+        for (int pixel = 0; pixel < s_block_pixel_count; ++pixel)
+        {
+            red[pixel] = rgba_pixels[pixel * 4];
+        }
+        stb_compress_bc4_block(block, red);
+    }
+
+    void compressBC5Block(const uint8_t* rgba_pixels, uint8_t* block)
+    {
+        uint8_t red_green[s_block_pixel_count * 2];
+        for (int pixel = 0; pixel < s_block_pixel_count; ++pixel)
+        {
+            red_green[pixel * 2 + 0] = rgba_pixels[pixel * 4 + 0];
+            red_green[pixel * 2 + 1] = rgba_pixels[pixel * 4 + 1];
+        }
+        stb_compress_bc5_block(block, red_green);
+    }
+} // namespace Piccolo
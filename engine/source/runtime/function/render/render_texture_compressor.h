@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Piccolo
+{
+    // block encoders for 4x4 pixel blocks, the source block is given row by row
+
+    // 16 rgba pixels to a 16 byte bc7 block
+    void compressBC7Block(const uint8_t* rgba_pixels, uint8_t* block);
+
+    // the red channel of 16 rgba pixels to an 8 byte bc4 block
+    void compressBC4Block(const uint8_t* rgba_pixels, uint8_t* block);
+
+    // the red and green channels of 16 rgba pixels to a 16 byte bc5 block
+    void compressBC5Block(const uint8_t* rgba_pixels, uint8_t* block);
+} // namespace Piccolo
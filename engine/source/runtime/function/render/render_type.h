@@ -17,7 +17,12 @@ namespace Piccolo
         PICCOLO_PIXEL_FORMAT_R8G8B8A8_SRGB,
         PICCOLO_PIXEL_FORMAT_R32G32_FLOAT,
         PICCOLO_PIXEL_FORMAT_R32G32B32_FLOAT,
-        PICCOLO_PIXEL_FORMAT_R32G32B32A32_FLOAT
+        PICCOLO_PIXEL_FORMAT_R32G32B32A32_FLOAT,
+        // block compressed, the pixels hold the whole mip chain
+        PICCOLO_PIXEL_FORMAT_BC4_UNORM,
+        PICCOLO_PIXEL_FORMAT_BC5_UNORM,
+        PICCOLO_PIXEL_FORMAT_BC7_UNORM,
+        PICCOLO_PIXEL_FORMAT_BC7_SRGB
     };
 
     enum class PICCOLO_IMAGE_TYPE : uint8_t
@@ -45,14 +50,19 @@ namespace Piccolo
             m_size = size;
             m_data = malloc(size);
         }
+        // view into memory kept alive by owner, e.g. a mapped file, the memory is not freed by the buffer
+        BufferData(std::shared_ptr<void> owner, void* data, size_t size) : m_size(size), m_data(data), m_owner(owner) {}
         ~BufferData()
         {
-            if (m_data)
+            if (m_data && !m_owner)
             {
                 free(m_data);
             }
         }
         bool isValid() const { return m_data != nullptr; }
+
+    private:
+        std::shared_ptr<void> m_owner;
     };
 
     class TextureData
@@ -65,13 +75,16 @@ namespace Piccolo
         uint32_t m_array_layers {0};
         void*    m_pixels {nullptr};
 
+        // when set, m_pixels points into memory kept alive by it, e.g. a mapped file, and is not freed
+        std::shared_ptr<void> m_pixels_owner;
+
         PICCOLO_PIXEL_FORMAT m_format {PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_UNKNOWN};
         PICCOLO_IMAGE_TYPE   m_type {PICCOLO_IMAGE_TYPE::PICCOLO_IMAGE_TYPE_UNKNOWM};
 
         TextureData() = default;
         ~TextureData()
         {
-            if (m_pixels)
+            if (m_pixels && !m_pixels_owner)
             {
                 free(m_pixels);
             }
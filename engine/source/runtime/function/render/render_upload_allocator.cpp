@@ -0,0 +1,96 @@
+#include "runtime/function/render/render_upload_allocator.h"
+
+#include "runtime/core/base/macro.h"
+
+#include "runtime/function/render/render_helper.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Piccolo
+{
+    void RenderUploadAllocator::initialize(void*                         memory_pointer,
+                                           uint32_t                      size,
+                                           uint32_t                      alignment,
+                                           uint32_t                      frames_in_flight,
+                                           std::function<void(uint32_t)> wait_for_frame)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_memory_pointer = memory_pointer;
+        m_size           = size;
+        m_alignment      = alignment;
+        m_wait_for_frame = std::move(wait_for_frame);
+
+        m_head                = 0;
+        m_used_size           = 0;
+        m_current_frame_index = 0;
+        m_frame_sizes.assign(frames_in_flight, 0);
+    }
+
+    void RenderUploadAllocator::beginFrame(uint32_t frame_index)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        releaseFrame(frame_index);
+        m_current_frame_index = frame_index;
+        ++m_frame_serial;
+    }
+
+    uint32_t RenderUploadAllocator::allocateBytes(uint32_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        assert(size <= m_size);
+
+        uint32_t frame_count = static_cast<uint32_t>(m_frame_sizes.size());
+
+        // after the current frame, the frames in flight are released from the oldest to the newest
+        for (uint32_t older_frame = 1; older_frame <= frame_count; ++older_frame)
+        {
+            uint32_t offset = roundUp(m_head, m_alignment);
+            if (static_cast<uint64_t>(offset) + size > m_size)
+            {
+                // wrap around, the end of the buffer is padding of this frame
+                offset = 0;
+            }
+
+            uint32_t consumed = (offset >= m_head) ? (offset + size - m_head) : (m_size - m_head + offset + size);
+            if (m_used_size + consumed <= m_size)
+            {
+                m_head = offset + size;
+                m_used_size += consumed;
+                m_frame_sizes[m_current_frame_index] += consumed;
+                m_high_water_mark = std::max(m_high_water_mark, m_frame_sizes[m_current_frame_index]);
+                return offset;
+            }
+
+            uint32_t oldest_frame_index = (m_current_frame_index + older_frame) % frame_count;
+            if (older_frame < frame_count && m_frame_sizes[oldest_frame_index] > 0)
+            {
+                m_wait_for_frame(oldest_frame_index);
+                releaseFrame(oldest_frame_index);
+                ++m_stall_count;
+            }
+        }
+
+        // the current frame alone needs more than the whole buffer, reuse the start of it instead of crashing
+        if (m_overflow_count++ == 0)
+        {
+            LOG_ERROR("the upload ring buffer of {} bytes is too small for one frame", m_size);
+        }
+        return 0;
+    }
+
+    void RenderUploadAllocator::releaseFrame(uint32_t frame_index)
+    {
+        m_used_size -= m_frame_sizes[frame_index];
+        m_frame_sizes[frame_index] = 0;
+
+        // nothing is in flight, start over at the beginning to avoid wrapping
+        if (m_used_size == 0)
+        {
+            m_head = 0;
+        }
+    }
+} // namespace Piccolo
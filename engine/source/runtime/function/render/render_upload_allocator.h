@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Piccolo
+{
+    template<typename T>
+    struct RenderUploadAllocation
+    {
+        T*       data {nullptr};
+        uint32_t dynamic_offset {0};
+    };
+
+    // linear allocator for the per-frame uploads of the passes over one persistently mapped buffer.
+    // the frames allocate one behind the other and wrap around at the end of the buffer, so a frame may use
+    // all the space the other frames in flight have left instead of a fixed slice per frame.
+    // when the buffer is full it waits for the oldest frames in flight to release their space.
+    // all methods are thread safe
+    class RenderUploadAllocator
+    {
+    public:
+        // wait_for_frame blocks until the gpu has finished the frame last submitted with the given index
+        void initialize(void*                         memory_pointer,
+                        uint32_t                      size,
+                        uint32_t                      alignment,
+                        uint32_t                      frames_in_flight,
+                        std::function<void(uint32_t)> wait_for_frame);
+
+        // releases what the frame allocated the last time it was recorded, its fence must have been waited
+        void beginFrame(uint32_t frame_index);
+
+        // count consecutive elements, the dynamic offset is relative to the start of the buffer
+        template<typename T>
+        RenderUploadAllocation<T> allocate(uint32_t count = 1)
+        {
+            RenderUploadAllocation<T> allocation;
+            allocation.dynamic_offset = allocateBytes(static_cast<uint32_t>(sizeof(T)) * count);
+            allocation.data =
+                reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(m_memory_pointer) + allocation.dynamic_offset);
+            return allocation;
+        }
+
+        uint32_t allocateBytes(uint32_t size);
+
+        uint32_t getSize() const { return m_size; }
+        // bumped by beginFrame, lets callers keep their own per-frame counters
+        uint64_t getFrameSerial() const { return m_frame_serial; }
+        // most bytes a single frame has used, alignment padding included
+        uint32_t getHighWaterMark() const { return m_high_water_mark; }
+        // allocations which had to wait for older frames in flight
+        uint32_t getStallCount() const { return m_stall_count; }
+        // allocations which did not fit even into the whole buffer and alias older data of their frame
+        uint32_t getOverflowCount() const { return m_overflow_count; }
+
+    private:
+        void releaseFrame(uint32_t frame_index);
+
+        void*                         m_memory_pointer {nullptr};
+        uint32_t                      m_size {0};
+        uint32_t                      m_alignment {1};
+        std::function<void(uint32_t)> m_wait_for_frame;
+
+        uint32_t m_head {0};
+        uint32_t m_used_size {0};
+        uint32_t m_current_frame_index {0};
+
+        // bytes each frame holds until it is released, wrap around padding included
+        std::vector<uint32_t> m_frame_sizes;
+
+        uint64_t m_frame_serial {0};
+        uint32_t m_high_water_mark {0};
+        uint32_t m_stall_count {0};
+        uint32_t m_overflow_count {0};
+
+        std::mutex m_mutex;
+    };
+} // namespace Piccolo
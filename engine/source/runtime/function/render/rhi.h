@@ -24,11 +24,13 @@ namespace Piccolo
         bool         isValidationLayerEnabled() const { return m_enable_validation_Layers; }
         bool         isDebugLabelEnabled() const { return m_enable_debug_utils_label; }
         bool         isPointLightShadowEnabled() const { return m_enable_point_light_shadow; }
+        bool         isTextureCompressionBCEnabled() const { return m_enable_texture_compression_bc; }
 
     protected:
         bool m_enable_validation_Layers {true};
         bool m_enable_debug_utils_label {true};
         bool m_enable_point_light_shadow {true};
+        bool m_enable_texture_compression_bc {false};
 
         // used in descriptor pool creation
         uint32_t m_max_vertex_blending_mesh_count {256};
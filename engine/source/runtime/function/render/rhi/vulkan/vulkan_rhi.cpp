@@ -1,10 +1,16 @@
 #include "runtime/function/render/rhi/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/rhi/vulkan/vulkan_util.h"
 
+#include "runtime/core/base/macro.h"
+#include "runtime/resource/config_manager/config_manager.h"
+
+#include "runtime/function/global/global_context.h"
 #include "runtime/function/render/window_system.h"
 
 #include <algorithm>
 #include <cassert>
+#include <fstream>
+#include <system_error>
 
 // https://gcc.gnu.org/onlinedocs/cpp/Stringizing.html
 #define PICCOLO_XSTR(s) PICCOLO_STR(s)
@@ -78,17 +84,37 @@ namespace Piccolo
     VulkanRHI::~VulkanRHI()
     {
         // TODO
+        savePipelineCache();
+        if (m_pipeline_cache != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
+        }
     }
 
     void VulkanRHI::initialize(RHIInitInfo init_info)
     {
-        m_window = init_info.window_system->getWindow();
+        m_window      = init_info.window_system->getWindow();
+        m_is_headless = init_info.window_system->isHeadless();
 
         std::array<int, 2> window_size = init_info.window_system->getWindowSize();
 
         m_viewport = {0.0f, 0.0f, (float)window_size[0], (float)window_size[1], 0.0f, 1.0f};
         m_scissor  = {{0, 0}, {(uint32_t)window_size[0], (uint32_t)window_size[1]}};
 
+        if (m_is_headless)
+        {
+            // nothing is presented, so the swapchain extension is not required
+            m_device_extensions.erase(std::remove_if(m_device_extensions.begin(),
+                                                     m_device_extensions.end(),
+                                                     [](const char* extension) {
+                                                         return strcmp(extension, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0;
+                                                     }),
+                                      m_device_extensions.end());
+
+            m_swapchain_extent             = {(uint32_t)window_size[0], (uint32_t)window_size[1]};
+            m_swapchain_image_final_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        }
+
 #ifndef NDEBUG
         m_enable_validation_Layers = true;
         m_enable_debug_utils_label = true;
@@ -97,12 +123,6 @@ namespace Piccolo
         m_enable_debug_utils_label  = false;
 #endif
 
-#if defined(__GNUC__) && defined(__MACH__)
-        m_enable_point_light_shadow = false;
-#else
-        m_enable_point_light_shadow = true;
-#endif
-
 #if defined(__GNUC__)
         // https://gcc.gnu.org/onlinedocs/cpp/Common-Predefined-Macros.html
 #if defined(__linux__)
@@ -136,6 +156,8 @@ namespace Piccolo
 
         createLogicalDevice();
 
+        createPipelineCache();
+
         createCommandPool();
 
         createCommandBuffers();
@@ -191,6 +213,22 @@ namespace Piccolo
 
     bool VulkanRHI::prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain)
     {
+        if (m_is_headless)
+        {
+            // the offscreen image of a frame index is free once the fence of the frame index has been waited, the
+            // empty submit signals the semaphore an acquire would have signaled
+            m_current_swapchain_image_index = m_current_frame_index;
+
+            VkSubmitInfo submit_info         = {};
+            submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit_info.signalSemaphoreCount = 1;
+            submit_info.pSignalSemaphores    = &m_image_available_for_render_semaphores[m_current_frame_index];
+
+            VkResult res_queue_submit = vkQueueSubmit(m_graphics_queue, 1, &submit_info, VK_NULL_HANDLE);
+            assert(VK_SUCCESS == res_queue_submit);
+            return false;
+        }
+
         VkResult acquire_image_result =
             vkAcquireNextImageKHR(m_device,
                                   m_swapchain,
@@ -243,6 +281,23 @@ namespace Piccolo
 
     void VulkanRHI::submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain)
     {
+        if (m_is_headless)
+        {
+            // the empty submit waits the semaphore a present would have, so it can be signaled again
+            VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT};
+            VkSubmitInfo         submit_info   = {};
+            submit_info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit_info.waitSemaphoreCount     = 1;
+            submit_info.pWaitSemaphores        = &m_image_finished_for_presentation_semaphores[m_current_frame_index];
+            submit_info.pWaitDstStageMask      = wait_stages;
+
+            VkResult res_queue_submit = vkQueueSubmit(m_graphics_queue, 1, &submit_info, VK_NULL_HANDLE);
+            assert(VK_SUCCESS == res_queue_submit);
+
+            m_current_frame_index = (m_current_frame_index + 1) % s_max_frames_in_flight;
+            return;
+        }
+
         // present swapchain
         VkPresentInfoKHR present_info   = {};
         present_info.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -334,11 +389,15 @@ namespace Piccolo
 
     std::vector<const char*> VulkanRHI::getRequiredExtensions()
     {
-        uint32_t     glfwExtensionCount = 0;
-        const char** glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        std::vector<const char*> extensions;
+        if (!m_is_headless)
+        {
+            uint32_t     glfwExtensionCount = 0;
+            const char** glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (m_enable_validation_Layers || m_enable_debug_utils_label)
         {
@@ -446,12 +505,91 @@ namespace Piccolo
 
     void VulkanRHI::createWindowSurface()
     {
+        if (m_is_headless)
+        {
+            return;
+        }
+
         if (glfwCreateWindowSurface(m_instance, m_window, nullptr, &m_surface) != VK_SUCCESS)
         {
             throw std::runtime_error("glfwCreateWindowSurface");
         }
     }
 
+    void VulkanRHI::createOffscreenImages()
+    {
+        m_swapchain_image_format = VK_FORMAT_B8G8R8A8_UNORM;
+
+        m_swapchain_images.resize(s_max_frames_in_flight);
+        m_offscreen_image_memories.resize(s_max_frames_in_flight);
+        for (uint32_t i = 0; i < s_max_frames_in_flight; ++i)
+        {
+            VulkanUtil::createImage(m_physical_device,
+                                    m_device,
+                                    m_swapchain_extent.width,
+                                    m_swapchain_extent.height,
+                                    m_swapchain_image_format,
+                                    VK_IMAGE_TILING_OPTIMAL,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                    m_swapchain_images[i],
+                                    m_offscreen_image_memories[i],
+                                    0,
+                                    1,
+                                    1);
+        }
+
+        m_scene_extent = m_swapchain_extent;
+        m_scissor      = {{0, 0}, {m_swapchain_extent.width, m_swapchain_extent.height}};
+    }
+
+    bool VulkanRHI::readbackPresentedImage(std::vector<uint8_t>& bgra_pixels)
+    {
+        if (!m_is_headless)
+        {
+            return false;
+        }
+
+        // the rendering and the particle simulation may still run
+        vkDeviceWaitIdle(m_device);
+
+        VkDeviceSize   buffer_size = VkDeviceSize(m_swapchain_extent.width) * m_swapchain_extent.height * 4;
+        VkBuffer       staging_buffer;
+        VkDeviceMemory staging_buffer_memory;
+        VulkanUtil::createBuffer(m_physical_device,
+                                 m_device,
+                                 buffer_size,
+                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 staging_buffer,
+                                 staging_buffer_memory);
+
+        VkBufferImageCopy region {};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent                 = {m_swapchain_extent.width, m_swapchain_extent.height, 1};
+
+        // the post process render pass leaves the image as a transfer source
+        VkCommandBuffer command_buffer = beginSingleTimeCommands();
+        vkCmdCopyImageToBuffer(command_buffer,
+                               m_swapchain_images[m_current_swapchain_image_index],
+                               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               staging_buffer,
+                               1,
+                               &region);
+        endSingleTimeCommands(command_buffer);
+
+        void* data = nullptr;
+        vkMapMemory(m_device, staging_buffer_memory, 0, buffer_size, 0, &data);
+        bgra_pixels.resize(static_cast<size_t>(buffer_size));
+        memcpy(bgra_pixels.data(), data, bgra_pixels.size());
+        vkUnmapMemory(m_device, staging_buffer_memory);
+
+        vkDestroyBuffer(m_device, staging_buffer, nullptr);
+        vkFreeMemory(m_device, staging_buffer_memory, nullptr);
+        return true;
+    }
+
     void VulkanRHI::initializePhysicalDevice()
     {
         uint32_t physical_device_count;
@@ -542,11 +680,11 @@ namespace Piccolo
         // support independent blending
         physical_device_features.independentBlend = VK_TRUE;
 
-        // support geometry shader
-        if (m_enable_point_light_shadow)
-        {
-            physical_device_features.geometryShader = VK_TRUE;
-        }
+        // support block compressed textures, the textures are loaded uncompressed otherwise
+        VkPhysicalDeviceFeatures supported_physical_device_features;
+        vkGetPhysicalDeviceFeatures(m_physical_device, &supported_physical_device_features);
+        m_enable_texture_compression_bc = supported_physical_device_features.textureCompressionBC == VK_TRUE;
+        physical_device_features.textureCompressionBC = supported_physical_device_features.textureCompressionBC;
 
         // device create info
         VkDeviceCreateInfo device_create_info {};
@@ -659,9 +797,13 @@ namespace Piccolo
 
         VkDescriptorPoolSize pool_sizes[6];
         pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-        pool_sizes[0].descriptorCount = 3 + 1 + 1 + 3 + 3 + 3 + 2;
+        pool_sizes[0].descriptorCount =
+            3 + 1 + 1 + 3 + 3 + 3 + 2 + 1 * s_max_frames_in_flight + 1; // + mesh skinning + pcf mask cascades
         pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        pool_sizes[1].descriptorCount = 1 + 1 + 1 * m_max_vertex_blending_mesh_count;
+        pool_sizes[1].descriptorCount =
+            1 + 1 + 1 * m_max_vertex_blending_mesh_count + (3 + 2) * s_max_frames_in_flight + // + mesh culling
+            3 * m_max_vertex_blending_mesh_count + 2 * s_max_frames_in_flight +             // + mesh skinning
+            2 * s_max_frames_in_flight;                                                     // + light clustering
         pool_sizes[2].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         pool_sizes[2].descriptorCount = 1 * m_max_material_count;
         pool_sizes[3].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -675,8 +817,9 @@ namespace Piccolo
         pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
         pool_info.pPoolSizes    = pool_sizes;
-        pool_info.maxSets       = 1 + 1 + 1 + m_max_material_count + m_max_vertex_blending_mesh_count + 1 +
-                            1; // +skybox + axis descriptor set
+        pool_info.maxSets       = 1 + 1 + 1 + m_max_material_count + m_max_vertex_blending_mesh_count + 1 + 1 +
+                            2 * s_max_frames_in_flight + m_max_vertex_blending_mesh_count + s_max_frames_in_flight +
+                            s_max_frames_in_flight; // +skybox + axis + mesh culling + mesh skinning + light clustering
         pool_info.flags = 0U;
 
         if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_descriptor_pool) != VK_SUCCESS)
@@ -704,9 +847,6 @@ namespace Piccolo
                 vkCreateSemaphore(
                     m_device, &semaphore_create_info, nullptr, &m_image_finished_for_presentation_semaphores[i]) !=
                     VK_SUCCESS ||
-                vkCreateSemaphore(
-                    m_device, &semaphore_create_info, nullptr, &m_image_available_for_texturescopy_semaphores[i]) !=
-                    VK_SUCCESS ||
                 vkCreateSemaphore(
                     m_device, &semaphore_create_info, nullptr, &m_image_available_for_bloom_blur_semaphores[i]) !=
                     VK_SUCCESS ||
@@ -780,6 +920,12 @@ namespace Piccolo
 
     void VulkanRHI::createSwapchain()
     {
+        if (m_is_headless)
+        {
+            createOffscreenImages();
+            return;
+        }
+
         // query all supports of this physical device
         SwapChainSupportDetails swapchain_support_details = querySwapChainSupport(m_physical_device);
 
@@ -842,6 +988,7 @@ namespace Piccolo
 
         m_swapchain_image_format = chosen_surface_format.format;
         m_swapchain_extent       = chosen_extent;
+        m_scene_extent           = chosen_extent;
 
         m_scissor = {{0, 0}, {m_swapchain_extent.width, m_swapchain_extent.height}};
     }
@@ -852,18 +999,33 @@ namespace Piccolo
         {
             vkDestroyImageView(m_device, imageview, NULL);
         }
-        vkDestroySwapchainKHR(m_device, m_swapchain, NULL); // also swapchain images
+
+        if (m_is_headless)
+        {
+            for (size_t i = 0; i < m_swapchain_images.size(); i++)
+            {
+                vkDestroyImage(m_device, m_swapchain_images[i], NULL);
+                vkFreeMemory(m_device, m_offscreen_image_memories[i], NULL);
+            }
+        }
+        else
+        {
+            vkDestroySwapchainKHR(m_device, m_swapchain, NULL); // also swapchain images
+        }
     }
 
     void VulkanRHI::recreateSwapchain()
     {
-        int width  = 0;
-        int height = 0;
-        glfwGetFramebufferSize(m_window, &width, &height);
-        while (width == 0 || height == 0) // minimized 0,0, pause for now
+        if (!m_is_headless)
         {
+            int width  = 0;
+            int height = 0;
             glfwGetFramebufferSize(m_window, &width, &height);
-            glfwWaitEvents();
+            while (width == 0 || height == 0) // minimized 0,0, pause for now
+            {
+                glfwGetFramebufferSize(m_window, &width, &height);
+                glfwWaitEvents();
+            }
         }
 
         VkResult res_wait_for_fences =
@@ -876,11 +1038,7 @@ namespace Piccolo
         vkDestroyImage(m_device, m_depth_image, NULL);
         vkFreeMemory(m_device, m_depth_image_memory, NULL);
 
-        for (auto imageview : m_swapchain_imageviews)
-        {
-            vkDestroyImageView(m_device, imageview, NULL);
-        }
-        vkDestroySwapchainKHR(m_device, m_swapchain, NULL);
+        clearSwapchain();
 
         createSwapchain();
         createSwapchainImageViews();
@@ -938,10 +1096,18 @@ namespace Piccolo
             }
 
             VkBool32 is_present_support = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(physical_device,
-                                                 i,
-                                                 m_surface,
-                                                 &is_present_support); // if support surface presentation
+            if (m_is_headless)
+            {
+                // nothing is presented, the graphics queue stands in for the present one
+                is_present_support = (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT) ? VK_TRUE : VK_FALSE;
+            }
+            else
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(physical_device,
+                                                     i,
+                                                     m_surface,
+                                                     &is_present_support); // if support surface presentation
+            }
             if (is_present_support)
             {
                 indices.m_present_family = i;
@@ -977,8 +1143,8 @@ namespace Piccolo
     {
         auto queue_indices           = findQueueFamilies(physical_device);
         bool is_extensions_supported = checkDeviceExtensionSupport(physical_device);
-        bool is_swapchain_adequate   = false;
-        if (is_extensions_supported)
+        bool is_swapchain_adequate   = m_is_headless && is_extensions_supported;
+        if (is_extensions_supported && !m_is_headless)
         {
             SwapChainSupportDetails swapchain_support_details = querySwapChainSupport(physical_device);
             is_swapchain_adequate =
@@ -1107,4 +1273,100 @@ namespace Piccolo
         }
     }
 
+
+    void VulkanRHI::createPipelineCache()
+    {
+        // the path is kept so the cache can still be saved when the config manager is gone at shutdown
+        m_pipeline_cache_path = g_runtime_global_context.m_config_manager->getRootFolder() / "cache" / "pipeline.cache";
+
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+
+        // a cache written by another device or driver is dropped, not every driver rejects it safely
+        std::vector<char> cache_data;
+        std::ifstream     file(m_pipeline_cache_path, std::ios::binary | std::ios::ate);
+        if (file)
+        {
+            cache_data.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(cache_data.data(), static_cast<std::streamsize>(cache_data.size()));
+            if (!file)
+            {
+                cache_data.clear();
+            }
+        }
+
+        VkPipelineCacheHeaderVersionOne header {};
+        if (cache_data.size() >= sizeof(header))
+        {
+            memcpy(&header, cache_data.data(), sizeof(header));
+        }
+        if (cache_data.size() < sizeof(header) || header.headerSize < sizeof(header) ||
+            header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            header.vendorID != physical_device_properties.vendorID ||
+            header.deviceID != physical_device_properties.deviceID ||
+            memcmp(header.pipelineCacheUUID, physical_device_properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            if (!cache_data.empty())
+            {
+                LOG_INFO("pipeline cache {} does not match the device, it is rebuilt",
+                         m_pipeline_cache_path.generic_string());
+            }
+            cache_data.clear();
+        }
+
+        VkPipelineCacheCreateInfo pipeline_cache_create_info {};
+        pipeline_cache_create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        pipeline_cache_create_info.initialDataSize = cache_data.size();
+        pipeline_cache_create_info.pInitialData    = cache_data.empty() ? nullptr : cache_data.data();
+
+        if (vkCreatePipelineCache(m_device, &pipeline_cache_create_info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+        {
+            throw std::runtime_error("create pipeline cache");
+        }
+    }
+
+    void VulkanRHI::savePipelineCache()
+    {
+        if (m_pipeline_cache == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        size_t cache_size = 0;
+        if (vkGetPipelineCacheData(m_device, m_pipeline_cache, &cache_size, nullptr) != VK_SUCCESS || cache_size == 0)
+        {
+            return;
+        }
+
+        std::vector<char> cache_data(cache_size);
+        if (vkGetPipelineCacheData(m_device, m_pipeline_cache, &cache_size, cache_data.data()) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(m_pipeline_cache_path.parent_path(), error);
+
+        // write to a temporary file first so a crash never leaves a half written cache
+        std::filesystem::path temporary_path = m_pipeline_cache_path;
+        temporary_path += ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            file.write(cache_data.data(), static_cast<std::streamsize>(cache_size));
+            if (!file)
+            {
+                LOG_WARN("failed to save pipeline cache {}", m_pipeline_cache_path.generic_string());
+                file.close();
+                std::filesystem::remove(temporary_path, error);
+                return;
+            }
+        }
+        std::filesystem::rename(temporary_path, m_pipeline_cache_path, error);
+        if (error)
+        {
+            LOG_WARN("failed to save pipeline cache {}: {}", m_pipeline_cache_path.generic_string(), error.message());
+            std::filesystem::remove(temporary_path, error);
+        }
+    }
 } // namespace Piccolo
\ No newline at end of file
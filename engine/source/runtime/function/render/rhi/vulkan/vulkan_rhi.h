@@ -5,6 +5,7 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <filesystem>
 #include <functional>
 #include <optional>
 #include <vector>
@@ -50,6 +51,9 @@ namespace Piccolo
         void createSwapchainImageViews();
         void createFramebufferImageAndView();
 
+        // headless only, copies the last rendered offscreen image out as tightly packed 8-bit BGRA texels
+        bool readbackPresentedImage(std::vector<uint8_t>& bgra_pixels);
+
         // debug utilities label
         PFN_vkCmdBeginDebugUtilsLabelEXT m_vk_cmd_begin_debug_utils_label_ext;
         PFN_vkCmdEndDebugUtilsLabelEXT   m_vk_cmd_end_debug_utils_label_ext;
@@ -66,6 +70,7 @@ namespace Piccolo
         void createInstance();
         void initializeDebugMessenger();
         void createWindowSurface();
+        void createOffscreenImages();
         void initializePhysicalDevice();
         void createLogicalDevice();
         void createCommandPool();
@@ -73,6 +78,8 @@ namespace Piccolo
         void createDescriptorPool();
         void createSyncPrimitives();
         void createAssetAllocator();
+        void createPipelineCache();
+        void savePipelineCache();
 
         bool                     checkValidationLayerSupport();
         std::vector<const char*> getRequiredExtensions();
@@ -118,8 +125,12 @@ namespace Piccolo
         VkSwapchainKHR           m_swapchain {VK_NULL_HANDLE};
         VkFormat                 m_swapchain_image_format {VK_FORMAT_UNDEFINED};
         VkExtent2D               m_swapchain_extent;
+        // the 3d passes render into the top left of their swapchain sized targets, see RenderResolutionScaler
+        VkExtent2D               m_scene_extent;
         std::vector<VkImage>     m_swapchain_images;
         std::vector<VkImageView> m_swapchain_imageviews;
+        // left by the last pass, the offscreen images are left as transfer sources instead
+        VkImageLayout m_swapchain_image_final_layout {VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
 
         VkImage        m_depth_image {VK_NULL_HANDLE};
         VkDeviceMemory m_depth_image_memory {VK_NULL_HANDLE};
@@ -153,6 +164,9 @@ namespace Piccolo
         // global descriptor pool
         VkDescriptorPool m_descriptor_pool;
 
+        // shared by all pipeline creations, loaded from and saved to disk
+        VkPipelineCache m_pipeline_cache {VK_NULL_HANDLE};
+
         // command pool and buffers
         static uint8_t const s_max_frames_in_flight {3};
         uint8_t              m_current_frame_index {0};
@@ -163,7 +177,6 @@ namespace Piccolo
         VkSemaphore          m_image_available_for_bloom_blur_semaphores[s_max_frames_in_flight];
         VkSemaphore          m_image_available_for_post_process_semaphores[s_max_frames_in_flight];
         VkSemaphore          m_image_available_for_render_semaphores[s_max_frames_in_flight];
-        VkSemaphore          m_image_available_for_texturescopy_semaphores[s_max_frames_in_flight];
         VkSemaphore          m_image_finished_for_presentation_semaphores[s_max_frames_in_flight];
         VkFence              m_is_frame_in_flight_fences[s_max_frames_in_flight];
 
@@ -190,5 +203,11 @@ namespace Piccolo
         };
 
         VkDebugUtilsMessengerEXT m_debug_messenger {VK_NULL_HANDLE};
+
+        // without a window the swapchain is emulated by a ring of offscreen images, one per frame in flight
+        bool                        m_is_headless {false};
+        std::vector<VkDeviceMemory> m_offscreen_image_memories;
+
+        std::filesystem::path m_pipeline_cache_path;
     };
 } // namespace Piccolo
@@ -226,7 +226,8 @@ namespace Piccolo
                                             VkImageAspectFlags image_aspect_flags,
                                             VkImageViewType    view_type,
                                             uint32_t           layout_count,
-                                            uint32_t           miplevels)
+                                            uint32_t           miplevels,
+                                            uint32_t           base_array_layer)
     {
         VkImageViewCreateInfo image_view_create_info {};
         image_view_create_info.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -236,7 +237,7 @@ namespace Piccolo
         image_view_create_info.subresourceRange.aspectMask     = image_aspect_flags;
         image_view_create_info.subresourceRange.baseMipLevel   = 0;
         image_view_create_info.subresourceRange.levelCount     = miplevels;
-        image_view_create_info.subresourceRange.baseArrayLayer = 0;
+        image_view_create_info.subresourceRange.baseArrayLayer = base_array_layer;
         image_view_create_info.subresourceRange.layerCount     = layout_count;
 
         VkImageView image_view;
@@ -264,7 +265,8 @@ namespace Piccolo
             return;
         }
 
-        VkDeviceSize texture_byte_size;
+        VkDeviceSize texture_byte_size {0};
+        VkDeviceSize block_byte_size {0};
         VkFormat     vulkan_image_format;
         switch (texture_image_format)
         {
@@ -296,11 +298,56 @@ namespace Piccolo
                 texture_byte_size   = texture_image_width * texture_image_height * 4 * 4;
                 vulkan_image_format = VK_FORMAT_R32G32B32A32_SFLOAT;
                 break;
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC4_UNORM:
+                block_byte_size     = 8;
+                vulkan_image_format = VK_FORMAT_BC4_UNORM_BLOCK;
+                break;
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC5_UNORM:
+                block_byte_size     = 16;
+                vulkan_image_format = VK_FORMAT_BC5_UNORM_BLOCK;
+                break;
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_UNORM:
+                block_byte_size     = 16;
+                vulkan_image_format = VK_FORMAT_BC7_UNORM_BLOCK;
+                break;
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_BC7_SRGB:
+                block_byte_size     = 16;
+                vulkan_image_format = VK_FORMAT_BC7_SRGB_BLOCK;
+                break;
             default:
                 throw std::runtime_error("invalid texture_byte_size");
                 break;
         }
 
+        // generate mipmapped image
+        uint32_t mip_levels =
+            (miplevels != 0) ? miplevels : floor(std::log2(std::max(texture_image_width, texture_image_height))) + 1;
+
+        // block compressed pixels hold all mip levels one after another, they can not be blitted so they are
+        // copied level by level instead of generated
+        std::vector<VkBufferImageCopy> mip_level_copies;
+        if (block_byte_size != 0)
+        {
+            texture_byte_size = 0;
+            for (uint32_t mip_level = 0; mip_level < mip_levels; ++mip_level)
+            {
+                uint32_t level_width  = std::max(texture_image_width >> mip_level, 1u);
+                uint32_t level_height = std::max(texture_image_height >> mip_level, 1u);
+
+                VkBufferImageCopy region {};
+                region.bufferOffset                    = texture_byte_size;
+                region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.mipLevel       = mip_level;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount     = 1;
+                region.imageOffset                     = {0, 0, 0};
+                region.imageExtent                     = {level_width, level_height, 1};
+                mip_level_copies.push_back(region);
+
+                texture_byte_size += VkDeviceSize((level_width + 3) / 4) * ((level_height + 3) / 4) * block_byte_size;
+            }
+        }
+
         // use staging buffer
         VkBuffer       inefficient_staging_buffer;
         VkDeviceMemory inefficient_staging_buffer_memory;
@@ -318,10 +365,6 @@ namespace Piccolo
         memcpy(data, texture_image_pixels, static_cast<size_t>(texture_byte_size));
         vkUnmapMemory(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer_memory);
 
-        // generate mipmapped image
-        uint32_t mip_levels =
-            (miplevels != 0) ? miplevels : floor(std::log2(std::max(texture_image_width, texture_image_height))) + 1;
-
         // use the vmaAllocator to allocate asset texture image
         VkImageCreateInfo image_create_info {};
         image_create_info.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -350,6 +393,46 @@ namespace Piccolo
                        &image_allocation,
                        NULL);
 
+        if (!mip_level_copies.empty())
+        {
+            transitionImageLayout(rhi,
+                                  image,
+                                  VK_IMAGE_LAYOUT_UNDEFINED,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  1,
+                                  mip_levels,
+                                  VK_IMAGE_ASPECT_COLOR_BIT);
+
+            VkCommandBuffer command_buffer = static_cast<VulkanRHI*>(rhi)->beginSingleTimeCommands();
+            vkCmdCopyBufferToImage(command_buffer,
+                                   inefficient_staging_buffer,
+                                   image,
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   static_cast<uint32_t>(mip_level_copies.size()),
+                                   mip_level_copies.data());
+            static_cast<VulkanRHI*>(rhi)->endSingleTimeCommands(command_buffer);
+
+            transitionImageLayout(rhi,
+                                  image,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                  1,
+                                  mip_levels,
+                                  VK_IMAGE_ASPECT_COLOR_BIT);
+
+            vkDestroyBuffer(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer, nullptr);
+            vkFreeMemory(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer_memory, nullptr);
+
+            image_view = createImageView(static_cast<VulkanRHI*>(rhi)->m_device,
+                                         image,
+                                         vulkan_image_format,
+                                         VK_IMAGE_ASPECT_COLOR_BIT,
+                                         VK_IMAGE_VIEW_TYPE_2D,
+                                         1,
+                                         mip_levels);
+            return;
+        }
+
         // layout transitions -- image layout is set from none to destination
         transitionImageLayout(rhi,
                               image,
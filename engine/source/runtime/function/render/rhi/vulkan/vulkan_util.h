@@ -59,7 +59,8 @@ namespace Piccolo
                                               VkImageAspectFlags image_aspect_flags,
                                               VkImageViewType    view_type,
                                               uint32_t           layout_count,
-                                              uint32_t           miplevels);
+                                              uint32_t           miplevels,
+                                              uint32_t           base_array_layer = 0);
         static void           createGlobalImage(RHI*                 rhi,
                                                 VkImage&             image,
                                                 VkImageView&         image_view,
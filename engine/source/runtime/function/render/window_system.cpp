@@ -6,12 +6,24 @@ namespace Piccolo
 {
     WindowSystem::~WindowSystem()
     {
+        if (m_is_headless)
+        {
+            return;
+        }
         glfwDestroyWindow(m_window);
         glfwTerminate();
     }
 
     void WindowSystem::initialize(WindowCreateInfo create_info)
     {
+        if (create_info.is_headless)
+        {
+            m_is_headless = true;
+            m_width       = create_info.width;
+            m_height      = create_info.height;
+            return;
+        }
+
         if (!glfwInit())
         {
             LOG_FATAL(__FUNCTION__, "failed to initialize GLFW");
@@ -46,11 +58,23 @@ namespace Piccolo
         glfwSetInputMode(m_window, GLFW_RAW_MOUSE_MOTION, GLFW_FALSE);
     }
 
-    void WindowSystem::pollEvents() const { glfwPollEvents(); }
+    void WindowSystem::pollEvents() const
+    {
+        if (!m_is_headless)
+        {
+            glfwPollEvents();
+        }
+    }
 
-    bool WindowSystem::shouldClose() const { return glfwWindowShouldClose(m_window); }
+    bool WindowSystem::shouldClose() const { return !m_is_headless && glfwWindowShouldClose(m_window); }
 
-    void WindowSystem::setTitle(const char* title) { glfwSetWindowTitle(m_window, title); }
+    void WindowSystem::setTitle(const char* title)
+    {
+        if (!m_is_headless)
+        {
+            glfwSetWindowTitle(m_window, title);
+        }
+    }
 
     GLFWwindow* WindowSystem::getWindow() const { return m_window; }
 
@@ -59,6 +83,10 @@ namespace Piccolo
     void WindowSystem::setFocusMode(bool mode)
     {
         m_is_focus_mode = mode;
+        if (m_is_headless)
+        {
+            return;
+        }
         glfwSetInputMode(m_window, GLFW_CURSOR, m_is_focus_mode ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
     }
 } // namespace Piccolo
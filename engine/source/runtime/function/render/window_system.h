@@ -15,6 +15,8 @@ namespace Piccolo
         int         height {720};
         const char* title {"Piccolo"};
         bool        is_fullscreen {false};
+        // no window is created, the size is only used by the offscreen rendering
+        bool is_headless {false};
     };
 
     class WindowSystem
@@ -28,6 +30,7 @@ namespace Piccolo
         void               setTitle(const char* title);
         GLFWwindow*        getWindow() const;
         std::array<int, 2> getWindowSize() const;
+        bool               isHeadless() const { return m_is_headless; }
 
         typedef std::function<void()>                   onResetFunc;
         typedef std::function<void(int, int, int, int)> onKeyFunc;
@@ -55,7 +58,7 @@ namespace Piccolo
 
         bool isMouseButtonDown(int button) const
         {
-            if (button < GLFW_MOUSE_BUTTON_1 || button > GLFW_MOUSE_BUTTON_LAST)
+            if (!m_window || button < GLFW_MOUSE_BUTTON_1 || button > GLFW_MOUSE_BUTTON_LAST)
             {
                 return false;
             }
@@ -197,6 +200,7 @@ namespace Piccolo
         int         m_width {0};
         int         m_height {0};
 
+        bool m_is_headless {false};
         bool m_is_focus_mode {false};
 
         std::vector<onResetFunc>       m_onResetFunc;
@@ -53,6 +53,19 @@ namespace Piccolo
 
     public:
         bool                m_enable_fxaa {true};
+        bool                m_enable_parallel_culling {false};
+        bool                m_enable_async_asset_loading {false};
+        bool                m_enable_texture_compression {false};
+        bool                m_enable_gpu_driven_culling {false};
+        bool                m_enable_parallel_command_recording {false};
+        bool                m_enable_compute_skinning {false};
+        bool                m_enable_fused_post_process {false};
+        bool                m_enable_dynamic_resolution {false};
+        float               m_dynamic_resolution_target_gpu_time_ms {14.0f};
+        float               m_dynamic_resolution_min_scale {0.5f};
+        int                 m_directional_light_cascade_count {1};
+        float               m_directional_light_cascade_split_lambda {0.75f};
+        int                 m_directional_light_first_cached_cascade {4};
         SkyBoxIrradianceMap m_skybox_irradiance_map;
         SkyBoxSpecularMap   m_skybox_specular_map;
         std::string         m_brdf_map;